@@ -33,9 +33,9 @@ class DistributedObjectGlobalUD(DistributedObjectUD):
             # Import some useful variables into the ExecNamespace initially.
             import panda3d.core
 
-            for key, value in panda3d.core.__dict__.items():
+            for key in dir(panda3d.core):
                 if not key.startswith('__'):
-                    self.ExecNamespace[key] = value
+                    self.ExecNamespace[key] = getattr(panda3d.core, key)
             #self.importExecNamespace()
 
         # Now try to evaluate the expression using ChatInputNormal.ExecNamespace as
@@ -1310,6 +1310,44 @@ write_sub_module(ostream &out, Object *obj) {
   }
 }
 
+/**
+ * Writes the entries for the table of classes that are created on demand,
+ * for the case in which the module supports this.  This is the counterpart
+ * to write_sub_module().
+ */
+void InterfaceMakerPythonNative::
+write_lazy_sub_module(ostream &out, Object *obj) {
+  string class_name = make_safe_name(obj->_itype.get_scoped_name());
+  string class_ptr = "&Dtool_" + class_name;
+
+  if (obj->_itype.is_typedef()) {
+    // Unwrap typedefs.
+    TypeIndex wrapped = obj->_itype._wrapped_type;
+    while (interrogate_type_is_typedef(wrapped)) {
+      wrapped = interrogate_type_wrapped_type(wrapped);
+    }
+
+    InterrogateDatabase *idb = InterrogateDatabase::get_ptr();
+    const InterrogateType &wrapped_itype = idb->get_type(wrapped);
+
+    class_name = make_safe_name(wrapped_itype.get_scoped_name());
+    if (!isExportThisRun(wrapped_itype._cpptype)) {
+      _external_imports.insert(TypeManager::resolve_type(wrapped_itype._cpptype));
+      class_ptr = "Dtool_Ptr_" + class_name;
+    } else {
+      class_ptr = "&Dtool_" + class_name;
+    }
+  }
+
+  std::string export_class_name = classNameFromCppName(obj->_itype.get_name(), false);
+  std::string export_class_name2 = classNameFromCppName(obj->_itype.get_name(), true);
+
+  out << "      {\"" << export_class_name << "\", " << class_ptr << "},\n";
+  if (export_class_name != export_class_name2) {
+    out << "      {\"" << export_class_name2 << "\", " << class_ptr << "},\n";
+  }
+}
+
 /**
 
  */
@@ -1444,6 +1482,9 @@ write_module_support(ostream &out, ostream *out_h, InterrogateModuleDef *def) {
     }
   }
 
+  // Collect the top-level classes and typedefs that should be added to the
+  // module.
+  std::vector<Object *> sub_modules;
   for (oi = _objects.begin(); oi != _objects.end(); ++oi) {
     Object *object = (*oi).second;
     if (!object->_itype.get_outer_class()) {
@@ -1452,13 +1493,32 @@ write_module_support(ostream &out, ostream *out_h, InterrogateModuleDef *def) {
           object->_itype.is_typedef()) {
         if (is_cpp_type_legal(object->_itype._cpptype)) {
           if (isExportThisRun(object->_itype._cpptype)) {
-            write_sub_module(out, object);
+            sub_modules.push_back(object);
           }
         }
       }
     }
   }
 
+  if (!sub_modules.empty()) {
+    out << "#ifdef DTOOL_LAZY_CLASSES\n"
+           "  {\n"
+           "    // The classes are created when they are first accessed.\n"
+           "    Dtool_TypeDef classes[] = {\n";
+    for (Object *object : sub_modules) {
+      write_lazy_sub_module(out, object);
+    }
+    out << "      {nullptr, nullptr},\n"
+           "    };\n"
+           "    Dtool_AddLazyClasses(module, classes);\n"
+           "  }\n"
+           "#else\n";
+    for (Object *object : sub_modules) {
+      write_sub_module(out, object);
+    }
+    out << "#endif\n";
+  }
+
   out << "}\n\n";
 
   bool force_base_functions = true;
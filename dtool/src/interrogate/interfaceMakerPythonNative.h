@@ -42,6 +42,7 @@ public:
 
   void write_module_class(std::ostream &out, Object *cls);
   virtual void write_sub_module(std::ostream &out, Object *obj);
+  void write_lazy_sub_module(std::ostream &out, Object *obj);
 
   virtual bool synthesize_this_parameter();
   virtual bool separate_overloading();
@@ -456,7 +456,7 @@ PyObject *DTool_CreatePyInstanceTyped(void *local_this_in, Dtool_PyTypedObject &
   if (type_index > 0) {
     // get best fit class...
     Dtool_PyTypedObject *target_class = (Dtool_PyTypedObject *)TypeHandle::from_index(type_index).get_python_type();
-    if (target_class != nullptr) {
+    if (target_class != nullptr && Dtool_ReadyClass(*target_class)) {
       // cast to the type...
       void *new_local_this = target_class->_Dtool_DowncastInterface(local_this_in, &known_class_type);
       if (new_local_this != nullptr) {
@@ -476,6 +476,9 @@ PyObject *DTool_CreatePyInstanceTyped(void *local_this_in, Dtool_PyTypedObject &
 
   // if we get this far .. just wrap the thing in the known type ?? better
   // than aborting...I guess....
+  if (!Dtool_ReadyClass(known_class_type)) {
+    return nullptr;
+  }
   Dtool_PyInstDef *self = (Dtool_PyInstDef *) known_class_type._PyType.tp_new(&known_class_type._PyType, nullptr, nullptr);
   if (self != nullptr) {
     self->_ptr_to_object = local_this_in;
@@ -498,6 +501,9 @@ PyObject *DTool_CreatePyInstance(void *local_this, Dtool_PyTypedObject &in_class
   }
 
   Dtool_PyTypedObject *classdef = &in_classdef;
+  if (!Dtool_ReadyClass(*classdef)) {
+    return nullptr;
+  }
   Dtool_PyInstDef *self = (Dtool_PyInstDef *) classdef->_PyType.tp_new(&classdef->_PyType, nullptr, nullptr);
   if (self != nullptr) {
     self->_ptr_to_object = local_this;
@@ -682,6 +688,166 @@ PyObject *Dtool_PyModuleInitHelper(const LibraryDef *defs[], const char *modulen
   return module;
 }
 
+/**
+ * Creates the Python type object for the indicated class, if this has not
+ * already been done.  Returns true on success, or false with a Python
+ * exception set.  Normally called via Dtool_ReadyClass().
+ */
+bool Dtool_InitClass(Dtool_PyTypedObject &classdef) {
+  if (classdef._PyType.tp_flags & Py_TPFLAGS_READY) {
+    return true;
+  }
+  nassertr(classdef._Dtool_ModuleClassInit != nullptr, false);
+  classdef._Dtool_ModuleClassInit(nullptr);
+  if (classdef._PyType.tp_flags & Py_TPFLAGS_READY) {
+    return true;
+  }
+  if (!PyErr_Occurred()) {
+    PyErr_Format(PyExc_TypeError, "failed to initialize class %s",
+                 classdef._PyType.tp_name);
+  }
+  return false;
+}
+
+#ifdef DTOOL_LAZY_CLASSES
+/**
+ * The classes of a module that are created on first access, keyed by the
+ * name under which they are exported.  This is stored in a capsule that is
+ * bound to the module's __getattr__ and __dir__ functions.
+ */
+class LazyClassTable {
+public:
+  PyObject *_module;
+  std::map<std::string, Dtool_PyTypedObject *> _classes;
+};
+
+static void Dtool_LazyClasses_Destroy(PyObject *capsule) {
+  delete (LazyClassTable *)PyCapsule_GetPointer(capsule, nullptr);
+}
+
+/**
+ * Returns the names that are currently in the module dictionary, merged with
+ * the names of the classes that have not yet been created, sorted.  If
+ * public_only is true, names beginning with an underscore are left out.
+ */
+static PyObject *Dtool_LazyClasses_GetNames(LazyClassTable *table, bool public_only) {
+  std::set<std::string> names;
+  for (const auto &item : table->_classes) {
+    names.insert(item.first);
+  }
+
+  PyObject *dict = PyModule_GetDict(table->_module);
+  PyObject *key, *value;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(dict, &pos, &key, &value)) {
+    const char *name = PyUnicode_AsUTF8(key);
+    if (name != nullptr && (!public_only || name[0] != '_')) {
+      names.insert(name);
+    }
+  }
+
+  PyObject *result = PyList_New(names.size());
+  Py_ssize_t i = 0;
+  for (const std::string &name : names) {
+    PyList_SET_ITEM(result, i++, PyUnicode_FromStringAndSize(name.data(), name.size()));
+  }
+  return result;
+}
+
+/**
+ * Implements the module-level __getattr__, which is called by Python when an
+ * attribute is not found in the module dictionary.  Creates the requested
+ * class and stores it in the module dictionary, so that this is only called
+ * once per class.
+ */
+static PyObject *Dtool_LazyClasses_GetAttr(PyObject *self, PyObject *arg) {
+  LazyClassTable *table = (LazyClassTable *)PyCapsule_GetPointer(self, nullptr);
+  const char *name = PyUnicode_AsUTF8(arg);
+  if (table == nullptr || name == nullptr) {
+    return nullptr;
+  }
+
+  auto it = table->_classes.find(name);
+  if (it == table->_classes.end()) {
+    if (strcmp(name, "__all__") == 0) {
+      // This makes "from module import *" pick up the classes that have not
+      // been created yet.
+      return Dtool_LazyClasses_GetNames(table, true);
+    }
+    return PyErr_Format(PyExc_AttributeError, "module '%s' has no attribute '%s'",
+                        PyModule_GetName(table->_module), name);
+  }
+
+  Dtool_PyTypedObject *classdef = it->second;
+  if (!Dtool_ReadyClass(*classdef)) {
+    return nullptr;
+  }
+
+  PyObject *dict = PyModule_GetDict(table->_module);
+  PyDict_SetItem(dict, arg, (PyObject *)classdef);
+  Py_INCREF((PyObject *)classdef);
+  return (PyObject *)classdef;
+}
+
+/**
+ * Implements the module-level __dir__.
+ */
+static PyObject *Dtool_LazyClasses_Dir(PyObject *self, PyObject *) {
+  LazyClassTable *table = (LazyClassTable *)PyCapsule_GetPointer(self, nullptr);
+  if (table == nullptr) {
+    return nullptr;
+  }
+  return Dtool_LazyClasses_GetNames(table, false);
+}
+
+static PyMethodDef lazy_getattr_def = {"__getattr__", &Dtool_LazyClasses_GetAttr, METH_O, nullptr};
+static PyMethodDef lazy_dir_def = {"__dir__", &Dtool_LazyClasses_Dir, METH_NOARGS, nullptr};
+
+/**
+ * Registers the indicated null-terminated list of classes with the module, to
+ * be created when they are first accessed by name.  This may be called more
+ * than once for the same module, once for each library that it combines.
+ */
+bool Dtool_AddLazyClasses(PyObject *module, const Dtool_TypeDef classes[]) {
+  PyObject *dict = PyModule_GetDict(module);
+  LazyClassTable *table = nullptr;
+
+  PyObject *getattr = PyDict_GetItemString(dict, "__getattr__");
+  if (getattr != nullptr && PyCFunction_Check(getattr) &&
+      PyCFunction_GET_FUNCTION(getattr) == lazy_getattr_def.ml_meth) {
+    table = (LazyClassTable *)PyCapsule_GetPointer(PyCFunction_GET_SELF(getattr), nullptr);
+  } else {
+    table = new LazyClassTable;
+    table->_module = module;
+
+    PyObject *capsule = PyCapsule_New(table, nullptr, &Dtool_LazyClasses_Destroy);
+    if (capsule == nullptr) {
+      delete table;
+      return false;
+    }
+    PyObject *getattr_func = PyCFunction_New(&lazy_getattr_def, capsule);
+    PyObject *dir_func = PyCFunction_New(&lazy_dir_def, capsule);
+    Py_DECREF(capsule);
+    if (getattr_func == nullptr || dir_func == nullptr) {
+      Py_XDECREF(getattr_func);
+      Py_XDECREF(dir_func);
+      return false;
+    }
+    PyDict_SetItemString(dict, "__getattr__", getattr_func);
+    PyDict_SetItemString(dict, "__dir__", dir_func);
+    Py_DECREF(getattr_func);
+    Py_DECREF(dir_func);
+  }
+
+  for (const Dtool_TypeDef *def = classes; def->name != nullptr; ++def) {
+    if (def->type != nullptr) {
+      table->_classes[def->name] = def->type;
+    }
+  }
+  return true;
+}
+#endif  // DTOOL_LAZY_CLASSES
+
 // HACK.... Be careful Dtool_BorrowThisReference This function can be used to
 // grab the "THIS" pointer from an object and use it Required to support
 // historical inheritance in the form of "is this instance of"..
@@ -744,7 +910,7 @@ PyObject *copy_from_make_copy(PyObject *self, PyObject *noargs) {
   if (callable == nullptr) {
     return nullptr;
   }
-  PyObject *result = _PyObject_CallNoArg(callable);
+  PyObject *result = PyObject_CallNoArgs(callable);
   Py_DECREF(callable);
   return result;
 }
@@ -768,7 +934,7 @@ PyObject *map_deepcopy_to_copy(PyObject *self, PyObject *args) {
   if (callable == nullptr) {
     return nullptr;
   }
-  PyObject *result = _PyObject_CallNoArg(callable);
+  PyObject *result = PyObject_CallNoArgs(callable);
   Py_DECREF(callable);
   return result;
 }
@@ -327,6 +327,19 @@ EXPCL_PYPANDA PyObject *Dtool_PyModuleInitHelper(const LibraryDef *defs[], PyMod
 EXPCL_PYPANDA PyObject *Dtool_PyModuleInitHelper(const LibraryDef *defs[], const char *modulename);
 #endif
 
+// Python 3.7 allows a module to define __getattr__, which we use to postpone
+// creating each class until it is first accessed.  Importing a module then
+// only has to create the classes that are actually used.
+#if PY_VERSION_HEX >= 0x03070000
+#define DTOOL_LAZY_CLASSES 1
+#endif
+
+#ifdef DTOOL_LAZY_CLASSES
+EXPCL_PYPANDA bool Dtool_AddLazyClasses(PyObject *module, const Dtool_TypeDef classes[]);
+#endif
+ALWAYS_INLINE bool Dtool_ReadyClass(Dtool_PyTypedObject &classdef);
+EXPCL_PYPANDA bool Dtool_InitClass(Dtool_PyTypedObject &classdef);
+
 // HACK.... Be carefull Dtool_BorrowThisReference This function can be used to
 // grab the "THIS" pointer from an object and use it Required to support fom
 // historical inharatence in the for of "is this instance of"..
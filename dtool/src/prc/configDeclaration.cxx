@@ -51,6 +51,16 @@ ConfigDeclaration::
   }
 }
 
+/**
+ * Changes the value assigned to this variable.
+ */
+void ConfigDeclaration::
+set_string_value(const string &string_value) {
+  _string_value = string_value;
+  _got_words = false;
+  _variable->invalidate_value();
+}
+
 /**
  * Changes the nth word to the indicated value without affecting the other
  * words.
@@ -80,7 +90,7 @@ set_string_word(size_t n, const string &value) {
     _string_value += (*wi)._str;
     ++wi;
   }
-  invalidate_cache();
+  _variable->invalidate_value();
 }
 
 /**
@@ -93,7 +103,7 @@ set_bool_word(size_t n, bool value) {
 
   _words[n]._flags |= (F_checked_bool | F_valid_bool);
   _words[n]._bool = value;
-  invalidate_cache();
+  _variable->invalidate_value();
 }
 
 /**
@@ -106,7 +116,7 @@ set_int_word(size_t n, int value) {
 
   _words[n]._flags |= (F_checked_int | F_valid_int);
   _words[n]._int = value;
-  invalidate_cache();
+  _variable->invalidate_value();
 }
 
 /**
@@ -119,7 +129,7 @@ set_int64_word(size_t n, int64_t value) {
 
   _words[n]._flags |= (F_checked_int64 | F_valid_int64);
   _words[n]._int_64 = value;
-  invalidate_cache();
+  _variable->invalidate_value();
 }
 
 /**
@@ -132,7 +142,7 @@ set_double_word(size_t n, double value) {
 
   _words[n]._flags |= (F_checked_double | F_valid_double);
   _words[n]._double = value;
-  invalidate_cache();
+  _variable->invalidate_value();
 }
 
 /**
@@ -47,7 +47,7 @@ PUBLISHED:
   MAKE_PROPERTY(variable, get_variable);
 
   INLINE const std::string &get_string_value() const;
-  INLINE void set_string_value(const std::string &value);
+  void set_string_value(const std::string &value);
 
   INLINE size_t get_num_words() const;
 
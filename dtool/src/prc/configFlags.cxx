@@ -14,6 +14,7 @@
 #include "configFlags.h"
 
 TVOLATILE AtomicAdjust::Integer ConfigFlags::_global_modified;
+TVOLATILE AtomicAdjust::Integer ConfigFlags::_global_epoch;
 
 /**
  *
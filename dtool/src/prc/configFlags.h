@@ -62,9 +62,12 @@ protected:
   ALWAYS_INLINE static void mark_cache_valid(AtomicAdjust::Integer &local_modified);
   INLINE static AtomicAdjust::Integer initial_invalid_cache();
   INLINE static void invalidate_cache();
+  ALWAYS_INLINE static AtomicAdjust::Integer get_global_epoch();
+  INLINE static void invalidate_all_caches();
 
 private:
   static TVOLATILE AtomicAdjust::Integer _global_modified;
+  static TVOLATILE AtomicAdjust::Integer _global_epoch;
 };
 
 std::ostream &operator << (std::ostream &out, ConfigFlags::ValueType type);
@@ -466,7 +466,7 @@ reload_implicit_pages() {
   }
 
   _currently_loading = false;
-  invalidate_cache();
+  invalidate_all_caches();
 
 #ifdef USE_PANDAFILESTREAM
   // Update this very low-level config variable here, for lack of any better
@@ -512,7 +512,7 @@ make_explicit_page(const string &name) {
   ++_next_page_seq;
   _explicit_pages.push_back(page);
   _pages_sorted = false;
-  invalidate_cache();
+  invalidate_all_caches();
   return page;
 }
 
@@ -530,7 +530,7 @@ delete_explicit_page(ConfigPage *page) {
     if ((*pi) == page) {
       _explicit_pages.erase(pi);
       delete page;
-      invalidate_cache();
+      invalidate_all_caches();
       return true;
     }
   }
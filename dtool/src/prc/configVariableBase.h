@@ -74,6 +74,11 @@ PUBLISHED:
   INLINE void write(std::ostream &out) const;
 
 protected:
+  ALWAYS_INLINE AtomicAdjust::Integer get_value_modified() const;
+  ALWAYS_INLINE bool is_value_cache_valid(AtomicAdjust::Integer local_modified) const;
+  ALWAYS_INLINE void mark_value_cache_valid(AtomicAdjust::Integer &local_modified) const;
+  INLINE AtomicAdjust::Integer initial_invalid_value_cache() const;
+
   void record_unconstructed() const;
   bool was_unconstructed() const;
 
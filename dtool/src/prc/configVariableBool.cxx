@@ -30,9 +30,9 @@ reload_value() const {
 
   // We check again for cache validity since another thread may have beaten
   // us to the punch while we were waiting for the lock.
-  if (!is_cache_valid(_local_modified)) {
+  if (!is_value_cache_valid(_local_modified)) {
     _cache = get_bool_word(0);
-    mark_cache_valid(_local_modified);
+    mark_value_cache_valid(_local_modified);
   }
 
   lock.unlock();
@@ -39,7 +39,8 @@ ConfigVariableCore(const string &name) :
   _default_value(nullptr),
   _local_value(nullptr),
   _declarations_sorted(true),
-  _value_queried(false)
+  _value_queried(false),
+  _value_seq(0)
 {
 #if defined(PRC_INC_TRUST_LEVEL) && PRC_INC_TRUST_LEVEL != 0
   _flags = (_flags & ~F_trust_level_mask) | ((_flags & F_trust_level_mask) + PRC_INC_TRUST_LEVEL);
@@ -61,7 +62,8 @@ ConfigVariableCore(const ConfigVariableCore &templ, const string &name) :
   _default_value(nullptr),
   _local_value(nullptr),
   _declarations_sorted(false),
-  _value_queried(false)
+  _value_queried(false),
+  _value_seq(0)
 {
   if (templ._default_value != nullptr) {
     set_default_value(templ._default_value->get_string_value());
@@ -258,7 +260,7 @@ clear_local_value() {
   if (_local_value != nullptr) {
     ConfigPage::get_local_page()->delete_declaration(_local_value);
     _local_value = nullptr;
-    invalidate_cache();
+    invalidate_value();
     return true;
   }
 
@@ -377,6 +379,7 @@ add_declaration(ConfigDeclaration *decl) {
   _declarations.push_back(decl);
 
   _declarations_sorted = false;
+  invalidate_value();
 }
 
 /**
@@ -396,6 +399,7 @@ remove_declaration(ConfigDeclaration *decl) {
       (*di) = (*di2);
       _declarations.erase(di2);
       _declarations_sorted = false;
+      invalidate_value();
       return;
     }
   }
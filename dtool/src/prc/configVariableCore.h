@@ -94,6 +94,10 @@ PUBLISHED:
   MAKE_SEQ_PROPERTY(trusted_references, get_num_trusted_references, get_trusted_reference);
   MAKE_SEQ_PROPERTY(unique_references, get_num_unique_references, get_unique_reference);
 
+public:
+  ALWAYS_INLINE AtomicAdjust::Integer get_value_seq() const;
+  INLINE void invalidate_value();
+
 private:
   void add_declaration(ConfigDeclaration *decl);
   void remove_declaration(ConfigDeclaration *decl);
@@ -118,6 +122,11 @@ private:
   bool _declarations_sorted;
   bool _value_queried;
 
+  // This is incremented whenever anything happens that might change the
+  // value of this variable.  ConfigVariable objects compare it against the
+  // sequence number they saw when they last cached the value.
+  TVOLATILE AtomicAdjust::Integer _value_seq;
+
   friend class ConfigDeclaration;
   friend class ConfigVariableManager;
 };
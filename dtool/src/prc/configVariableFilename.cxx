@@ -26,12 +26,12 @@ reload_cache() {
 
   // We check again for cache validity since another thread may have beaten
   // us to the punch while we were waiting for the lock.
-  if (!is_cache_valid(_local_modified)) {
+  if (!is_value_cache_valid(_local_modified)) {
     nassertv(_core != nullptr);
     const ConfigDeclaration *decl = _core->get_declaration(0);
 
     _cache = decl->get_filename_value();
-    mark_cache_valid(_local_modified);
+    mark_value_cache_valid(_local_modified);
   }
   filename_lock.unlock();
 }
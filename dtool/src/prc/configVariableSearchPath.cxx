@@ -20,7 +20,7 @@
 void ConfigVariableSearchPath::
 reload_search_path() {
   nassertv(_core != nullptr);
-  mark_cache_valid(_local_modified);
+  mark_value_cache_valid(_local_modified);
   _cache.clear();
 
   _cache.append_path(_prefix);
@@ -25,9 +25,9 @@ reload_cache() {
 
   // We check again for cache validity since another thread may have beaten
   // us to the punch while we were waiting for the lock.
-  if (!is_cache_valid(_local_modified)) {
+  if (!is_value_cache_valid(_local_modified)) {
     _cache = get_string_value();
-    mark_cache_valid(_local_modified);
+    mark_value_cache_valid(_local_modified);
   }
 
   string_lock.unlock();
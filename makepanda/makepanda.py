@@ -4330,6 +4330,12 @@ if PkgSkip("OPENAL") == 0:
     TargetAdd('libp3openal_audio.dll', input=COMMON_PANDA_LIBS)
     TargetAdd('libp3openal_audio.dll', opts=['MODULE', 'ADVAPI', 'WINUSER', 'WINMM', 'WINSHELL', 'WINOLE', 'OPENAL'])
 
+OPTS=['DIR:panda/src/audiotraits', 'BUILDING:SOFTWARE_AUDIO']
+TargetAdd('software_audio_software_audio_composite1.obj', opts=OPTS, input='software_audio_composite1.cxx')
+TargetAdd('libp3software_audio.dll', input='software_audio_software_audio_composite1.obj')
+TargetAdd('libp3software_audio.dll', input=COMMON_PANDA_LIBS)
+TargetAdd('libp3software_audio.dll', opts=['MODULE', 'ADVAPI', 'WINUSER', 'WINMM'])
+
 #
 # DIRECTORY: panda/src/downloadertools/
 #
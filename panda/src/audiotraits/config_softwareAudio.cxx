@@ -0,0 +1,100 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file config_softwareAudio.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+
+#include "config_softwareAudio.h"
+#include "softwareAudioManager.h"
+#include "softwareAudioSound.h"
+#include "pandaSystem.h"
+#include "dconfig.h"
+
+#if !defined(CPPPARSER) && !defined(LINK_ALL_STATIC) && !defined(BUILDING_SOFTWARE_AUDIO)
+  #error Buildsystem error: BUILDING_SOFTWARE_AUDIO not defined
+#endif
+
+ConfigureDef(config_softwareAudio);
+NotifyCategoryDef(softwareAudio, ":audio");
+
+ConfigureFn(config_softwareAudio) {
+  init_libSoftwareAudio();
+}
+
+ConfigVariableInt software_audio_rate
+("software-audio-rate", 44100,
+ PRC_DESC("The sample rate, in samples per second, at which the software "
+          "audio mixer produces its output.  Sounds recorded at other rates "
+          "are resampled on the fly."));
+
+ConfigVariableInt software_audio_channels
+("software-audio-channels", 2,
+ PRC_DESC("The number of output channels produced by the software audio "
+          "mixer.  This may be 1 (mono) or 2 (stereo)."));
+
+ConfigVariableInt software_audio_block_size
+("software-audio-block-size", 512,
+ PRC_DESC("The number of sample frames the software audio mixer produces "
+          "at a time.  When the mixer runs in its own thread, this also "
+          "determines the latency of changes to the playing sounds."));
+
+ConfigVariableFilename software_audio_output
+("software-audio-output", "",
+ PRC_DESC("If this is set to a filename, the software audio mixer writes "
+          "everything it mixes to that file, as a 16-bit PCM .wav file.  "
+          "If it is empty, the mixed audio is simply discarded, which is "
+          "still useful for a headless process that needs sounds to play "
+          "and finish in real time."));
+
+ConfigVariableBool software_audio_threaded
+("software-audio-threaded", true,
+ PRC_DESC("Set this true to mix audio in a separate thread, paced to the "
+          "real-time clock.  Set it false to mix audio only from within "
+          "AudioManager::update(), advancing by the amount the global "
+          "ClockObject has advanced since the previous update.  The latter "
+          "is useful for rendering the audio of a replay faster or slower "
+          "than real time, with a deterministic result."));
+
+/**
+ * Initializes the library.  This must be called at least once before any of
+ * the functions or classes in this library can be used.  Normally it will be
+ * called by the static initializers and need not be called explicitly, but
+ * special cases exist.
+ */
+void
+init_libSoftwareAudio() {
+  static bool initialized = false;
+  if (initialized) {
+    return;
+  }
+
+  initialized = true;
+  SoftwareAudioManager::init_type();
+  SoftwareAudioSound::init_type();
+
+  AudioManager::register_AudioManager_creator(&Create_SoftwareAudioManager);
+
+  PandaSystem *ps = PandaSystem::get_global_ptr();
+  ps->add_system("audio");
+  ps->set_system_tag("audio", "implementation", "software");
+}
+
+/**
+ * This function is called when the dynamic library is loaded; it should
+ * return the Create_AudioManager function appropriate to create a
+ * SoftwareAudioManager.
+ */
+Create_AudioManager_proc *
+get_audio_manager_func_software_audio() {
+  init_libSoftwareAudio();
+  return &Create_SoftwareAudioManager;
+}
@@ -0,0 +1,38 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file config_softwareAudio.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef CONFIG_SOFTWAREAUDIO_H
+#define CONFIG_SOFTWAREAUDIO_H
+
+#include "pandabase.h"
+
+#include "notifyCategoryProxy.h"
+#include "dconfig.h"
+#include "audioManager.h"
+#include "configVariableBool.h"
+#include "configVariableFilename.h"
+#include "configVariableInt.h"
+
+ConfigureDecl(config_softwareAudio, EXPCL_SOFTWARE_AUDIO, EXPTP_SOFTWARE_AUDIO);
+NotifyCategoryDecl(softwareAudio, EXPCL_SOFTWARE_AUDIO, EXPTP_SOFTWARE_AUDIO);
+
+extern "C" EXPCL_SOFTWARE_AUDIO void init_libSoftwareAudio();
+extern "C" EXPCL_SOFTWARE_AUDIO Create_AudioManager_proc *get_audio_manager_func_software_audio();
+
+extern ConfigVariableInt software_audio_rate;
+extern ConfigVariableInt software_audio_channels;
+extern ConfigVariableInt software_audio_block_size;
+extern ConfigVariableFilename software_audio_output;
+extern ConfigVariableBool software_audio_threaded;
+
+#endif // CONFIG_SOFTWAREAUDIO_H
@@ -0,0 +1,886 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioManager.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+
+#include "config_audio.h"
+#include "config_putil.h"
+#include "config_softwareAudio.h"
+#include "softwareAudioManager.h"
+#include "softwareAudioSound.h"
+#include "softwareAudioMix.h"
+#include "virtualFileSystem.h"
+#include "movieAudio.h"
+#include "reMutexHolder.h"
+#include "clockObject.h"
+#include "trueClock.h"
+#include "datagram.h"
+#include "pStatClient.h"
+#include "pStatTimer.h"
+#include "thread.h"
+
+#include <algorithm>
+
+using std::string;
+
+TypeHandle SoftwareAudioManager::_type_handle;
+
+ReMutex SoftwareAudioManager::_lock;
+
+// This is the list of all SoftwareAudioManager objects in the world.  It must
+// be a pointer rather than a concrete object, so it won't be destructed at
+// exit time before we're done removing things from it.
+SoftwareAudioManager::Managers *SoftwareAudioManager::_managers = nullptr;
+
+int SoftwareAudioManager::_active_managers = 0;
+bool SoftwareAudioManager::_mixer_valid = false;
+int SoftwareAudioManager::_output_rate = 0;
+int SoftwareAudioManager::_output_channels = 0;
+int SoftwareAudioManager::_block_frames = 0;
+uint64_t SoftwareAudioManager::_frames_mixed = 0;
+pvector<float> SoftwareAudioManager::_mix_buffer;
+pvector<int16_t> SoftwareAudioManager::_output_buffer;
+pofstream *SoftwareAudioManager::_output = nullptr;
+uint64_t SoftwareAudioManager::_output_bytes = 0;
+PT(GenericThread) SoftwareAudioManager::_thread;
+unsigned int SoftwareAudioManager::_mixer_generation = 0;
+double SoftwareAudioManager::_last_frame_time = 0.0;
+double SoftwareAudioManager::_pending_frames = 0.0;
+
+PStatCollector SoftwareAudioManager::_mix_pcollector("Audio mix");
+
+/**
+ * Factory Function
+ */
+AudioManager *Create_SoftwareAudioManager() {
+  audio_debug("Create_SoftwareAudioManager()");
+  return new SoftwareAudioManager;
+}
+
+/**
+ *
+ */
+SoftwareAudioManager::
+SoftwareAudioManager() {
+  ReMutexHolder holder(_lock);
+  if (_managers == nullptr) {
+    _managers = new Managers;
+  }
+
+  _managers->insert(this);
+
+  _cleanup_required = true;
+  _active = audio_active;
+  _volume = audio_volume;
+  _play_rate = 1.0f;
+
+  _cache_limit = audio_cache_limit;
+
+  _concurrent_sound_limit = 0;
+
+  if (_active_managers == 0) {
+    _mixer_valid = start_mixer();
+  }
+
+  // We increment _active_managers regardless of possible errors above.  The
+  // shutdown call will do the right thing when it's called, either way.
+  ++_active_managers;
+}
+
+/**
+ *
+ */
+SoftwareAudioManager::
+~SoftwareAudioManager() {
+  ReMutexHolder holder(_lock);
+  nassertv(_managers != nullptr);
+  Managers::iterator mi = _managers->find(this);
+  nassertv(mi != _managers->end());
+  _managers->erase(mi);
+  cleanup();
+}
+
+/**
+ * Call this at exit time to shut down the audio system.  This will invalidate
+ * all currently-active AudioManagers and AudioSounds in the system, and
+ * finish writing the output file, if any.  If you change your mind and want
+ * to play sounds again, you will have to recreate all of these objects.
+ */
+void SoftwareAudioManager::
+shutdown() {
+  ReMutexHolder holder(_lock);
+  if (_managers != nullptr) {
+    Managers::iterator mi;
+    for (mi = _managers->begin(); mi != _managers->end(); ++mi) {
+      (*mi)->cleanup();
+    }
+  }
+
+  nassertv(_active_managers == 0);
+}
+
+/**
+ * Returns true if the mixer was started successfully.
+ */
+bool SoftwareAudioManager::
+is_valid() {
+  ReMutexHolder holder(_lock);
+  return _mixer_valid && _cleanup_required;
+}
+
+/**
+ * Returns true if the source is in a format the mixer can play.
+ */
+bool SoftwareAudioManager::
+can_use_audio(MovieAudioCursor *source) {
+  int channels = source->audio_channels();
+  if ((channels != 1) && (channels != 2)) {
+    audio_error("Currently, only mono and stereo are supported.");
+    return false;
+  }
+  if (source->audio_rate() <= 0) {
+    audio_error("Invalid sample rate " << source->audio_rate());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Returns true if the source should be decoded into memory all at once,
+ * rather than streamed.  This follows the same rules as the OpenAL manager.
+ */
+bool SoftwareAudioManager::
+should_load_audio(MovieAudioCursor *source, int mode) {
+  if (mode == SM_stream) {
+    // If the user asked for streaming, give him streaming.
+    return false;
+  }
+  if (source->get_source()->get_filename().empty()) {
+    // Non-files cannot be preloaded.
+    return false;
+  }
+  if (source->ready() != 0x40000000) {
+    // Streaming sources cannot be preloaded.
+    return false;
+  }
+  if (source->length() > 3600.0) {
+    // Anything longer than an hour cannot be preloaded.
+    return false;
+  }
+  int channels = source->audio_channels();
+  int samples = (int)(source->length() * source->audio_rate());
+  int bytes = samples * channels * 2;
+  if ((mode == SM_heuristic) && (bytes > audio_preload_threshold)) {
+    // In heuristic mode, if file is long, stream it.
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Returns the already-decoded sample data for the indicated file, if it is
+ * in the cache and the mode permits its use, or NULL otherwise.
+ */
+PT(SoftwareAudioManager::SampleData) SoftwareAudioManager::
+find_sample_data(const Filename &path, int mode) {
+  ReMutexHolder holder(_lock);
+  if (path.empty() || mode == SM_stream) {
+    return nullptr;
+  }
+
+  SampleCache::const_iterator si = _sample_cache.find(path);
+  if (si != _sample_cache.end()) {
+    return (*si).second;
+  }
+  return nullptr;
+}
+
+/**
+ * Decodes the entire source into memory, and adds the result to the cache.
+ */
+PT(SoftwareAudioManager::SampleData) SoftwareAudioManager::
+load_sample_data(MovieAudioCursor *source) {
+  ReMutexHolder holder(_lock);
+  const Filename &path = source->get_source()->get_filename();
+
+  PT(SampleData) sd = new SampleData;
+  sd->_rate = source->audio_rate();
+  sd->_channels = source->audio_channels();
+
+  int channels = sd->_channels;
+  int chunk = (int)(source->length() * sd->_rate) + 1;
+  chunk = std::min(std::max(chunk, 4096), 65536);
+  pvector<int16_t> buffer(chunk * channels);
+
+  // The length is only an estimate, so keep reading until we run out.
+  int frames = 0;
+  while (true) {
+    int count = source->read_samples(chunk, &buffer[0]);
+    if (count <= 0) {
+      break;
+    }
+    sd->_data.resize((frames + count) * channels);
+    float *dest = &sd->_data[frames * channels];
+    for (int i = 0; i < count * channels; ++i) {
+      dest[i] = buffer[i] * (1.0f / 32768.0f);
+    }
+    frames += count;
+  }
+  sd->_frames = frames;
+
+  // Duplicate the last frame, so that interpolation between the last frame
+  // and the next one doesn't need to be special-cased.
+  if (frames > 0) {
+    for (int c = 0; c < channels; ++c) {
+      sd->_data.push_back(sd->_data[(frames - 1) * channels + c]);
+    }
+  } else {
+    sd->_data.assign(channels, 0.0f);
+  }
+
+  audio_debug(path.get_basename() << ": loaded " << frames << " frames");
+
+  _sample_cache[path] = sd;
+  discard_excess_cache(_cache_limit);
+  return sd;
+}
+
+/**
+ * Removes sample data from the cache that is not being used by any sound,
+ * until no more than limit such entries remain.
+ */
+void SoftwareAudioManager::
+discard_excess_cache(unsigned int limit) {
+  ReMutexHolder holder(_lock);
+
+  unsigned int unused = 0;
+  SampleCache::const_iterator si;
+  for (si = _sample_cache.begin(); si != _sample_cache.end(); ++si) {
+    if ((*si).second->get_ref_count() == 1) {
+      ++unused;
+    }
+  }
+
+  SampleCache::iterator it = _sample_cache.begin();
+  while (unused > limit && it != _sample_cache.end()) {
+    if ((*it).second->get_ref_count() == 1) {
+      audio_debug("Expiring: " << Filename((*it).first).get_basename());
+      it = _sample_cache.erase(it);
+      --unused;
+    } else {
+      ++it;
+    }
+  }
+}
+
+/**
+ * This is what creates a sound instance.
+ */
+PT(AudioSound) SoftwareAudioManager::
+get_sound(MovieAudio *sound, bool positional, int mode) {
+  ReMutexHolder holder(_lock);
+  if (!is_valid()) {
+    return get_null_sound();
+  }
+  PT(SoftwareAudioSound) sas =
+    new SoftwareAudioSound(this, sound, positional, mode);
+
+  if (!sas->_manager) {
+    // The sound cleaned itself up immediately.  It pretty clearly didn't like
+    // something, so we should just return a null sound instead.
+    return get_null_sound();
+  }
+
+  _all_sounds.insert(sas);
+  PT(AudioSound) res = (AudioSound *)(SoftwareAudioSound *)sas;
+  return res;
+}
+
+/**
+ * This is what creates a sound instance.
+ */
+PT(AudioSound) SoftwareAudioManager::
+get_sound(const Filename &file_name, bool positional, int mode) {
+  ReMutexHolder holder(_lock);
+  if (!is_valid()) {
+    return get_null_sound();
+  }
+
+  Filename path = file_name;
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  vfs->resolve_filename(path, get_model_path());
+
+  if (path.empty()) {
+    audio_error("get_sound - invalid filename");
+    return nullptr;
+  }
+
+  PT(MovieAudio) mva = MovieAudio::get(path);
+  return get_sound(mva, positional, mode);
+}
+
+/**
+ * Deletes a sample from the cache.  If the sound is actively in use, then
+ * the sound cannot be deleted, and this function has no effect.
+ */
+void SoftwareAudioManager::
+uncache_sound(const Filename &file_name) {
+  ReMutexHolder holder(_lock);
+  Filename path = file_name;
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  vfs->resolve_filename(path, get_model_path());
+
+  SampleCache::iterator sci = _sample_cache.find(path);
+  if (sci == _sample_cache.end()) {
+    sci = _sample_cache.find(file_name);
+  }
+  if (sci != _sample_cache.end() && (*sci).second->get_ref_count() == 1) {
+    _sample_cache.erase(sci);
+  }
+}
+
+/**
+ * Clear out the sound cache.
+ */
+void SoftwareAudioManager::
+clear_cache() {
+  ReMutexHolder holder(_lock);
+  discard_excess_cache(0);
+}
+
+/**
+ * Set the number of sounds that the cache can hold.
+ */
+void SoftwareAudioManager::
+set_cache_limit(unsigned int count) {
+  ReMutexHolder holder(_lock);
+  _cache_limit = count;
+  discard_excess_cache(count);
+}
+
+/**
+ *
+ */
+unsigned int SoftwareAudioManager::
+get_cache_limit() const {
+  return _cache_limit;
+}
+
+/**
+ *
+ */
+void SoftwareAudioManager::
+release_sound(SoftwareAudioSound *sound) {
+  ReMutexHolder holder(_lock);
+  AllSounds::iterator ai = _all_sounds.find(sound);
+  if (ai != _all_sounds.end()) {
+    _all_sounds.erase(ai);
+  }
+}
+
+/**
+ * Sets the volume of all of the sounds of this manager.  This takes effect
+ * with the next block that is mixed.
+ */
+void SoftwareAudioManager::
+set_volume(PN_stdfloat volume) {
+  ReMutexHolder holder(_lock);
+  _volume = volume;
+}
+
+/**
+ *
+ */
+PN_stdfloat SoftwareAudioManager::
+get_volume() const {
+  return _volume;
+}
+
+/**
+ * Set manager's play rate (will be multiplied with each sound's play rate).
+ */
+void SoftwareAudioManager::
+set_play_rate(PN_stdfloat play_rate) {
+  ReMutexHolder holder(_lock);
+  _play_rate = play_rate;
+}
+
+/**
+ * get the play rate
+ */
+PN_stdfloat SoftwareAudioManager::
+get_play_rate() const {
+  return _play_rate;
+}
+
+/**
+ * Turns all of the sounds of this manager on or off.
+ */
+void SoftwareAudioManager::
+set_active(bool active) {
+  ReMutexHolder holder(_lock);
+  if (_active != active) {
+    _active = active;
+    // Tell our AudioSounds to adjust:
+    AllSounds::iterator i = _all_sounds.begin();
+    for (; i != _all_sounds.end(); ++i) {
+      (**i).set_active(_active);
+    }
+  }
+}
+
+/**
+ *
+ */
+bool SoftwareAudioManager::
+get_active() const {
+  return _active;
+}
+
+/**
+ * Inform the manager that a sound is about to play.  The manager will add
+ * this sound to the list of sounds being mixed.
+ */
+void SoftwareAudioManager::
+starting_sound(SoftwareAudioSound *sound) {
+  ReMutexHolder holder(_lock);
+  if (sound->_playing) {
+    return;
+  }
+
+  // First give all sounds that have finished a chance to stop, so that these
+  // get stopped first.
+  collect_finished_sounds();
+
+  if (_concurrent_sound_limit) {
+    reduce_sounds_playing_to(_concurrent_sound_limit - 1); // because we're about to add one
+  }
+
+  sound->_playing = true;
+  _sounds_playing.insert(sound);
+}
+
+/**
+ * Inform the manager that a sound is finished or someone called stop on the
+ * sound (this should not be called if a sound is only paused).
+ */
+void SoftwareAudioManager::
+stopping_sound(SoftwareAudioSound *sound) {
+  ReMutexHolder holder(_lock);
+  sound->_playing = false;
+  _sounds_playing.erase(sound); // This could cause the sound to destruct.
+}
+
+/**
+ *
+ */
+void SoftwareAudioManager::
+set_concurrent_sound_limit(unsigned int limit) {
+  ReMutexHolder holder(_lock);
+  _concurrent_sound_limit = limit;
+  reduce_sounds_playing_to(_concurrent_sound_limit);
+}
+
+/**
+ *
+ */
+unsigned int SoftwareAudioManager::
+get_concurrent_sound_limit() const {
+  return _concurrent_sound_limit;
+}
+
+/**
+ *
+ */
+void SoftwareAudioManager::
+reduce_sounds_playing_to(unsigned int count) {
+  ReMutexHolder holder(_lock);
+  // first give all sounds that have finished a chance to stop, so that these
+  // get stopped first
+  collect_finished_sounds();
+
+  int limit = _sounds_playing.size() - count;
+  while (limit-- > 0) {
+    SoundsPlaying::iterator sound = _sounds_playing.begin();
+    nassertv(sound != _sounds_playing.end());
+    // When we stop a sound here, this can remove the last PT, which would
+    // cause the destructor to call stop again.  To avoid this, we create a
+    // temporary PT, stop the sound, and then release the PT.
+    PT(SoftwareAudioSound) s = (*sound);
+    s->stop();
+  }
+}
+
+/**
+ * Stop playback on all sounds managed by this manager.
+ */
+void SoftwareAudioManager::
+stop_all_sounds() {
+  ReMutexHolder holder(_lock);
+  reduce_sounds_playing_to(0);
+}
+
+/**
+ * Perform all per-frame update functions.  If the mixer does not have its
+ * own thread, this also mixes as much audio as the global clock has advanced
+ * since the last update.
+ */
+void SoftwareAudioManager::
+update() {
+  ReMutexHolder holder(_lock);
+  if (_mixer_valid && _thread == nullptr) {
+    advance_clock();
+  }
+  collect_finished_sounds();
+}
+
+/**
+ * Mixes the indicated number of sample frames immediately, regardless of
+ * whether the mixer has its own thread.  This may be used to drive the mixer
+ * explicitly, for instance when rendering the audio of a replay.
+ */
+void SoftwareAudioManager::
+mix(int num_frames) {
+  ReMutexHolder holder(_lock);
+  if (_mixer_valid) {
+    do_mix(num_frames);
+  }
+}
+
+/**
+ * Returns the sample rate of the mixed output.
+ */
+int SoftwareAudioManager::
+get_output_rate() {
+  return _output_rate;
+}
+
+/**
+ * Returns the number of channels of the mixed output.
+ */
+int SoftwareAudioManager::
+get_output_channels() {
+  return _output_channels;
+}
+
+/**
+ * Returns the total number of sample frames that have been mixed since the
+ * mixer was last started.
+ */
+uint64_t SoftwareAudioManager::
+get_frames_mixed() {
+  ReMutexHolder holder(_lock);
+  return _frames_mixed;
+}
+
+/**
+ * Calls finished() on each sound that has played to its end.
+ */
+void SoftwareAudioManager::
+collect_finished_sounds() {
+  ReMutexHolder holder(_lock);
+
+  // We must first collect a seperate list of finished sounds, since
+  // finished() modifies _sounds_playing.
+  SoundsPlaying sounds_finished;
+  SoundsPlaying::iterator i;
+  for (i = _sounds_playing.begin(); i != _sounds_playing.end(); ++i) {
+    if ((*i)->_mix_done) {
+      sounds_finished.insert(*i);
+    }
+  }
+
+  for (i = sounds_finished.begin(); i != sounds_finished.end(); ++i) {
+    (**i).finished();
+  }
+}
+
+/**
+ * Shuts down the audio manager and releases any resources associated with it.
+ * Also cleans up all AudioSounds created via the manager.
+ */
+void SoftwareAudioManager::
+cleanup() {
+  ReMutexHolder holder(_lock);
+  if (!_cleanup_required) {
+    return;
+  }
+
+  stop_all_sounds();
+
+  AllSounds sounds(_all_sounds);
+  AllSounds::iterator ai;
+  for (ai = sounds.begin(); ai != sounds.end(); ++ai) {
+    (*ai)->cleanup();
+  }
+
+  _sample_cache.clear();
+
+  nassertv(_active_managers > 0);
+  --_active_managers;
+
+  if (_active_managers == 0) {
+    stop_mixer();
+  }
+  _cleanup_required = false;
+}
+
+/**
+ * Starts the shared mixer, opening the output file and starting the mixing
+ * thread, as configured.  Returns true on success.  Assumes the lock is held.
+ */
+bool SoftwareAudioManager::
+start_mixer() {
+  _output_rate = software_audio_rate;
+  _output_channels = software_audio_channels;
+  _block_frames = std::max((int)software_audio_block_size, 16);
+  _frames_mixed = 0;
+  _pending_frames = 0.0;
+  _last_frame_time = ClockObject::get_global_clock()->get_frame_time();
+  ++_mixer_generation;
+
+  if (_output_rate <= 0 || (_output_channels != 1 && _output_channels != 2)) {
+    softwareAudio_cat.error()
+      << "Invalid output format: " << _output_channels << " channels at "
+      << _output_rate << " Hz\n";
+    return false;
+  }
+
+  if (!open_output()) {
+    return false;
+  }
+
+  if (software_audio_threaded && Thread::is_threading_supported()) {
+    _thread = new GenericThread("software_audio", "software_audio",
+                                st_thread_main,
+                                (void *)(uintptr_t)_mixer_generation);
+    if (!_thread->start(TP_urgent, false)) {
+      softwareAudio_cat.warning()
+        << "Couldn't start mixing thread; audio will be mixed in update().\n";
+      _thread.clear();
+    }
+  }
+
+  if (softwareAudio_cat.is_debug()) {
+    softwareAudio_cat.debug()
+      << "Started mixer: " << _output_channels << " channels at "
+      << _output_rate << " Hz, " << _block_frames << " frames per block, "
+      << (_thread != nullptr ? "threaded" : "not threaded") << "\n";
+  }
+  return true;
+}
+
+/**
+ * Stops the shared mixer and finishes writing the output file.  Assumes the
+ * lock is held.
+ */
+void SoftwareAudioManager::
+stop_mixer() {
+  // The thread will notice this the next time it acquires the lock, and exit
+  // without mixing anything further.
+  ++_mixer_generation;
+  _thread.clear();
+
+  close_output();
+  _mixer_valid = false;
+}
+
+/**
+ * Mixes the indicated number of frames of all of the playing sounds of all
+ * of the managers, and sends the result to the output.  Assumes the lock is
+ * held.
+ */
+void SoftwareAudioManager::
+do_mix(int num_frames) {
+  PStatTimer timer(_mix_pcollector);
+
+  while (num_frames > 0) {
+    int frames = std::min(num_frames, _block_frames);
+    size_t count = (size_t)frames * _output_channels;
+    _mix_buffer.assign(count, 0.0f);
+
+    if (_managers != nullptr) {
+      Managers::const_iterator mi;
+      for (mi = _managers->begin(); mi != _managers->end(); ++mi) {
+        SoftwareAudioManager *mgr = (*mi);
+        SoundsPlaying::const_iterator si;
+        for (si = mgr->_sounds_playing.begin(); si != mgr->_sounds_playing.end(); ++si) {
+          (*si)->mix(&_mix_buffer[0], _output_channels, frames, _output_rate,
+                     mgr->_volume, mgr->_play_rate);
+        }
+      }
+    }
+
+    if (_output != nullptr) {
+      _output_buffer.resize(count);
+      software_audio_convert(&_output_buffer[0], &_mix_buffer[0], count);
+#ifdef WORDS_BIGENDIAN
+      // A .wav file is always little-endian.
+      for (size_t i = 0; i < count; ++i) {
+        uint16_t v = (uint16_t)_output_buffer[i];
+        _output_buffer[i] = (int16_t)((v >> 8) | (v << 8));
+      }
+#endif
+      _output->write((const char *)&_output_buffer[0], count * sizeof(int16_t));
+      _output_bytes += count * sizeof(int16_t);
+    }
+
+    _frames_mixed += frames;
+    num_frames -= frames;
+  }
+
+  if (_output != nullptr) {
+    // Keep the header up-to-date, so that the file is usable even if the
+    // process never gets around to shutting down the audio.
+    write_output_header();
+  }
+}
+
+/**
+ * Mixes as many frames as correspond to the time the global clock has
+ * advanced since the last call.  Assumes the lock is held.
+ */
+void SoftwareAudioManager::
+advance_clock() {
+  double now = ClockObject::get_global_clock()->get_frame_time();
+  double elapsed = now - _last_frame_time;
+  _last_frame_time = now;
+  if (elapsed <= 0.0) {
+    return;
+  }
+
+  _pending_frames += elapsed * _output_rate;
+  int frames = (int)_pending_frames;
+  _pending_frames -= frames;
+  do_mix(frames);
+}
+
+/**
+ * Opens the output file named by software-audio-output, if any.  Returns
+ * false if it is named but can't be opened.  Assumes the lock is held.
+ */
+bool SoftwareAudioManager::
+open_output() {
+  nassertr(_output == nullptr, false);
+
+  Filename filename = software_audio_output;
+  if (filename.empty()) {
+    return true;
+  }
+
+  filename.set_binary();
+  pofstream *out = new pofstream;
+  if (!filename.open_write(*out)) {
+    softwareAudio_cat.error()
+      << "Couldn't open " << filename << " for writing.\n";
+    delete out;
+    return false;
+  }
+
+  softwareAudio_cat.info()
+    << "Writing audio to " << filename << "\n";
+
+  _output = out;
+  _output_bytes = 0;
+  write_output_header();
+  return true;
+}
+
+/**
+ * Finishes writing and closes the output file, if any.  Assumes the lock is
+ * held.
+ */
+void SoftwareAudioManager::
+close_output() {
+  if (_output != nullptr) {
+    write_output_header();
+    _output->close();
+    delete _output;
+    _output = nullptr;
+  }
+}
+
+/**
+ * Writes (or rewrites) the RIFF header at the start of the output file, with
+ * the amount of sample data written so far.  Assumes the lock is held.
+ */
+void SoftwareAudioManager::
+write_output_header() {
+  uint32_t data_bytes = (uint32_t)std::min(_output_bytes, (uint64_t)0xffffffd0u);
+  int block_align = _output_channels * 2;
+
+  Datagram dg;
+  dg.append_data("RIFF", 4);
+  dg.add_uint32(36 + data_bytes);
+  dg.append_data("WAVE", 4);
+  dg.append_data("fmt ", 4);
+  dg.add_uint32(16);
+  dg.add_uint16(1); // PCM
+  dg.add_uint16(_output_channels);
+  dg.add_uint32(_output_rate);
+  dg.add_uint32(_output_rate * block_align);
+  dg.add_uint16(block_align);
+  dg.add_uint16(16);
+  dg.append_data("data", 4);
+  dg.add_uint32(data_bytes);
+
+  std::streampos end = _output->tellp();
+  _output->seekp(0);
+  _output->write((const char *)dg.get_data(), dg.get_length());
+  if (end > (std::streampos)dg.get_length()) {
+    _output->seekp(end);
+  }
+  _output->flush();
+}
+
+/**
+ * The thread main function, static version (for passing to GenericThread).
+ */
+void SoftwareAudioManager::
+st_thread_main(void *data) {
+  thread_main((unsigned int)(uintptr_t)data);
+}
+
+/**
+ * The mixing thread.  Mixes a block at a time, paced to the real-time clock,
+ * until the mixer is stopped.
+ */
+void SoftwareAudioManager::
+thread_main(unsigned int generation) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double next = clock->get_short_time();
+
+  while (true) {
+    double block_time;
+    {
+      ReMutexHolder holder(_lock);
+      if (_mixer_generation != generation) {
+        return;
+      }
+      do_mix(_block_frames);
+      block_time = (double)_block_frames / (double)_output_rate;
+    }
+    PStatClient::thread_tick("software_audio");
+
+    next += block_time;
+    double now = clock->get_short_time();
+    if (next > now) {
+      Thread::sleep(next - now);
+    } else if (now - next > 0.5) {
+      // We've fallen badly behind, perhaps because the process was suspended.
+      // Don't try to catch up all at once.
+      next = now;
+    }
+  }
+}
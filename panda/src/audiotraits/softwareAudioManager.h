@@ -0,0 +1,199 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioManager.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef SOFTWAREAUDIOMANAGER_H
+#define SOFTWAREAUDIOMANAGER_H
+
+#include "pandabase.h"
+
+#include "audioManager.h"
+#include "movieAudioCursor.h"
+#include "genericThread.h"
+#include "reMutex.h"
+#include "referenceCount.h"
+#include "pmap.h"
+#include "pset.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+#include "pandaFileStream.h"
+
+class SoftwareAudioSound;
+
+/**
+ * An AudioManager that does all of its own mixing, in software, rather than
+ * relying on a sound card.  The mixed result may be written to a .wav file,
+ * or simply thrown away; see software-audio-output.  This is intended for
+ * headless processes, such as servers that must replay or record a session,
+ * and for testing.
+ *
+ * All of the SoftwareAudioManagers in the process share a single mixer, so
+ * that (for instance) the sound effects and music managers created by
+ * ShowBase end up in the same output.  The mixer runs in its own thread,
+ * unless software-audio-threaded is false, in which case it is advanced by
+ * update() according to the global clock.
+ */
+class EXPCL_SOFTWARE_AUDIO SoftwareAudioManager : public AudioManager {
+  friend class SoftwareAudioSound;
+
+public:
+  SoftwareAudioManager();
+  virtual ~SoftwareAudioManager();
+
+  virtual void shutdown();
+
+  virtual bool is_valid();
+
+  virtual PT(AudioSound) get_sound(const Filename &, bool positional = false, int mode=SM_heuristic);
+  virtual PT(AudioSound) get_sound(MovieAudio *sound, bool positional = false, int mode=SM_heuristic);
+
+  virtual void uncache_sound(const Filename &);
+  virtual void clear_cache();
+  virtual void set_cache_limit(unsigned int count);
+  virtual unsigned int get_cache_limit() const;
+
+  virtual void set_volume(PN_stdfloat);
+  virtual PN_stdfloat get_volume() const;
+
+  void set_play_rate(PN_stdfloat play_rate);
+  PN_stdfloat get_play_rate() const;
+
+  virtual void set_active(bool);
+  virtual bool get_active() const;
+
+  virtual void set_concurrent_sound_limit(unsigned int limit = 0);
+  virtual unsigned int get_concurrent_sound_limit() const;
+  virtual void reduce_sounds_playing_to(unsigned int count);
+
+  virtual void stop_all_sounds();
+
+  virtual void update();
+
+  static void mix(int num_frames);
+  static int get_output_rate();
+  static int get_output_channels();
+  static uint64_t get_frames_mixed();
+
+private:
+  // Decoded sample data that is shared between all of the sounds loaded from
+  // the same file.  The samples are stored as interleaved floats, followed by
+  // a copy of the last frame, so that interpolation never needs to check
+  // whether it has run off the end.
+  class SampleData : public ReferenceCount {
+  public:
+    pvector<float> _data;
+    int _frames;
+    int _rate;
+    int _channels;
+  };
+
+  bool can_use_audio(MovieAudioCursor *source);
+  bool should_load_audio(MovieAudioCursor *source, int mode);
+  PT(SampleData) find_sample_data(const Filename &path, int mode);
+  PT(SampleData) load_sample_data(MovieAudioCursor *source);
+  void discard_excess_cache(unsigned int limit);
+
+  // Tell the manager that the sound dtor was called.
+  void release_sound(SoftwareAudioSound *sound);
+
+  void starting_sound(SoftwareAudioSound *sound);
+  void stopping_sound(SoftwareAudioSound *sound);
+  void collect_finished_sounds();
+
+  void cleanup();
+
+  static bool start_mixer();
+  static void stop_mixer();
+  static void do_mix(int num_frames);
+  static void advance_clock();
+
+  static bool open_output();
+  static void close_output();
+  static void write_output_header();
+
+  static void st_thread_main(void *data);
+  static void thread_main(unsigned int generation);
+
+private:
+  // This global lock protects all of the state of all of the managers and
+  // their sounds, as well as the shared mixer.  The mixer holds it while it
+  // mixes each block.
+  static ReMutex _lock;
+
+  typedef pmap<std::string, PT(SampleData)> SampleCache;
+  SampleCache _sample_cache;
+
+  typedef pset<PT(SoftwareAudioSound)> SoundsPlaying;
+  SoundsPlaying _sounds_playing;
+
+  typedef pset<SoftwareAudioSound *> AllSounds;
+  AllSounds _all_sounds;
+
+  unsigned int _cache_limit;
+  PN_stdfloat _volume;
+  PN_stdfloat _play_rate;
+  bool _active;
+  bool _cleanup_required;
+  unsigned int _concurrent_sound_limit;
+
+  typedef pset<SoftwareAudioManager *> Managers;
+  static Managers *_managers;
+
+  // The state of the shared mixer, which is started when the first manager
+  // is created and stopped when the last one is cleaned up.
+  static int _active_managers;
+  static bool _mixer_valid;
+  static int _output_rate;
+  static int _output_channels;
+  static int _block_frames;
+  static uint64_t _frames_mixed;
+  static pvector<float> _mix_buffer;
+  static pvector<int16_t> _output_buffer;
+
+  static pofstream *_output;
+  static uint64_t _output_bytes;
+
+  // The mixing thread exits as soon as it notices that the generation has
+  // changed.  It is never joined, since the last manager may well be
+  // destructed while the lock is held.
+  static PT(GenericThread) _thread;
+  static unsigned int _mixer_generation;
+
+  // Used to advance the mixer when it does not run in its own thread.
+  static double _last_frame_time;
+  static double _pending_frames;
+
+  static PStatCollector _mix_pcollector;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AudioManager::init_type();
+    register_type(_type_handle, "SoftwareAudioManager", AudioManager::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {
+    init_type();
+    return get_class_type();
+  }
+
+private:
+  static TypeHandle _type_handle;
+};
+
+EXPCL_SOFTWARE_AUDIO AudioManager *Create_SoftwareAudioManager();
+
+#endif /* SOFTWAREAUDIOMANAGER_H */
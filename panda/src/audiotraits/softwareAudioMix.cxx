@@ -0,0 +1,199 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioMix.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "softwareAudioMix.h"
+#include "pnotify.h"
+
+#include <math.h>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SOFTWARE_AUDIO_SSE2
+#endif
+
+static const float frac_scale = 1.0f / 65536.0f;
+
+/**
+ * Mixes the indicated range of output frames, one frame at a time.
+ */
+static void
+mix_scalar(float *out, int out_channels, int begin, int end,
+           const float *src, int src_channels, uint32_t frac, uint32_t step,
+           float gain_left, float gain_right) {
+  uint32_t pos = frac + (uint32_t)begin * step;
+
+  if (src_channels == 1) {
+    for (int i = begin; i < end; ++i) {
+      uint32_t index = pos >> 16;
+      float f = (float)(pos & 0xffff) * frac_scale;
+      float a = src[index];
+      float b = src[index + 1];
+      float s = a + (b - a) * f;
+      if (out_channels == 2) {
+        out[i * 2] += s * gain_left;
+        out[i * 2 + 1] += s * gain_right;
+      } else {
+        out[i] += s * ((gain_left + gain_right) * 0.5f);
+      }
+      pos += step;
+    }
+  } else {
+    for (int i = begin; i < end; ++i) {
+      uint32_t index = pos >> 16;
+      float f = (float)(pos & 0xffff) * frac_scale;
+      const float *a = src + index * 2;
+      float l = a[0] + (a[2] - a[0]) * f;
+      float r = a[1] + (a[3] - a[1]) * f;
+      if (out_channels == 2) {
+        out[i * 2] += l * gain_left;
+        out[i * 2 + 1] += r * gain_right;
+      } else {
+        out[i] += (l * gain_left + r * gain_right) * 0.5f;
+      }
+      pos += step;
+    }
+  }
+}
+
+#ifdef SOFTWARE_AUDIO_SSE2
+/**
+ * Adds the left and right channels of four frames into a stereo output.
+ */
+static INLINE void
+add_stereo4(float *out, __m128 left, __m128 right) {
+  __m128 lo = _mm_unpacklo_ps(left, right);
+  __m128 hi = _mm_unpackhi_ps(left, right);
+  _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), lo));
+  _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), hi));
+}
+
+/**
+ * Mixes as many frames as possible into a stereo output four at a time.
+ * Returns the number of frames that were mixed.
+ */
+static int
+mix_stereo_sse2(float *out, int num_frames,
+                const float *src, int src_channels, uint32_t frac,
+                uint32_t step, float gain_left, float gain_right) {
+  const __m128 gl = _mm_set1_ps(gain_left);
+  const __m128 gr = _mm_set1_ps(gain_right);
+  int i = 0;
+
+  if (frac == 0 && step == 0x10000) {
+    // The source is already at the output rate, so there is nothing to
+    // interpolate.
+    if (src_channels == 1) {
+      for (; i + 4 <= num_frames; i += 4) {
+        __m128 s = _mm_loadu_ps(src + i);
+        add_stereo4(out + i * 2, _mm_mul_ps(s, gl), _mm_mul_ps(s, gr));
+      }
+    } else {
+      const __m128 g = _mm_unpacklo_ps(gl, gr);
+      for (; i + 4 <= num_frames; i += 4) {
+        float *o = out + i * 2;
+        const float *s = src + i * 2;
+        _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), _mm_mul_ps(_mm_loadu_ps(s), g)));
+        _mm_storeu_ps(o + 4, _mm_add_ps(_mm_loadu_ps(o + 4), _mm_mul_ps(_mm_loadu_ps(s + 4), g)));
+      }
+    }
+    return i;
+  }
+
+  const __m128i mask = _mm_set1_epi32(0xffff);
+  const __m128 scale = _mm_set1_ps(frac_scale);
+  const __m128i step4 = _mm_set1_epi32((int)(step * 4));
+  __m128i pos = _mm_setr_epi32((int)frac, (int)(frac + step),
+                               (int)(frac + step * 2), (int)(frac + step * 3));
+  uint32_t index[4];
+
+  for (; i + 4 <= num_frames; i += 4) {
+    _mm_storeu_si128((__m128i *)index, _mm_srli_epi32(pos, 16));
+    __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pos, mask)), scale);
+
+    if (src_channels == 1) {
+      __m128 a = _mm_setr_ps(src[index[0]], src[index[1]],
+                             src[index[2]], src[index[3]]);
+      __m128 b = _mm_setr_ps(src[index[0] + 1], src[index[1] + 1],
+                             src[index[2] + 1], src[index[3] + 1]);
+      __m128 s = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f));
+      add_stereo4(out + i * 2, _mm_mul_ps(s, gl), _mm_mul_ps(s, gr));
+
+    } else {
+      const float *s0 = src + index[0] * 2;
+      const float *s1 = src + index[1] * 2;
+      const float *s2 = src + index[2] * 2;
+      const float *s3 = src + index[3] * 2;
+      __m128 la = _mm_setr_ps(s0[0], s1[0], s2[0], s3[0]);
+      __m128 ra = _mm_setr_ps(s0[1], s1[1], s2[1], s3[1]);
+      __m128 lb = _mm_setr_ps(s0[2], s1[2], s2[2], s3[2]);
+      __m128 rb = _mm_setr_ps(s0[3], s1[3], s2[3], s3[3]);
+      __m128 l = _mm_add_ps(la, _mm_mul_ps(_mm_sub_ps(lb, la), f));
+      __m128 r = _mm_add_ps(ra, _mm_mul_ps(_mm_sub_ps(rb, ra), f));
+      add_stereo4(out + i * 2, _mm_mul_ps(l, gl), _mm_mul_ps(r, gr));
+    }
+
+    pos = _mm_add_epi32(pos, step4);
+  }
+  return i;
+}
+#endif  // SOFTWARE_AUDIO_SSE2
+
+/**
+ * Resamples and mixes a span of a single sound into the output buffer.
+ */
+void
+software_audio_mix(float *out, int out_channels, int num_frames,
+                   const float *src, int src_channels,
+                   uint32_t frac, uint32_t step,
+                   PN_float32 gain_left, PN_float32 gain_right) {
+  nassertv(out_channels == 1 || out_channels == 2);
+  nassertv(src_channels == 1 || src_channels == 2);
+
+  int i = 0;
+#ifdef SOFTWARE_AUDIO_SSE2
+  if (out_channels == 2) {
+    i = mix_stereo_sse2(out, num_frames, src, src_channels, frac, step,
+                        gain_left, gain_right);
+  }
+#endif
+  mix_scalar(out, out_channels, i, num_frames, src, src_channels, frac, step,
+             gain_left, gain_right);
+}
+
+/**
+ * Converts mixed floating-point samples to 16-bit PCM.
+ */
+void
+software_audio_convert(int16_t *dest, const float *src, size_t count) {
+  size_t i = 0;
+
+#ifdef SOFTWARE_AUDIO_SSE2
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+    a = _mm_min_ps(_mm_max_ps(a, lo), hi);
+    b = _mm_min_ps(_mm_max_ps(b, lo), hi);
+    __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128((__m128i *)(dest + i), packed);
+  }
+#endif
+
+  for (; i < count; ++i) {
+    float v = src[i] * 32767.0f;
+    v = (v < -32768.0f) ? -32768.0f : ((v > 32767.0f) ? 32767.0f : v);
+    dest[i] = (int16_t)lrintf(v);
+  }
+}
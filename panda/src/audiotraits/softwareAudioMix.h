@@ -0,0 +1,43 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioMix.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef SOFTWAREAUDIOMIX_H
+#define SOFTWAREAUDIOMIX_H
+
+#include "pandabase.h"
+#include "numeric_types.h"
+
+// The inner loops of the software audio mixer.  When SSE2 is available at
+// compile time, these process four sample frames at once; the result is
+// identical either way.
+
+// Resamples num_frames frames of the source, which has src_channels (1 or 2)
+// interleaved channels, using linear interpolation, and adds the result,
+// scaled by the given gains, into the interleaved output, which has
+// out_channels (1 or 2) channels.  The source position is given in 16.16
+// fixed point, relative to the first frame of src: the first output frame
+// is taken from position frac, and each subsequent one is step further on.
+// The caller must ensure that the frame following the last one addressed is
+// also valid, and that frac + num_frames * step does not overflow.
+void
+software_audio_mix(float *out, int out_channels, int num_frames,
+                   const float *src, int src_channels,
+                   uint32_t frac, uint32_t step,
+                   PN_float32 gain_left, PN_float32 gain_right);
+
+// Converts mixed samples in the range -1 .. 1 to 16-bit PCM, clipping any
+// that are out of range.
+void
+software_audio_convert(int16_t *dest, const float *src, size_t count);
+
+#endif
@@ -0,0 +1,602 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioSound.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "pandabase.h"
+
+#include "config_audio.h"
+#include "config_softwareAudio.h"
+#include "softwareAudioSound.h"
+#include "softwareAudioMix.h"
+#include "throw_event.h"
+#include "reMutexHolder.h"
+
+#include <algorithm>
+
+TypeHandle SoftwareAudioSound::_type_handle;
+
+/**
+ *
+ */
+SoftwareAudioSound::
+SoftwareAudioSound(SoftwareAudioManager *manager,
+                   MovieAudio *movie,
+                   bool positional,
+                   int mode) :
+  _movie(movie),
+  _manager(manager),
+  _stream_base(0),
+  _stream_eof(false),
+  _rate(0),
+  _channels(0),
+  _length(0.0),
+  _pos(0),
+  _playing(false),
+  _mix_done(false),
+  _loop_count(1),
+  _loops_completed(0),
+  _volume(1.0f),
+  _balance(0),
+  _play_rate(1.0),
+  _positional(positional),
+  _start_time(0.0),
+  _current_time(0.0),
+  _basename(movie->get_filename().get_basename()),
+  _active(manager->get_active()),
+  _paused(false)
+{
+  _location[0] = 0.0f;
+  _location[1] = 0.0f;
+  _location[2] = 0.0f;
+  _velocity[0] = 0.0f;
+  _velocity[1] = 0.0f;
+  _velocity[2] = 0.0f;
+
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  // If another sound has already loaded this file, share its samples rather
+  // than opening the file again.
+  _sample = manager->find_sample_data(movie->get_filename(), mode);
+  if (_sample == nullptr) {
+    PT(MovieAudioCursor) cursor = movie->open();
+    if (cursor == nullptr) {
+      audio_error("Cannot open file: " << movie->get_filename());
+      cleanup();
+      return;
+    }
+
+    if (!manager->can_use_audio(cursor)) {
+      audio_error("File is not in usable format: " << movie->get_filename());
+      cleanup();
+      return;
+    }
+
+    if (manager->should_load_audio(cursor, mode)) {
+      audio_debug(_basename << ": loading as sample");
+      _sample = manager->load_sample_data(cursor);
+    } else {
+      audio_debug(_basename << ": loading as stream");
+      _stream = cursor;
+      _rate = cursor->audio_rate();
+      _channels = cursor->audio_channels();
+      _length = cursor->length();
+    }
+  }
+
+  if (_sample != nullptr) {
+    _rate = _sample->_rate;
+    _channels = _sample->_channels;
+    _length = (double)_sample->_frames / (double)_rate;
+  }
+}
+
+/**
+ *
+ */
+SoftwareAudioSound::
+~SoftwareAudioSound() {
+  cleanup();
+}
+
+/**
+ * Disables the sound forever.  Releases resources and detaches the sound
+ * from its audio manager.
+ */
+void SoftwareAudioSound::
+cleanup() {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  if (!is_valid()) {
+    return;
+  }
+  if (is_playing()) {
+    stop();
+  }
+  _sample.clear();
+  _stream.clear();
+  _stream_data.clear();
+  _manager->release_sound(this);
+  _manager = nullptr;
+}
+
+/**
+ * Plays a sound.
+ */
+void SoftwareAudioSound::
+play() {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  if (!_active) {
+    _paused = true;
+    return;
+  }
+
+  stop();
+
+  _loops_completed = 0;
+  _mix_done = false;
+  seek_to(_start_time);
+
+  _manager->starting_sound(this);
+
+  _current_time = _start_time;
+  _start_time = 0.0;
+}
+
+/**
+ * Stop a sound
+ */
+void SoftwareAudioSound::
+stop() {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  if (is_playing() && !_mix_done) {
+    _current_time = get_position();
+  }
+
+  _paused = false;
+
+  _manager->stopping_sound(this);
+}
+
+/**
+ * Called by the manager when the sound has played to its end.
+ */
+void SoftwareAudioSound::
+finished() {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  stop();
+  _current_time = _length;
+  if (!_finished_event.empty()) {
+    throw_event(_finished_event);
+  }
+}
+
+/**
+ * Turns looping on and off
+ */
+void SoftwareAudioSound::
+set_loop(bool loop) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  set_loop_count((loop) ? 0 : 1);
+}
+
+/**
+ * Returns whether looping is on or off
+ */
+bool SoftwareAudioSound::
+get_loop() const {
+  return (_loop_count == 0);
+}
+
+/**
+ *
+ */
+void SoftwareAudioSound::
+set_loop_count(unsigned long loop_count) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  if (loop_count >= 1000000000) {
+    loop_count = 0;
+  }
+  _loop_count = loop_count;
+}
+
+/**
+ * Return how many times a sound will loop.
+ */
+unsigned long SoftwareAudioSound::
+get_loop_count() const {
+  return _loop_count;
+}
+
+/**
+ * Sets the time at which the next play() operation will begin.  If we are
+ * already playing, the new position takes effect with the next block that is
+ * mixed.
+ */
+void SoftwareAudioSound::
+set_time(PN_stdfloat time) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  if (is_playing() && !_mix_done) {
+    seek_to(time);
+  } else {
+    _start_time = time;
+    _current_time = time;
+  }
+}
+
+/**
+ * Gets the play position within the sound
+ */
+PN_stdfloat SoftwareAudioSound::
+get_time() const {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  if (!is_valid()) {
+    return 0.0;
+  }
+  if (is_playing() && !_mix_done) {
+    return get_position();
+  }
+  return _current_time;
+}
+
+/**
+ * 0.0 to 1.0 scale.  This takes effect with the next block that is mixed.
+ */
+void SoftwareAudioSound::
+set_volume(PN_stdfloat volume) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  _volume = volume;
+}
+
+/**
+ * Gets the current volume of a sound.  1 is Max.  O is Min.
+ */
+PN_stdfloat SoftwareAudioSound::
+get_volume() const {
+  return _volume;
+}
+
+/**
+ * -1.0 to 1.0 scale.  A sound panned fully to one side is played at full
+ * volume on that side, and not at all on the other.
+ */
+void SoftwareAudioSound::
+set_balance(PN_stdfloat balance_right) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  _balance = std::min(std::max(balance_right, (PN_stdfloat)-1), (PN_stdfloat)1);
+}
+
+/**
+ * -1.0 to 1.0 scale -1 should be all the way left.  1 is all the way to the
+ * right.
+ */
+PN_stdfloat SoftwareAudioSound::
+get_balance() const {
+  return _balance;
+}
+
+/**
+ * Sets the speed at which a sound plays back.  The rate is a multiple of the
+ * sound, normal playback speed.  Both the pitch and the speed are changed,
+ * since the sound is simply resampled.
+ */
+void SoftwareAudioSound::
+set_play_rate(PN_stdfloat play_rate) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  _play_rate = play_rate;
+}
+
+/**
+ *
+ */
+PN_stdfloat SoftwareAudioSound::
+get_play_rate() const {
+  return _play_rate;
+}
+
+/**
+ * Sets whether the sound is marked "active".  By default, the active flag
+ * true for all sounds.  If the active flag is set to false for any
+ * particular sound, the sound will not be heard.
+ */
+void SoftwareAudioSound::
+set_active(bool active) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+
+  if (!is_valid()) return;
+
+  if (_active != active) {
+    _active = active;
+    if (_active) {
+      // ...activate the sound.
+      if (_paused && _loop_count == 0) {
+        // ...this sound was looping when it was paused.
+        _paused = false;
+        play();
+      }
+    } else {
+      // ...deactivate the sound.
+      if (status() == PLAYING) {
+        // Store off the current time so we can resume from where we paused.
+        _start_time = get_time();
+        stop();
+        if (_loop_count == 0) {
+          // ...we're pausing a looping sound.
+          _paused = true;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns whether the sound has been marked "active".
+ */
+bool SoftwareAudioSound::
+get_active() const {
+  return _active;
+}
+
+/**
+ *
+ */
+void SoftwareAudioSound::
+set_finished_event(const std::string &event) {
+  _finished_event = event;
+}
+
+/**
+ * Return the string the finished event is referenced by
+ */
+const std::string &SoftwareAudioSound::
+get_finished_event() const {
+  return _finished_event;
+}
+
+/**
+ * Get name of sound file
+ */
+const std::string &SoftwareAudioSound::
+get_name() const {
+  return _basename;
+}
+
+/**
+ * Get length
+ */
+PN_stdfloat SoftwareAudioSound::
+length() const {
+  return _length;
+}
+
+/**
+ * Stores the position and velocity of the sound.  The software mixer does
+ * not spatialize sounds; use set_balance() to position them instead.
+ */
+void SoftwareAudioSound::
+set_3d_attributes(PN_stdfloat px, PN_stdfloat py, PN_stdfloat pz, PN_stdfloat vx, PN_stdfloat vy, PN_stdfloat vz) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  _location[0] = px;
+  _location[1] = py;
+  _location[2] = pz;
+
+  _velocity[0] = vx;
+  _velocity[1] = vy;
+  _velocity[2] = vz;
+}
+
+/**
+ * Get position and velocity of this sound
+ */
+void SoftwareAudioSound::
+get_3d_attributes(PN_stdfloat *px, PN_stdfloat *py, PN_stdfloat *pz, PN_stdfloat *vx, PN_stdfloat *vy, PN_stdfloat *vz) {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  *px = _location[0];
+  *py = _location[1];
+  *pz = _location[2];
+
+  *vx = _velocity[0];
+  *vy = _velocity[1];
+  *vz = _velocity[2];
+}
+
+/**
+ * Get status of the sound.
+ */
+AudioSound::SoundStatus SoftwareAudioSound::
+status() const {
+  ReMutexHolder holder(SoftwareAudioManager::_lock);
+  if (!is_playing() || _mix_done) {
+    return AudioSound::READY;
+  }
+  return AudioSound::PLAYING;
+}
+
+/**
+ * Moves the play position to the indicated time, in seconds.  Assumes the
+ * lock is held.
+ */
+void SoftwareAudioSound::
+seek_to(double time) {
+  if (time < 0.0) {
+    time = 0.0;
+  }
+  _pos = (uint64_t)(time * _rate * 65536.0);
+
+  if (_sample != nullptr) {
+    _pos = std::min(_pos, (uint64_t)_sample->_frames << 16);
+
+  } else if (_stream != nullptr) {
+    _stream->seek(time);
+    _stream_data.clear();
+    _stream_base = (int64_t)(_pos >> 16);
+    _stream_eof = false;
+  }
+}
+
+/**
+ * Called by the mixer, with the lock held, to add the next num_frames frames
+ * of this sound into the output buffer.  Once the sound has played to its
+ * end, this sets _mix_done; the next call to the manager's update() will then
+ * stop it and throw the finished event.
+ */
+void SoftwareAudioSound::
+mix(float *out, int out_channels, int num_frames, int out_rate,
+    PN_stdfloat volume, PN_stdfloat play_rate) {
+  if (_mix_done || (_sample == nullptr && _stream == nullptr)) {
+    return;
+  }
+
+  // The step between output frames, in source frames, as 16.16 fixed point.
+  double ratio = (double)_rate * _play_rate * play_rate / (double)out_rate;
+  uint32_t step = (uint32_t)std::min(std::max(ratio * 65536.0 + 0.5, 1.0), 32.0 * 65536.0);
+
+  PN_float32 vol = (PN_float32)(_volume * volume);
+  PN_float32 gain_left = vol * (PN_float32)std::min((PN_stdfloat)1, 1 - _balance);
+  PN_float32 gain_right = vol * (PN_float32)std::min((PN_stdfloat)1, 1 + _balance);
+
+  // This keeps the 16.16 position within a single call from overflowing.
+  int64_t max_span = (int64_t)((0xffffffffu - 0xffffu) / step);
+
+  int done = 0;
+  while (done < num_frames) {
+    const float *src;
+    int64_t base;
+    int64_t limit;
+    if (_sample != nullptr) {
+      src = &_sample->_data[0];
+      base = 0;
+      limit = _sample->_frames;
+    } else {
+      int64_t end_frame = (int64_t)((_pos + (uint64_t)(num_frames - done) * step) >> 16) + 2;
+      if (!fill_stream(end_frame)) {
+        // The stream can't keep up; we'll try again with the next block.
+        return;
+      }
+      src = &_stream_data[0];
+      base = _stream_base;
+      limit = _stream_base + (int64_t)(_stream_data.size() / _channels) - 1;
+    }
+
+    int64_t index = (int64_t)(_pos >> 16);
+    if (index >= limit) {
+      if (_stream != nullptr && !_stream_eof) {
+        return;
+      }
+
+      // We have reached the end of one pass through the sound.
+      ++_loops_completed;
+      if (limit <= 0 || (_loop_count != 0 && _loops_completed >= _loop_count)) {
+        _mix_done = true;
+        return;
+      }
+      _pos -= (uint64_t)limit << 16;
+      if (_stream != nullptr) {
+        _stream->seek(0.0);
+        _stream_data.clear();
+        _stream_base = 0;
+        _stream_eof = false;
+      }
+      continue;
+    }
+
+    // Mix as much as we can before we run off the end of the data.
+    uint32_t frac = (uint32_t)(_pos & 0xffff);
+    int64_t span = ((limit - index) << 16) - frac;
+    int64_t count = (span + step - 1) / step;
+    count = std::min(count, (int64_t)(num_frames - done));
+    count = std::min(count, max_span);
+
+    software_audio_mix(out + done * out_channels, out_channels, (int)count,
+                       src + (index - base) * _channels, _channels,
+                       frac, step, gain_left, gain_right);
+
+    _pos += (uint64_t)count * step;
+    done += (int)count;
+  }
+}
+
+/**
+ * Decodes enough of the stream that all frames before end_frame are
+ * available in _stream_data, or the end of the stream has been reached, and
+ * discards the frames that have already been played.  Returns false if the
+ * stream has no data ready, but has not yet reached its end.  Assumes the
+ * lock is held.
+ */
+bool SoftwareAudioSound::
+fill_stream(int64_t end_frame) {
+  int channels = _channels;
+  int64_t have = (int64_t)(_stream_data.size() / channels);
+
+  int64_t index = (int64_t)(_pos >> 16);
+  if (index > _stream_base && have > 0) {
+    int64_t drop = std::min(have, index - _stream_base);
+    _stream_data.erase(_stream_data.begin(), _stream_data.begin() + drop * channels);
+    _stream_base += drop;
+    have -= drop;
+  }
+
+  bool reached_eof = false;
+  while (!_stream_eof && _stream_base + have < end_frame) {
+    int want = (int)std::max(end_frame - (_stream_base + have), (int64_t)1024);
+    int ready = _stream->ready();
+    if (ready <= 0) {
+      if (!_stream->aborted()) {
+        return false;
+      }
+      reached_eof = true;
+      break;
+    }
+    want = std::min(want, ready);
+
+    _decode_buffer.resize((size_t)want * channels);
+    int got = _stream->read_samples(want, &_decode_buffer[0]);
+    if (got <= 0) {
+      reached_eof = true;
+      break;
+    }
+
+    size_t start = _stream_data.size();
+    _stream_data.resize(start + (size_t)got * channels);
+    float *dest = &_stream_data[start];
+    for (int i = 0; i < got * channels; ++i) {
+      dest[i] = _decode_buffer[i] * (1.0f / 32768.0f);
+    }
+    have += got;
+  }
+
+  if (reached_eof) {
+    // Duplicate the last frame, as we do for sample data.
+    _stream_eof = true;
+    if (have > 0) {
+      for (int c = 0; c < channels; ++c) {
+        _stream_data.push_back(_stream_data[(size_t)(have - 1) * channels + c]);
+      }
+    } else {
+      _stream_data.assign(channels, 0.0f);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,163 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareAudioSound.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef SOFTWAREAUDIOSOUND_H
+#define SOFTWAREAUDIOSOUND_H
+
+#include "pandabase.h"
+
+#include "audioSound.h"
+#include "movieAudio.h"
+#include "movieAudioCursor.h"
+#include "softwareAudioManager.h"
+
+/**
+ * A sound played by the SoftwareAudioManager.  Short sounds share decoded
+ * sample data with the other sounds loaded from the same file; long sounds
+ * are decoded a little at a time, by the mixer, from a MovieAudioCursor of
+ * their own.
+ */
+class EXPCL_SOFTWARE_AUDIO SoftwareAudioSound : public AudioSound {
+  friend class SoftwareAudioManager;
+
+public:
+  ~SoftwareAudioSound();
+
+  void play();
+  void stop();
+
+  void set_loop(bool loop=true);
+  bool get_loop() const;
+
+  void set_loop_count(unsigned long loop_count=1);
+  unsigned long get_loop_count() const;
+
+  void set_time(PN_stdfloat time=0.0);
+  PN_stdfloat get_time() const;
+
+  void set_volume(PN_stdfloat volume=1.0);
+  PN_stdfloat get_volume() const;
+
+  void set_balance(PN_stdfloat balance_right=0.0);
+  PN_stdfloat get_balance() const;
+
+  void set_play_rate(PN_stdfloat play_rate=1.0f);
+  PN_stdfloat get_play_rate() const;
+
+  void set_active(bool active=true);
+  bool get_active() const;
+
+  void set_finished_event(const std::string &event);
+  const std::string &get_finished_event() const;
+
+  const std::string &get_name() const;
+
+  PN_stdfloat length() const;
+
+  void set_3d_attributes(PN_stdfloat px, PN_stdfloat py, PN_stdfloat pz, PN_stdfloat vx, PN_stdfloat vy, PN_stdfloat vz);
+  void get_3d_attributes(PN_stdfloat *px, PN_stdfloat *py, PN_stdfloat *pz, PN_stdfloat *vx, PN_stdfloat *vy, PN_stdfloat *vz);
+
+  AudioSound::SoundStatus status() const;
+
+  void finished();
+
+private:
+  SoftwareAudioSound(SoftwareAudioManager *manager,
+                     MovieAudio *movie,
+                     bool positional,
+                     int mode);
+
+  void cleanup();
+  void seek_to(double time);
+  void mix(float *out, int out_channels, int num_frames, int out_rate,
+           PN_stdfloat volume, PN_stdfloat play_rate);
+  bool fill_stream(int64_t end_frame);
+
+  INLINE bool is_valid() const;
+  INLINE bool is_playing() const;
+  INLINE double get_position() const;
+
+private:
+  PT(MovieAudio) _movie;
+  PT(SoftwareAudioManager) _manager;
+
+  // Exactly one of these is set.
+  PT(SoftwareAudioManager::SampleData) _sample;
+  PT(MovieAudioCursor) _stream;
+
+  // For a streaming sound, the frames most recently decoded from _stream.
+  // The first of these is the frame with index _stream_base.  Once the end
+  // of the stream is reached, a copy of the last frame is appended, just as
+  // for SampleData.
+  pvector<float> _stream_data;
+  int64_t _stream_base;
+  bool _stream_eof;
+  pvector<int16_t> _decode_buffer;
+
+  int _rate;
+  int _channels;
+  double _length;
+
+  // The current position within the sound, in frames, as 48.16 fixed point.
+  uint64_t _pos;
+
+  bool _playing;
+  bool _mix_done;
+  unsigned long _loop_count;
+  unsigned long _loops_completed;
+
+  PN_stdfloat _volume;
+  PN_stdfloat _balance;
+  PN_stdfloat _play_rate;
+
+  bool _positional;
+  PN_stdfloat _location[3];
+  PN_stdfloat _velocity[3];
+
+  // The start_time field affects the next call to play.  The current_time
+  // is reported by get_time() while the sound is not playing.
+  double _start_time;
+  double _current_time;
+
+  std::string _finished_event;
+  Filename _basename;
+
+  // _active is for things like a 'turn off sound effects' in a preferences
+  // pannel.  _active is not about whether a sound is currently playing.  Use
+  // status() for info on whether the sound is playing.
+  bool _active;
+  bool _paused;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AudioSound::init_type();
+    register_type(_type_handle, "SoftwareAudioSound", AudioSound::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {
+    init_type();
+    return get_class_type();
+  }
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "softwareAudioSound.I"
+
+#endif /* SOFTWAREAUDIOSOUND_H */
@@ -0,0 +1,4 @@
+#include "config_softwareAudio.cxx"
+#include "softwareAudioManager.cxx"
+#include "softwareAudioMix.cxx"
+#include "softwareAudioSound.cxx"
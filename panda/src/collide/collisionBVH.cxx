@@ -0,0 +1,270 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "collisionBVH.h"
+#include "geometricBoundingVolume.h"
+#include "finiteBoundingVolume.h"
+#include "boundingLine.h"
+
+#include <algorithm>
+
+/**
+ *
+ */
+CollisionBVH::
+CollisionBVH() {
+}
+
+/**
+ * Adds a new item with the indicated axis-aligned bounds.  The index is
+ * returned by query() to identify the item; it need not be unique or
+ * sequential.  build() must be called after all items have been added.
+ */
+void CollisionBVH::
+add_item(int index, const LPoint3 &min_point, const LPoint3 &max_point) {
+  Item item;
+  item._min = min_point;
+  item._max = max_point;
+  item._index = index;
+  _items.push_back(item);
+}
+
+/**
+ * Adds a new item that has no finite bounds, such as a CollisionPlane.  It
+ * will be returned by every query.
+ */
+void CollisionBVH::
+add_unbounded_item(int index) {
+  _unbounded.push_back(index);
+}
+
+/**
+ * Builds the hierarchy from the items added so far.
+ */
+void CollisionBVH::
+build() {
+  _nodes.clear();
+  if (_items.empty()) {
+    return;
+  }
+
+  // A median split produces a balanced tree, so there are fewer than
+  // 2 * ceil(n / max_leaf_items) nodes.
+  _nodes.reserve(2 * (_items.size() / max_leaf_items + 1));
+  _nodes.push_back(Node());
+  r_build(0, 0, _items.size());
+}
+
+/**
+ * Appends to result the index of every item whose bounds might intersect the
+ * indicated volume, in no particular order.  Returns true on success, or
+ * false if the volume is of a type that the hierarchy cannot be used to
+ * search, in which case the caller should consider all of the items.
+ */
+bool CollisionBVH::
+query(const GeometricBoundingVolume *volume, vector_int &result) const {
+  if (volume->is_empty()) {
+    result.insert(result.end(), _unbounded.begin(), _unbounded.end());
+    return true;
+  }
+  if (volume->is_infinite()) {
+    return false;
+  }
+
+  const FiniteBoundingVolume *fbv = volume->as_finite_bounding_volume();
+  if (fbv != nullptr) {
+    query_box(fbv->get_min(), fbv->get_max(), result);
+    return true;
+  }
+
+  const BoundingLine *line = volume->as_bounding_line();
+  if (line != nullptr) {
+    query_line(line->get_point_a(),
+               line->get_point_b() - line->get_point_a(), result);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ *
+ */
+void CollisionBVH::
+output(std::ostream &out) const {
+  out << "CollisionBVH, " << get_num_items() << " items, "
+      << _nodes.size() << " nodes";
+}
+
+/**
+ * Fills in the indicated node to contain the items in the range [begin, end),
+ * recursively splitting it if it contains too many.
+ */
+void CollisionBVH::
+r_build(size_t node_index, size_t begin, size_t end) {
+  LPoint3 min_point = _items[begin]._min;
+  LPoint3 max_point = _items[begin]._max;
+  LPoint3 min_center = (_items[begin]._min + _items[begin]._max) * 0.5f;
+  LPoint3 max_center = min_center;
+  for (size_t i = begin + 1; i < end; ++i) {
+    const Item &item = _items[i];
+    LPoint3 center = (item._min + item._max) * 0.5f;
+    for (int a = 0; a < 3; ++a) {
+      min_point[a] = std::min(min_point[a], item._min[a]);
+      max_point[a] = std::max(max_point[a], item._max[a]);
+      min_center[a] = std::min(min_center[a], center[a]);
+      max_center[a] = std::max(max_center[a], center[a]);
+    }
+  }
+
+  {
+    Node &node = _nodes[node_index];
+    node._min = min_point;
+    node._max = max_point;
+    node._first = begin;
+    node._count = end - begin;
+  }
+  if (end - begin <= max_leaf_items) {
+    return;
+  }
+
+  // Split along the axis in which the centers are most spread out.
+  LVector3 extent = max_center - min_center;
+  int axis = 0;
+  if (extent[1] > extent[axis]) {
+    axis = 1;
+  }
+  if (extent[2] > extent[axis]) {
+    axis = 2;
+  }
+
+  size_t middle = begin + (end - begin) / 2;
+  std::nth_element(_items.begin() + begin, _items.begin() + middle,
+                   _items.begin() + end,
+                   [axis](const Item &a, const Item &b) {
+    return (a._min[axis] + a._max[axis]) < (b._min[axis] + b._max[axis]);
+  });
+
+  // The children are allocated together, so that only the first needs to
+  // be recorded.  Note that push_back() may invalidate any Node reference.
+  size_t child = _nodes.size();
+  _nodes.push_back(Node());
+  _nodes.push_back(Node());
+  _nodes[node_index]._first = child;
+  _nodes[node_index]._count = 0;
+
+  r_build(child, begin, middle);
+  r_build(child + 1, middle, end);
+}
+
+/**
+ * Appends the items whose bounds overlap the indicated box.
+ */
+void CollisionBVH::
+query_box(const LPoint3 &min_point, const LPoint3 &max_point,
+          vector_int &result) const {
+  result.insert(result.end(), _unbounded.begin(), _unbounded.end());
+  if (_nodes.empty()) {
+    return;
+  }
+
+  // Since the tree is balanced, its depth can't exceed the number of bits in
+  // a size_t.
+  size_t stack[sizeof(size_t) * 8 + 1];
+  size_t sp = 0;
+  stack[sp++] = 0;
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    if (!overlaps_box(node._min, node._max, min_point, max_point)) {
+      continue;
+    }
+    if (node._count != 0) {
+      for (size_t i = node._first; i < node._first + node._count; ++i) {
+        const Item &item = _items[i];
+        if (overlaps_box(item._min, item._max, min_point, max_point)) {
+          result.push_back(item._index);
+        }
+      }
+    } else {
+      stack[sp++] = node._first;
+      stack[sp++] = node._first + 1;
+    }
+  }
+}
+
+/**
+ * Appends the items whose bounds overlap the infinite line through the
+ * indicated point.  BoundingLine is also used by CollisionRay, so the line
+ * extends in both directions.
+ */
+void CollisionBVH::
+query_line(const LPoint3 &origin, const LVector3 &direction,
+           vector_int &result) const {
+  result.insert(result.end(), _unbounded.begin(), _unbounded.end());
+  if (_nodes.empty()) {
+    return;
+  }
+
+  size_t stack[sizeof(size_t) * 8 + 1];
+  size_t sp = 0;
+  stack[sp++] = 0;
+  while (sp > 0) {
+    const Node &node = _nodes[stack[--sp]];
+    if (!overlaps_line(node._min, node._max, origin, direction)) {
+      continue;
+    }
+    if (node._count != 0) {
+      for (size_t i = node._first; i < node._first + node._count; ++i) {
+        const Item &item = _items[i];
+        if (overlaps_line(item._min, item._max, origin, direction)) {
+          result.push_back(item._index);
+        }
+      }
+    } else {
+      stack[sp++] = node._first;
+      stack[sp++] = node._first + 1;
+    }
+  }
+}
+
+/**
+ * Returns true if the infinite line intersects the indicated box, using the
+ * slab method.
+ */
+bool CollisionBVH::
+overlaps_line(const LPoint3 &min_point, const LPoint3 &max_point,
+              const LPoint3 &origin, const LVector3 &direction) {
+  PN_stdfloat t_min = -FLT_MAX;
+  PN_stdfloat t_max = FLT_MAX;
+  for (int a = 0; a < 3; ++a) {
+    if (direction[a] == 0.0f) {
+      // The line is parallel to this slab.
+      if (origin[a] < min_point[a] || origin[a] > max_point[a]) {
+        return false;
+      }
+    } else {
+      PN_stdfloat inv = 1.0f / direction[a];
+      PN_stdfloat t0 = (min_point[a] - origin[a]) * inv;
+      PN_stdfloat t1 = (max_point[a] - origin[a]) * inv;
+      if (t0 > t1) {
+        std::swap(t0, t1);
+      }
+      t_min = std::max(t_min, t0);
+      t_max = std::min(t_max, t1);
+      if (t_min > t_max) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
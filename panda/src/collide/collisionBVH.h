@@ -0,0 +1,111 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionBVH.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef COLLISIONBVH_H
+#define COLLISIONBVH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+#include "vector_int.h"
+
+class GeometricBoundingVolume;
+
+/**
+ * A bounding volume hierarchy over a set of axis-aligned boxes, each of
+ * which is identified by an integer index.  This is used by the
+ * CollisionTraverser to quickly find the handful of triangles within a large
+ * Geom, or the handful of solids within a large CollisionNode, whose bounds
+ * might intersect a particular collider.
+ *
+ * The hierarchy is stored as a flat array of nodes, built top-down by
+ * splitting each node at the median of its items along its longest axis.  It
+ * is immutable once built; to reflect a change in the underlying items, build
+ * a new one.
+ */
+class EXPCL_PANDA_COLLIDE CollisionBVH : public ReferenceCount {
+public:
+  CollisionBVH();
+
+  void add_item(int index, const LPoint3 &min_point, const LPoint3 &max_point);
+  void add_unbounded_item(int index);
+  void build();
+
+  INLINE size_t get_num_items() const;
+  INLINE size_t get_num_nodes() const;
+
+  bool query(const GeometricBoundingVolume *volume, vector_int &result) const;
+
+  template<class Visitor>
+  INLINE void traverse_ray(const LPoint3 &origin, const LVector3 &direction,
+                           PN_stdfloat &max_t, Visitor &&visitor) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  void r_build(size_t node_index, size_t begin, size_t end);
+
+  void query_box(const LPoint3 &min_point, const LPoint3 &max_point,
+                 vector_int &result) const;
+  void query_line(const LPoint3 &origin, const LVector3 &direction,
+                  vector_int &result) const;
+
+  INLINE static bool overlaps_box(const LPoint3 &min_a, const LPoint3 &max_a,
+                                  const LPoint3 &min_b, const LPoint3 &max_b);
+  static bool overlaps_line(const LPoint3 &min_point, const LPoint3 &max_point,
+                            const LPoint3 &origin, const LVector3 &direction);
+  INLINE static bool clip_ray(const LPoint3 &min_point, const LPoint3 &max_point,
+                              const LPoint3 &origin, const LVector3 &direction,
+                              PN_stdfloat max_t, PN_stdfloat &t_enter);
+
+private:
+  class Item {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    int _index;
+  };
+  typedef pvector<Item> Items;
+  Items _items;
+
+  // A node with a nonzero _count is a leaf containing the _count items
+  // beginning at _first.  Otherwise, its children are the two nodes beginning
+  // at _first.
+  class Node {
+  public:
+    Node() : _min(0.0f), _max(0.0f), _first(0), _count(0) {}
+
+    LPoint3 _min;
+    LPoint3 _max;
+    size_t _first;
+    size_t _count;
+  };
+  typedef pvector<Node> Nodes;
+  Nodes _nodes;
+
+  // These are the items with infinite bounds, which must always be tested.
+  vector_int _unbounded;
+
+  enum { max_leaf_items = 4 };
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionBVH &bvh) {
+  bvh.output(out);
+  return out;
+}
+
+#include "collisionBVH.I"
+
+#endif
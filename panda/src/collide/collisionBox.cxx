@@ -633,83 +633,73 @@ test_intersection_from_capsule(const CollisionEntry &entry) const {
   const CollisionCapsule *capsule;
   DCAST_INTO_R(capsule, entry.get_from(), nullptr);
 
-  const LMatrix4 &wrt_mat = entry.get_wrt_mat();
+  CPT(TransformState) wrt_space = entry.get_wrt_space();
+  CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
+  const LMatrix4 &wrt_mat = wrt_space->get_mat();
 
   LPoint3 from_a = capsule->get_point_a() * wrt_mat;
   LPoint3 from_b = capsule->get_point_b() * wrt_mat;
   LVector3 from_direction = from_b - from_a;
-  PN_stdfloat radius_sq = wrt_mat.xform_vec(LVector3(0, 0, capsule->get_radius())).length_squared();
-  PN_stdfloat radius = csqrt(radius_sq);
-
-  LPoint3 box_min = get_min();
-  LPoint3 box_max = get_max();
-  LVector3 dimensions = box_max - box_min;
-
-  // The method below is inspired by Christer Ericson's book Real-Time
-  // Collision Detection.  Instead of testing a capsule against a box, we test
-  // a segment against an box that is oversized by the capsule radius.
-
-  // First, we test if the line segment intersects a box with its faces
-  // expanded outwards by the capsule radius.  If not, there is no collision.
-  double t1, t2;
-  if (!intersects_line(t1, t2, from_a, from_direction, radius)) {
-    return nullptr;
-  }
-
-  if (t2 < 0.0 || t1 > 1.0) {
-    return nullptr;
-  }
-
-  t1 = std::min(1.0, std::max(0.0, (t1 + t2) * 0.5));
-  LPoint3 point = from_a + from_direction * t1;
+  PN_stdfloat radius = wrt_mat.xform_vec(LVector3(0, 0, capsule->get_radius())).length();
 
-  // We now have a point of intersection between the line segment and the
-  // oversized box.  Check on how many axes it lies outside the box.  If it is
-  // less than two, we know that it does not lie in one of the rounded regions
-  // of the oversized rounded box, and it is a guaranteed hit.  Otherwise, we
-  // will need to test against the edge regions.
-  if ((point[0] < box_min[0] || point[0] > box_max[0]) +
-      (point[1] < box_min[1] || point[1] > box_max[1]) +
-      (point[2] < box_min[2] || point[2] > box_max[2]) > 1) {
-    // Test the capsule against each edge of the box.
-    static const struct {
-      LPoint3 point;
-      int axis;
-    } edges[] = {
-      {{0, 0, 0}, 0},
-      {{0, 1, 0}, 0},
-      {{0, 0, 1}, 0},
-      {{0, 1, 1}, 0},
-      {{0, 0, 0}, 1},
-      {{0, 0, 1}, 1},
-      {{1, 0, 0}, 1},
-      {{1, 0, 1}, 1},
-      {{0, 0, 0}, 2},
-      {{0, 1, 0}, 2},
-      {{1, 0, 0}, 2},
-      {{1, 1, 0}, 2},
-    };
+  LPoint3 surface_point, interior_point;
+  LVector3 normal;
+  PN_stdfloat t = 1.0f;
+  bool hit = false;
+
+  // Determine how far the capsule has moved since the last frame.  We don't
+  // know whether it has undergone any rotation, so we hold it at its final
+  // orientation and only consider the translation.
+  LVector3 delta = LVector3::zero();
+  if (wrt_prev_space != wrt_space) {
+    delta = from_a - capsule->get_point_a() * wrt_prev_space->get_mat();
+  }
+
+  if (delta != LVector3::zero()) {
+    // Find out during which part of the motion the capsule overlaps the box
+    // on each of the axes, and test it at successive points along that
+    // stretch of its path, spaced no further apart than its radius, so that
+    // it can't skip over the box.
+    PN_stdfloat t_first = 0.0f;
+    PN_stdfloat t_last = 1.0f;
+    LPoint3 diff = from_a + from_direction * 0.5f - _center;
+    LVector3 into_extents = get_dimensions() * 0.5f;
+    for (int i = 0; i < 3; ++i) {
+      if (!sweep_axis(diff[i], delta[i],
+                      into_extents[i] + cabs(from_direction[i]) * 0.5f + radius,
+                      t_first, t_last)) {
+        return nullptr;
+      }
+    }
 
-    PN_stdfloat best_dist_sq = FLT_MAX;
+    PN_stdfloat length = delta.length() * (t_last - t_first);
+    int num_steps = 0;
+    if (length > radius) {
+      num_steps = min((int)cceil(length / radius),
+                      (int)collision_sweep_max_steps);
+    }
 
-    for (int i = 0; i < 12; ++i) {
-      LPoint3 vertex = edges[i].point;
-      vertex.componentwise_mult(dimensions);
-      vertex += box_min;
-      LVector3 delta(0);
-      delta[edges[i].axis] = dimensions[edges[i].axis];
-      double u1, u2;
-      CollisionCapsule::calc_closest_segment_points(u1, u2, from_a, from_direction, vertex, delta);
-      PN_stdfloat dist_sq = ((from_a + from_direction * u1) - (vertex + delta * u2)).length_squared();
-      if (dist_sq < best_dist_sq) {
-        best_dist_sq = dist_sq;
+    for (int i = 0; i <= num_steps && !hit; ++i) {
+      if (num_steps > 0) {
+        t = t_first + (t_last - t_first) * i / num_steps;
+      } else {
+        t = t_first;
       }
+      hit = intersects_capsule(from_a + delta * (t - 1.0f), from_direction,
+                               radius, surface_point, interior_point, normal);
     }
 
-    if (best_dist_sq > radius_sq) {
-      // It is not actually touching any edge.
-      return nullptr;
-    }
+    // The capsule has moved on since it touched the box, so it needs to be
+    // pushed back by that much more.
+    interior_point += delta * (1.0f - t);
+
+  } else {
+    hit = intersects_capsule(from_a, from_direction, radius,
+                             surface_point, interior_point, normal);
+  }
+
+  if (!hit) {
+    return nullptr;
   }
 
   if (collide_cat.is_debug()) {
@@ -718,47 +708,7 @@ test_intersection_from_capsule(const CollisionEntry &entry) const {
       << " into " << entry.get_into_node_path() << "\n";
   }
   PT(CollisionEntry) new_entry = new CollisionEntry(entry);
-
-  // Which is the longest axis?
-  LVector3 diff = point - _center;
-  diff[0] /= dimensions[0];
-  diff[1] /= dimensions[1];
-  diff[2] /= dimensions[2];
-  int axis = 0;
-  if (cabs(diff[0]) > cabs(diff[1])) {
-    if (cabs(diff[0]) > cabs(diff[2])) {
-      axis = 0;
-    } else {
-      axis = 2;
-    }
-  } else {
-    if (cabs(diff[1]) > cabs(diff[2])) {
-      axis = 1;
-    } else {
-      axis = 2;
-    }
-  }
-  LVector3 normal(0);
-  normal[axis] = std::copysign(1, diff[axis]);
-
-  LPoint3 clamped = point.fmax(box_min).fmin(box_max);
-  LPoint3 surface_point = clamped;
-  surface_point[axis] = (diff[axis] >= 0.0f) ? box_max[axis] : box_min[axis];
-
-  // Is the point inside the box?
-  LVector3 interior_vec;
-  if (clamped != point) {
-    // No, it is outside.  The interior point is in the direction of the
-    // surface point.
-    interior_vec = point - surface_point;
-    if (!interior_vec.normalize()) {
-      interior_vec = normal;
-    }
-  } else {
-    // It is inside.  I think any point will work for this.
-    interior_vec = normal;
-  }
-  new_entry->set_interior_point(point - interior_vec * radius);
+  new_entry->set_interior_point(interior_point);
   new_entry->set_surface_point(surface_point);
 
   if (has_effective_normal() && capsule->get_respect_effective_normal()) {
@@ -767,6 +717,10 @@ test_intersection_from_capsule(const CollisionEntry &entry) const {
     new_entry->set_surface_normal(normal);
   }
 
+  new_entry->set_contact_pos(from_a + delta * (t - 1.0f));
+  new_entry->set_contact_normal(normal);
+  new_entry->set_t(t);
+
   return new_entry;
 }
 
@@ -778,12 +732,25 @@ test_intersection_from_box(const CollisionEntry &entry) const {
   const CollisionBox *box;
   DCAST_INTO_R(box, entry.get_from(), nullptr);
 
-  const LMatrix4 &wrt_mat = entry.get_wrt_mat();
+  CPT(TransformState) wrt_space = entry.get_wrt_space();
+  CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
+  const LMatrix4 &wrt_mat = wrt_space->get_mat();
 
   LPoint3 diff = wrt_mat.xform_point_general(box->get_center()) - _center;
   LVector3 from_extents = box->get_dimensions() * 0.5f;
   LVector3 into_extents = get_dimensions() * 0.5f;
 
+  // If the box has moved since the last frame, we sweep it along its path, so
+  // that we find the time of impact and don't miss this box if it went all
+  // the way through it.  We don't know how the box has rotated in the
+  // meantime, so we hold it at its final orientation and only consider the
+  // translation.
+  LVector3 delta = LVector3::zero();
+  if (wrt_prev_space != wrt_space) {
+    delta = diff + _center -
+      wrt_prev_space->get_mat().xform_point_general(box->get_center());
+  }
+
   LVecBase3 box_x = wrt_mat.get_row3(0);
   LVecBase3 box_y = wrt_mat.get_row3(1);
   LVecBase3 box_z = wrt_mat.get_row3(2);
@@ -803,138 +770,128 @@ test_intersection_from_box(const CollisionEntry &entry) const {
   from_extents[2] *= l;
   box_z /= l;
 
+  // This is the fraction of the motion during which the boxes overlap; each
+  // of the separating axes narrows it down further.
+  PN_stdfloat t_first = 0.0f;
+  PN_stdfloat t_last = 1.0f;
+
+  // The projected extents of the from box onto the axes of the into box.
+  LVector3 from_proj(
+    cabs(box_x[0] * from_extents[0]) +
+    cabs(box_y[0] * from_extents[1]) +
+    cabs(box_z[0] * from_extents[2]),
+    cabs(box_x[1] * from_extents[0]) +
+    cabs(box_y[1] * from_extents[1]) +
+    cabs(box_z[1] * from_extents[2]),
+    cabs(box_x[2] * from_extents[0]) +
+    cabs(box_y[2] * from_extents[1]) +
+    cabs(box_z[2] * from_extents[2]));
+
   PN_stdfloat r1, r2;
-  PN_stdfloat min_pen = 0;
-  PN_stdfloat pen;
-  int axis = 0;
 
   // SAT test for the three axes of the into cube.
-  r1 = into_extents[0];
-  r2 = cabs(box_x[0] * from_extents[0]) +
-       cabs(box_y[0] * from_extents[1]) +
-       cabs(box_z[0] * from_extents[2]);
-  pen = r1 + r2 - cabs(diff[0]);
-  if (pen < 0) {
+  if (!sweep_axis(diff[0], delta[0], into_extents[0] + from_proj[0], t_first, t_last) ||
+      !sweep_axis(diff[1], delta[1], into_extents[1] + from_proj[1], t_first, t_last) ||
+      !sweep_axis(diff[2], delta[2], into_extents[2] + from_proj[2], t_first, t_last)) {
     return nullptr;
   }
-  min_pen = pen;
-
-  r1 = into_extents[1];
-  r2 = cabs(box_x[1] * from_extents[0]) +
-       cabs(box_y[1] * from_extents[1]) +
-       cabs(box_z[1] * from_extents[2]);
-  pen = r1 + r2 - cabs(diff[1]);
-  if (pen < 0) {
-    return nullptr;
-  }
-  if (pen < min_pen) {
-    min_pen = pen;
-    axis = 1;
-  }
-
-  r1 = into_extents[2];
-  r2 = cabs(box_x[2] * from_extents[0]) +
-       cabs(box_y[2] * from_extents[1]) +
-       cabs(box_z[2] * from_extents[2]);
-  pen = r1 + r2 - cabs(diff[2]);
-  if (pen < 0) {
-    return nullptr;
-  }
-  if (pen < min_pen) {
-    min_pen = pen;
-    axis = 2;
-  }
 
   // SAT test for the three axes of the from cube.
   r1 = cabs(box_x[0] * into_extents[0]) +
        cabs(box_x[1] * into_extents[1]) +
        cabs(box_x[2] * into_extents[2]);
   r2 = from_extents[0];
-  pen = r1 + r2 - cabs(diff.dot(box_x));
-  if (pen < 0) {
+  if (!sweep_axis(diff.dot(box_x), delta.dot(box_x), r1 + r2, t_first, t_last)) {
     return nullptr;
   }
-  if (pen < min_pen) {
-    min_pen = pen;
-  }
 
   r1 = cabs(box_y[0] * into_extents[0]) +
        cabs(box_y[1] * into_extents[1]) +
        cabs(box_y[2] * into_extents[2]);
   r2 = from_extents[1];
-  pen = r1 + r2 - cabs(diff.dot(box_y));
-  if (pen < 0) {
+  if (!sweep_axis(diff.dot(box_y), delta.dot(box_y), r1 + r2, t_first, t_last)) {
     return nullptr;
   }
-  if (pen < min_pen) {
-    min_pen = pen;
-  }
 
   r1 = cabs(box_z[0] * into_extents[0]) +
        cabs(box_z[1] * into_extents[1]) +
        cabs(box_z[2] * into_extents[2]);
   r2 = from_extents[2];
-  pen = r1 + r2 - cabs(diff.dot(box_z));
-  if (pen < 0) {
+  if (!sweep_axis(diff.dot(box_z), delta.dot(box_z), r1 + r2, t_first, t_last)) {
     return nullptr;
   }
-  if (pen < min_pen) {
-    min_pen = pen;
-  }
 
   // SAT test of the nine cross products.
   r1 = into_extents[1] * cabs(box_x[2]) + into_extents[2] * cabs(box_x[1]);
   r2 = from_extents[1] * cabs(box_z[0]) + from_extents[2] * cabs(box_y[0]);
-  if (cabs(diff[2] * box_x[1] - diff[1] * box_x[2]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[2] * box_x[1] - diff[1] * box_x[2],
+                  delta[2] * box_x[1] - delta[1] * box_x[2],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[1] * cabs(box_y[2]) + into_extents[2] * cabs(box_y[1]);
   r2 = from_extents[0] * cabs(box_z[0]) + from_extents[2] * cabs(box_x[0]);
-  if (cabs(diff[2] * box_y[1] - diff[1] * box_y[2]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[2] * box_y[1] - diff[1] * box_y[2],
+                  delta[2] * box_y[1] - delta[1] * box_y[2],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[1] * cabs(box_z[2]) + into_extents[2] * cabs(box_z[1]);
   r2 = from_extents[0] * cabs(box_y[0]) + from_extents[1] * cabs(box_x[0]);
-  if (cabs(diff[2] * box_z[1] - diff[1] * box_z[2]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[2] * box_z[1] - diff[1] * box_z[2],
+                  delta[2] * box_z[1] - delta[1] * box_z[2],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_x[2]) + into_extents[2] * cabs(box_x[0]);
   r2 = from_extents[1] * cabs(box_z[1]) + from_extents[2] * cabs(box_y[1]);
-  if (cabs(diff[0] * box_x[2] - diff[2] * box_x[0]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[0] * box_x[2] - diff[2] * box_x[0],
+                  delta[0] * box_x[2] - delta[2] * box_x[0],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_y[2]) + into_extents[2] * cabs(box_y[0]);
   r2 = from_extents[0] * cabs(box_z[1]) + from_extents[2] * cabs(box_x[1]);
-  if (cabs(diff[0] * box_y[2] - diff[2] * box_y[0]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[0] * box_y[2] - diff[2] * box_y[0],
+                  delta[0] * box_y[2] - delta[2] * box_y[0],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_z[2]) + into_extents[2] * cabs(box_z[0]);
   r2 = from_extents[0] * cabs(box_y[1]) + from_extents[1] * cabs(box_x[1]);
-  if (cabs(diff[0] * box_z[2] - diff[2] * box_z[0]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[0] * box_z[2] - diff[2] * box_z[0],
+                  delta[0] * box_z[2] - delta[2] * box_z[0],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_x[1]) + into_extents[1] * cabs(box_x[0]);
   r2 = from_extents[1] * cabs(box_z[2]) + from_extents[2] * cabs(box_y[2]);
-  if (cabs(diff[1] * box_x[0] - diff[0] * box_x[1]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[1] * box_x[0] - diff[0] * box_x[1],
+                  delta[1] * box_x[0] - delta[0] * box_x[1],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_y[1]) + into_extents[1] * cabs(box_y[0]);
   r2 = from_extents[0] * cabs(box_z[2]) + from_extents[2] * cabs(box_x[2]);
-  if (cabs(diff[1] * box_y[0] - diff[0] * box_y[1]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[1] * box_y[0] - diff[0] * box_y[1],
+                  delta[1] * box_y[0] - delta[0] * box_y[1],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   r1 = into_extents[0] * cabs(box_z[1]) + into_extents[1] * cabs(box_z[0]);
   r2 = from_extents[0] * cabs(box_y[2]) + from_extents[1] * cabs(box_x[2]);
-  if (cabs(diff[1] * box_z[0] - diff[0] * box_z[1]) > r1 + r2) {
-      return nullptr;
+  if (!sweep_axis(diff[1] * box_z[0] - diff[0] * box_z[1],
+                  delta[1] * box_z[0] - delta[0] * box_z[1],
+                  r1 + r2, t_first, t_last)) {
+    return nullptr;
   }
 
   if (collide_cat.is_debug()) {
@@ -944,24 +901,41 @@ test_intersection_from_box(const CollisionEntry &entry) const {
   }
   PT(CollisionEntry) new_entry = new CollisionEntry(entry);
 
+  // If the box wasn't moving, it touched this box at the end of the frame.
+  PN_stdfloat t = (delta == LVector3::zero()) ? 1.0f : t_first;
+
+  // Find the axis of least penetration at the time of impact.  If the box
+  // came from outside, this is the face that it hit first.
+  LVector3 contact_diff = diff + delta * (t - 1.0f);
+  PN_stdfloat min_pen = into_extents[0] + from_proj[0] - cabs(contact_diff[0]);
+  int axis = 0;
+  for (int i = 1; i < 3; ++i) {
+    PN_stdfloat pen = into_extents[i] + from_proj[i] - cabs(contact_diff[i]);
+    if (pen < min_pen) {
+      min_pen = pen;
+      axis = i;
+    }
+  }
+
   // This isn't always the correct surface point.  However, it seems to be
   // enough to let the pusher do the right thing.
   LPoint3 surface(
-    min(max(diff[0], -into_extents[0]), into_extents[0]),
-    min(max(diff[1], -into_extents[1]), into_extents[1]),
-    min(max(diff[2], -into_extents[2]), into_extents[2]));
+    min(max(contact_diff[0], -into_extents[0]), into_extents[0]),
+    min(max(contact_diff[1], -into_extents[1]), into_extents[1]),
+    min(max(contact_diff[2], -into_extents[2]), into_extents[2]));
 
   // Create the normal along the axis of least penetration.
   LVector3 normal(0);
-  PN_stdfloat diff_axis = diff[axis];
-  int sign = (diff_axis >= 0) ? 1 : -1;
+  int sign = (contact_diff[axis] >= 0) ? 1 : -1;
   normal[axis] = sign;
   surface[axis] = into_extents[axis] * sign;
 
   new_entry->set_surface_point(surface + _center);
 
-  // Does not generate the correct depth.  Needs fixing.
-  new_entry->set_interior_point(surface + _center + normal * -min_pen);
+  // The box needs to be pushed back out by however far it has moved on into
+  // this box since the time of impact.
+  PN_stdfloat depth = into_extents[axis] + from_proj[axis] - diff[axis] * sign;
+  new_entry->set_interior_point(surface + _center + normal * -depth);
 
   if (has_effective_normal() && box->get_respect_effective_normal()) {
     new_entry->set_surface_normal(get_effective_normal());
@@ -969,6 +943,10 @@ test_intersection_from_box(const CollisionEntry &entry) const {
     new_entry->set_surface_normal(normal);
   }
 
+  new_entry->set_contact_pos(box->get_center() * wrt_mat + delta * (t - 1.0f));
+  new_entry->set_contact_normal(normal);
+  new_entry->set_t(t);
+
   return new_entry;
 }
 
@@ -1058,6 +1036,132 @@ fill_viz_geom() {
   _bounds_viz_geom->add_geom(geom2, get_wireframe_viz_state());
 }
 
+/**
+ * Tests a capsule, given by the end points of its inner segment and its
+ * radius in the coordinate space of the box, against the box.  If they
+ * intersect, fills in the surface point, interior point and surface normal,
+ * and returns true.
+ */
+bool CollisionBox::
+intersects_capsule(const LPoint3 &from_a, const LVector3 &from_direction,
+                   PN_stdfloat radius, LPoint3 &surface_point,
+                   LPoint3 &interior_point, LVector3 &normal) const {
+  PN_stdfloat radius_sq = radius * radius;
+
+  LPoint3 box_min = get_min();
+  LPoint3 box_max = get_max();
+  LVector3 dimensions = box_max - box_min;
+
+  // The method below is inspired by Christer Ericson's book Real-Time
+  // Collision Detection.  Instead of testing a capsule against a box, we test
+  // a segment against an box that is oversized by the capsule radius.
+
+  // First, we test if the line segment intersects a box with its faces
+  // expanded outwards by the capsule radius.  If not, there is no collision.
+  double t1, t2;
+  if (!intersects_line(t1, t2, from_a, from_direction, radius)) {
+    return false;
+  }
+
+  if (t2 < 0.0 || t1 > 1.0) {
+    return false;
+  }
+
+  t1 = std::min(1.0, std::max(0.0, (t1 + t2) * 0.5));
+  LPoint3 point = from_a + from_direction * t1;
+
+  // We now have a point of intersection between the line segment and the
+  // oversized box.  Check on how many axes it lies outside the box.  If it is
+  // less than two, we know that it does not lie in one of the rounded regions
+  // of the oversized rounded box, and it is a guaranteed hit.  Otherwise, we
+  // will need to test against the edge regions.
+  if ((point[0] < box_min[0] || point[0] > box_max[0]) +
+      (point[1] < box_min[1] || point[1] > box_max[1]) +
+      (point[2] < box_min[2] || point[2] > box_max[2]) > 1) {
+    // Test the capsule against each edge of the box.
+    static const struct {
+      LPoint3 point;
+      int axis;
+    } edges[] = {
+      {{0, 0, 0}, 0},
+      {{0, 1, 0}, 0},
+      {{0, 0, 1}, 0},
+      {{0, 1, 1}, 0},
+      {{0, 0, 0}, 1},
+      {{0, 0, 1}, 1},
+      {{1, 0, 0}, 1},
+      {{1, 0, 1}, 1},
+      {{0, 0, 0}, 2},
+      {{0, 1, 0}, 2},
+      {{1, 0, 0}, 2},
+      {{1, 1, 0}, 2},
+    };
+
+    PN_stdfloat best_dist_sq = FLT_MAX;
+
+    for (int i = 0; i < 12; ++i) {
+      LPoint3 vertex = edges[i].point;
+      vertex.componentwise_mult(dimensions);
+      vertex += box_min;
+      LVector3 delta(0);
+      delta[edges[i].axis] = dimensions[edges[i].axis];
+      double u1, u2;
+      CollisionCapsule::calc_closest_segment_points(u1, u2, from_a, from_direction, vertex, delta);
+      PN_stdfloat dist_sq = ((from_a + from_direction * u1) - (vertex + delta * u2)).length_squared();
+      if (dist_sq < best_dist_sq) {
+        best_dist_sq = dist_sq;
+      }
+    }
+
+    if (best_dist_sq > radius_sq) {
+      // It is not actually touching any edge.
+      return false;
+    }
+  }
+
+  // Which is the longest axis?
+  LVector3 diff = point - _center;
+  diff[0] /= dimensions[0];
+  diff[1] /= dimensions[1];
+  diff[2] /= dimensions[2];
+  int axis = 0;
+  if (cabs(diff[0]) > cabs(diff[1])) {
+    if (cabs(diff[0]) > cabs(diff[2])) {
+      axis = 0;
+    } else {
+      axis = 2;
+    }
+  } else {
+    if (cabs(diff[1]) > cabs(diff[2])) {
+      axis = 1;
+    } else {
+      axis = 2;
+    }
+  }
+  normal = LVector3::zero();
+  normal[axis] = std::copysign(1, diff[axis]);
+
+  LPoint3 clamped = point.fmax(box_min).fmin(box_max);
+  surface_point = clamped;
+  surface_point[axis] = (diff[axis] >= 0.0f) ? box_max[axis] : box_min[axis];
+
+  // Is the point inside the box?
+  LVector3 interior_vec;
+  if (clamped != point) {
+    // No, it is outside.  The interior point is in the direction of the
+    // surface point.
+    interior_vec = point - surface_point;
+    if (!interior_vec.normalize()) {
+      interior_vec = normal;
+    }
+  } else {
+    // It is inside.  I think any point will work for this.
+    interior_vec = normal;
+  }
+  interior_point = point - interior_vec * radius;
+  return true;
+}
+
 /**
  * Determine the point(s) of intersection of a parametric line with the box.
  * The line is infinite in both directions, and passes through "from" and
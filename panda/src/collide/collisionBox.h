@@ -94,6 +94,9 @@ protected:
   bool intersects_line(double &t1, double &t2,
                        const LPoint3 &from, const LVector3 &delta,
                        PN_stdfloat inflate_size=0) const;
+  bool intersects_capsule(const LPoint3 &from_a, const LVector3 &from_direction,
+                          PN_stdfloat radius, LPoint3 &surface_point,
+                          LPoint3 &interior_point, LVector3 &normal) const;
 
 private:
   LPoint3 _center;
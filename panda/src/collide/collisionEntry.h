@@ -28,6 +28,7 @@
 #include "pandaNode.h"
 #include "nodePath.h"
 #include "clipPlaneAttrib.h"
+#include "deletedChain.h"
 
 /**
  * Defines a single collision event.  One of these is created for each
@@ -38,12 +39,16 @@
  * intersection point and normal) that might or might not be known for each
  * collision.  It is up to the handler to determine what information is known
  * and to do the right thing with it.
+ *
+ * Since many of these are created and destroyed every frame, their memory is
+ * recycled through a DeletedChain rather than returned to the heap.
  */
 class EXPCL_PANDA_COLLIDE CollisionEntry : public TypedWritableReferenceCount {
 public:
   INLINE CollisionEntry();
   CollisionEntry(const CollisionEntry &copy);
   void operator = (const CollisionEntry &copy);
+  ALLOC_DELETED_CHAIN(CollisionEntry);
 
 PUBLISHED:
   INLINE const CollisionSolid *get_from() const;
@@ -168,6 +173,7 @@ private:
 
   friend class CollisionTraverser;
   friend class CollisionHandlerFluidPusher;
+  friend class CollisionHandlerQueue;
 };
 
 INLINE std::ostream &operator << (std::ostream &out, const CollisionEntry &entry);
@@ -61,7 +61,7 @@ xform(const LMatrix4 &mat) {
   }
   Triangles::iterator ti;
   for (ti=_triangles.begin();ti!=_triangles.end();++ti) {
-    CollisionFloorMesh::TriangleIndices tri = *ti;
+    CollisionFloorMesh::TriangleIndices &tri = *ti;
     LPoint3 v1 = _vertices[tri.p1];
     LPoint3 v2 = _vertices[tri.p2];
     LPoint3 v3 = _vertices[tri.p3];
@@ -71,6 +71,7 @@ xform(const LMatrix4 &mat) {
     tri.min_y=min(min(v1[1],v2[1]),v3[1]);
     tri.max_y=max(max(v1[1],v2[1]),v3[1]);
   }
+  mark_grid_stale();
   CollisionSolid::xform(mat);
 }
 
@@ -135,56 +136,16 @@ test_intersection_from_ray(const CollisionEntry &entry) const {
   double fx = from_origin[0];
   double fy = from_origin[1];
 
-  CollisionFloorMesh::Triangles::const_iterator ti;
-  for (ti = _triangles.begin(); ti < _triangles.end(); ++ti) {
-    TriangleIndices tri = *ti;
-    // First do a naive bounding box check on the triangle
-    if (fx < tri.min_x || fx >= tri.max_x || fy < tri.min_y || fy >= tri.max_y) {
-      continue;
-    }
-
-    // okay, there's a good chance we'll be colliding
-    LPoint3 p0 = _vertices[tri.p1];
-    LPoint3 p1 = _vertices[tri.p2];
-    LPoint3 p2 = _vertices[tri.p3];
-    PN_stdfloat p0x = p0[0];
-    PN_stdfloat p0y = p0[1];
-    PN_stdfloat e0x, e0y, e1x, e1y, e2x, e2y;
-    PN_stdfloat u, v;
-
-    e0x = fx - p0x; e0y = fy - p0y;
-    e1x = p1[0] - p0x; e1y = p1[1] - p0y;
-    e2x = p2[0] - p0x; e2y = p2[1] - p0y;
-    if (e1x == 0.0) {
-      if (e2x == 0.0) continue;
-      u = e0x / e2x;
-      if (u < 0.0 || u > 1.0) continue;
-      if (e1y == 0) continue;
-      v = (e0y - (e2y * u)) / e1y;
-      if (v < 0.0) continue;
-    } else {
-      PN_stdfloat d = (e2y * e1x) - (e2x * e1y);
-      if (d == 0.0) continue;
-      u = ((e0y * e1x) - (e0x * e1y)) / d;
-      if (u < 0.0 || u > 1.0) continue;
-      v = (e0x - (e2x * u)) / e1x;
-      if (v < 0.0) continue;
-    }
-    if (u + v <= 0.0 || u + v > 1.0) continue;
-    // we collided!!
-    PN_stdfloat mag = u + v;
-    PN_stdfloat p0z = p0[2];
-
-    PN_stdfloat uz = (p2[2] - p0z) *  mag;
-    PN_stdfloat vz = (p1[2] - p0z) *  mag;
-    PN_stdfloat finalz = p0z + vz + (((uz - vz) * u) / (u + v));
-    PT(CollisionEntry) new_entry = new CollisionEntry(entry);
-
-    new_entry->set_surface_normal(LPoint3(0, 0, 1));
-    new_entry->set_surface_point(LPoint3(fx, fy, finalz));
-    return new_entry;
+  PN_stdfloat finalz;
+  if (find_triangle(fx, fy, finalz) == nullptr) {
+    return nullptr;
   }
-  return nullptr;
+
+  PT(CollisionEntry) new_entry = new CollisionEntry(entry);
+
+  new_entry->set_surface_normal(LPoint3(0, 0, 1));
+  new_entry->set_surface_point(LPoint3(fx, fy, finalz));
+  return new_entry;
 }
 
 
@@ -202,62 +163,198 @@ test_intersection_from_sphere(const CollisionEntry &entry) const {
 
   PN_stdfloat  fz = PN_stdfloat(from_origin[2]);
   PN_stdfloat rad = sphere->get_radius();
-  CollisionFloorMesh::Triangles::const_iterator ti;
-  for (ti = _triangles.begin(); ti < _triangles.end(); ++ti) {
-    TriangleIndices tri = *ti;
-    // First do a naive bounding box check on the triangle
-    if (fx < tri.min_x || fx >= tri.max_x || fy < tri.min_y || fy >= tri.max_y) {
-      continue;
+
+  PN_stdfloat finalz;
+  if (find_triangle(fx, fy, finalz) == nullptr) {
+    return nullptr;
+  }
+
+  PN_stdfloat dz = fz - finalz;
+  if(dz > rad)
+    return nullptr;
+  PT(CollisionEntry) new_entry = new CollisionEntry(entry);
+
+  new_entry->set_surface_normal(LPoint3(0, 0, 1));
+  new_entry->set_surface_point(LPoint3(fx, fy, finalz));
+  return new_entry;
+}
+
+/**
+ * Returns the first triangle whose projection onto the XY plane contains the
+ * indicated point, and fills in z with the height of the triangle at that
+ * point, or returns NULL if there is no such triangle.
+ */
+const CollisionFloorMesh::TriangleIndices *CollisionFloorMesh::
+find_triangle(double fx, double fy, PN_stdfloat &z) const {
+  {
+    LightMutexHolder holder(((CollisionFloorMesh *)this)->_grid_lock);
+    if (_grid_stale) {
+      ((CollisionFloorMesh *)this)->build_grid();
     }
+  }
+
+  // This also rejects NaN coordinates.
+  if (_grid_num_x == 0 || !(fx >= _grid_min_x) || !(fy >= _grid_min_y)) {
+    return nullptr;
+  }
 
-    // okay, there's a good chance we'll be colliding
-    LPoint3 p0 = _vertices[tri.p1];
-    LPoint3 p1 = _vertices[tri.p2];
-    LPoint3 p2 = _vertices[tri.p3];
-    PN_stdfloat p0x = p0[0];
-    PN_stdfloat p0y = p0[1];
-    PN_stdfloat e0x, e0y, e1x, e1y, e2x, e2y;
-    PN_stdfloat u, v;
-
-    e0x = fx - p0x; e0y = fy - p0y;
-    e1x = p1[0] - p0x; e1y = p1[1] - p0y;
-    e2x = p2[0] - p0x; e2y = p2[1] - p0y;
-    if (e1x == 0.0) {
-      if (e2x == 0.0) continue;
-      u = e0x / e2x;
-      if (u < 0.0 || u > 1.0) continue;
-      if (e1y == 0) continue;
-      v = (e0y - (e2y * u)) / e1y;
-      if (v < 0.0) continue;
-    } else {
-      PN_stdfloat d = (e2y * e1x) - (e2x * e1y);
-      if (d == 0.0) continue;
-      u = ((e0y * e1x) - (e0x * e1y)) / d;
-      if (u < 0.0 || u > 1.0) continue;
-      v = (e0x - (e2x * u)) / e1x;
-      if (v < 0.0) continue;
+  int cx = get_grid_cell(fx, _grid_min_x, _grid_scale_x, _grid_num_x);
+  int cy = get_grid_cell(fy, _grid_min_y, _grid_scale_y, _grid_num_y);
+  size_t cell = (size_t)cy * _grid_num_x + cx;
+
+  // The triangles are listed in each cell in their original order, so we
+  // find the same one that a linear search of all triangles would.
+  for (uint32_t i = _grid_cells[cell]; i < _grid_cells[cell + 1]; ++i) {
+    const TriangleIndices &tri = _triangles[_grid_triangles[i]];
+    if (test_triangle(tri, fx, fy, z)) {
+      return &tri;
     }
-    if (u + v <= 0.0 || u + v > 1.0) continue;
-    // we collided!!
-    PN_stdfloat mag = u + v;
-    PN_stdfloat p0z = p0[2];
-
-    PN_stdfloat uz = (p2[2] - p0z) *  mag;
-    PN_stdfloat vz = (p1[2] - p0z) *  mag;
-    PN_stdfloat finalz = p0z+vz+(((uz - vz) *u)/(u+v));
-    PN_stdfloat dz = fz - finalz;
-    if(dz > rad)
-      return nullptr;
-    PT(CollisionEntry) new_entry = new CollisionEntry(entry);
-
-    new_entry->set_surface_normal(LPoint3(0, 0, 1));
-    new_entry->set_surface_point(LPoint3(fx, fy, finalz));
-    return new_entry;
   }
   return nullptr;
 }
 
+/**
+ * Returns true if the projection of the triangle onto the XY plane contains
+ * the indicated point, and fills in z with the height of the triangle at that
+ * point.
+ */
+bool CollisionFloorMesh::
+test_triangle(const TriangleIndices &tri, double fx, double fy,
+              PN_stdfloat &z) const {
+  // First do a naive bounding box check on the triangle
+  if (fx < tri.min_x || fx >= tri.max_x || fy < tri.min_y || fy >= tri.max_y) {
+    return false;
+  }
+
+  // okay, there's a good chance we'll be colliding
+  LPoint3 p0 = _vertices[tri.p1];
+  LPoint3 p1 = _vertices[tri.p2];
+  LPoint3 p2 = _vertices[tri.p3];
+  PN_stdfloat p0x = p0[0];
+  PN_stdfloat p0y = p0[1];
+  PN_stdfloat e0x, e0y, e1x, e1y, e2x, e2y;
+  PN_stdfloat u, v;
+
+  e0x = fx - p0x; e0y = fy - p0y;
+  e1x = p1[0] - p0x; e1y = p1[1] - p0y;
+  e2x = p2[0] - p0x; e2y = p2[1] - p0y;
+  if (e1x == 0.0) {
+    if (e2x == 0.0) return false;
+    u = e0x / e2x;
+    if (u < 0.0 || u > 1.0) return false;
+    if (e1y == 0) return false;
+    v = (e0y - (e2y * u)) / e1y;
+    if (v < 0.0) return false;
+  } else {
+    PN_stdfloat d = (e2y * e1x) - (e2x * e1y);
+    if (d == 0.0) return false;
+    u = ((e0y * e1x) - (e0x * e1y)) / d;
+    if (u < 0.0 || u > 1.0) return false;
+    v = (e0x - (e2x * u)) / e1x;
+    if (v < 0.0) return false;
+  }
+  if (u + v <= 0.0 || u + v > 1.0) return false;
+  // we collided!!
+  PN_stdfloat mag = u + v;
+  PN_stdfloat p0z = p0[2];
+
+  PN_stdfloat uz = (p2[2] - p0z) *  mag;
+  PN_stdfloat vz = (p1[2] - p0z) *  mag;
+  z = p0z + vz + (((uz - vz) * u) / (u + v));
+  return true;
+}
+
+/**
+ * Rebuilds the grid that indexes the triangles.  The grid has roughly one
+ * cell per triangle, so that each lookup only needs to consider a handful of
+ * triangles.  Assumes the lock is held.
+ */
+void CollisionFloorMesh::
+build_grid() {
+  _grid_stale = false;
+  _grid_cells.clear();
+  _grid_triangles.clear();
+  _grid_num_x = 0;
+  _grid_num_y = 0;
+  if (_triangles.empty()) {
+    return;
+  }
+
+  Triangles::const_iterator ti = _triangles.begin();
+  PN_stdfloat min_x = (*ti).min_x;
+  PN_stdfloat max_x = (*ti).max_x;
+  PN_stdfloat min_y = (*ti).min_y;
+  PN_stdfloat max_y = (*ti).max_y;
+  for (++ti; ti != _triangles.end(); ++ti) {
+    min_x = min(min_x, (*ti).min_x);
+    max_x = max(max_x, (*ti).max_x);
+    min_y = min(min_y, (*ti).min_y);
+    max_y = max(max_y, (*ti).max_y);
+  }
+
+  // Choose the number of cells along each axis so that the cells are roughly
+  // square, unless the mesh is degenerate in one dimension.
+  double num_triangles = (double)_triangles.size();
+  double width = max_x - min_x;
+  double height = max_y - min_y;
+  double num_x = 1.0;
+  double num_y = 1.0;
+  if (width > 0.0 && height > 0.0) {
+    num_x = sqrt(num_triangles * width / height);
+    num_y = sqrt(num_triangles * height / width);
+  } else if (width > 0.0) {
+    num_x = num_triangles;
+  } else if (height > 0.0) {
+    num_y = num_triangles;
+  }
+  const double max_cells = 4096.0;
+  _grid_num_x = (int)std::max(1.0, std::min(max_cells, floor(num_x + 0.5)));
+  _grid_num_y = (int)std::max(1.0, std::min(max_cells, floor(num_y + 0.5)));
+  _grid_min_x = min_x;
+  _grid_min_y = min_y;
+  _grid_scale_x = (width > 0.0) ? (PN_stdfloat)(_grid_num_x / width) : 0.0f;
+  _grid_scale_y = (height > 0.0) ? (PN_stdfloat)(_grid_num_y / height) : 0.0f;
+
+  // Count the triangles in each cell, then convert the counts into offsets,
+  // and finally fill in the triangles.
+  size_t num_cells = (size_t)_grid_num_x * _grid_num_y;
+  _grid_cells.assign(num_cells + 1, 0);
+  for (int pass = 0; pass < 2; ++pass) {
+    GridIndices next;
+    if (pass == 1) {
+      for (size_t c = 0; c < num_cells; ++c) {
+        _grid_cells[c + 1] += _grid_cells[c];
+      }
+      _grid_triangles.resize(_grid_cells[num_cells]);
+      next.assign(_grid_cells.begin(), _grid_cells.end() - 1);
+    }
+
+    for (size_t i = 0; i < _triangles.size(); ++i) {
+      const TriangleIndices &tri = _triangles[i];
+      int x0 = get_grid_cell(tri.min_x, _grid_min_x, _grid_scale_x, _grid_num_x);
+      int x1 = get_grid_cell(tri.max_x, _grid_min_x, _grid_scale_x, _grid_num_x);
+      int y0 = get_grid_cell(tri.min_y, _grid_min_y, _grid_scale_y, _grid_num_y);
+      int y1 = get_grid_cell(tri.max_y, _grid_min_y, _grid_scale_y, _grid_num_y);
+      for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+          size_t cell = (size_t)cy * _grid_num_x + cx;
+          if (pass == 0) {
+            ++_grid_cells[cell + 1];
+          } else {
+            _grid_triangles[next[cell]++] = (uint32_t)i;
+          }
+        }
+      }
+    }
+  }
 
+  if (collide_cat.is_debug()) {
+    collide_cat.debug()
+      << "Built " << _grid_num_x << " x " << _grid_num_y << " grid for "
+      << _triangles.size() << " floor mesh triangles, with "
+      << _grid_triangles.size() << " entries\n";
+  }
+}
 
 /**
  * Fills the _viz_geom GeomNode up with Geoms suitable for rendering this
@@ -334,11 +431,20 @@ void CollisionFloorMesh::
 write_datagram(BamWriter *manager, Datagram &me)
 {
   CollisionSolid::write_datagram(manager, me);
-  me.add_uint16(_vertices.size());
+  bool has_grid = (manager->get_file_minor_ver() >= 46);
+  if (has_grid) {
+    me.add_uint32(_vertices.size());
+  } else {
+    me.add_uint16(_vertices.size());
+  }
   for (size_t i = 0; i < _vertices.size(); i++) {
     _vertices[i].write_datagram(me);
   }
-  me.add_uint16(_triangles.size());
+  if (has_grid) {
+    me.add_uint32(_triangles.size());
+  } else {
+    me.add_uint16(_triangles.size());
+  }
   for (size_t i = 0; i < _triangles.size(); i++) {
     me.add_uint32(_triangles[i].p1);
     me.add_uint32(_triangles[i].p2);
@@ -349,6 +455,27 @@ write_datagram(BamWriter *manager, Datagram &me)
     me.add_stdfloat(_triangles[i].max_y);
 
   }
+
+  if (has_grid) {
+    // Store the grid as well, so that it needn't be rebuilt upon loading.
+    LightMutexHolder holder(_grid_lock);
+    if (_grid_stale) {
+      build_grid();
+    }
+    me.add_stdfloat(_grid_min_x);
+    me.add_stdfloat(_grid_min_y);
+    me.add_stdfloat(_grid_scale_x);
+    me.add_stdfloat(_grid_scale_y);
+    me.add_uint16(_grid_num_x);
+    me.add_uint16(_grid_num_y);
+    for (size_t i = 0; i < _grid_cells.size(); i++) {
+      me.add_uint32(_grid_cells[i]);
+    }
+    me.add_uint32(_grid_triangles.size());
+    for (size_t i = 0; i < _grid_triangles.size(); i++) {
+      me.add_uint32(_grid_triangles[i]);
+    }
+  }
 }
 
 /**
@@ -360,14 +487,15 @@ void CollisionFloorMesh::
 fillin(DatagramIterator& scan, BamReader* manager)
 {
   CollisionSolid::fillin(scan, manager);
-  unsigned int num_verts = scan.get_uint16();
+  bool has_grid = (manager->get_file_minor_ver() >= 46);
+  unsigned int num_verts = has_grid ? scan.get_uint32() : scan.get_uint16();
   for (size_t i = 0; i < num_verts; i++) {
     LPoint3 vert;
     vert.read_datagram(scan);
 
     _vertices.push_back(vert);
   }
-  unsigned int num_tris = scan.get_uint16();
+  unsigned int num_tris = has_grid ? scan.get_uint32() : scan.get_uint16();
   for (size_t i = 0; i < num_tris; i++) {
     CollisionFloorMesh::TriangleIndices tri;
 
@@ -381,6 +509,39 @@ fillin(DatagramIterator& scan, BamReader* manager)
     tri.max_y=scan.get_stdfloat();
     _triangles.push_back(tri);
   }
+
+  if (has_grid) {
+    _grid_min_x = scan.get_stdfloat();
+    _grid_min_y = scan.get_stdfloat();
+    _grid_scale_x = scan.get_stdfloat();
+    _grid_scale_y = scan.get_stdfloat();
+    _grid_num_x = scan.get_uint16();
+    _grid_num_y = scan.get_uint16();
+    if (!_triangles.empty()) {
+      size_t num_cells = (size_t)_grid_num_x * _grid_num_y;
+      _grid_cells.resize(num_cells + 1);
+      for (size_t i = 0; i <= num_cells; i++) {
+        _grid_cells[i] = scan.get_uint32();
+      }
+    }
+    _grid_triangles.resize(scan.get_uint32());
+    for (size_t i = 0; i < _grid_triangles.size(); i++) {
+      _grid_triangles[i] = scan.get_uint32();
+    }
+
+    // Make sure the grid is consistent before trusting it; otherwise, it
+    // will simply be rebuilt when it is first needed.
+    bool valid = _triangles.empty() ||
+      (_grid_num_x > 0 && _grid_num_y > 0 && _grid_cells[0] == 0 &&
+       _grid_cells.back() == _grid_triangles.size());
+    for (size_t i = 1; valid && i < _grid_cells.size(); i++) {
+      valid = (_grid_cells[i - 1] <= _grid_cells[i]);
+    }
+    for (size_t i = 0; valid && i < _grid_triangles.size(); i++) {
+      valid = (_grid_triangles[i] < _triangles.size());
+    }
+    _grid_stale = !valid;
+  }
 }
 
 /**
@@ -433,4 +594,6 @@ add_triangle(unsigned int pointA, unsigned int pointB, unsigned int pointC) {
   tri.max_y=max(max(v1[1],v2[1]),v3[1]);
 
   _triangles.push_back(tri);
+  mark_grid_stale();
+  mark_viz_stale();
 }
@@ -20,12 +20,18 @@
 #include "clipPlaneAttrib.h"
 #include "look_at.h"
 #include "pvector.h"
+#include "lightMutex.h"
 
 class GeomNode;
 
 /**
  * This object represents a solid made entirely of triangles, which will only
  * be tested again z axis aligned rays
+ *
+ * To quickly find the triangle under a given point, the triangles are
+ * indexed by a uniform two-dimensional grid over their X and Y extents, which
+ * is built on the first query after the mesh is modified, and stored in the
+ * bam file.
  */
 class EXPCL_PANDA_COLLIDE CollisionFloorMesh : public CollisionSolid {
 public:
@@ -84,6 +90,16 @@ protected:
 
   virtual void fill_viz_geom();
 
+private:
+  INLINE void mark_grid_stale();
+  void build_grid();
+  INLINE static int get_grid_cell(double v, PN_stdfloat grid_min,
+                                  PN_stdfloat grid_scale, int grid_num);
+  const TriangleIndices *find_triangle(double fx, double fy,
+                                       PN_stdfloat &z) const;
+  bool test_triangle(const TriangleIndices &tri, double fx, double fy,
+                     PN_stdfloat &z) const;
+
 private:
   typedef pvector<LPoint3> Vertices;
   typedef pvector<TriangleIndices> Triangles;
@@ -91,6 +107,23 @@ private:
   Vertices _vertices;
   Triangles _triangles;
 
+  // The grid divides the XY extents of the triangles into _grid_num_x by
+  // _grid_num_y cells; the _grid_scale values convert a distance from the
+  // grid's minimum corner into a number of cells.  The triangles whose bounding rectangles
+  // overlap cell i are listed, in order, in the range
+  // [_grid_cells[i], _grid_cells[i + 1]) of _grid_triangles.
+  typedef pvector<uint32_t> GridIndices;
+  bool _grid_stale;
+  PN_stdfloat _grid_min_x;
+  PN_stdfloat _grid_min_y;
+  PN_stdfloat _grid_scale_x;
+  PN_stdfloat _grid_scale_y;
+  int _grid_num_x;
+  int _grid_num_y;
+  GridIndices _grid_cells;
+  GridIndices _grid_triangles;
+  LightMutex _grid_lock;
+
   static PStatCollector _volume_pcollector;
   static PStatCollector _test_pcollector;
 
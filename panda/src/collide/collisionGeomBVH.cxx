@@ -0,0 +1,226 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomBVH.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "collisionGeomBVH.h"
+#include "collisionPolygon.h"
+#include "config_collide.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "boundingSphere.h"
+#include "lightMutexHolder.h"
+
+/**
+ *
+ */
+CollisionGeomBVH::
+CollisionGeomBVH(UpdateSeq modified) :
+  _modified(modified)
+{
+}
+
+/**
+ * Returns the triangles of the indicated Geom, with a hierarchy built over
+ * them, reusing a cached result if the Geom has not been modified since.
+ * Returns NULL if the Geom should instead be collided with one triangle at a
+ * time: if it has fewer than collision-bvh-threshold triangles, or if its
+ * vertices are animated or marked dynamic, and will probably change every
+ * frame anyway.
+ *
+ * The Geom must already have been determined to contain polygons.
+ */
+CPT(CollisionGeomBVH) CollisionGeomBVH::
+get_bvh(const Geom *geom, Thread *current_thread) {
+  int threshold = collision_bvh_threshold;
+  if (threshold <= 0) {
+    return nullptr;
+  }
+
+  CPT(GeomVertexData) data = geom->get_vertex_data(current_thread);
+  if (data->get_format()->get_animation().get_animation_type() != Geom::AT_none ||
+      data->get_usage_hint() == Geom::UH_stream ||
+      data->get_usage_hint() == Geom::UH_dynamic) {
+    return nullptr;
+  }
+
+  // Get a cheap upper bound on the number of triangles before we go through
+  // the trouble of decomposing the primitives.
+  if (geom->get_nested_vertices(current_thread) < threshold * 3) {
+    return nullptr;
+  }
+
+  UpdateSeq modified = get_geom_modified(geom, current_thread);
+
+  Cache *cache = get_cache();
+  {
+    LightMutexHolder holder(cache->_lock);
+    Cache::Entries::const_iterator ei = cache->_entries.find(geom);
+    if (ei != cache->_entries.end() && (*ei).second._bvh->_modified == modified) {
+      return (*ei).second._bvh;
+    }
+  }
+
+  // Build the new hierarchy without holding the lock.  Another thread might
+  // build the same one at the same time, but that's harmless.
+  PT(CollisionGeomBVH) bvh = new CollisionGeomBVH(modified);
+  bvh->add_triangles(geom, current_thread);
+  bvh->build();
+
+  if (collide_cat.is_debug()) {
+    collide_cat.debug()
+      << "Built " << *bvh << " for " << *geom << "\n";
+  }
+
+  bool is_new;
+  {
+    LightMutexHolder holder(cache->_lock);
+    Cache::Entry &entry = cache->_entries[geom];
+    is_new = (entry._bvh == nullptr);
+    entry._geom = geom;
+    entry._bvh = bvh;
+  }
+
+  if (is_new) {
+    // This must be done without holding our lock, since the callback is made
+    // with the WeakReferenceList's lock held, and it grabs our lock.  Since
+    // the caller holds a reference to the Geom, it can't be destructed now.
+    WCPT(Geom) wgeom(geom);
+    wgeom.add_callback(cache);
+  }
+
+  return bvh;
+}
+
+/**
+ * Removes all of the cached hierarchies, freeing their memory.  They will be
+ * rebuilt as needed.
+ */
+void CollisionGeomBVH::
+clear_cache() {
+  Cache *cache = get_cache();
+  Cache::Entries entries;
+  {
+    LightMutexHolder holder(cache->_lock);
+    entries.swap(cache->_entries);
+  }
+
+  Cache::Entries::const_iterator ei;
+  for (ei = entries.begin(); ei != entries.end(); ++ei) {
+    (*ei).second._geom.remove_callback(cache);
+  }
+}
+
+/**
+ * Returns the number of Geoms that currently have a cached hierarchy.
+ */
+size_t CollisionGeomBVH::
+get_cache_size() {
+  Cache *cache = get_cache();
+  LightMutexHolder holder(cache->_lock);
+  return cache->_entries.size();
+}
+
+/**
+ * Returns a sequence number that changes whenever anything that affects the
+ * triangles of the Geom changes.  Since all of these sequences are drawn from
+ * the same global counter, the largest of them suffices.
+ */
+UpdateSeq CollisionGeomBVH::
+get_geom_modified(const Geom *geom, Thread *current_thread) {
+  UpdateSeq modified = geom->get_modified(current_thread);
+
+  CPT(GeomVertexData) data = geom->get_vertex_data(current_thread);
+  modified = std::max(modified, data->get_modified(current_thread));
+
+  int array_index = data->get_format()->get_array_with(InternalName::get_vertex());
+  if (array_index >= 0) {
+    modified = std::max(modified, data->get_array(array_index)->get_modified());
+  }
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    modified = std::max(modified, geom->get_primitive(i)->get_modified());
+  }
+  return modified;
+}
+
+/**
+ * Collects the non-degenerate triangles of the Geom, and adds each one as an
+ * item bounded by its bounding sphere.  This is the same sphere that the
+ * CollisionTraverser tests each triangle against, so that a query returns a
+ * superset of the triangles that would pass that test.
+ */
+void CollisionGeomBVH::
+add_triangles(const Geom *geom, Thread *current_thread) {
+  CPT(GeomVertexData) data = geom->get_vertex_data(current_thread);
+  GeomVertexReader vertex(data, InternalName::get_vertex(), current_thread);
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) tris = geom->get_primitive(i)->decompose();
+    nassertd(tris->is_of_type(GeomTriangles::get_class_type())) continue;
+
+    GeomVertexReader index(current_thread);
+    if (tris->is_indexed()) {
+      index = GeomVertexReader(tris->get_vertices(), 0, current_thread);
+    }
+    int num_vertices = tris->get_num_vertices();
+    int first_vertex = tris->get_first_vertex();
+
+    for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+      LPoint3 v[3];
+      for (int k = 0; k < 3; ++k) {
+        if (tris->is_indexed()) {
+          vertex.set_row_unsafe(index.get_data1i());
+        } else {
+          vertex.set_row_unsafe(first_vertex + vi + k);
+        }
+        v[k] = vertex.get_data3();
+      }
+
+      if (CollisionPolygon::verify_points(v[0], v[1], v[2])) {
+        BoundingSphere sphere;
+        sphere.around(v, v + 3);
+        LVector3 radius(sphere.get_radius());
+
+        add_item(get_num_triangles(), sphere.get_center() - radius,
+                 sphere.get_center() + radius);
+        _vertices.insert(_vertices.end(), v, v + 3);
+      }
+    }
+  }
+}
+
+/**
+ * Returns the global cache of hierarchies.  It is never destructed, since
+ * Geoms may outlive static destruction and still make callbacks into it.
+ */
+CollisionGeomBVH::Cache *CollisionGeomBVH::
+get_cache() {
+  static Cache *cache = new Cache;
+  return cache;
+}
+
+/**
+ * Called when a Geom with a cached hierarchy is destructed.
+ */
+void CollisionGeomBVH::Cache::
+wp_callback(void *pointer) {
+  CPT(CollisionGeomBVH) bvh;
+  LightMutexHolder holder(_lock);
+  Entries::iterator ei = _entries.find((const Geom *)pointer);
+  if (ei != _entries.end()) {
+    // Release the hierarchy only after the lock is released.
+    bvh = std::move((*ei).second._bvh);
+    _entries.erase(ei);
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionGeomBVH.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef COLLISIONGEOMBVH_H
+#define COLLISIONGEOMBVH_H
+
+#include "pandabase.h"
+
+#include "collisionBVH.h"
+#include "weakPointerCallback.h"
+#include "weakPointerTo.h"
+#include "updateSeq.h"
+#include "lightMutex.h"
+#include "pmap.h"
+#include "geom.h"
+
+/**
+ * The triangles of a particular Geom, as seen by the CollisionTraverser when
+ * it collides with visible geometry, along with a CollisionBVH over their
+ * bounding spheres.
+ *
+ * These are built on demand by get_bvh(), and cached until the Geom, its
+ * primitives or its vertices are modified, or until the Geom is destructed.
+ */
+class EXPCL_PANDA_COLLIDE CollisionGeomBVH : public CollisionBVH {
+private:
+  CollisionGeomBVH(UpdateSeq modified);
+
+public:
+  static CPT(CollisionGeomBVH) get_bvh(const Geom *geom, Thread *current_thread);
+  static void clear_cache();
+  static size_t get_cache_size();
+
+  INLINE int get_num_triangles() const;
+  INLINE const LPoint3 *get_triangle(int n) const;
+
+private:
+  static UpdateSeq get_geom_modified(const Geom *geom, Thread *current_thread);
+  void add_triangles(const Geom *geom, Thread *current_thread);
+
+  UpdateSeq _modified;
+
+  // Three vertices per triangle.
+  typedef pvector<LPoint3> Vertices;
+  Vertices _vertices;
+
+  // This removes the cache entry for a Geom when it is destructed.
+  class Cache : public WeakPointerCallback {
+  public:
+    virtual void wp_callback(void *pointer);
+
+    class Entry {
+    public:
+      WCPT(Geom) _geom;
+      CPT(CollisionGeomBVH) _bvh;
+    };
+
+    LightMutex _lock;
+    typedef pmap<const Geom *, Entry> Entries;
+    Entries _entries;
+  };
+  static Cache *get_cache();
+};
+
+#include "collisionGeomBVH.I"
+
+#endif
@@ -134,12 +134,13 @@ handle_entries() {
       CPT(TransformState) prev_trans(from_node_path.get_prev_transform(wrt_node));
       const LPoint3 orig_prev_pos(prev_trans->get_pos());
 
-      // currently we only support spheres as the collider
-      const CollisionSphere *sphere;
-      DCAST_INTO_R(sphere, entries.front()->get_from(), false);
+      // The contact pos is the position of the collider's collision origin
+      // at the time of impact; for a sphere, this is its center.
+      const CollisionSolid *solid = entries.front()->get_from();
+      nassertr(solid != nullptr, false);
 
       from_node_path.set_pos(wrt_node, 0,0,0);
-      LPoint3 sphere_offset = (sphere->get_center() *
+      LPoint3 origin_offset = (solid->get_collision_origin() *
                                 from_node_path.get_transform(wrt_node)->get_mat());
       from_node_path.set_pos(wrt_node, orig_pos);
 
@@ -186,7 +187,7 @@ handle_entries() {
           break;
         }
         // calculate the position of the target node at the point of contact
-        contact_pos -= sphere_offset;
+        contact_pos -= origin_offset;
 
         uncollided_pos = candidate_final_pos;
         candidate_final_pos = contact_pos;
@@ -17,34 +17,13 @@
 
 TypeHandle CollisionHandlerQueue::_type_handle;
 
-// This class is used in sort_entries(), below.
-class CollisionEntrySorter {
-public:
-  CollisionEntrySorter(CollisionEntry *entry) {
-    _entry = entry;
-    if (entry->has_surface_point()) {
-      LVector3 vec =
-        entry->get_surface_point(entry->get_from_node_path()) -
-        entry->get_from()->get_collision_origin();
-      _dist2 = vec.length_squared();
-    }
-    else {
-      _dist2 = make_inf((PN_stdfloat)0);
-    }
-  }
-  bool operator < (const CollisionEntrySorter &other) const {
-    return _dist2 < other._dist2;
-  }
-
-  CollisionEntry *_entry;
-  PN_stdfloat _dist2;
-};
-
 /**
  *
  */
 CollisionHandlerQueue::
-CollisionHandlerQueue() {
+CollisionHandlerQueue() :
+  _hits_only(false)
+{
 }
 
 /**
@@ -55,6 +34,8 @@ CollisionHandlerQueue() {
 void CollisionHandlerQueue::
 begin_group() {
   _entries.clear();
+  _hits.clear();
+  _hit_nodes.clear();
 }
 
 /**
@@ -64,7 +45,28 @@ begin_group() {
 void CollisionHandlerQueue::
 add_entry(CollisionEntry *entry) {
   nassertv(entry != nullptr);
-  _entries.push_back(entry);
+  if (!_hits_only) {
+    _entries.push_back(entry);
+    return;
+  }
+
+  Hit hit;
+  hit._point = LPoint3::zero();
+  hit._normal = LVector3::zero();
+  hit._dist2 = make_inf((PN_stdfloat)0);
+  if (entry->has_surface_point() || entry->has_surface_normal()) {
+    const LMatrix4 &mat = entry->get_inv_wrt_mat();
+    if (entry->has_surface_point()) {
+      hit._point = entry->_surface_point * mat;
+      hit._dist2 = (hit._point - entry->get_from()->get_collision_origin()).length_squared();
+    }
+    if (entry->has_surface_normal()) {
+      hit._normal = mat.xform_vec(entry->_surface_normal);
+    }
+  }
+  hit._from_node = record_hit_node(entry->get_from_node());
+  hit._into_node = record_hit_node(entry->get_into_node());
+  _hits.push_back(hit);
 }
 
 /**
@@ -75,28 +77,45 @@ add_entry(CollisionEntry *entry) {
  */
 void CollisionHandlerQueue::
 sort_entries() {
-  // Build up a temporary vector of entries so we can sort the pointers.  This
-  // uses the class defined above.
-  typedef pvector<CollisionEntrySorter> Sorter;
+  if (_hits_only) {
+    std::stable_sort(_hits.begin(), _hits.end(),
+                     [](const Hit &a, const Hit &b) { return a._dist2 < b._dist2; });
+    return;
+  }
+
+  // Compute the sort key of each entry once, and sort the keys along with the
+  // indices of the entries.
+  typedef pvector<std::pair<PN_stdfloat, size_t> > Sorter;
   Sorter sorter;
   sorter.reserve(_entries.size());
 
-  Entries::const_iterator ei;
-  for (ei = _entries.begin(); ei != _entries.end(); ++ei) {
-    sorter.push_back(CollisionEntrySorter(*ei));
+  for (size_t i = 0; i < _entries.size(); ++i) {
+    const CollisionEntry *entry = _entries[i];
+    PN_stdfloat dist2;
+    if (entry->has_surface_point()) {
+      LVector3 vec =
+        entry->get_surface_point(entry->get_from_node_path()) -
+        entry->get_from()->get_collision_origin();
+      dist2 = vec.length_squared();
+    } else {
+      dist2 = make_inf((PN_stdfloat)0);
+    }
+    sorter.push_back(std::make_pair(dist2, i));
   }
 
-  sort(sorter.begin(), sorter.end());
-  nassertv(sorter.size() == _entries.size());
+  std::stable_sort(sorter.begin(), sorter.end(),
+    [](const std::pair<PN_stdfloat, size_t> &a,
+       const std::pair<PN_stdfloat, size_t> &b) {
+      return a.first < b.first;
+    });
 
-  // Now that they're sorted, get them back.  We do this in two steps,
-  // building up a temporary vector first, so we don't accidentally delete all
-  // the entries when the pointers go away.
+  // Now move the entries into their sorted order.  Moving the pointers
+  // rather than copying them avoids touching their reference counts.
   Entries sorted_entries;
   sorted_entries.reserve(sorter.size());
   Sorter::const_iterator si;
   for (si = sorter.begin(); si != sorter.end(); ++si) {
-    sorted_entries.push_back((*si)._entry);
+    sorted_entries.push_back(std::move(_entries[(*si).second]));
   }
 
   _entries.swap(sorted_entries);
@@ -108,6 +127,8 @@ sort_entries() {
 void CollisionHandlerQueue::
 clear_entries() {
   _entries.clear();
+  _hits.clear();
+  _hit_nodes.clear();
 }
 
 /**
@@ -132,7 +153,12 @@ get_entry(int n) const {
  */
 void CollisionHandlerQueue::
 output(std::ostream &out) const {
-  out << "CollisionHandlerQueue, " << _entries.size() << " entries";
+  out << "CollisionHandlerQueue, ";
+  if (_hits_only) {
+    out << _hits.size() << " hits";
+  } else {
+    out << _entries.size() << " entries";
+  }
 }
 
 /**
@@ -140,6 +166,18 @@ output(std::ostream &out) const {
  */
 void CollisionHandlerQueue::
 write(std::ostream &out, int indent_level) const {
+  if (_hits_only) {
+    indent(out, indent_level)
+      << "CollisionHandlerQueue, " << _hits.size() << " hits:\n";
+    for (const Hit &hit : _hits) {
+      indent(out, indent_level + 2)
+        << *_hit_nodes[hit._from_node] << " into "
+        << *_hit_nodes[hit._into_node] << " at " << hit._point
+        << ", normal " << hit._normal << "\n";
+    }
+    return;
+  }
+
   indent(out, indent_level)
     << "CollisionHandlerQueue, " << _entries.size() << " entries:\n";
 
@@ -148,3 +186,20 @@ write(std::ostream &out, int indent_level) const {
     (*ei)->write(out, indent_level + 2);
   }
 }
+
+/**
+ * Returns the index of the indicated node within _hit_nodes, adding it if
+ * necessary.  Since the CollisionTraverser reports all of the collisions with
+ * a given node together, it suffices to check the most recently added nodes.
+ */
+int CollisionHandlerQueue::
+record_hit_node(PandaNode *node) {
+  int num_nodes = (int)_hit_nodes.size();
+  for (int i = num_nodes - 1; i >= 0 && i >= num_nodes - 2; --i) {
+    if (_hit_nodes[i] == node) {
+      return i;
+    }
+  }
+  _hit_nodes.push_back(node);
+  return num_nodes;
+}
@@ -25,6 +25,12 @@
  * CollisionEntries detected the last pass.  This set of CollisionEntries may
  * then be queried by the calling function.  It's primarily useful when a
  * simple intersection test is being made, e.g.  for picking from the window.
+ *
+ * If hits_only is set, the queue instead records only the surface point and
+ * normal, in the coordinate space of the from node, and the nodes involved in
+ * each collision.  These are kept in a flat array, and the CollisionEntries
+ * are released immediately, so that their memory is reused for the next
+ * collision.  This is much cheaper when there are many collisions.
  */
 class EXPCL_PANDA_COLLIDE CollisionHandlerQueue : public CollisionHandler {
 PUBLISHED:
@@ -43,6 +49,16 @@ PUBLISHED:
   MAKE_SEQ(get_entries, get_num_entries, get_entry);
   MAKE_SEQ_PROPERTY(entries, get_num_entries, get_entry);
 
+  INLINE void set_hits_only(bool hits_only);
+  INLINE bool get_hits_only() const;
+  MAKE_PROPERTY(hits_only, get_hits_only, set_hits_only);
+
+  INLINE int get_num_hits() const;
+  INLINE LPoint3 get_hit_point(int n) const;
+  INLINE LVector3 get_hit_normal(int n) const;
+  INLINE CollisionNode *get_hit_from_node(int n) const;
+  INLINE PandaNode *get_hit_into_node(int n) const;
+
   void output(std::ostream &out) const;
   void write(std::ostream &out, int indent_level = 0) const;
 
@@ -52,6 +68,26 @@ private:
   typedef pvector< PT(CollisionEntry) > Entries;
   Entries _entries;
 
+  // A collision recorded in hits_only mode.  The nodes are stored as indices
+  // into _hit_nodes, so that recording a hit involves no reference counting.
+  class Hit {
+  public:
+    LPoint3 _point;
+    LVector3 _normal;
+    PN_stdfloat _dist2;
+    int _from_node;
+    int _into_node;
+  };
+  typedef pvector<Hit> Hits;
+  typedef pvector< PT(PandaNode) > HitNodes;
+
+  INLINE const Hit &get_hit(int n) const;
+  int record_hit_node(PandaNode *node);
+
+  bool _hits_only;
+  Hits _hits;
+  HitNodes _hit_nodes;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -75,4 +111,6 @@ INLINE std::ostream &operator << (std::ostream &out, const CollisionHandlerQueue
   return out;
 }
 
+#include "collisionHandlerQueue.I"
+
 #endif
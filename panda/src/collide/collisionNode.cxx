@@ -28,6 +28,7 @@
 #include "clockObject.h"
 #include "boundingSphere.h"
 #include "boundingBox.h"
+#include "finiteBoundingVolume.h"
 #include "config_mathutil.h"
 
 TypeHandle CollisionNode::_type_handle;
@@ -106,7 +107,7 @@ xform(const LMatrix4 &mat) {
     PT(CollisionSolid) solid = (*si).get_write_pointer();
     solid->xform(mat);
   }
-  mark_internal_bounds_stale();
+  mark_solids_stale();
 }
 
 /**
@@ -134,7 +135,7 @@ combine_with(PandaNode *other) {
         const COWPT(CollisionSolid) *solids_begin = &cother->_solids[0];
         const COWPT(CollisionSolid) *solids_end = solids_begin + cother->_solids.size();
         _solids.insert(_solids.end(), solids_begin, solids_end);
-        mark_internal_bounds_stale();
+        mark_solids_stale();
         return this;
       }
 
@@ -323,6 +324,48 @@ compute_internal_bounds(CPT(BoundingVolume) &internal_bounds,
   internal_vertices = 0;
 }
 
+/**
+ * Returns a hierarchy over the bounding volumes of the solids in this node,
+ * whose item indices are indices into the list of solids, or NULL if the node
+ * has fewer than collision-bvh-threshold solids.  The hierarchy is built the
+ * first time this is called after the solids have been changed.
+ */
+CPT(CollisionBVH) CollisionNode::
+get_bvh(Thread *current_thread) const {
+  int threshold = collision_bvh_threshold;
+  if (threshold <= 0 || _solids.size() < (size_t)threshold) {
+    return nullptr;
+  }
+
+  LightMutexHolder holder(_bvh_lock);
+  if (_bvh == nullptr) {
+    PT(CollisionBVH) bvh = new CollisionBVH;
+    int num_solids = (int)_solids.size();
+    for (int i = 0; i < num_solids; ++i) {
+      CPT(CollisionSolid) solid = _solids[i].get_read_pointer(current_thread);
+      CPT(BoundingVolume) bounds = solid->get_bounds();
+      if (bounds->is_empty()) {
+        // This solid can't intersect anything.
+        continue;
+      }
+      const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+      if (fbv != nullptr) {
+        bvh->add_item(i, fbv->get_min(), fbv->get_max());
+      } else {
+        bvh->add_unbounded_item(i);
+      }
+    }
+    bvh->build();
+    _bvh = bvh;
+
+    if (collide_cat.is_debug()) {
+      collide_cat.debug()
+        << "Built " << *bvh << " for " << *this << "\n";
+    }
+  }
+  return _bvh;
+}
+
 /**
  * Returns a RenderState for rendering the ghosted collision solid that
  * represents the previous frame's position, for those collision nodes that
@@ -20,6 +20,9 @@
 
 #include "collideMask.h"
 #include "pandaNode.h"
+#include "collisionBVH.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
 
 /**
  * A node in the scene graph that can hold any number of CollisionSolids.
@@ -84,7 +87,11 @@ protected:
                                        int pipeline_stage,
                                        Thread *current_thread) const;
 
+public:
+  CPT(CollisionBVH) get_bvh(Thread *current_thread = Thread::get_current_thread()) const;
+
 private:
+  INLINE void mark_solids_stale();
   CPT(RenderState) get_last_pos_state();
 
   // This data is not cycled, for now.  We assume the collision traversal will
@@ -95,6 +102,11 @@ private:
   typedef pvector< COWPT(CollisionSolid) > Solids;
   Solids _solids;
 
+  // A hierarchy over the bounds of the solids, built on demand by get_bvh()
+  // and cleared whenever the solids change.
+  mutable LightMutex _bvh_lock;
+  mutable CPT(CollisionBVH) _bvh;
+
   friend class CollisionTraverser;
 
 public:
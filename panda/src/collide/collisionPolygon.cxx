@@ -899,154 +899,68 @@ test_intersection_from_capsule(const CollisionEntry &entry) const {
   LVector3 from_radius_v =
     LVector3(capsule->get_radius(), 0.0f, 0.0f) * wrt_mat;
   PN_stdfloat from_radius_sq = from_radius_v.length_squared();
-
-  // Check if the capsule is colliding with the plane at all.
-  // Are the points on the same side of the plane?
-  if ((from_a[1] > 0) == (from_b[1] > 0)) {
-    // Yes, so calculate the distance of the closest point.
-    PN_stdfloat dist = min(cabs(from_a[1]), cabs(from_b[1]));
-    if (dist * dist > from_radius_sq) {
-      // Not currently colliding.  Did the capsule travel into the plane?
-      if (from_a[1] < 0 || !entry.get_respect_prev_transform()) {
-        return nullptr;
-      }
-
-      CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
-      if (wrt_prev_space == wrt_space) {
-        return nullptr;
-      }
-
-      // Note that we only check for a sphere at the center, since we don't
-      // know whether the capsule has undergone any rotation.
-      LPoint3 from_center = (from_a + from_b) * 0.5f;
-      LPoint3 prev_center =
-        LPoint3((capsule->get_point_a() + capsule->get_point_b()) * 0.5f) *
-        (wrt_prev_space->get_mat() * _to_2d_mat);
-
-      if (prev_center[1] > 0 || prev_center[1] > 0) {
-        // Nope, it did not.
-        return nullptr;
-      }
-
-      // Determine the intersection of the sphere with the polygon.
-      PN_stdfloat t = from_center[1] / (from_center[1] - prev_center[1]);
-      LPoint2 p(
-        prev_center[0] * t + from_center[0] * (1.0f - t),
-        prev_center[2] * t + from_center[2] * (1.0f - t));
-      LPoint2 edge_p(p);
-      PN_stdfloat edge_dist = dist_to_polygon(p, edge_p, _points);
-      if (edge_dist >= 0 && edge_dist * edge_dist > from_radius_sq) {
-        return nullptr;
-      }
-
-      if (collide_cat.is_debug()) {
-        collide_cat.debug()
-          << "intersection detected from " << entry.get_from_node_path()
-          << " into " << entry.get_into_node_path() << "\n";
-      }
-      PT(CollisionEntry) new_entry = new CollisionEntry(entry);
-      LVector3 normal = (has_effective_normal() && capsule->get_respect_effective_normal()) ? get_effective_normal() : get_normal();
-      new_entry->set_surface_normal(normal);
-
-      LMatrix4 to_3d_mat;
-      rederive_to_3d_mat(to_3d_mat);
-
-      LPoint3 deepest = (from_a[1] < from_b[1] ? capsule->get_point_b() : capsule->get_point_a()) * wrt_mat;
-      PN_stdfloat from_radius = csqrt(from_radius_sq);
-      new_entry->set_surface_point(to_3d(edge_p, to_3d_mat));
-      new_entry->set_interior_point(deepest - get_normal() * from_radius);
-
-      return new_entry;
+  PN_stdfloat from_radius = csqrt(from_radius_sq);
+
+  // Determine how far the capsule has moved since the last frame.  We don't
+  // know whether it has undergone any rotation, so we hold it at its final
+  // orientation and only consider the translation of its center.
+  LVector3 delta = LVector3::zero();
+  LVector3 delta_3d = LVector3::zero();
+  if (entry.get_respect_prev_transform()) {
+    CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
+    if (wrt_prev_space != wrt_space) {
+      LPoint3 center = (capsule->get_point_a() + capsule->get_point_b()) * 0.5f;
+      delta_3d = center * wrt_mat - center * wrt_prev_space->get_mat();
+      delta = _to_2d_mat.xform_vec(delta_3d);
     }
   }
 
-  // Order from_a and from_b so that from_a has the deepest point.
-  bool swapped = (from_a[1] < from_b[1]);
-  if (swapped) {
-    std::swap(from_a, from_b);
-  }
-
+  PN_stdfloat t = 1.0f;
   LPoint3 surface_point, interior_point;
-
-  // Is the projection of from_a onto the plane inside the polygon?
-  LPoint2 from_a_proj(from_a[0], from_a[2]);
-  if (point_is_inside(from_a_proj, _points)) {
-    // Yes, and we already checked the vertical separation earlier on, so we
-    // know that the capsule is touching the polygon near from_a.
-    LPoint3 deepest = (swapped ? capsule->get_point_b() : capsule->get_point_a()) * wrt_mat;
-    PN_stdfloat from_radius = csqrt(from_radius_sq);
-    surface_point = get_plane().project(deepest);
-    interior_point = deepest - get_normal() * from_radius;
-  }
-  else {
-    LVector3 from_direction = from_b - from_a;
-
-    // Find the point in the capsule's inner segment with the closest distance
-    // to the polygon's edges.  We effectively test a sphere around that point.
-    PN_stdfloat min_dist_sq = make_inf((PN_stdfloat)0);
-    LPoint3 poly_point;
-    LPoint3 line_point;
-
-    LPoint2 last_point = _points.back()._p;
-    for (const PointDef &pd : _points) {
-      LVector2 dir = last_point - pd._p;
-      last_point = pd._p;
-
-      double t1, t2;
-      CollisionCapsule::calc_closest_segment_points(t1, t2,
-          LPoint3(pd._p[0], 0, pd._p[1]), LVector3(dir[0], 0, dir[1]),
-          from_a, from_direction);
-
-      LPoint3 point1(pd._p[0] + dir[0] * t1, 0, pd._p[1] + dir[1] * t1);
-      LPoint3 point2 = from_a + from_direction * t2;
-      PN_stdfloat dist_sq = (point2 - point1).length_squared();
-      if (dist_sq < min_dist_sq) {
-        min_dist_sq = dist_sq;
-        poly_point = point1;
-        line_point = point2;
-      }
+  bool hit = false;
+
+  if (delta[1] > 0.0f) {
+    // The capsule is moving into the front of the polygon.  Find out during
+    // which part of the motion it overlaps the plane, and test it at
+    // successive points along that stretch of its path, spaced no further
+    // apart than its radius, so that it can't skip over the polygon.
+    PN_stdfloat t_first = 0.0f;
+    PN_stdfloat t_last = 1.0f;
+    if (!sweep_axis((from_a[1] + from_b[1]) * 0.5f, delta[1],
+                    cabs(from_a[1] - from_b[1]) * 0.5f + from_radius,
+                    t_first, t_last)) {
+      return nullptr;
     }
 
-    // Project the closest point on the segment onto the polygon.  Is this point
-    // inside the polygon?
-    LPoint2 line_point_proj(line_point[0], line_point[2]);
-    if (point_is_inside(line_point_proj, _points)) {
-      // Yes, and we already checked the vertical separation earlier on, so we
-      // know that the capsule is touching the polygon here.
-      LMatrix4 to_3d_mat;
-      rederive_to_3d_mat(to_3d_mat);
-
-      surface_point = to_3d(line_point_proj, to_3d_mat);
+    PN_stdfloat length = delta.length() * (t_last - t_first);
+    int num_steps = 0;
+    if (length > from_radius) {
+      num_steps = min((int)cceil(length / from_radius),
+                      (int)collision_sweep_max_steps);
+    }
 
-      LPoint3 interior;
-      if (IS_NEARLY_EQUAL(from_a[1], from_b[1])) {
-        // It's parallel to the polygon; we can use any point on the segment we
-        // want, so we might as well use the point we determined to be closest.
-        interior = line_point;
+    for (int i = 0; i <= num_steps && !hit; ++i) {
+      if (num_steps > 0) {
+        t = t_first + (t_last - t_first) * i / num_steps;
       } else {
-        // Use the deepest point.  FIXME: we need something better.  This
-        // pushes the capsule out way too much.
-        interior = from_a;
+        t = t_first;
       }
-      interior[1] += csqrt(from_radius_sq);
-      interior_point = interior * to_3d_mat;
+      LVector3 offset = delta * (t - 1.0f);
+      hit = intersects_capsule(from_a + offset, from_b + offset, from_radius_sq,
+                               surface_point, interior_point);
     }
-    else if (min_dist_sq < from_radius_sq) {
-      // No, but it is colliding with an edge.
-      LMatrix4 to_3d_mat;
-      rederive_to_3d_mat(to_3d_mat);
 
-      surface_point = poly_point * to_3d_mat;
+    // The capsule has moved on since it touched the polygon, so it needs to
+    // be pushed back by that much more.
+    interior_point += delta_3d * (1.0f - t);
 
-      // Make sure we calculate an interior point that lies below the polygon.
-      LVector3 dir = line_point * to_3d_mat - surface_point;
-      dir.normalize();
-      interior_point = surface_point - dir * (csqrt(from_radius_sq) - csqrt(min_dist_sq));
-    }
-    else {
-      // It is outside the polygon altogether.
-      return nullptr;
-    }
+  } else {
+    hit = intersects_capsule(from_a, from_b, from_radius_sq,
+                             surface_point, interior_point);
+  }
+
+  if (!hit) {
+    return nullptr;
   }
 
   if (collide_cat.is_debug()) {
@@ -1059,6 +973,9 @@ test_intersection_from_capsule(const CollisionEntry &entry) const {
   new_entry->set_surface_normal(normal);
   new_entry->set_surface_point(surface_point);
   new_entry->set_interior_point(interior_point);
+  new_entry->set_contact_pos(capsule->get_point_a() * wrt_mat + delta_3d * (t - 1.0f));
+  new_entry->set_contact_normal(get_normal());
+  new_entry->set_t(t);
 
   return new_entry;
 }
@@ -1086,108 +1003,99 @@ test_intersection_from_box(const CollisionEntry &entry) const {
   LVecBase3 box_y = plane_mat.get_row3(1) * from_extents[1];
   LVecBase3 box_z = plane_mat.get_row3(2) * from_extents[2];
 
-  PT(CollisionEntry) new_entry;
-
-  // Is there a separating axis between the plane and the box?
-  if (cabs(from_center[1]) <= cabs(box_x[1]) + cabs(box_y[1]) + cabs(box_z[1])) {
-    // No, there isn't.  Now do the same test for each of the box' primary axes.
-    PN_stdfloat r1, center, r2;
-
-    r1 = cabs(box_x.dot(box_x)) + cabs(box_y.dot(box_x)) + cabs(box_z.dot(box_x));
-    project(box_x, center, r2);
-    if (cabs(from_center.dot(box_x) - center) > r1 + r2) {
-      return nullptr;
+  // If the box has moved into the front of the polygon since the last frame,
+  // we sweep it along its path, so that we find the time of impact and don't
+  // miss the polygon if the box went all the way through it.  We don't know
+  // how the box has rotated in the meantime, so we hold it at its final
+  // orientation and only consider the translation.
+  LVector3 delta = LVector3::zero();
+  LVector3 delta_3d = LVector3::zero();
+  if (entry.get_respect_prev_transform()) {
+    CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
+    if (wrt_prev_space != wrt_space) {
+      delta_3d = box->get_center() * wrt_mat -
+                 box->get_center() * wrt_prev_space->get_mat();
+      delta = _to_2d_mat.xform_vec(delta_3d);
+      if (delta[1] <= 0.0f) {
+        // It is moving away from the polygon.
+        delta = LVector3::zero();
+        delta_3d = LVector3::zero();
+      }
     }
+  }
 
-    r1 = cabs(box_x.dot(box_y)) + cabs(box_y.dot(box_y)) + cabs(box_z.dot(box_y));
-    project(box_y, center, r2);
-    if (cabs(from_center.dot(box_y) - center) > r1 + r2) {
-      return nullptr;
-    }
+  // This is the fraction of the motion during which the box overlaps the
+  // polygon; each of the separating axes narrows it down further.
+  PN_stdfloat t_first = 0.0f;
+  PN_stdfloat t_last = 1.0f;
 
-    r1 = cabs(box_x.dot(box_z)) + cabs(box_y.dot(box_z)) + cabs(box_z.dot(box_z));
-    project(box_z, center, r2);
-    if (cabs(from_center.dot(box_z) - center) > r1 + r2) {
-      return nullptr;
-    }
+  // Is there a separating axis between the plane and the box?
+  if (!sweep_axis(from_center[1], delta[1],
+                  cabs(box_x[1]) + cabs(box_y[1]) + cabs(box_z[1]),
+                  t_first, t_last)) {
+    return nullptr;
+  }
 
-    // Now do the same check for the cross products between the box axes and the
-    // polygon edges.
-    Points::const_iterator pi;
-    for (pi = _points.begin(); pi != _points.end(); ++pi) {
-      const PointDef &pd = *pi;
-      LVector3 axis;
-
-      axis.set(-box_x[1] * pd._v[1],
-                box_x[0] * pd._v[1] - box_x[2] * pd._v[0],
-                box_x[1] * pd._v[0]);
-      r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
-      project(axis, center, r2);
-      if (cabs(from_center.dot(axis) - center) > r1 + r2) {
-        return nullptr;
-      }
+  // No, there isn't.  Now do the same test for each of the box' primary axes.
+  PN_stdfloat r1, center, r2;
 
-      axis.set(-box_y[1] * pd._v[1],
-                box_y[0] * pd._v[1] - box_y[2] * pd._v[0],
-                box_y[1] * pd._v[0]);
-      r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
-      project(axis, center, r2);
-      if (cabs(from_center.dot(axis) - center) > r1 + r2) {
-        return nullptr;
-      }
+  r1 = cabs(box_x.dot(box_x)) + cabs(box_y.dot(box_x)) + cabs(box_z.dot(box_x));
+  project(box_x, center, r2);
+  if (!sweep_axis(from_center.dot(box_x) - center, delta.dot(box_x), r1 + r2,
+                  t_first, t_last)) {
+    return nullptr;
+  }
 
-      axis.set(-box_z[1] * pd._v[1],
-                box_z[0] * pd._v[1] - box_z[2] * pd._v[0],
-                box_z[1] * pd._v[0]);
-      r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
-      project(axis, center, r2);
-      if (cabs(from_center.dot(axis) - center) > r1 + r2) {
-        return nullptr;
-      }
-    }
+  r1 = cabs(box_x.dot(box_y)) + cabs(box_y.dot(box_y)) + cabs(box_z.dot(box_y));
+  project(box_y, center, r2);
+  if (!sweep_axis(from_center.dot(box_y) - center, delta.dot(box_y), r1 + r2,
+                  t_first, t_last)) {
+    return nullptr;
+  }
 
-    new_entry = new CollisionEntry(entry);
+  r1 = cabs(box_x.dot(box_z)) + cabs(box_y.dot(box_z)) + cabs(box_z.dot(box_z));
+  project(box_z, center, r2);
+  if (!sweep_axis(from_center.dot(box_z) - center, delta.dot(box_z), r1 + r2,
+                  t_first, t_last)) {
+    return nullptr;
   }
-  else {
-    // There is a separating axis.  No collision, but the box may have moved
-    // through the polygon since the last frame.
-    if (from_center[1] < 0.0f || !entry.get_respect_prev_transform()) {
-      return nullptr;
-    }
 
-    CPT(TransformState) wrt_prev_space = entry.get_wrt_prev_space();
-    if (wrt_prev_space == wrt_space) {
+  // Now do the same check for the cross products between the box axes and the
+  // polygon edges.
+  Points::const_iterator pi;
+  for (pi = _points.begin(); pi != _points.end(); ++pi) {
+    const PointDef &pd = *pi;
+    LVector3 axis;
+
+    axis.set(-box_x[1] * pd._v[1],
+              box_x[0] * pd._v[1] - box_x[2] * pd._v[0],
+              box_x[1] * pd._v[0]);
+    r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
+    project(axis, center, r2);
+    if (!sweep_axis(from_center.dot(axis) - center, delta.dot(axis), r1 + r2,
+                    t_first, t_last)) {
       return nullptr;
     }
 
-    // Did the center travel into the plane of the polygon?
-    LPoint3 prev_center = box->get_center() * (wrt_prev_space->get_mat() * _to_2d_mat);
-    if (prev_center[1] > 0.0f) {
-      // Nope, it did not.
+    axis.set(-box_y[1] * pd._v[1],
+              box_y[0] * pd._v[1] - box_y[2] * pd._v[0],
+              box_y[1] * pd._v[0]);
+    r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
+    project(axis, center, r2);
+    if (!sweep_axis(from_center.dot(axis) - center, delta.dot(axis), r1 + r2,
+                    t_first, t_last)) {
       return nullptr;
     }
 
-    // We don't know how much the box has been rotated in the meantime, so we
-    // test a circle that we know fits inside the box, positioned at the box
-    // center as it was going through the plane.
-    PN_stdfloat t = from_center[1] / (from_center[1] - prev_center[1]);
-    LPoint2 p(
-      prev_center[0] * t + from_center[0] * (1.0f - t),
-      prev_center[2] * t + from_center[2] * (1.0f - t));
-    LPoint2 edge_p(p);
-    PN_stdfloat edge_dist = dist_to_polygon(p, edge_p, _points);
-    if (edge_dist > from_extents[0] ||
-        edge_dist > from_extents[1] ||
-        edge_dist > from_extents[2]) {
+    axis.set(-box_z[1] * pd._v[1],
+              box_z[0] * pd._v[1] - box_z[2] * pd._v[0],
+              box_z[1] * pd._v[0]);
+    r1 = cabs(box_x.dot(axis)) + cabs(box_y.dot(axis)) + cabs(box_z.dot(axis));
+    project(axis, center, r2);
+    if (!sweep_axis(from_center.dot(axis) - center, delta.dot(axis), r1 + r2,
+                    t_first, t_last)) {
       return nullptr;
     }
-
-    new_entry = new CollisionEntry(entry);
-
-    // This is not quite correct but close enough.
-    LMatrix4 to_3d_mat;
-    rederive_to_3d_mat(to_3d_mat);
-    new_entry->set_surface_point(to_3d(edge_p, to_3d_mat));
   }
 
   if (collide_cat.is_debug()) {
@@ -1195,13 +1103,16 @@ test_intersection_from_box(const CollisionEntry &entry) const {
       << "intersection detected from " << entry.get_from_node_path()
       << " into " << entry.get_into_node_path() << "\n";
   }
+  PT(CollisionEntry) new_entry = new CollisionEntry(entry);
 
   LVector3 normal = (has_effective_normal() && box->get_respect_effective_normal()) ? get_effective_normal() : get_normal();
   new_entry->set_surface_normal(normal);
 
   // Determine which point on the cube will be the interior point.  This is
   // the calculation that is also used for the plane, which is not perfectly
-  // applicable, but I suppose it's better than nothing.
+  // applicable, but I suppose it's better than nothing.  Since this is the
+  // deepest corner of the box in its final position, it also gives the right
+  // depth when the box has passed through the polygon entirely.
   const PN_stdfloat nearly_zero = get_nearly_zero_value((PN_stdfloat)0);
   LPoint3 interior_point = box->get_center() * wrt_mat +
     wrt_mat.get_row3(0) * from_extents[0] * ((box_x[1] > nearly_zero) - (box_x[1] < -nearly_zero)) +
@@ -1211,9 +1122,13 @@ test_intersection_from_box(const CollisionEntry &entry) const {
   new_entry->set_interior_point(interior_point);
 
   // The surface point is the interior point projected onto the plane.
-  if (!new_entry->has_surface_point()) {
-    new_entry->set_surface_point(get_plane().project(interior_point));
-  }
+  new_entry->set_surface_point(get_plane().project(interior_point));
+
+  // If the box wasn't moving, it touched the polygon at the end of the frame.
+  PN_stdfloat t = (delta_3d == LVector3::zero()) ? 1.0f : t_first;
+  new_entry->set_contact_pos(box->get_center() * wrt_mat + delta_3d * (t - 1.0f));
+  new_entry->set_contact_normal(get_normal());
+  new_entry->set_t(t);
 
   return new_entry;
 }
@@ -1502,6 +1417,116 @@ dist_to_polygon(const LPoint2 &p, LPoint2 &edge_p, const CollisionPolygon::Point
   return best_dist;
 }
 
+/**
+ * Tests a capsule, whose end points are given in the 2-d coordinate space of
+ * the polygon, against the polygon.  If they intersect, fills in the surface
+ * and interior points, in the coordinate space of the polygon, and returns
+ * true.
+ */
+bool CollisionPolygon::
+intersects_capsule(LPoint3 from_a, LPoint3 from_b, PN_stdfloat from_radius_sq,
+                   LPoint3 &surface_point, LPoint3 &interior_point) const {
+  // Check if the capsule is colliding with the plane at all.
+  // Are the points on the same side of the plane?
+  if ((from_a[1] > 0) == (from_b[1] > 0)) {
+    // Yes, so calculate the distance of the closest point.
+    PN_stdfloat dist = min(cabs(from_a[1]), cabs(from_b[1]));
+    if (dist * dist > from_radius_sq) {
+      return false;
+    }
+  }
+
+  // Order from_a and from_b so that from_a has the deepest point.
+  if (from_a[1] < from_b[1]) {
+    std::swap(from_a, from_b);
+  }
+
+  // Is the projection of from_a onto the plane inside the polygon?
+  LPoint2 from_a_proj(from_a[0], from_a[2]);
+  if (point_is_inside(from_a_proj, _points)) {
+    // Yes, and we already checked the vertical separation earlier on, so we
+    // know that the capsule is touching the polygon near from_a.
+    LMatrix4 to_3d_mat;
+    rederive_to_3d_mat(to_3d_mat);
+
+    LPoint3 deepest = from_a * to_3d_mat;
+    surface_point = get_plane().project(deepest);
+    interior_point = deepest - get_normal() * csqrt(from_radius_sq);
+    return true;
+  }
+
+  LVector3 from_direction = from_b - from_a;
+
+  // Find the point in the capsule's inner segment with the closest distance
+  // to the polygon's edges.  We effectively test a sphere around that point.
+  PN_stdfloat min_dist_sq = make_inf((PN_stdfloat)0);
+  LPoint3 poly_point;
+  LPoint3 line_point;
+
+  LPoint2 last_point = _points.back()._p;
+  for (const PointDef &pd : _points) {
+    LVector2 dir = last_point - pd._p;
+    last_point = pd._p;
+
+    double t1, t2;
+    CollisionCapsule::calc_closest_segment_points(t1, t2,
+        LPoint3(pd._p[0], 0, pd._p[1]), LVector3(dir[0], 0, dir[1]),
+        from_a, from_direction);
+
+    LPoint3 point1(pd._p[0] + dir[0] * t1, 0, pd._p[1] + dir[1] * t1);
+    LPoint3 point2 = from_a + from_direction * t2;
+    PN_stdfloat dist_sq = (point2 - point1).length_squared();
+    if (dist_sq < min_dist_sq) {
+      min_dist_sq = dist_sq;
+      poly_point = point1;
+      line_point = point2;
+    }
+  }
+
+  // Project the closest point on the segment onto the polygon.  Is this point
+  // inside the polygon?
+  LPoint2 line_point_proj(line_point[0], line_point[2]);
+  if (point_is_inside(line_point_proj, _points)) {
+    // Yes, and we already checked the vertical separation earlier on, so we
+    // know that the capsule is touching the polygon here.
+    LMatrix4 to_3d_mat;
+    rederive_to_3d_mat(to_3d_mat);
+
+    surface_point = to_3d(line_point_proj, to_3d_mat);
+
+    LPoint3 interior;
+    if (IS_NEARLY_EQUAL(from_a[1], from_b[1])) {
+      // It's parallel to the polygon; we can use any point on the segment we
+      // want, so we might as well use the point we determined to be closest.
+      interior = line_point;
+    } else {
+      // Use the deepest point.  FIXME: we need something better.  This
+      // pushes the capsule out way too much.
+      interior = from_a;
+    }
+    interior[1] += csqrt(from_radius_sq);
+    interior_point = interior * to_3d_mat;
+    return true;
+  }
+
+  if (min_dist_sq < from_radius_sq) {
+    // No, but it is colliding with an edge.
+    LMatrix4 to_3d_mat;
+    rederive_to_3d_mat(to_3d_mat);
+
+    surface_point = poly_point * to_3d_mat;
+
+    // Make sure we calculate an interior point that lies below the polygon.
+    LVector3 dir = line_point * to_3d_mat - surface_point;
+    dir.normalize();
+    interior_point = surface_point - dir * (csqrt(from_radius_sq) - csqrt(min_dist_sq));
+    return true;
+  }
+
+  // It is outside the polygon altogether.
+  return false;
+}
+
 /**
  * Projects the polygon onto the given axis, returning the center on the line
  * and the half extent.
@@ -132,6 +132,10 @@ private:
   bool point_is_inside(const LPoint2 &p, const Points &points) const;
   PN_stdfloat dist_to_polygon(const LPoint2 &p, LPoint2 &edge_p, const Points &points) const;
   void project(const LVector3 &axis, PN_stdfloat &center, PN_stdfloat &extent) const;
+  bool intersects_capsule(LPoint3 from_a, LPoint3 from_b,
+                          PN_stdfloat from_radius_sq,
+                          LPoint3 &surface_point,
+                          LPoint3 &interior_point) const;
 
   INLINE LPoint2 to_2d(const LVecBase3 &point3d) const;
   INLINE void calc_to_3d_mat(LMatrix4 &to_3d_mat) const;
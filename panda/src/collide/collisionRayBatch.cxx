@@ -0,0 +1,628 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionRayBatch.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "collisionRayBatch.h"
+#include "collisionNode.h"
+#include "collisionPolygon.h"
+#include "collisionGeom.h"
+#include "collisionBox.h"
+#include "collisionSphere.h"
+#include "collisionPlane.h"
+#include "collisionGeomBVH.h"
+#include "config_collide.h"
+#include "geomNode.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "lodNode.h"
+#include "boundingSphere.h"
+#include "finiteBoundingVolume.h"
+#include "pStatTimer.h"
+
+#include <algorithm>
+
+PStatCollector CollisionRayBatch::_traverse_pcollector("App:Collisions:Ray batch");
+
+/**
+ *
+ */
+CollisionRayBatch::
+CollisionRayBatch() :
+  _collide_mask(CollisionNode::get_default_collide_mask()),
+  _find_all(false)
+{
+}
+
+/**
+ * Removes all of the rays, and their results.
+ */
+void CollisionRayBatch::
+clear() {
+  _rays.clear();
+  _hits.clear();
+  _first_hit.clear();
+}
+
+/**
+ * Adds a ray that starts at the indicated origin and extends infinitely in
+ * the indicated direction.  Returns the index of the new ray, which is used to
+ * retrieve its results after traverse().
+ */
+int CollisionRayBatch::
+add_ray(const LPoint3 &origin, const LVector3 &direction) {
+  Ray ray;
+  ray._origin = origin;
+  ray._direction = direction;
+  ray._max_t = FLT_MAX;
+  _rays.push_back(ray);
+  return (int)_rays.size() - 1;
+}
+
+/**
+ * Adds a line segment between the two indicated points.  Returns the index of
+ * the new segment, which is used to retrieve its results after traverse().
+ */
+int CollisionRayBatch::
+add_segment(const LPoint3 &point_a, const LPoint3 &point_b) {
+  Ray ray;
+  ray._origin = point_a;
+  ray._direction = point_b - point_a;
+  ray._max_t = 1.0f;
+  _rays.push_back(ray);
+  return (int)_rays.size() - 1;
+}
+
+/**
+ * Tests all of the rays against the indicated subgraph, whose root defines
+ * the coordinate space of the rays.  Returns the total number of hits.  The
+ * results of any previous traversal are discarded.
+ */
+int CollisionRayBatch::
+traverse(const NodePath &root) {
+  nassertr(!root.is_empty(), 0);
+  PStatTimer timer(_traverse_pcollector);
+  Thread *current_thread = Thread::get_current_thread();
+
+  int num_rays = (int)_rays.size();
+  _hits.clear();
+  _first_hit.clear();
+  if (!_find_all) {
+    // Start out with a placeholder for each ray, which is replaced whenever
+    // a nearer hit is found.
+    _hits.resize(num_rays);
+    for (int i = 0; i < num_rays; ++i) {
+      _hits[i]._ray = i;
+      _hits[i]._t = _rays[i]._max_t;
+    }
+  }
+
+  LocalRays &rays = get_scratch(0);
+  rays.resize(num_rays);
+  for (int i = 0; i < num_rays; ++i) {
+    rays[i]._origin = _rays[i]._origin;
+    rays[i]._direction = _rays[i]._direction;
+    rays[i]._index = i;
+  }
+
+  // The rays are given in the coordinate space of the root node, so its own
+  // transform and bounding volume (which is in its parent's space) don't
+  // apply.
+  PandaNode *node = root.node();
+  if (!(node->get_net_collide_mask(current_thread) & _collide_mask).is_zero()) {
+    r_traverse_contents(node, LMatrix4::ident_mat(), 0, CollideMask::all_on(),
+                        current_thread);
+  }
+
+  // Now sort the hits by ray, discarding the placeholders of rays that didn't
+  // hit anything, and index them.
+  if (_find_all) {
+    std::sort(_hits.begin(), _hits.end());
+  } else {
+    _hits.erase(std::remove_if(_hits.begin(), _hits.end(),
+                               [](const Hit &hit) { return hit._node == nullptr; }),
+                _hits.end());
+  }
+
+  _first_hit.resize(num_rays + 1);
+  size_t hi = 0;
+  for (int i = 0; i < num_rays; ++i) {
+    _first_hit[i] = (int)hi;
+    while (hi < _hits.size() && _hits[hi]._ray == i) {
+      ++hi;
+    }
+  }
+  _first_hit[num_rays] = (int)hi;
+
+  return (int)_hits.size();
+}
+
+/**
+ *
+ */
+void CollisionRayBatch::
+output(std::ostream &out) const {
+  out << "CollisionRayBatch, " << _rays.size() << " rays";
+  if (!_first_hit.empty()) {
+    out << ", " << _hits.size() << " hits";
+  }
+}
+
+/**
+ * Visits the indicated node, which is a child of a node that has already
+ * been visited, with the rays that reached the parent, in the parent's
+ * coordinate space.
+ */
+void CollisionRayBatch::
+r_traverse(PandaNode *node, const LMatrix4 &parent_mat, size_t depth,
+           CollideMask include_mask, Thread *current_thread) {
+  CollideMask mask = _collide_mask & include_mask;
+  if ((node->get_net_collide_mask(current_thread) & mask).is_zero()) {
+    return;
+  }
+
+  // Keep only the rays that pass through the node's bounding volume, which
+  // is expressed in the parent's coordinate space.
+  const LocalRays &parent_rays = get_scratch(depth);
+  LocalRays &rays = get_scratch(depth + 1);
+  rays.clear();
+
+  CPT(BoundingVolume) bounds = node->get_bounds(current_thread);
+  LocalRays::const_iterator ri;
+  for (ri = parent_rays.begin(); ri != parent_rays.end(); ++ri) {
+    if (test_bounds(bounds, *ri, get_max_t((*ri)._index))) {
+      rays.push_back(*ri);
+    }
+  }
+  if (rays.empty()) {
+    return;
+  }
+
+  // Then bring them into the node's own coordinate space.  The parametric
+  // distance along each ray is unaffected by this.
+  const TransformState *transform = node->get_transform(current_thread);
+  if (transform->is_identity()) {
+    r_traverse_contents(node, parent_mat, depth + 1, include_mask,
+                        current_thread);
+
+  } else {
+    CPT(TransformState) inv_transform = transform->get_inverse();
+    if (inv_transform == nullptr || !inv_transform->has_mat()) {
+      // A singular transform.
+      return;
+    }
+    const LMatrix4 &inv_mat = inv_transform->get_mat();
+
+    LocalRays::iterator ri;
+    for (ri = rays.begin(); ri != rays.end(); ++ri) {
+      (*ri)._origin = inv_mat.xform_point((*ri)._origin);
+      (*ri)._direction = inv_mat.xform_vec((*ri)._direction);
+    }
+
+    LMatrix4 net_mat = transform->get_mat() * parent_mat;
+    r_traverse_contents(node, net_mat, depth + 1, include_mask,
+                        current_thread);
+  }
+}
+
+/**
+ * Tests the rays against the contents of the indicated node, and continues
+ * on to its children.  The rays are in the node's coordinate space, and
+ * net_mat converts from that space to that of the root.
+ */
+void CollisionRayBatch::
+r_traverse_contents(PandaNode *node, const LMatrix4 &net_mat, size_t depth,
+                    CollideMask include_mask, Thread *current_thread) {
+  CollideMask mask = _collide_mask & include_mask;
+
+  if (node->is_collision_node()) {
+    const CollisionNode *cnode = (const CollisionNode *)node;
+    if (!(cnode->get_into_collide_mask() & mask).is_zero()) {
+      collide_with_node(cnode, net_mat, get_scratch(depth), current_thread);
+    }
+
+  } else if (node->is_geom_node()) {
+    const GeomNode *gnode = (const GeomNode *)node;
+    if (!(gnode->get_into_collide_mask() & mask).is_zero()) {
+      GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+      int num_geoms = geoms.get_num_geoms();
+      for (int i = 0; i < num_geoms; ++i) {
+        CPT(Geom) geom = geoms.get_geom(i);
+        if (geom->get_primitive_type() == Geom::PT_polygons) {
+          collide_with_geom(gnode, geom, net_mat, get_scratch(depth),
+                            current_thread);
+        }
+      }
+    }
+  }
+
+  // The children are visited following the same rules as the
+  // CollisionTraverser.
+  if (node->has_single_child_visibility()) {
+    int index = node->get_visible_child();
+    if (index >= 0 && index < node->get_num_children(current_thread)) {
+      r_traverse(node->get_child(index, current_thread), net_mat, depth,
+                 include_mask, current_thread);
+    }
+
+  } else if (node->is_lod_node()) {
+    // Visible geometry is only considered at the lowest level of detail.
+    int index = DCAST(LODNode, node)->get_lowest_switch();
+    PandaNode::Children children = node->get_children(current_thread);
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      CollideMask child_mask = include_mask;
+      if (i != index) {
+        child_mask &= ~GeomNode::get_default_collide_mask();
+      }
+      r_traverse(children.get_child(i), net_mat, depth, child_mask,
+                 current_thread);
+    }
+
+  } else {
+    PandaNode::Children children = node->get_children(current_thread);
+    int num_children = children.get_num_children();
+    for (int i = 0; i < num_children; ++i) {
+      r_traverse(children.get_child(i), net_mat, depth, include_mask,
+                 current_thread);
+    }
+  }
+}
+
+/**
+ * Tests the rays against the solids of the indicated CollisionNode.
+ */
+void CollisionRayBatch::
+collide_with_node(const CollisionNode *cnode, const LMatrix4 &net_mat,
+                  const LocalRays &rays, Thread *current_thread) {
+  PandaNode *node = (PandaNode *)cnode;
+  CPT(CollisionBVH) bvh = cnode->get_bvh(current_thread);
+
+  LocalRays::const_iterator ri;
+  for (ri = rays.begin(); ri != rays.end(); ++ri) {
+    const LocalRay &ray = (*ri);
+    PN_stdfloat max_t = get_max_t(ray._index);
+
+    if (bvh != nullptr) {
+      // Let the hierarchy find the solids along the ray, nearest first.
+      bvh->traverse_ray(ray._origin, ray._direction, max_t, [&](int index) {
+        CPT(CollisionSolid) solid = cnode->get_solid(index);
+        PN_stdfloat t;
+        LVector3 normal;
+        if (test_solid(solid, ray, max_t, t, normal)) {
+          record_hit(ray._index, t, normal, net_mat, node);
+          max_t = get_max_t(ray._index);
+        }
+      });
+
+    } else {
+      size_t num_solids = cnode->get_num_solids();
+      for (size_t i = 0; i < num_solids; ++i) {
+        CPT(CollisionSolid) solid = cnode->get_solid(i);
+        PN_stdfloat t;
+        LVector3 normal;
+        if (test_solid(solid, ray, max_t, t, normal)) {
+          record_hit(ray._index, t, normal, net_mat, node);
+          max_t = get_max_t(ray._index);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Tests the rays against the triangles of the indicated Geom.
+ */
+void CollisionRayBatch::
+collide_with_geom(const GeomNode *gnode, const Geom *geom,
+                  const LMatrix4 &net_mat, const LocalRays &rays,
+                  Thread *current_thread) {
+  PandaNode *node = (PandaNode *)gnode;
+  CPT(BoundingVolume) geom_bounds = geom->get_bounds(current_thread);
+
+  CPT(CollisionGeomBVH) bvh = CollisionGeomBVH::get_bvh(geom, current_thread);
+  if (bvh != nullptr) {
+    LocalRays::const_iterator ri;
+    for (ri = rays.begin(); ri != rays.end(); ++ri) {
+      const LocalRay &ray = (*ri);
+      PN_stdfloat max_t = get_max_t(ray._index);
+
+      bvh->traverse_ray(ray._origin, ray._direction, max_t, [&](int n) {
+        const LPoint3 *v = bvh->get_triangle(n);
+        PN_stdfloat t;
+        if (test_triangle(v[0], v[1], v[2], ray, max_t, t)) {
+          LVector3 normal = (v[1] - v[0]).cross(v[2] - v[0]);
+          record_hit(ray._index, t, normal, net_mat, node);
+          max_t = get_max_t(ray._index);
+        }
+      });
+    }
+    return;
+  }
+
+  // The Geom is small or animated, so just walk through its triangles.  First
+  // find the rays that might hit it at all.
+  LocalRays geom_rays;
+  LocalRays::const_iterator ri;
+  for (ri = rays.begin(); ri != rays.end(); ++ri) {
+    if (test_bounds(geom_bounds, *ri, get_max_t((*ri)._index))) {
+      geom_rays.push_back(*ri);
+    }
+  }
+  if (geom_rays.empty()) {
+    return;
+  }
+
+  CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
+  GeomVertexReader vertex(data, InternalName::get_vertex(), current_thread);
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) tris = geom->get_primitive(i)->decompose();
+    nassertd(tris->is_of_type(GeomTriangles::get_class_type())) continue;
+
+    GeomVertexReader index(current_thread);
+    if (tris->is_indexed()) {
+      index = GeomVertexReader(tris->get_vertices(), 0, current_thread);
+    }
+    int num_vertices = tris->get_num_vertices();
+    int first_vertex = tris->get_first_vertex();
+
+    for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+      LPoint3 v[3];
+      for (int k = 0; k < 3; ++k) {
+        if (tris->is_indexed()) {
+          vertex.set_row_unsafe(index.get_data1i());
+        } else {
+          vertex.set_row_unsafe(first_vertex + vi + k);
+        }
+        v[k] = vertex.get_data3();
+      }
+
+      for (ri = geom_rays.begin(); ri != geom_rays.end(); ++ri) {
+        const LocalRay &ray = (*ri);
+        PN_stdfloat t;
+        if (test_triangle(v[0], v[1], v[2], ray, get_max_t(ray._index), t)) {
+          LVector3 normal = (v[1] - v[0]).cross(v[2] - v[0]);
+          record_hit(ray._index, t, normal, net_mat, node);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Tests the ray against the indicated solid.  If there is an intersection in
+ * the range [0, max_t], fills in t and the surface normal, in the solid's
+ * coordinate space, and returns true.
+ */
+bool CollisionRayBatch::
+test_solid(const CollisionSolid *solid, const LocalRay &ray,
+           PN_stdfloat max_t, PN_stdfloat &t, LVector3 &normal) {
+  TypeHandle type = solid->get_type();
+
+  if (type == CollisionPolygon::get_class_type() ||
+      type == CollisionGeom::get_class_type()) {
+    const CollisionPolygon *poly = (const CollisionPolygon *)solid;
+    size_t num_points = poly->get_num_points();
+    if (num_points < 3) {
+      return false;
+    }
+    // A CollisionPolygon is convex, so we can test it as a triangle fan.
+    LPoint3 p0 = poly->get_point(0);
+    LPoint3 p1 = poly->get_point(1);
+    for (size_t i = 2; i < num_points; ++i) {
+      LPoint3 p2 = poly->get_point(i);
+      if (test_triangle(p0, p1, p2, ray, max_t, t)) {
+        normal = (poly->has_effective_normal() && respect_effective_normal)
+          ? poly->get_effective_normal() : poly->get_normal();
+        return true;
+      }
+      p1 = p2;
+    }
+    return false;
+
+  } else if (type == CollisionBox::get_class_type()) {
+    const CollisionBox *box = (const CollisionBox *)solid;
+    const LPoint3 &min_point = box->get_min();
+    const LPoint3 &max_point = box->get_max();
+
+    PN_stdfloat t1 = -FLT_MAX;
+    PN_stdfloat t2 = FLT_MAX;
+    for (int a = 0; a < 3; ++a) {
+      if (ray._direction[a] == 0.0f) {
+        if (ray._origin[a] < min_point[a] || ray._origin[a] > max_point[a]) {
+          return false;
+        }
+      } else {
+        PN_stdfloat inv = 1.0f / ray._direction[a];
+        PN_stdfloat ta = (min_point[a] - ray._origin[a]) * inv;
+        PN_stdfloat tb = (max_point[a] - ray._origin[a]) * inv;
+        if (ta > tb) {
+          std::swap(ta, tb);
+        }
+        t1 = std::max(t1, ta);
+        t2 = std::min(t2, tb);
+      }
+    }
+    if (t1 > t2 || t2 < 0.0f) {
+      return false;
+    }
+    // If the origin is inside the box, the exit is the surface point, as in
+    // CollisionBox::test_intersection_from_ray().
+    t = (t1 < 0.0f) ? t2 : t1;
+    if (t > max_t) {
+      return false;
+    }
+
+    if (box->has_effective_normal() && respect_effective_normal) {
+      normal = box->get_effective_normal();
+    } else {
+      LPoint3 point = ray._origin + ray._direction * t;
+      normal.set(
+        IS_NEARLY_EQUAL(point[0], max_point[0]) - IS_NEARLY_EQUAL(point[0], min_point[0]),
+        IS_NEARLY_EQUAL(point[1], max_point[1]) - IS_NEARLY_EQUAL(point[1], min_point[1]),
+        IS_NEARLY_EQUAL(point[2], max_point[2]) - IS_NEARLY_EQUAL(point[2], min_point[2]));
+    }
+    return true;
+
+  } else if (type == CollisionSphere::get_class_type()) {
+    const CollisionSphere *sphere = (const CollisionSphere *)solid;
+    LVector3 offset = ray._origin - sphere->get_center();
+    PN_stdfloat radius = sphere->get_radius();
+
+    PN_stdfloat a = ray._direction.dot(ray._direction);
+    if (a == 0.0f) {
+      return false;
+    }
+    PN_stdfloat b = 2.0f * ray._direction.dot(offset);
+    PN_stdfloat c = offset.dot(offset) - radius * radius;
+    PN_stdfloat radical = b * b - 4.0f * a * c;
+    if (radical < 0.0f) {
+      return false;
+    }
+    PN_stdfloat root = csqrt(radical);
+    PN_stdfloat t2 = (-b + root) / (2.0f * a);
+    if (t2 < 0.0f) {
+      return false;
+    }
+    t = std::max((-b - root) / (2.0f * a), (PN_stdfloat)0.0f);
+    if (t > max_t) {
+      return false;
+    }
+
+    if (sphere->has_effective_normal() && respect_effective_normal) {
+      normal = sphere->get_effective_normal();
+    } else {
+      normal = ray._origin + ray._direction * t - sphere->get_center();
+    }
+    return true;
+
+  } else if (type == CollisionPlane::get_class_type()) {
+    const CollisionPlane *plane = (const CollisionPlane *)solid;
+    const LPlane &lplane = plane->get_plane();
+    if (lplane.dist_to_plane(ray._origin) < 0.0f) {
+      // The origin is behind the plane, which counts as a hit.
+      t = 0.0f;
+    } else if (!lplane.intersects_line(t, ray._origin, ray._direction) ||
+               t < 0.0f || t > max_t) {
+      return false;
+    }
+
+    normal = (plane->has_effective_normal() && respect_effective_normal)
+      ? plane->get_effective_normal() : plane->get_normal();
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Returns true if the part of the ray in the range [0, max_t] might intersect
+ * the indicated bounding volume.
+ */
+bool CollisionRayBatch::
+test_bounds(const BoundingVolume *bounds, const LocalRay &ray,
+            PN_stdfloat max_t) {
+  if (bounds->is_empty()) {
+    return false;
+  }
+  if (bounds->is_infinite()) {
+    return true;
+  }
+
+  const BoundingSphere *sphere = bounds->as_bounding_sphere();
+  if (sphere != nullptr) {
+    // Find the point on the ray nearest to the center.
+    LVector3 offset = sphere->get_center() - ray._origin;
+    PN_stdfloat length_sq = ray._direction.length_squared();
+    PN_stdfloat t = 0.0f;
+    if (length_sq != 0.0f) {
+      t = std::min(std::max(offset.dot(ray._direction) / length_sq,
+                            (PN_stdfloat)0.0f), max_t);
+    }
+    LVector3 v = offset - ray._direction * t;
+    PN_stdfloat radius = sphere->get_radius();
+    return v.length_squared() <= radius * radius;
+  }
+
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv != nullptr) {
+    LPoint3 min_point = fbv->get_min();
+    LPoint3 max_point = fbv->get_max();
+    PN_stdfloat t1 = 0.0f;
+    PN_stdfloat t2 = max_t;
+    for (int a = 0; a < 3; ++a) {
+      if (ray._direction[a] == 0.0f) {
+        if (ray._origin[a] < min_point[a] || ray._origin[a] > max_point[a]) {
+          return false;
+        }
+      } else {
+        PN_stdfloat inv = 1.0f / ray._direction[a];
+        PN_stdfloat ta = (min_point[a] - ray._origin[a]) * inv;
+        PN_stdfloat tb = (max_point[a] - ray._origin[a]) * inv;
+        if (ta > tb) {
+          std::swap(ta, tb);
+        }
+        t1 = std::max(t1, ta);
+        t2 = std::min(t2, tb);
+        if (t1 > t2) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Some other kind of volume, such as a plane; just assume it intersects.
+  return true;
+}
+
+/**
+ * Records a hit of the indicated ray at the parametric distance t, with a
+ * normal in the coordinate space given by net_mat.  In the default mode, this
+ * replaces the previous hit of the ray if it is nearer.
+ */
+void CollisionRayBatch::
+record_hit(int ray, PN_stdfloat t, const LVector3 &normal,
+           const LMatrix4 &net_mat, PandaNode *node) {
+  LVector3 net_normal = net_mat.xform_vec_general(normal);
+  net_normal.normalize();
+
+  if (_find_all) {
+    Hit hit;
+    hit._ray = ray;
+    hit._t = t;
+    hit._normal = net_normal;
+    hit._node = node;
+    _hits.push_back(std::move(hit));
+
+  } else {
+    Hit &hit = _hits[ray];
+    if (t < hit._t || hit._node == nullptr) {
+      hit._t = t;
+      hit._normal = net_normal;
+      hit._node = node;
+    }
+  }
+}
+
+/**
+ * Returns the list of rays at the indicated depth of the traversal, which is
+ * reused from one traversal to the next to avoid reallocating it.
+ */
+CollisionRayBatch::LocalRays &CollisionRayBatch::
+get_scratch(size_t depth) {
+  while (_scratch.size() <= depth) {
+    _scratch.push_back(LocalRays());
+  }
+  return _scratch[depth];
+}
@@ -0,0 +1,164 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file collisionRayBatch.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef COLLISIONRAYBATCH_H
+#define COLLISIONRAYBATCH_H
+
+#include "pandabase.h"
+
+#include "referenceCount.h"
+#include "collideMask.h"
+#include "pandaNode.h"
+#include "nodePath.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pdeque.h"
+#include "pStatCollector.h"
+
+class CollisionNode;
+class CollisionSolid;
+class GeomNode;
+class Geom;
+
+/**
+ * Casts a large number of rays and line segments into the scene graph at
+ * once, for picking, line-of-sight and hit-scan tests.
+ *
+ * This is a lighter-weight alternative to adding a CollisionRay or
+ * CollisionSegment to a CollisionTraverser and collecting the results in a
+ * CollisionHandlerQueue.  The scene graph is walked only once for the whole
+ * batch, culling the set of rays still under consideration against the
+ * bounding volume of each node, and the hits are stored in a flat array
+ * rather than as CollisionEntry objects.  By default only the closest hit of
+ * each ray is kept, which allows the farther parts of the scene to be culled
+ * as soon as a ray has found something.
+ *
+ * Rays are collided with CollisionPolygons, CollisionBoxes,
+ * CollisionSpheres and CollisionPlanes, and with visible geometry.  Other
+ * kinds of solids are ignored, as are clip planes and the previous transform.
+ * All points and normals are given in the coordinate space of the root node
+ * passed to traverse().
+ */
+class EXPCL_PANDA_COLLIDE CollisionRayBatch : public ReferenceCount {
+PUBLISHED:
+  CollisionRayBatch();
+
+  void clear();
+  int add_ray(const LPoint3 &origin, const LVector3 &direction);
+  int add_segment(const LPoint3 &point_a, const LPoint3 &point_b);
+  INLINE int get_num_rays() const;
+
+  INLINE void set_collide_mask(CollideMask mask);
+  INLINE CollideMask get_collide_mask() const;
+  MAKE_PROPERTY(collide_mask, get_collide_mask, set_collide_mask);
+
+  INLINE void set_find_all(bool find_all);
+  INLINE bool get_find_all() const;
+  MAKE_PROPERTY(find_all, get_find_all, set_find_all);
+
+  int traverse(const NodePath &root);
+
+  INLINE bool has_hit(int ray) const;
+  INLINE int get_num_hits(int ray) const;
+  INLINE PN_stdfloat get_hit_t(int ray, int n = 0) const;
+  INLINE LPoint3 get_hit_point(int ray, int n = 0) const;
+  INLINE LVector3 get_hit_normal(int ray, int n = 0) const;
+  INLINE PandaNode *get_hit_node(int ray, int n = 0) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  class Ray {
+  public:
+    LPoint3 _origin;
+    LVector3 _direction;
+    PN_stdfloat _max_t;
+  };
+
+  // A ray transformed into the coordinate space of a particular node.
+  class LocalRay {
+  public:
+    LPoint3 _origin;
+    LVector3 _direction;
+    int _index;
+  };
+  typedef pvector<LocalRay> LocalRays;
+
+  class Hit {
+  public:
+    INLINE bool operator < (const Hit &other) const;
+
+    int _ray;
+    PN_stdfloat _t;
+    LVector3 _normal;
+    PT(PandaNode) _node;
+  };
+  typedef pvector<Hit> Hits;
+
+  void r_traverse(PandaNode *node, const LMatrix4 &parent_mat, size_t depth,
+                  CollideMask include_mask, Thread *current_thread);
+  void r_traverse_contents(PandaNode *node, const LMatrix4 &net_mat,
+                           size_t depth, CollideMask include_mask,
+                           Thread *current_thread);
+
+  void collide_with_node(const CollisionNode *cnode, const LMatrix4 &net_mat,
+                         const LocalRays &rays, Thread *current_thread);
+  void collide_with_geom(const GeomNode *gnode, const Geom *geom,
+                         const LMatrix4 &net_mat, const LocalRays &rays,
+                         Thread *current_thread);
+
+  static bool test_solid(const CollisionSolid *solid, const LocalRay &ray,
+                         PN_stdfloat max_t, PN_stdfloat &t, LVector3 &normal);
+  static bool test_bounds(const BoundingVolume *bounds, const LocalRay &ray,
+                          PN_stdfloat max_t);
+  INLINE static bool test_triangle(const LPoint3 &v0, const LPoint3 &v1,
+                                   const LPoint3 &v2, const LocalRay &ray,
+                                   PN_stdfloat max_t, PN_stdfloat &t);
+
+  INLINE PN_stdfloat get_max_t(int ray) const;
+  void record_hit(int ray, PN_stdfloat t, const LVector3 &normal,
+                  const LMatrix4 &net_mat, PandaNode *node);
+
+  INLINE const Hit &get_hit(int ray, int n) const;
+  LocalRays &get_scratch(size_t depth);
+
+private:
+  typedef pvector<Ray> Rays;
+  Rays _rays;
+
+  CollideMask _collide_mask;
+  bool _find_all;
+
+  // While traversing in find-all mode, all hits are appended to _hits; they
+  // are sorted by ray and t afterwards.  Otherwise, _hits is kept parallel to
+  // _rays and holds the closest hit so far, with a NULL _node if none.
+  Hits _hits;
+
+  // The index of the first hit of each ray in _hits, plus one past the end.
+  pvector<int> _first_hit;
+
+  // The rays that remain at each level of the traversal, in the coordinate
+  // space of the node at that level.
+  pdeque<LocalRays> _scratch;
+
+  static PStatCollector _traverse_pcollector;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CollisionRayBatch &batch) {
+  batch.output(out);
+  return out;
+}
+
+#include "collisionRayBatch.I"
+
+#endif
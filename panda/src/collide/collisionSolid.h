@@ -118,6 +118,10 @@ protected:
                                                  TypeHandle into_type);
   static void report_undefined_from_intersection(TypeHandle from_type);
 
+  INLINE static bool sweep_axis(PN_stdfloat dist, PN_stdfloat delta,
+                                PN_stdfloat extent,
+                                PN_stdfloat &t_first, PN_stdfloat &t_last);
+
   INLINE void mark_viz_stale();
   virtual void fill_viz_geom();
 
@@ -16,6 +16,7 @@
 #include "collisionEntry.h"
 #include "collisionPolygon.h"
 #include "collisionGeom.h"
+#include "collisionGeomBVH.h"
 #include "collisionRecorder.h"
 #include "collisionVisualizer.h"
 #include "collisionSphere.h"
@@ -1153,6 +1154,26 @@ compare_collider_to_node(CollisionEntry &entry,
       nassertv(ci != _colliders.end());
       entry.test_intersection((*ci).second, this);
     } else {
+      // If the node has many solids, ask its hierarchy which of them are near
+      // enough to the collider to be worth testing.  They are sorted so that
+      // they are tested in the same order as they would be otherwise.
+      CPT(CollisionBVH) bvh;
+      if (from_node_gbv != nullptr) {
+        bvh = cnode->get_bvh(current_thread);
+      }
+      vector_int indices;
+      if (bvh != nullptr && bvh->query(from_node_gbv, indices)) {
+        std::sort(indices.begin(), indices.end());
+        for (int index : indices) {
+          entry._into = cnode->_solids[index].get_read_pointer(current_thread);
+
+          CPT(BoundingVolume) solid_bv = entry._into->get_bounds();
+          compare_collider_to_solid(entry, from_node_gbv,
+                                    solid_bv->as_geometric_bounding_volume());
+        }
+        return;
+      }
+
       CollisionNode::Solids::const_iterator si;
       for (si = cnode->_solids.begin(); si != cnode->_solids.end(); ++si) {
         entry._into = (*si).get_read_pointer(current_thread);
@@ -1265,6 +1286,33 @@ compare_collider_to_geom(CollisionEntry &entry, const Geom *geom,
 
     if (geom->get_primitive_type() == Geom::PT_polygons) {
       Thread *current_thread = Thread::get_current_thread();
+
+      // If the Geom has many triangles, ask its cached hierarchy which of
+      // them are near enough to the collider to be worth testing.
+      CPT(CollisionGeomBVH) bvh;
+      if (from_node_gbv != nullptr) {
+        bvh = CollisionGeomBVH::get_bvh(geom, current_thread);
+      }
+      vector_int triangles;
+      if (bvh != nullptr && bvh->query(from_node_gbv, triangles)) {
+        std::sort(triangles.begin(), triangles.end());
+        for (int n : triangles) {
+          const LPoint3 *v = bvh->get_triangle(n);
+
+          BoundingSphere sphere;
+          sphere.around(v, v + 3);
+#ifdef DO_PSTATS
+          CollisionGeom::_volume_pcollector.add_level(1);
+#endif  // DO_PSTATS
+          if (sphere.contains(from_node_gbv) != 0) {
+            PT(CollisionGeom) cgeom = new CollisionGeom(v[0], v[1], v[2]);
+            entry._into = cgeom;
+            entry.test_intersection((*ci).second, this);
+          }
+        }
+        return;
+      }
+
       CPT(GeomVertexData) data = geom->get_animated_vertex_data(true, current_thread);
       GeomVertexReader vertex(data, InternalName::get_vertex());
 
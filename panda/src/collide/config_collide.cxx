@@ -111,6 +111,23 @@ ConfigVariableBool pushers_horizontal
           "set_horizontal() flag by default, false to let the move "
           "in three dimensions by default."));
 
+ConfigVariableInt collision_bvh_threshold
+("collision-bvh-threshold", 64,
+ PRC_DESC("When a CollisionTraverser tests a collider against a Geom with at "
+          "least this many triangles, or a CollisionNode with at least this "
+          "many solids, it builds and caches a bounding volume hierarchy "
+          "over them, so that only the nearby triangles or solids are "
+          "tested.  The hierarchy is rebuilt whenever the Geom or "
+          "CollisionNode is modified.  Set this to 0 to disable it."));
+
+ConfigVariableInt collision_sweep_max_steps
+("collision-sweep-max-steps", 16,
+ PRC_DESC("When respect-prev-transform is in effect, a CollisionCapsule is "
+          "tested at several points along the path it took since the "
+          "previous frame, spaced no further apart than its radius.  This "
+          "limits the number of points tested for a single collision, for "
+          "capsules that move very far relative to their size."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -30,6 +30,8 @@ extern EXPCL_PANDA_COLLIDE ConfigVariableDouble collision_parabola_bounds_thresh
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_parabola_bounds_sample;
 extern EXPCL_PANDA_COLLIDE ConfigVariableInt fluid_cap_amount;
 extern EXPCL_PANDA_COLLIDE ConfigVariableBool pushers_horizontal;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_bvh_threshold;
+extern EXPCL_PANDA_COLLIDE ConfigVariableInt collision_sweep_max_steps;
 
 extern EXPCL_PANDA_COLLIDE void init_libcollide();
 
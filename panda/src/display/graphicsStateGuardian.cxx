@@ -16,6 +16,7 @@
  */
 
 #include "graphicsStateGuardian.h"
+#include "lightMutexHolder.h"
 #include "graphicsEngine.h"
 #include "config_display.h"
 #include "textureContext.h"
@@ -3780,6 +3781,72 @@ ensure_generated_shader(const RenderState *state) {
 #endif
 }
 
+/**
+ * Called by prepare_scene() for each state that will be used to render the
+ * scene.  Rather than generating the shader for the state immediately, as
+ * ensure_generated_shader() does, the state is queued up until the next call
+ * to flush_generated_shaders(), so that the shaders for all of the states may
+ * be generated in one batch.
+ */
+void GraphicsStateGuardian::
+enqueue_generated_shader(const RenderState *state) {
+#ifdef HAVE_CG
+  const ShaderAttrib *shader_attrib;
+  state->get_attrib_def(shader_attrib);
+
+  if (shader_attrib->auto_shader() &&
+      (state->_generated_shader == nullptr ||
+       state->_generated_shader_seq != _generated_shader_seq)) {
+    LightMutexHolder holder(_pending_generated_shaders_lock);
+    _pending_generated_shaders.push_back(state);
+  }
+#endif
+}
+
+/**
+ * Generates the shaders for all of the states queued up by
+ * enqueue_generated_shader().  The ShaderGenerator may spread this work over
+ * several threads; see shader-generator-threads.
+ */
+void GraphicsStateGuardian::
+flush_generated_shaders() {
+#ifdef HAVE_CG
+  PendingShaderStates states;
+  {
+    LightMutexHolder holder(_pending_generated_shaders_lock);
+    states.swap(_pending_generated_shaders);
+  }
+  if (states.empty()) {
+    return;
+  }
+
+  if (_shader_generator == nullptr) {
+    if (!_supports_basic_shaders) {
+      return;
+    }
+    _shader_generator = new ShaderGenerator(this);
+  }
+
+  pvector<GeomVertexAnimationSpec> specs(states.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    const ShaderAttrib *sattr;
+    states[i]->get_attrib_def(sattr);
+    if (sattr->get_flag(ShaderAttrib::F_hardware_skinning)) {
+      specs[i].set_hardware(4, true);
+    }
+  }
+
+  pvector<CPT(ShaderAttrib)> results;
+  _shader_generator->synthesize_shaders(states, specs, results);
+  nassertv(results.size() == states.size());
+
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i]->_generated_shader = results[i];
+    states[i]->_generated_shader_seq = _generated_shader_seq;
+  }
+#endif
+}
+
 /**
  * Returns true if the GSG implements the extension identified by the given
  * string.  This currently is only implemented by the OpenGL back-end.
@@ -50,6 +50,7 @@
 #include "texGenAttrib.h"
 #include "textureAttrib.h"
 #include "shaderGenerator.h"
+#include "lightMutex.h"
 
 class DrawableRegion;
 class GraphicsEngine;
@@ -442,6 +443,8 @@ public:
   virtual GraphicsOutput *make_shadow_buffer(LightLensNode *light, Texture *tex, GraphicsOutput *host);
 
   virtual void ensure_generated_shader(const RenderState *state);
+  virtual void enqueue_generated_shader(const RenderState *state);
+  virtual void flush_generated_shaders();
 
 #ifdef DO_PSTATS
   static void init_frame_pstats();
@@ -656,6 +659,11 @@ protected:
 
   PT(ShaderGenerator) _shader_generator;
 
+  // States queued by prepare_scene() for the shader generator.
+  typedef pvector<CPT(RenderState)> PendingShaderStates;
+  PendingShaderStates _pending_generated_shaders;
+  LightMutex _pending_generated_shaders_lock;
+
 #ifndef NDEBUG
   PT(Texture) _flash_texture;
 #else
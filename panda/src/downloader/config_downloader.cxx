@@ -109,6 +109,19 @@ ConfigVariableInt http_max_connect_count
           "prevent the code from attempting runaway connections; this limit "
           "should never be reached in practice."));
 
+ConfigVariableInt http_download_connections
+("http-download-connections", 4,
+ PRC_DESC("This is the default maximum number of simultaneous connections "
+          "that an HTTPDownloadManager will open to any one server.  See "
+          "HTTPDownloadManager::set_max_connections_per_host()."));
+
+ConfigVariableInt http_download_range_size
+("http-download-range-size", 4 * 1024 * 1024,
+ PRC_DESC("This is the default number of bytes that an HTTPDownloadManager "
+          "requests from the server at once.  Documents larger than this "
+          "are fetched in several pieces, in parallel.  See "
+          "HTTPDownloadManager::set_range_size()."));
+
 ConfigVariableInt tcp_header_size
 ("tcp-header-size", 2,
  PRC_DESC("Specifies the number of bytes to use to specify the datagram "
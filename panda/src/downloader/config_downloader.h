@@ -43,6 +43,8 @@ extern ConfigVariableDouble http_timeout;
 extern ConfigVariableInt http_skip_body_size;
 extern ConfigVariableDouble http_idle_timeout;
 extern ConfigVariableInt http_max_connect_count;
+extern ConfigVariableInt http_download_connections;
+extern ConfigVariableInt http_download_range_size;
 
 extern EXPCL_PANDA_DOWNLOADER ConfigVariableInt tcp_header_size;
 extern EXPCL_PANDA_DOWNLOADER ConfigVariableBool support_ipv6;
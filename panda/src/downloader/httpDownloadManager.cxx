@@ -0,0 +1,844 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file httpDownloadManager.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "httpDownloadManager.h"
+#include "config_downloader.h"
+
+#ifdef HAVE_OPENSSL
+
+#include "openSSLWrapper.h"  // must be included before any other openssl.
+#include <openssl/md5.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * The streambuf that receives the body of a single request from an
+ * HTTPChannel, and passes it on to the HTTPDownloadManager to be written at
+ * the appropriate position in the output file.
+ */
+class HTTPDownloadManager::RangeStreamBuf : public std::streambuf {
+public:
+  RangeStreamBuf(HTTPDownloadManager *manager, HTTPChannel *channel,
+                 int di, int ri, bool whole_document, size_t first_byte);
+
+protected:
+  virtual std::streamsize xsputn(const char *s, std::streamsize n);
+  virtual int overflow(int ch);
+  virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir dir,
+                                 std::ios_base::openmode which);
+  virtual std::streampos seekpos(std::streampos pos, std::ios_base::openmode which);
+
+private:
+  bool check_response();
+
+  HTTPDownloadManager *_manager;
+  HTTPChannel *_channel;
+  int _di;
+  int _ri;
+  bool _whole_document;
+  size_t _first_byte;
+  size_t _pos;
+  bool _checked_response;
+};
+
+/**
+ *
+ */
+HTTPDownloadManager::RangeStreamBuf::
+RangeStreamBuf(HTTPDownloadManager *manager, HTTPChannel *channel,
+               int di, int ri, bool whole_document, size_t first_byte) :
+  _manager(manager),
+  _channel(channel),
+  _di(di),
+  _ri(ri),
+  _whole_document(whole_document),
+  _first_byte(first_byte),
+  _pos(0),
+  _checked_response(false)
+{
+}
+
+/**
+ * Called by the ostream to write a block of data.  Returns the number of
+ * bytes written, which will be less than n on error.
+ */
+std::streamsize HTTPDownloadManager::RangeStreamBuf::
+xsputn(const char *s, std::streamsize n) {
+  if (!check_response()) {
+    return 0;
+  }
+  if (!_manager->receive_data(_di, _ri, _pos, s, (size_t)n)) {
+    return 0;
+  }
+  _pos += (size_t)n;
+  return n;
+}
+
+/**
+ * Called by the ostream to write a single character.
+ */
+int HTTPDownloadManager::RangeStreamBuf::
+overflow(int ch) {
+  if (ch == EOF) {
+    return 0;
+  }
+  char c = (char)ch;
+  return (xsputn(&c, 1) == 1) ? ch : EOF;
+}
+
+/**
+ * The HTTPChannel seeks to the start of the stream before writing; positions
+ * are relative to the start of the range.
+ */
+std::streampos HTTPDownloadManager::RangeStreamBuf::
+seekoff(std::streamoff off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which) {
+  if ((which & std::ios::out) == 0) {
+    return -1;
+  }
+  switch (dir) {
+  case std::ios::beg:
+    _pos = (size_t)off;
+    break;
+
+  case std::ios::cur:
+    _pos = (size_t)((std::streamoff)_pos + off);
+    break;
+
+  default:
+    return -1;
+  }
+  return (std::streampos)_pos;
+}
+
+/**
+ *
+ */
+std::streampos HTTPDownloadManager::RangeStreamBuf::
+seekpos(std::streampos pos, std::ios_base::openmode which) {
+  return seekoff(pos, std::ios::beg, which);
+}
+
+/**
+ * Verifies, before any data is written, that the server is actually sending
+ * the range we asked for.  Some servers ignore range requests and send the
+ * whole document, and of course an error page must not end up in the file.
+ */
+bool HTTPDownloadManager::RangeStreamBuf::
+check_response() {
+  if (_checked_response) {
+    return true;
+  }
+
+  int status_code = _channel->get_status_code();
+  if (_whole_document) {
+    if (status_code != 200) {
+      return false;
+    }
+  } else {
+    if (status_code != 206 ||
+        _channel->get_first_byte_delivered() != _first_byte) {
+      downloader_cat.warning()
+        << "Server did not honor range request for "
+        << _channel->get_url() << " (status " << status_code << ")\n";
+      return false;
+    }
+  }
+
+  _checked_response = true;
+  return true;
+}
+
+/**
+ * If client is NULL, the global HTTPClient is used.
+ */
+HTTPDownloadManager::
+HTTPDownloadManager(HTTPClient *client) :
+  _client(client),
+  _max_connections_per_host(std::max((int)http_download_connections, 1)),
+  _range_size((size_t)std::max((int)http_download_range_size, 1)),
+  _max_retries(2),
+  _total_bytes_downloaded(0)
+{
+  if (_client == nullptr) {
+    _client = HTTPClient::get_global_ptr();
+  }
+}
+
+/**
+ *
+ */
+HTTPDownloadManager::
+~HTTPDownloadManager() {
+  for (Servers::iterator si = _servers.begin(); si != _servers.end(); ++si) {
+    Connections &connections = (*si).second._connections;
+    for (Connection &conn : connections) {
+      if (conn._busy) {
+        conn._channel->reset();
+      }
+      delete conn._stream;
+      delete conn._buf;
+    }
+  }
+
+  for (Download &download : _downloads) {
+    close_file(download);
+  }
+}
+
+/**
+ * Adds a new document to be downloaded to the indicated file.  The download
+ * will begin with the next call to run().  Returns the index of the new
+ * download, which may be passed to get_download_status() and related methods.
+ *
+ * If the size of the document is known in advance, it may be specified here;
+ * this saves a round trip to the server to ask for it.  In this case, the
+ * server is assumed to support range requests.
+ */
+int HTTPDownloadManager::
+add_download(const DocumentSpec &url, const Filename &filename,
+             size_t file_size) {
+  int di = (int)_downloads.size();
+  _downloads.push_back(Download());
+  Download &download = _downloads.back();
+  download._url = url;
+  download._filename = Filename::binary_filename(filename);
+  download._server = url.get_url().get_server_and_port();
+  download._file_size = file_size;
+  download._file_size_known = (file_size != 0);
+
+  Server &server = _servers[download._server];
+  if (download._file_size_known) {
+    split_ranges(server, di);
+  } else {
+    // First ask the server how big it is, and whether it supports ranges.
+    Task task;
+    task._download = di;
+    task._range = -1;
+    server._tasks.push_back(task);
+  }
+  return di;
+}
+
+/**
+ * Adds a new document to be downloaded to the indicated file, as above.  Once
+ * the download has completed, its MD5 hash is compared to expected_hash; if
+ * they differ, the download status will be DS_hash_mismatch.
+ */
+int HTTPDownloadManager::
+add_download(const DocumentSpec &url, const Filename &filename,
+             size_t file_size, const HashVal &expected_hash) {
+  int di = add_download(url, filename, file_size);
+  Download &download = _downloads[di];
+  download._has_expected_hash = true;
+  download._expected_hash = expected_hash;
+  return di;
+}
+
+/**
+ * This must be called repeatedly to advance the downloads.  It issues new
+ * requests as connections become available, and processes whatever data has
+ * arrived on the open connections, without blocking.
+ *
+ * The return value is true if there is still work pending, or false if all
+ * of the downloads have either completed or failed.
+ */
+bool HTTPDownloadManager::
+run() {
+  bool any_pending = false;
+
+  for (Servers::iterator si = _servers.begin(); si != _servers.end(); ++si) {
+    Server &server = (*si).second;
+
+    // Hand out waiting requests to idle connections, opening new connections
+    // as needed, up to the limit.
+    for (Connection &conn : server._connections) {
+      if (!conn._busy && !server._tasks.empty()) {
+        Task task = server._tasks.front();
+        server._tasks.pop_front();
+        start_task(conn, task);
+      }
+    }
+    while (!server._tasks.empty() &&
+           (int)server._connections.size() < _max_connections_per_host) {
+      Connection conn;
+      conn._channel = _client->make_channel(true);
+      conn._busy = false;
+      conn._buf = nullptr;
+      conn._stream = nullptr;
+      server._connections.push_back(conn);
+
+      Task task = server._tasks.front();
+      server._tasks.pop_front();
+      start_task(server._connections.back(), task);
+    }
+
+    for (Connection &conn : server._connections) {
+      if (conn._busy) {
+        if (conn._channel->run()) {
+          any_pending = true;
+        } else {
+          finish_task(server, conn);
+        }
+      }
+    }
+
+    if (!server._tasks.empty()) {
+      any_pending = true;
+    }
+  }
+
+  return any_pending;
+}
+
+/**
+ * Runs until all of the downloads have either completed or failed.  Returns
+ * true if all of them completed successfully.
+ */
+bool HTTPDownloadManager::
+download_all() {
+  while (run()) {
+    thread_yield();
+  }
+
+  for (const Download &download : _downloads) {
+    if (download._status != DS_complete) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns the total number of bytes received so far, over all downloads.
+ * This includes any bytes that had to be received again after a failed
+ * request.
+ */
+size_t HTTPDownloadManager::
+get_total_bytes_downloaded() const {
+  return _total_bytes_downloaded;
+}
+
+/**
+ * Returns the number of connections that have been opened, to all servers.
+ */
+int HTTPDownloadManager::
+get_num_connections() const {
+  int num_connections = 0;
+  for (Servers::const_iterator si = _servers.begin(); si != _servers.end(); ++si) {
+    num_connections += (int)(*si).second._connections.size();
+  }
+  return num_connections;
+}
+
+/**
+ *
+ */
+HTTPDownloadManager::Download::
+Download() :
+  _file_size(0),
+  _file_size_known(false),
+  _accepts_ranges(true),
+  _header_attempts(0),
+  _has_expected_hash(false),
+  _status(DS_pending),
+  _num_ranges_done(0),
+  _bytes_downloaded(0),
+#ifdef _WIN32
+  _handle(INVALID_HANDLE_VALUE),
+#else
+  _fd(-1),
+#endif
+  _md5(nullptr),
+  _hash_pos(0),
+  _hash_range(0)
+{
+}
+
+/**
+ * Issues the request for the indicated task on the indicated (idle)
+ * connection.
+ */
+void HTTPDownloadManager::
+start_task(Connection &conn, const Task &task) {
+  Download &download = _downloads[task._download];
+  conn._busy = true;
+  conn._task = task;
+
+  if (task._range < 0) {
+    ++download._header_attempts;
+    conn._channel->begin_get_header(download._url);
+    return;
+  }
+
+  Range &range = download._ranges[task._range];
+  ++range._attempts;
+
+  // If this is a retry, whatever we got the last time will be received again.
+  download._bytes_downloaded -= range._bytes_written;
+  range._bytes_written = 0;
+
+  if (range._whole_document) {
+    conn._channel->begin_get_document(download._url);
+  } else {
+    conn._channel->begin_get_subdocument(download._url, range._first_byte,
+                                         range._first_byte + range._length - 1);
+  }
+
+  nassertv(conn._stream == nullptr);
+  conn._buf = new RangeStreamBuf(this, conn._channel, task._download, task._range,
+                                 range._whole_document, range._first_byte);
+  conn._stream = new std::ostream(conn._buf);
+  conn._channel->download_to_stream(conn._stream, false);
+}
+
+/**
+ * Called when the request on the indicated connection has finished, one way
+ * or another.
+ */
+void HTTPDownloadManager::
+finish_task(Server &server, Connection &conn) {
+  Task task = conn._task;
+  conn._busy = false;
+
+  if (task._range < 0) {
+    finish_header(server, task, conn._channel);
+  } else {
+    finish_range(server, task, conn._channel);
+  }
+
+  delete conn._stream;
+  delete conn._buf;
+  conn._stream = nullptr;
+  conn._buf = nullptr;
+}
+
+/**
+ * Called when the header request for a document of unknown size has
+ * finished.  Divides the document into ranges.
+ */
+void HTTPDownloadManager::
+finish_header(Server &server, const Task &task, HTTPChannel *channel) {
+  int di = task._download;
+  Download &download = _downloads[di];
+
+  if (!channel->is_valid()) {
+    int status_code = channel->get_status_code();
+    std::string status_string = channel->get_status_string();
+    channel->reset();
+    if (status_code < HTTPChannel::SC_http_error_watermark &&
+        download._header_attempts <= _max_retries) {
+      // A network error; try again.
+      server._tasks.push_front(task);
+      return;
+    }
+    downloader_cat.warning()
+      << "Unable to download " << download._url << ": "
+      << status_code << " " << status_string << "\n";
+    fail_download(di);
+    return;
+  }
+
+  if (channel->is_file_size_known()) {
+    download._file_size = (size_t)channel->get_file_size();
+    download._file_size_known = true;
+  }
+  download._accepts_ranges =
+    (HTTPChannel::downcase(channel->get_header_value("Accept-Ranges")) == "bytes");
+
+  split_ranges(server, di);
+}
+
+/**
+ * Called when a request for one range of a document has finished.
+ */
+void HTTPDownloadManager::
+finish_range(Server &server, const Task &task, HTTPChannel *channel) {
+  int di = task._download;
+  Download &download = _downloads[di];
+  Range &range = download._ranges[task._range];
+
+  if (download._status != DS_downloading) {
+    // Some other part of this download has already failed.
+    channel->reset();
+    return;
+  }
+
+  bool success = channel->is_download_complete() && channel->is_valid();
+  if (success && download._file_size_known &&
+      range._bytes_written != range._length) {
+    success = false;
+  }
+
+  if (!success) {
+    // Make sure the channel is no longer holding on to our stream.
+    int status_code = channel->get_status_code();
+    std::string status_string = channel->get_status_string();
+    channel->reset();
+
+    if (range._attempts <= _max_retries) {
+      if (downloader_cat.is_debug()) {
+        downloader_cat.debug()
+          << "Retrying bytes " << range._first_byte << " to "
+          << range._first_byte + range._length << " of " << download._url
+          << "\n";
+      }
+      server._tasks.push_front(task);
+      return;
+    }
+
+    downloader_cat.warning()
+      << "Unable to download " << download._url << ": "
+      << status_code << " " << status_string << "\n";
+    fail_download(di);
+    return;
+  }
+
+  range._done = true;
+  if (!download._file_size_known) {
+    download._file_size = range._bytes_written;
+    range._length = range._bytes_written;
+  }
+
+  ++download._num_ranges_done;
+  if (download._num_ranges_done == (int)download._ranges.size()) {
+    finish_download(di);
+  }
+}
+
+/**
+ * Opens the output file for the indicated download, divides it into ranges,
+ * and queues up a request for each one.
+ */
+void HTTPDownloadManager::
+split_ranges(Server &server, int di) {
+  Download &download = _downloads[di];
+  if (!open_file(download)) {
+    downloader_cat.warning()
+      << "Could not open " << download._filename << " for writing.\n";
+    fail_download(di);
+    return;
+  }
+  download._status = DS_downloading;
+
+  Range range;
+  range._bytes_written = 0;
+  range._attempts = 0;
+  range._done = false;
+
+  if (download._file_size_known && download._accepts_ranges &&
+      download._file_size > _range_size) {
+    range._whole_document = false;
+    for (size_t first = 0; first < download._file_size; first += _range_size) {
+      range._first_byte = first;
+      range._length = std::min(_range_size, download._file_size - first);
+      download._ranges.push_back(range);
+    }
+  } else {
+    range._whole_document = true;
+    range._first_byte = 0;
+    range._length = download._file_size;
+    download._ranges.push_back(range);
+  }
+
+  for (size_t ri = 0; ri < download._ranges.size(); ++ri) {
+    Task task;
+    task._download = di;
+    task._range = (int)ri;
+    server._tasks.push_back(task);
+  }
+}
+
+/**
+ * Marks the indicated download as failed, cancels its outstanding requests,
+ * and removes the incomplete file.
+ */
+void HTTPDownloadManager::
+fail_download(int di) {
+  Download &download = _downloads[di];
+  bool had_file = (download._md5 != nullptr);
+  download._status = DS_failed;
+  close_file(download);
+  if (had_file) {
+    download._filename.unlink();
+  }
+
+  Server &server = _servers[download._server];
+  Tasks::iterator ti = server._tasks.begin();
+  while (ti != server._tasks.end()) {
+    if ((*ti)._download == di) {
+      ti = server._tasks.erase(ti);
+    } else {
+      ++ti;
+    }
+  }
+}
+
+/**
+ * Called when all of the ranges of the indicated download have been
+ * received.  Finishes computing the hash, and checks it.
+ */
+void HTTPDownloadManager::
+finish_download(int di) {
+  Download &download = _downloads[di];
+  advance_hash(download);
+
+  if (download._hash_pos != download._file_size) {
+    downloader_cat.warning()
+      << "Unable to verify " << download._filename << "\n";
+    fail_download(di);
+    return;
+  }
+
+  unsigned char md[16];
+  MD5_Final(md, download._md5);
+  static const char *const hex_digits = "0123456789abcdef";
+  std::string hex;
+  for (int i = 0; i < 16; ++i) {
+    hex += hex_digits[md[i] >> 4];
+    hex += hex_digits[md[i] & 0xf];
+  }
+  download._hash.set_from_hex(hex);
+  close_file(download);
+
+  if (download._has_expected_hash && download._hash != download._expected_hash) {
+    downloader_cat.warning()
+      << "Hash mismatch on " << download._filename << ": expected "
+      << download._expected_hash << ", got " << download._hash << "\n";
+    download._status = DS_hash_mismatch;
+    return;
+  }
+
+  if (downloader_cat.is_debug()) {
+    downloader_cat.debug()
+      << "Downloaded " << download._url << " to " << download._filename
+      << " (" << download._file_size << " bytes in "
+      << download._ranges.size() << " pieces)\n";
+  }
+  download._status = DS_complete;
+}
+
+/**
+ * Creates (or truncates) the output file for the indicated download, and
+ * prepares to compute its hash.  Returns true on success.
+ */
+bool HTTPDownloadManager::
+open_file(Download &download) {
+  download._filename.make_dir();
+
+#ifdef _WIN32
+  std::wstring os_specific = download._filename.to_os_specific_w();
+  HANDLE handle = CreateFileW(os_specific.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  download._handle = handle;
+#else
+  std::string os_specific = download._filename.to_os_specific();
+  download._fd = open(os_specific.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (download._fd < 0) {
+    return false;
+  }
+  if (download._file_size_known) {
+    // Reserve the space up front, so that the ranges don't fragment the file.
+    if (ftruncate(download._fd, (off_t)download._file_size) != 0) {
+      close(download._fd);
+      download._fd = -1;
+      return false;
+    }
+  }
+#endif
+
+  download._md5 = new MD5_CTX;
+  MD5_Init(download._md5);
+  download._hash_pos = 0;
+  download._hash_range = 0;
+  return true;
+}
+
+/**
+ * Closes the output file for the indicated download, if it is open.
+ */
+void HTTPDownloadManager::
+close_file(Download &download) {
+#ifdef _WIN32
+  if (download._handle != INVALID_HANDLE_VALUE) {
+    CloseHandle((HANDLE)download._handle);
+    download._handle = INVALID_HANDLE_VALUE;
+  }
+#else
+  if (download._fd >= 0) {
+    close(download._fd);
+    download._fd = -1;
+  }
+#endif
+
+  delete download._md5;
+  download._md5 = nullptr;
+}
+
+/**
+ * Writes the data at the indicated offset within the output file, without
+ * disturbing any other writes in progress.  Returns true on success.
+ */
+bool HTTPDownloadManager::
+write_data(Download &download, size_t offset, const char *data, size_t size) {
+#ifdef _WIN32
+  while (size > 0) {
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)((uint64_t)offset >> 32);
+    DWORD written = 0;
+    if (!WriteFile((HANDLE)download._handle, data, (DWORD)size, &written, &overlapped) ||
+        written == 0) {
+      return false;
+    }
+    data += written;
+    offset += written;
+    size -= written;
+  }
+#else
+  while (size > 0) {
+    ssize_t written = pwrite(download._fd, data, size, (off_t)offset);
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    offset += written;
+    size -= written;
+  }
+#endif
+  return true;
+}
+
+/**
+ * Reads back data that was previously written to the output file.  Returns
+ * true on success.
+ */
+bool HTTPDownloadManager::
+read_data(Download &download, size_t offset, char *data, size_t size) {
+#ifdef _WIN32
+  while (size > 0) {
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)((uint64_t)offset >> 32);
+    DWORD count = 0;
+    if (!ReadFile((HANDLE)download._handle, data, (DWORD)size, &count, &overlapped) ||
+        count == 0) {
+      return false;
+    }
+    data += count;
+    offset += count;
+    size -= count;
+  }
+#else
+  while (size > 0) {
+    ssize_t count = pread(download._fd, data, size, (off_t)offset);
+    if (count <= 0) {
+      return false;
+    }
+    data += count;
+    offset += count;
+    size -= count;
+  }
+#endif
+  return true;
+}
+
+/**
+ * Called by the RangeStreamBuf as data arrives for the indicated range of the
+ * indicated download.  pos is relative to the start of the range.  Returns
+ * true on success, false if the data should be rejected.
+ */
+bool HTTPDownloadManager::
+receive_data(int di, int ri, size_t pos, const char *data, size_t size) {
+  Download &download = _downloads[di];
+  Range &range = download._ranges[ri];
+  if (download._status != DS_downloading) {
+    return false;
+  }
+  if (download._file_size_known && pos + size > range._length) {
+    // The server is sending more than we asked for.
+    return false;
+  }
+
+  size_t offset = range._first_byte + pos;
+  if (!write_data(download, offset, data, size)) {
+    downloader_cat.warning()
+      << "Error writing to " << download._filename << "\n";
+    return false;
+  }
+
+  _total_bytes_downloaded += size;
+  if (pos + size > range._bytes_written) {
+    download._bytes_downloaded += pos + size - range._bytes_written;
+    range._bytes_written = pos + size;
+  }
+
+  // If this data continues where the hash left off, we can hash it right
+  // away; this is always the case for the range at the front.
+  if (offset <= download._hash_pos && download._hash_pos < offset + size) {
+    size_t skip = download._hash_pos - offset;
+    MD5_Update(download._md5, data + skip, size - skip);
+    download._hash_pos = offset + size;
+  }
+  advance_hash(download);
+  return true;
+}
+
+/**
+ * Hashes any data that has been received beyond the current hash position.
+ * This catches up on ranges that completed before the ranges preceding them,
+ * by reading their data back from the file.
+ */
+void HTTPDownloadManager::
+advance_hash(Download &download) {
+  static const size_t buffer_size = 16384;
+  char buffer[buffer_size];
+
+  while (download._hash_range < download._ranges.size()) {
+    const Range &range = download._ranges[download._hash_range];
+    if ((download._file_size_known || range._done) &&
+        download._hash_pos >= range._first_byte + range._length) {
+      ++download._hash_range;
+      continue;
+    }
+
+    size_t available = range._first_byte + range._bytes_written;
+    if (available <= download._hash_pos) {
+      return;
+    }
+
+    while (download._hash_pos < available) {
+      size_t count = std::min(buffer_size, available - download._hash_pos);
+      if (!read_data(download, download._hash_pos, buffer, count)) {
+        return;
+      }
+      MD5_Update(download._md5, buffer, count);
+      download._hash_pos += count;
+    }
+  }
+}
+
+#endif  // HAVE_OPENSSL
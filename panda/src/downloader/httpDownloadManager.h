@@ -0,0 +1,208 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file httpDownloadManager.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef HTTPDOWNLOADMANAGER_H
+#define HTTPDOWNLOADMANAGER_H
+
+#include "pandabase.h"
+
+// This module requires OpenSSL to compile, even if you do not intend to use
+// this to establish https connections; this is because it uses the OpenSSL
+// library to portably handle all of the socket communications.
+
+#ifdef HAVE_OPENSSL
+
+#include "httpClient.h"
+#include "httpChannel.h"
+#include "documentSpec.h"
+#include "filename.h"
+#include "hashVal.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "pdeque.h"
+#include "pmap.h"
+#include "referenceCount.h"
+
+typedef struct MD5state_st MD5_CTX;
+
+/**
+ * Downloads any number of documents to disk concurrently, using a pool of
+ * persistent HTTPChannels for each server.
+ *
+ * Documents larger than get_range_size() are divided into several range
+ * requests, which are issued in parallel over up to
+ * get_max_connections_per_host() connections to the same server.  The
+ * received bytes are written directly to the appropriate place in the output
+ * file, and each document's MD5 hash is computed as its data arrives, so
+ * that it may be verified against an expected HashVal without reading the
+ * file again afterwards.
+ *
+ * Like HTTPChannel, this uses non-blocking I/O; call run() repeatedly until
+ * it returns false, or call download_all() to wait for all of the downloads
+ * to finish.
+ */
+class EXPCL_PANDA_DOWNLOADER HTTPDownloadManager : public ReferenceCount {
+PUBLISHED:
+  explicit HTTPDownloadManager(HTTPClient *client = nullptr);
+  ~HTTPDownloadManager();
+
+  enum DownloadStatus {
+    DS_pending,
+    DS_downloading,
+    DS_complete,
+    DS_failed,
+    DS_hash_mismatch,
+  };
+
+  INLINE HTTPClient *get_client() const;
+
+  INLINE void set_max_connections_per_host(int max_connections);
+  INLINE int get_max_connections_per_host() const;
+  MAKE_PROPERTY(max_connections_per_host, get_max_connections_per_host,
+                set_max_connections_per_host);
+
+  INLINE void set_range_size(size_t range_size);
+  INLINE size_t get_range_size() const;
+  MAKE_PROPERTY(range_size, get_range_size, set_range_size);
+
+  INLINE void set_max_retries(int max_retries);
+  INLINE int get_max_retries() const;
+  MAKE_PROPERTY(max_retries, get_max_retries, set_max_retries);
+
+  int add_download(const DocumentSpec &url, const Filename &filename,
+                   size_t file_size = 0);
+  int add_download(const DocumentSpec &url, const Filename &filename,
+                   size_t file_size, const HashVal &expected_hash);
+
+  bool run();
+  BLOCKING bool download_all();
+
+  INLINE int get_num_downloads() const;
+  INLINE const DocumentSpec &get_download_url(int n) const;
+  INLINE const Filename &get_download_filename(int n) const;
+  INLINE DownloadStatus get_download_status(int n) const;
+  INLINE size_t get_download_file_size(int n) const;
+  INLINE size_t get_download_bytes(int n) const;
+  INLINE const HashVal &get_download_hash(int n) const;
+  INLINE bool is_download_complete(int n) const;
+
+  size_t get_total_bytes_downloaded() const;
+  int get_num_connections() const;
+  MAKE_PROPERTY(total_bytes_downloaded, get_total_bytes_downloaded);
+  MAKE_PROPERTY(num_connections, get_num_connections);
+
+private:
+  class RangeStreamBuf;
+
+  // A contiguous piece of one document, fetched with a single request.  If
+  // _whole_document is true, this is the only range, and it is fetched with
+  // an ordinary (non-range) request; in this case _length is meaningful only
+  // if the document size is known.
+  class Range {
+  public:
+    size_t _first_byte;
+    size_t _length;
+    size_t _bytes_written;
+    int _attempts;
+    bool _whole_document;
+    bool _done;
+  };
+  typedef pvector<Range> Ranges;
+
+  class Download {
+  public:
+    Download();
+
+    DocumentSpec _url;
+    Filename _filename;
+    std::string _server;
+    size_t _file_size;
+    bool _file_size_known;
+    bool _accepts_ranges;
+    int _header_attempts;
+    bool _has_expected_hash;
+    HashVal _expected_hash;
+    HashVal _hash;
+    DownloadStatus _status;
+    Ranges _ranges;
+    int _num_ranges_done;
+    size_t _bytes_downloaded;
+
+#ifdef _WIN32
+    void *_handle;
+#else
+    int _fd;
+#endif
+    MD5_CTX *_md5;
+    size_t _hash_pos;
+    size_t _hash_range;
+  };
+  typedef pvector<Download> Downloads;
+
+  // A request waiting for a connection.  If _range is -1, this is the
+  // initial header request, which determines the document size.
+  class Task {
+  public:
+    int _download;
+    int _range;
+  };
+  typedef pdeque<Task> Tasks;
+
+  class Connection {
+  public:
+    PT(HTTPChannel) _channel;
+    bool _busy;
+    Task _task;
+    RangeStreamBuf *_buf;
+    std::ostream *_stream;
+  };
+  typedef pvector<Connection> Connections;
+
+  class Server {
+  public:
+    Connections _connections;
+    Tasks _tasks;
+  };
+  typedef pmap<std::string, Server> Servers;
+
+  void start_task(Connection &conn, const Task &task);
+  void finish_task(Server &server, Connection &conn);
+  void finish_header(Server &server, const Task &task, HTTPChannel *channel);
+  void finish_range(Server &server, const Task &task, HTTPChannel *channel);
+  void split_ranges(Server &server, int di);
+  void fail_download(int di);
+  void finish_download(int di);
+
+  bool open_file(Download &download);
+  void close_file(Download &download);
+  bool write_data(Download &download, size_t offset, const char *data, size_t size);
+  bool read_data(Download &download, size_t offset, char *data, size_t size);
+
+  bool receive_data(int di, int ri, size_t pos, const char *data, size_t size);
+  void advance_hash(Download &download);
+
+  PT(HTTPClient) _client;
+  int _max_connections_per_host;
+  size_t _range_size;
+  int _max_retries;
+
+  Downloads _downloads;
+  Servers _servers;
+  size_t _total_bytes_downloaded;
+};
+
+#include "httpDownloadManager.I"
+
+#endif  // HAVE_OPENSSL
+
+#endif
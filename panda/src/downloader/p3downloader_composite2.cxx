@@ -5,6 +5,7 @@
 #include "httpCookie.cxx"
 #include "httpDate.cxx"
 #include "httpDigestAuthorization.cxx"
+#include "httpDownloadManager.cxx"
 #include "httpEntityTag.cxx"
 #include "httpEnum.cxx"
 #include "identityStream.cxx"
@@ -61,6 +61,22 @@ ConfigVariableInt patchfile_buffer_size
 ConfigVariableInt patchfile_zone_size
 ("patchfile-zone-size", 10000);
 
+ConfigVariableInt patchfile_build_threads
+("patchfile-build-threads", 0,
+ PRC_DESC("The number of threads that Patchfile::build() uses to search the "
+          "new file for matching byte sequences in the original file.  Set "
+          "this to 0 (the default) to use one thread per available CPU, or "
+          "to 1 to do all of the work in the calling thread."));
+
+ConfigVariableInt64 patchfile_max_index_size
+("patchfile-max-index-size", 256 * 1024 * 1024,
+ PRC_DESC("The maximum number of bytes Patchfile::build() may spend on the "
+          "table that indexes every footprint of the original file.  If the "
+          "original file is too large to index every byte position within "
+          "this limit, only every nth position is indexed; matching "
+          "sequences are still found, but a few bytes at the start of each "
+          "one may be stored in the patch literally."));
+
 ConfigVariableBool keep_temporary_files
 ("keep-temporary-files", false,
  PRC_DESC("Set this true to keep around the temporary files from "
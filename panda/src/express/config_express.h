@@ -20,6 +20,7 @@
 
 #include "configVariableBool.h"
 #include "configVariableInt.h"
+#include "configVariableInt64.h"
 #include "configVariableDouble.h"
 #include "configVariableList.h"
 #include "configVariableFilename.h"
@@ -47,6 +48,8 @@ extern ConfigVariableInt patchfile_window_size;
 extern ConfigVariableInt patchfile_increment_size;
 extern ConfigVariableInt patchfile_buffer_size;
 extern ConfigVariableInt patchfile_zone_size;
+extern ConfigVariableInt patchfile_build_threads;
+extern ConfigVariableInt64 patchfile_max_index_size;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool keep_temporary_files;
 extern ConfigVariableBool multifile_always_binary;
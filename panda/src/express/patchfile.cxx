@@ -26,6 +26,21 @@
 
 #include <string.h>  // for strstr
 
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+#include <thread>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using std::endl;
 using std::ios;
 using std::istream;
@@ -73,6 +88,37 @@ const uint32_t Patchfile::_DEFAULT_FOOTPRINT_LENGTH = 9; // this produced the sm
 const uint32_t Patchfile::_NULL_VALUE = uint32_t(0) - 1;
 const uint32_t Patchfile::_MAX_RUN_LENGTH = (uint32_t(1) << 16) - 1;
 const uint32_t Patchfile::_HASH_MASK = (uint32_t(1) << Patchfile::_HASH_BITS) - 1;
+const uint32_t Patchfile::_HASH_MULTIPLIER = 0x01000193;
+const uint32_t Patchfile::_BUILD_CHUNK_SIZE = 1024 * 1024;
+
+namespace {
+  /**
+   * Provides read access to the complete contents of one of the inputs to
+   * Patchfile::build().  If a filename is given, the file is mapped into
+   * memory, so that even very large files don't need to be read into RAM.
+   * Otherwise, or if the mapping fails, the stream is read into a buffer.
+   */
+  class BuildSource {
+  public:
+    BuildSource(const Filename &filename, istream &stream);
+    ~BuildSource();
+
+    const char *get_data() const { return _data; }
+    uint32_t get_length() const { return _length; }
+
+  private:
+    bool map_file(const Filename &filename);
+
+    const char *_data;
+    uint32_t _length;
+    char *_buffer;
+#ifdef _WIN32
+    HANDLE _mapping;
+#else
+    size_t _mapped_size;
+#endif
+  };
+}
 
 /**
  * Create a patch file and initializes internal data
@@ -99,6 +145,8 @@ init(PT(Buffer) buffer) {
   _rename_output_to_orig = false;
   _delete_patchfile = false;
   _hash_table = nullptr;
+  _hash_roll_factor = 1;
+  _index_stride = 1;
   _initiated = false;
   nassertv(!buffer.is_null());
   _buffer = buffer;
@@ -577,35 +625,18 @@ internal_read_header(const Filename &patch_file) {
 // PATCH FILE BUILDING MEMBER FUNCTIONS
 
 /**
- *
+ * Returns the hash of the footprint that begins at the indicated buffer
+ * position.  This is a polynomial hash, so the hash of the footprint at the
+ * following position can be computed cheaply with roll_hash().  Use
+ * get_hash_index() to reduce the result to a hash table index.
  */
 uint32_t Patchfile::
-calc_hash(const char *buffer) {
-#ifdef USE_MD5_FOR_HASHTABLE_INDEX_VALUES
-  HashVal hash;
-  hash.hash_buffer(buffer, _footprint_length);
-
-  // cout << uint16_t(hash.get_value(0)) << " ";
-
-  return uint16_t(hash.get_value(0));
-#else
+calc_hash(const char *buffer) const {
   uint32_t hash_value = 0;
-
-  for(int i = 0; i < (int)_footprint_length; i++) {
-    // this is probably not such a good hash.  to be replaced --> TRIED MD5,
-    // was not worth it for the execution-time hit on 800Mhz PC
-    hash_value ^= uint32_t(*buffer) << ((i * 2) % Patchfile::_HASH_BITS);
-    buffer++;
+  for (uint32_t i = 0; i < _footprint_length; ++i) {
+    hash_value = hash_value * _HASH_MULTIPLIER + (uint32_t)(unsigned char)buffer[i];
   }
-
-  // use the bits that overflowed past the end of the hash bit range (this is
-  // intended for _HASH_BITS == 24)
-  hash_value ^= (hash_value >> Patchfile::_HASH_BITS);
-
-  // cout << hash_value << " ";
-
-  return hash_value & _HASH_MASK;
-#endif
+  return hash_value;
 }
 
 /**
@@ -619,10 +650,15 @@ calc_hash(const char *buffer) {
  * that has a matching footprint.
  *
  * The link table is a large linked list of file offsets, with one entry for
- * every byte in the file.  Each offset in the link table will point to
- * another offset that has the same footprint at the corresponding offset in
- * the actual file.  Starting with an offset taken from the hash table, one
- * can rapidly produce a list of offsets that all have the same footprint.
+ * every indexed position in the file.  Each offset in the link table will
+ * point to another offset that has the same footprint at the corresponding
+ * offset in the actual file.  Starting with an offset taken from the hash
+ * table, one can rapidly produce a list of offsets that all have the same
+ * footprint.
+ *
+ * Normally every byte position is indexed, but if _index_stride is greater
+ * than 1, only every _index_stride'th position is, and the link table is
+ * correspondingly smaller.
  */
 void Patchfile::
 build_hash_link_tables(const char *buffer_orig, uint32_t length_orig,
@@ -636,48 +672,31 @@ build_hash_link_tables(const char *buffer_orig, uint32_t length_orig,
   }
 
   // clear link table
-  for(i = 0; i < length_orig; i++) {
+  uint32_t link_table_size = (length_orig + _index_stride - 1) / _index_stride;
+  for(i = 0; i < link_table_size; i++) {
     link_table[i] = _NULL_VALUE;
   }
 
   if(length_orig < _footprint_length) return;
 
   // run through original file and hash each footprint
+  uint32_t hash_value = calc_hash(buffer_orig);
   for(i = 0; i < (length_orig - _footprint_length); i++) {
-
-    uint32_t hash_value = calc_hash(&buffer_orig[i]);
-
-    // we must now store this file index in the hash table at the offset of
-    // the hash value
-
-    // to account for multiple file offsets with identical hash values, there
-    // is a link table with an entry for every footprint in the file.  We
-    // create linked lists of offsets in the link table.
-
-    // first, set the value in the link table for the current offset to
-    // whatever the current list head is (the value in the hash table) (note
-    // that this only works because the hash and link tables both use
-    // _NULL_VALUE to indicate a null index)
-    link_table[i] = hash_table[hash_value];
-
-    // set the new list head; store the current offset in the hash table at
-    // the offset of the footprint's hash value
-    hash_table[hash_value] = i;
-
-    /*
-    if (_NULL_VALUE == hash_table[hash_value]) {
-      // hash entry is empty, store this offset
-      hash_table[hash_value] = i;
-    } else {
-      // hash entry is taken, go to the link table
-      uint32_t link_offset = hash_table[hash_value];
-
-      while (_NULL_VALUE != link_table[link_offset]) {
-        link_offset = link_table[link_offset];
-      }
-      link_table[link_offset] = i;
+    if (i % _index_stride == 0) {
+      uint32_t hash_index = get_hash_index(hash_value);
+
+      // To account for multiple file offsets with identical hash values,
+      // there is a link table with an entry for every indexed footprint in
+      // the file.  We create linked lists of offsets in the link table: the
+      // link table entry for the current offset is set to whatever the
+      // current list head is, and the current offset becomes the new list
+      // head.  (Note that this only works because the hash and link tables
+      // both use _NULL_VALUE to indicate a null index.)
+      link_table[i / _index_stride] = hash_table[hash_index];
+      hash_table[hash_index] = i;
     }
-    */
+
+    hash_value = roll_hash(hash_value, &buffer_orig[i]);
   }
 }
 
@@ -709,24 +728,23 @@ calc_match_length(const char* buf1, const char* buf2, uint32_t max_length,
 /**
  *
  * This function will find the longest string in the original file that
- * matches a string in the new file.
+ * matches a string in the new file.  hash_index is the hash table index of
+ * the footprint at new_pos.
  */
 void Patchfile::
-find_longest_match(uint32_t new_pos, uint32_t &copy_pos, uint16_t &copy_length,
-  uint32_t *hash_table, uint32_t *link_table, const char* buffer_orig,
-  uint32_t length_orig, const char* buffer_new, uint32_t length_new) {
+find_longest_match(uint32_t new_pos, uint32_t hash_index,
+  uint32_t &copy_pos, uint16_t &copy_length,
+  const uint32_t *hash_table, const uint32_t *link_table, const char* buffer_orig,
+  uint32_t length_orig, const char* buffer_new, uint32_t length_new) const {
 
   // set length to a safe value
   copy_length = 0;
 
-  // get offset of matching string (in orig file) from hash table
-  uint32_t hash_value = calc_hash(&buffer_new[new_pos]);
-
   // if no match, bail
-  if (_NULL_VALUE == hash_table[hash_value])
+  if (_NULL_VALUE == hash_table[hash_index])
     return;
 
-  copy_pos = hash_table[hash_value];
+  copy_pos = hash_table[hash_index];
 
   // calc match length
   copy_length = (uint16_t)calc_match_length(&buffer_new[new_pos],
@@ -739,7 +757,7 @@ find_longest_match(uint32_t new_pos, uint32_t &copy_pos, uint16_t &copy_length,
   // run through link table, see if we find any longer matches
   uint32_t match_offset;
   uint16_t match_length;
-  match_offset = link_table[copy_pos];
+  match_offset = link_table[copy_pos / _index_stride];
 
   while (match_offset != _NULL_VALUE) {
     match_length = (uint16_t)calc_match_length(&buffer_new[new_pos],
@@ -756,8 +774,133 @@ find_longest_match(uint32_t new_pos, uint32_t &copy_pos, uint16_t &copy_length,
     }
 
     // traverse the link table
-    match_offset = link_table[match_offset];
+    match_offset = link_table[match_offset / _index_stride];
+  }
+}
+
+/**
+ * Greedily scans the range [chunk_begin, chunk_end) of the new file for
+ * strings that also appear in the original file, and appends them to the
+ * matches vector, in order.  The last match may extend beyond chunk_end.
+ *
+ * This does not modify the Patchfile, so it may be called for different
+ * chunks from multiple threads at once.
+ */
+void Patchfile::
+find_chunk_matches(BuildMatches &matches,
+                   uint32_t chunk_begin, uint32_t chunk_end,
+                   const uint32_t *hash_table, const uint32_t *link_table,
+                   const char *buffer_orig, uint32_t length_orig,
+                   const char *buffer_new, uint32_t length_new) const {
+  if (length_new < _footprint_length) {
+    return;
   }
+  uint32_t scan_end = min(chunk_end, length_new - _footprint_length);
+
+  uint32_t new_pos = chunk_begin;
+  uint32_t start_pos = new_pos; // this is the position for the start of ADD operations
+  if (new_pos >= scan_end) {
+    return;
+  }
+  uint32_t hash_value = calc_hash(&buffer_new[new_pos]);
+
+  while (new_pos < scan_end) {
+    // find best match for current position
+    uint32_t copy_pos;
+    uint16_t copy_length;
+    find_longest_match(new_pos, get_hash_index(hash_value), copy_pos, copy_length,
+                       hash_table, link_table,
+                       buffer_orig, length_orig, buffer_new, length_new);
+
+    // if no match or match not longer than footprint length, skip to next
+    // byte
+    if (copy_length < _footprint_length) {
+      hash_value = roll_hash(hash_value, &buffer_new[new_pos]);
+      new_pos++;
+      continue;
+    }
+
+    // The match may actually have started a few bytes earlier, especially
+    // if not every position in the original file is indexed.  Extend it
+    // backwards over the bytes we have skipped so far.
+    BuildMatch match;
+    match._new_pos = new_pos;
+    match._copy_pos = copy_pos;
+    match._length = copy_length;
+    while (match._new_pos > start_pos && match._copy_pos > 0 &&
+           buffer_new[match._new_pos - 1] == buffer_orig[match._copy_pos - 1]) {
+      --match._new_pos;
+      --match._copy_pos;
+      ++match._length;
+    }
+    matches.push_back(match);
+
+    new_pos += (uint32_t)copy_length;
+    start_pos = new_pos;
+    if (new_pos < scan_end) {
+      hash_value = calc_hash(&buffer_new[new_pos]);
+    }
+  }
+}
+
+/**
+ * Scans the entire new file for matching strings, one chunk of
+ * _BUILD_CHUNK_SIZE bytes at a time.  The chunks are divided among as many
+ * threads as patchfile-build-threads allows; since the chunk boundaries don't
+ * depend on the number of threads, neither does the result.  On return,
+ * chunk_matches contains the matches found in each chunk, in order.
+ */
+void Patchfile::
+find_all_matches(pvector<BuildMatches> &chunk_matches,
+                 const uint32_t *hash_table, const uint32_t *link_table,
+                 const char *buffer_orig, uint32_t length_orig,
+                 const char *buffer_new, uint32_t length_new) const {
+  size_t num_chunks = (length_new + _BUILD_CHUNK_SIZE - 1) / _BUILD_CHUNK_SIZE;
+  chunk_matches.clear();
+  chunk_matches.resize(num_chunks);
+
+  size_t num_threads = 1;
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  if (patchfile_build_threads > 0) {
+    num_threads = (size_t)patchfile_build_threads;
+  } else {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_threads = min(num_threads, num_chunks);
+#endif
+
+  // Thread ti takes chunks ti, ti + num_threads, ti + 2 * num_threads, etc.
+  auto scan_chunks = [&](size_t ti) {
+    for (size_t ci = ti; ci < num_chunks; ci += num_threads) {
+      uint32_t chunk_begin = (uint32_t)(ci * _BUILD_CHUNK_SIZE);
+      uint32_t chunk_end = (uint32_t)min((size_t)length_new, (ci + 1) * _BUILD_CHUNK_SIZE);
+      find_chunk_matches(chunk_matches[ci], chunk_begin, chunk_end,
+                         hash_table, link_table,
+                         buffer_orig, length_orig, buffer_new, length_new);
+    }
+  };
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  if (num_threads > 1) {
+    if (express_cat.is_debug()) {
+      express_cat.debug()
+        << "Scanning " << num_chunks << " chunks on " << num_threads
+        << " threads\n";
+    }
+    pvector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t ti = 1; ti < num_threads; ++ti) {
+      threads.push_back(std::thread(scan_chunks, ti));
+    }
+    scan_chunks(0);
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    return;
+  }
+#endif
+
+  scan_chunks(0);
 }
 
 /**
@@ -955,37 +1098,28 @@ write_terminator(ostream &write_stream) {
  * Computes the patches for the entire file (if it is not a multifile) or for
  * a single subfile (if it is)
  *
+ * If map_orig or map_new is not empty, it names the file that the
+ * corresponding stream reads in its entirety, which is then mapped into
+ * memory rather than read from the stream.
+ *
  * Returns true if successful, false on error.
  */
 bool Patchfile::
 compute_file_patches(ostream &write_stream,
                      uint32_t offset_orig, uint32_t offset_new,
-                     istream &stream_orig, istream &stream_new) {
+                     istream &stream_orig, istream &stream_new,
+                     const Filename &map_orig, const Filename &map_new) {
   // read in original file
-  stream_orig.seekg(0, ios::end);
+  BuildSource source_orig(map_orig, stream_orig);
   nassertr(stream_orig, false);
-  uint32_t source_file_length = stream_orig.tellg();
-  if (express_cat.is_debug()) {
-    express_cat.debug()
-      << "Allocating " << source_file_length << " bytes to read orig\n";
-  }
-
-  char *buffer_orig = (char *)PANDA_MALLOC_ARRAY(source_file_length);
-  stream_orig.seekg(0, ios::beg);
-  stream_orig.read(buffer_orig, source_file_length);
+  const char *buffer_orig = source_orig.get_data();
+  uint32_t source_file_length = source_orig.get_length();
 
   // read in new file
-  stream_new.seekg(0, ios::end);
-  uint32_t result_file_length = stream_new.tellg();
+  BuildSource source_new(map_new, stream_new);
   nassertr(stream_new, false);
-  if (express_cat.is_debug()) {
-    express_cat.debug()
-      << "Allocating " << result_file_length << " bytes to read new\n";
-  }
-
-  char *buffer_new = (char *)PANDA_MALLOC_ARRAY(result_file_length);
-  stream_new.seekg(0, ios::beg);
-  stream_new.read(buffer_new, result_file_length);
+  const char *buffer_new = source_new.get_data();
+  uint32_t result_file_length = source_new.get_length();
 
   // allocate hashlink tables
   if (_hash_table == nullptr) {
@@ -996,50 +1130,67 @@ compute_file_patches(ostream &write_stream,
     _hash_table = (uint32_t *)PANDA_MALLOC_ARRAY(_HASHTABLESIZE * sizeof(uint32_t));
   }
 
+  // If indexing every byte of the original file would take more memory than
+  // we are allowed, index only every nth byte.
+  uint64_t max_index_entries = std::max(patchfile_max_index_size.get_value() / (int64_t)sizeof(uint32_t), (int64_t)1);
+  _index_stride = (uint32_t)std::max(((uint64_t)source_file_length + max_index_entries - 1) / max_index_entries, (uint64_t)1);
+  uint32_t link_table_size = (source_file_length + _index_stride - 1) / _index_stride;
+
   if (express_cat.is_debug()) {
     express_cat.debug()
-      << "Allocating linktable of size " << source_file_length << " * 4\n";
+      << "Allocating linktable of size " << link_table_size << " * 4";
+    if (_index_stride > 1) {
+      express_cat.debug(false)
+        << " (indexing every " << _index_stride << " bytes)";
+    }
+    express_cat.debug(false) << "\n";
   }
 
-  uint32_t *link_table = (uint32_t *)PANDA_MALLOC_ARRAY(source_file_length * sizeof(uint32_t));
+  uint32_t *link_table = (uint32_t *)PANDA_MALLOC_ARRAY(std::max(link_table_size, (uint32_t)1) * sizeof(uint32_t));
+
+  // This is the multiplier that removes the first byte of a footprint from
+  // its rolling hash.
+  _hash_roll_factor = 1;
+  for (uint32_t i = 1; i < _footprint_length; ++i) {
+    _hash_roll_factor *= _HASH_MULTIPLIER;
+  }
 
   // build hash and link tables for original file
   build_hash_link_tables(buffer_orig, source_file_length, _hash_table, link_table);
 
-  // run through new file
-
-  uint32_t new_pos = 0;
-  uint32_t start_pos = new_pos; // this is the position for the start of ADD operations
-
-  if(((uint32_t) result_file_length) >= _footprint_length)
-  {
-    while (new_pos < (result_file_length - _footprint_length)) {
-
-      // find best match for current position
-      uint32_t COPY_pos;
-      uint16_t COPY_length;
-
-      find_longest_match(new_pos, COPY_pos, COPY_length, _hash_table, link_table,
-        buffer_orig, source_file_length, buffer_new, result_file_length);
-
-      // if no match or match not longer than footprint length, skip to next
-      // byte
-      if (COPY_length < _footprint_length) {
-        // go to next byte
-        new_pos++;
-      } else {
-        // emit ADD for all skipped bytes
-        int num_skipped = (int)new_pos - (int)start_pos;
-        if (express_cat.is_spam()) {
-          express_cat.spam()
-            << "build: num_skipped = " << num_skipped
-            << endl;
+  // run through new file, possibly on several threads at once
+  pvector<BuildMatches> chunk_matches;
+  find_all_matches(chunk_matches, _hash_table, link_table,
+                   buffer_orig, source_file_length,
+                   buffer_new, result_file_length);
+
+  // Now emit the matches in order.  A match found near the end of one chunk
+  // may overlap the first matches found in the next chunk; these are
+  // trimmed or dropped.
+  uint32_t start_pos = 0; // this is the position for the start of ADD operations
+  for (const BuildMatches &matches : chunk_matches) {
+    for (BuildMatch match : matches) {
+      if (match._new_pos < start_pos) {
+        uint32_t overlap = start_pos - match._new_pos;
+        if (overlap >= match._length ||
+            match._length - overlap < _footprint_length) {
+          continue;
         }
-        cache_add_and_copy(write_stream, num_skipped, &buffer_new[start_pos],
-                           COPY_length, COPY_pos + offset_orig);
-        new_pos += (uint32_t)COPY_length;
-        start_pos = new_pos;
+        match._new_pos += overlap;
+        match._copy_pos += overlap;
+        match._length -= overlap;
+      }
+
+      // emit ADD for all skipped bytes
+      uint32_t num_skipped = match._new_pos - start_pos;
+      if (express_cat.is_spam()) {
+        express_cat.spam()
+          << "build: num_skipped = " << num_skipped
+          << endl;
       }
+      cache_add_and_copy(write_stream, num_skipped, &buffer_new[start_pos],
+                         match._length, match._copy_pos + offset_orig);
+      start_pos = match._new_pos + match._length;
     }
   }
 
@@ -1062,9 +1213,6 @@ compute_file_patches(ostream &write_stream,
 
   PANDA_FREE_ARRAY(link_table);
 
-  PANDA_FREE_ARRAY(buffer_orig);
-  PANDA_FREE_ARRAY(buffer_new);
-
   return true;
 }
 
@@ -1157,7 +1305,11 @@ compute_mf_patches(ostream &write_stream,
  * the masters thesis "Differential Compression: A Generalized Solution for
  * Binary Files" by Randal C. Burns (p.13). For an original file of size M and
  * a new file of size N, this algorithm is O(M) in space and O(M*N) (worst-
- * case) in time.  return false on error
+ * case) in time.  Footprints are located with a rolling hash, and the new
+ * file is searched in independent chunks on multiple threads (see
+ * patchfile-build-threads).  The input files are mapped into memory rather
+ * than read, and for very large original files the index is thinned out to
+ * stay within patchfile-max-index-size.  return false on error
  */
 bool Patchfile::
 build(Filename file_orig, Filename file_new, Filename patch_name) {
@@ -1199,7 +1351,7 @@ build(Filename file_orig, Filename file_new, Filename patch_name) {
 
   if (!do_compute_patches(file_orig, file_new,
                           write_stream, 0, 0,
-                          stream_orig, stream_new)) {
+                          stream_orig, stream_new, true)) {
     return false;
   }
 
@@ -1230,7 +1382,8 @@ bool Patchfile::
 do_compute_patches(const Filename &file_orig, const Filename &file_new,
                    ostream &write_stream,
                    uint32_t offset_orig, uint32_t offset_new,
-                   istream &stream_orig, istream &stream_new) {
+                   istream &stream_orig, istream &stream_new,
+                   bool whole_files) {
   nassertr(_add_pos + _cache_add_data.size() + _cache_copy_length == offset_new, false);
 
   // Check whether our input files are Panda multifiles or tar files.
@@ -1272,8 +1425,15 @@ do_compute_patches(const Filename &file_orig, const Filename &file_new,
       express_cat.debug()
         << file_orig.get_basename() << " is not a multifile.\n";
     }
+    // If the streams read the named files from beginning to end, we can map
+    // the files directly instead of reading them into memory.
+    Filename map_orig, map_new;
+    if (whole_files) {
+      map_orig = file_orig;
+      map_new = file_new;
+    }
     if (!compute_file_patches(write_stream, offset_orig, offset_new,
-                              stream_orig, stream_new)) {
+                              stream_orig, stream_new, map_orig, map_new)) {
       return false;
     }
   }
@@ -1334,4 +1494,111 @@ patch_subfile(ostream &write_stream,
   return true;
 }
 
+/**
+ *
+ */
+BuildSource::
+BuildSource(const Filename &filename, istream &stream) :
+  _data(nullptr),
+  _length(0),
+  _buffer(nullptr)
+{
+#ifdef _WIN32
+  _mapping = nullptr;
+#else
+  _mapped_size = 0;
+#endif
+
+  stream.seekg(0, ios::end);
+  _length = (uint32_t)stream.tellg();
+
+  if (!filename.empty() && _length != 0 && map_file(filename)) {
+    if (express_cat.is_debug()) {
+      express_cat.debug()
+        << "Mapped " << _length << " bytes of " << filename << "\n";
+    }
+    return;
+  }
+
+  if (express_cat.is_debug()) {
+    express_cat.debug()
+      << "Allocating " << _length << " bytes to read "
+      << (filename.empty() ? string("stream") : filename.get_fullpath()) << "\n";
+  }
+  _buffer = (char *)PANDA_MALLOC_ARRAY(std::max(_length, (uint32_t)1));
+  stream.seekg(0, ios::beg);
+  stream.read(_buffer, _length);
+  _data = _buffer;
+}
+
+/**
+ *
+ */
+BuildSource::
+~BuildSource() {
+  if (_buffer != nullptr) {
+    PANDA_FREE_ARRAY(_buffer);
+  }
+#ifdef _WIN32
+  if (_mapping != nullptr) {
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+  }
+#else
+  if (_mapped_size != 0) {
+    munmap((void *)_data, _mapped_size);
+  }
+#endif
+}
+
+/**
+ * Attempts to map the indicated file, which must be at least _length bytes
+ * long, into memory.  Returns true on success.
+ */
+bool BuildSource::
+map_file(const Filename &filename) {
+#ifdef _WIN32
+  std::wstring wos_specific = filename.to_os_specific_w();
+  HANDLE handle = CreateFileW(wos_specific.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  _mapping = CreateFileMapping(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (_mapping == nullptr) {
+    return false;
+  }
+  _data = (const char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, _length);
+  if (_data == nullptr) {
+    CloseHandle(_mapping);
+    _mapping = nullptr;
+    return false;
+  }
+  return true;
+
+#else
+  string os_specific = filename.to_os_specific();
+  int fd = open(os_specific.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < (uint64_t)_length) {
+    close(fd);
+    return false;
+  }
+  void *data = mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  _data = (const char *)data;
+  _mapped_size = _length;
+  return true;
+#endif
+}
+
 #endif // HAVE_OPENSSL
@@ -22,6 +22,7 @@
 #include "pnotify.h"
 #include "filename.h"
 #include "plist.h"
+#include "pvector.h"
 #include "datagram.h"
 #include "datagramIterator.h"
 #include "buffer.h"
@@ -79,14 +80,34 @@ private:
 
 private:
   // stuff for the build operation
+  class BuildMatch {
+  public:
+    uint32_t _new_pos;
+    uint32_t _copy_pos;
+    uint32_t _length;
+  };
+  typedef pvector<BuildMatch> BuildMatches;
+
   void build_hash_link_tables(const char *buffer_orig, uint32_t length_orig,
     uint32_t *hash_table, uint32_t *link_table);
-  uint32_t calc_hash(const char *buffer);
-  void find_longest_match(uint32_t new_pos, uint32_t &copy_pos, uint16_t &copy_length,
-    uint32_t *hash_table, uint32_t *link_table, const char* buffer_orig,
-    uint32_t length_orig, const char* buffer_new, uint32_t length_new);
-  uint32_t calc_match_length(const char* buf1, const char* buf2, uint32_t max_length,
+  uint32_t calc_hash(const char *buffer) const;
+  INLINE uint32_t roll_hash(uint32_t hash, const char *buffer) const;
+  INLINE static uint32_t get_hash_index(uint32_t hash);
+  void find_longest_match(uint32_t new_pos, uint32_t hash_index,
+    uint32_t &copy_pos, uint16_t &copy_length,
+    const uint32_t *hash_table, const uint32_t *link_table, const char* buffer_orig,
+    uint32_t length_orig, const char* buffer_new, uint32_t length_new) const;
+  static uint32_t calc_match_length(const char* buf1, const char* buf2, uint32_t max_length,
     uint32_t min_length);
+  void find_chunk_matches(BuildMatches &matches,
+    uint32_t chunk_begin, uint32_t chunk_end,
+    const uint32_t *hash_table, const uint32_t *link_table,
+    const char *buffer_orig, uint32_t length_orig,
+    const char *buffer_new, uint32_t length_new) const;
+  void find_all_matches(pvector<BuildMatches> &chunk_matches,
+    const uint32_t *hash_table, const uint32_t *link_table,
+    const char *buffer_orig, uint32_t length_orig,
+    const char *buffer_new, uint32_t length_new) const;
 
   void emit_ADD(std::ostream &write_stream, uint32_t length, const char* buffer);
   void emit_COPY(std::ostream &write_stream, uint32_t length, uint32_t COPY_pos);
@@ -104,7 +125,8 @@ private:
 
   bool compute_file_patches(std::ostream &write_stream,
                             uint32_t offset_orig, uint32_t offset_new,
-                             std::istream &stream_orig, std::istream &stream_new);
+                            std::istream &stream_orig, std::istream &stream_new,
+                            const Filename &map_orig, const Filename &map_new);
   bool compute_mf_patches(std::ostream &write_stream,
                           uint32_t offset_orig, uint32_t offset_new,
                           std::istream &stream_orig, std::istream &stream_new);
@@ -112,7 +134,8 @@ private:
   bool do_compute_patches(const Filename &file_orig, const Filename &file_new,
                           std::ostream &write_stream,
                           uint32_t offset_orig, uint32_t offset_new,
-                          std::istream &stream_orig, std::istream &stream_new);
+                          std::istream &stream_orig, std::istream &stream_new,
+                          bool whole_files = false);
 
   bool patch_subfile(std::ostream &write_stream,
                      uint32_t offset_orig, uint32_t offset_new,
@@ -126,11 +149,15 @@ private:
   static const uint32_t _NULL_VALUE;
   static const uint32_t _MAX_RUN_LENGTH;
   static const uint32_t _HASH_MASK;
+  static const uint32_t _HASH_MULTIPLIER;
+  static const uint32_t _BUILD_CHUNK_SIZE;
 
   bool _allow_multifile;
   uint32_t _footprint_length;
 
   uint32_t *_hash_table;
+  uint32_t _hash_roll_factor;
+  uint32_t _index_stride;
 
   uint32_t _add_pos;
   uint32_t _last_copy_pos;
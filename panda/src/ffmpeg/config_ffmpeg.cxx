@@ -58,6 +58,14 @@ ConfigVariableInt ffmpeg_max_readahead_frames
           "should read in advance of actual playback.  Set this to 0 to "
           "decode ffmpeg videos in the main thread."));
 
+ConfigVariableInt ffmpeg_decode_threads
+("ffmpeg-decode-threads", 0,
+ PRC_DESC("The number of threads in the pool that decodes ffmpeg videos "
+          "whose max-readahead-frames is nonzero.  These threads are shared "
+          "between all videos, and always work on whichever video is "
+          "closest to running out of decoded frames.  Set this to 0 to use "
+          "one thread per CPU."));
+
 ConfigVariableBool ffmpeg_show_seek_frames
 ("ffmpeg-show-seek-frames", true,
  PRC_DESC("Set this true to allow showing the intermediate results of seeking "
@@ -26,6 +26,7 @@ ConfigureDecl(config_ffmpeg, EXPCL_FFMPEG, EXPTP_FFMPEG);
 NotifyCategoryDecl(ffmpeg, EXPCL_FFMPEG, EXPTP_FFMPEG);
 
 extern ConfigVariableInt ffmpeg_max_readahead_frames;
+extern ConfigVariableInt ffmpeg_decode_threads;
 extern ConfigVariableBool ffmpeg_show_seek_frames;
 extern ConfigVariableBool ffmpeg_support_seek;
 extern ConfigVariableBool ffmpeg_global_lock;
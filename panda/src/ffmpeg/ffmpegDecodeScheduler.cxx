@@ -0,0 +1,222 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file ffmpegDecodeScheduler.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "ffmpegDecodeScheduler.h"
+#include "ffmpegVideoCursor.h"
+#include "config_ffmpeg.h"
+#include "mutexHolder.h"
+#include "trueClock.h"
+#include "pStatClient.h"
+#include "thread.h"
+
+#include <algorithm>
+#include <thread>
+
+FfmpegDecodeScheduler *FfmpegDecodeScheduler::_global_ptr = nullptr;
+
+PStatCollector FfmpegDecodeScheduler::_latency_pcollector("FFMPEG Decode latency");
+
+/**
+ *
+ */
+FfmpegDecodeScheduler::
+FfmpegDecodeScheduler() :
+  _lock("FfmpegDecodeScheduler::_lock"),
+  _cvar(_lock)
+{
+  _num_threads = ffmpeg_decode_threads;
+  if (_num_threads <= 0) {
+    _num_threads = std::max((int)std::thread::hardware_concurrency(), 1);
+  }
+}
+
+/**
+ * Registers a cursor with the scheduler, so that it may subsequently post
+ * requests with request().  This also starts the threads in the pool, if
+ * they have not already been started.  Returns false if no threads could be
+ * started, in which case the cursor must do its own decoding.
+ */
+bool FfmpegDecodeScheduler::
+add_cursor(FfmpegVideoCursor *cursor) {
+  MutexHolder holder(_lock);
+  if (_threads.empty()) {
+    start_threads();
+    if (_threads.empty()) {
+      return false;
+    }
+  }
+
+  cursor->_decode_registered = true;
+  cursor->_decode_queued = false;
+  return true;
+}
+
+/**
+ * Unregisters a cursor from the scheduler.  Any pending request is removed
+ * from the queue, and if one of the threads is currently servicing the
+ * cursor, this blocks until it has finished.  This must not be called while
+ * holding the cursor's lock.
+ */
+void FfmpegDecodeScheduler::
+remove_cursor(FfmpegVideoCursor *cursor) {
+  MutexHolder holder(_lock);
+  cursor->_decode_registered = false;
+
+  if (cursor->_decode_queued) {
+    Cursors::iterator ci = std::find(_queue.begin(), _queue.end(), cursor);
+    nassertv(ci != _queue.end());
+    _queue.erase(ci);
+    cursor->_decode_queued = false;
+  }
+
+  while (cursor->_decode_busy) {
+    _cvar.wait();
+  }
+}
+
+/**
+ * Called by a cursor, with its own lock held, to indicate that it has work
+ * for the pool to do.  The slack is the number of seconds of video the
+ * cursor has already buffered ahead of the frame that is currently being
+ * displayed; the cursor with the least remaining time is serviced first.
+ */
+void FfmpegDecodeScheduler::
+request(FfmpegVideoCursor *cursor, double slack) {
+  double now = TrueClock::get_global_ptr()->get_short_time();
+  double deadline = now + slack;
+
+  MutexHolder holder(_lock);
+  if (!cursor->_decode_registered) {
+    return;
+  }
+
+  if (cursor->_decode_queued) {
+    // Already waiting; just make sure it isn't kept waiting longer than
+    // necessary.
+    cursor->_decode_deadline = std::min(cursor->_decode_deadline, deadline);
+  } else {
+    cursor->_decode_queued = true;
+    cursor->_decode_deadline = deadline;
+    cursor->_decode_request_time = now;
+    _queue.push_back(cursor);
+  }
+  _cvar.notify();
+}
+
+/**
+ * Returns the global FfmpegDecodeScheduler object.
+ */
+FfmpegDecodeScheduler *FfmpegDecodeScheduler::
+get_global_ptr() {
+  if (_global_ptr == nullptr) {
+    _global_ptr = new FfmpegDecodeScheduler;
+  }
+  return _global_ptr;
+}
+
+/**
+ * Creates and starts the threads in the pool.  Assumes the lock is held.
+ */
+void FfmpegDecodeScheduler::
+start_threads() {
+  if (ffmpeg_cat.is_debug()) {
+    ffmpeg_cat.debug()
+      << "Starting " << _num_threads << " ffmpeg decoding threads.\n";
+  }
+
+  for (int i = 0; i < _num_threads; ++i) {
+    std::ostringstream strm;
+    strm << "ffmpeg_decode_" << i;
+    PT(GenericThread) thread = new GenericThread(strm.str(), "ffmpeg_decode", st_thread_main, this);
+    if (thread->start(ffmpeg_thread_priority, true)) {
+      _threads.push_back(thread);
+    }
+  }
+
+  if (_threads.empty()) {
+    ffmpeg_cat.error()
+      << "Couldn't start any ffmpeg decoding threads.\n";
+  }
+}
+
+/**
+ * Removes the queued cursor with the earliest deadline that is not already
+ * being serviced by another thread, marks it busy, and returns it.  Returns
+ * NULL if there is no such cursor.  Assumes the lock is held.
+ */
+FfmpegVideoCursor *FfmpegDecodeScheduler::
+choose_cursor() {
+  Cursors::iterator best = _queue.end();
+  for (Cursors::iterator ci = _queue.begin(); ci != _queue.end(); ++ci) {
+    if (!(*ci)->_decode_busy &&
+        (best == _queue.end() || (*ci)->_decode_deadline < (*best)->_decode_deadline)) {
+      best = ci;
+    }
+  }
+
+  if (best == _queue.end()) {
+    return nullptr;
+  }
+
+  FfmpegVideoCursor *cursor = *best;
+  *best = _queue.back();
+  _queue.pop_back();
+
+  cursor->_decode_queued = false;
+  cursor->_decode_busy = true;
+  return cursor;
+}
+
+/**
+ * The thread main function, static version (for passing to GenericThread).
+ */
+void FfmpegDecodeScheduler::
+st_thread_main(void *self) {
+  ((FfmpegDecodeScheduler *)self)->thread_main();
+}
+
+/**
+ * The thread main function.  Services cursors forever, in order of their
+ * deadlines.
+ */
+void FfmpegDecodeScheduler::
+thread_main() {
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  MutexHolder holder(_lock);
+  while (true) {
+    FfmpegVideoCursor *cursor = choose_cursor();
+    if (cursor == nullptr) {
+      _cvar.wait();
+      continue;
+    }
+
+    // The cursor is marked busy, so it can't be destructed out from under us
+    // until we have finished with it.
+    double request_time = cursor->_decode_request_time;
+    _lock.release();
+
+    if (cursor->service_decode()) {
+      _latency_pcollector.set_level(clock->get_short_time() - request_time);
+    }
+    PStatClient::thread_tick("ffmpeg_decode");
+    Thread::consider_yield();
+
+    _lock.acquire();
+    cursor->_decode_busy = false;
+
+    // Wake up anyone waiting in remove_cursor(), as well as any thread that
+    // skipped over this cursor while it was busy.
+    _cvar.notify_all();
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file ffmpegDecodeScheduler.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef FFMPEGDECODESCHEDULER_H
+#define FFMPEGDECODESCHEDULER_H
+
+#include "pandabase.h"
+#include "genericThread.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+
+class FfmpegVideoCursor;
+
+/**
+ * A fixed pool of threads that decode video on behalf of all of the
+ * FfmpegVideoCursors that have a nonzero max_readahead_frames.
+ *
+ * Rather than each cursor owning a thread of its own, a cursor that has work
+ * to do posts a request to this scheduler along with a deadline: the time at
+ * which the frames it has already buffered will have run out.  Whenever a
+ * thread in the pool becomes free, it services the cursor with the earliest
+ * deadline.  A cursor is only ever serviced by one thread at a time.
+ *
+ * The number of threads is controlled by ffmpeg-decode-threads.
+ */
+class EXPCL_FFMPEG FfmpegDecodeScheduler {
+private:
+  FfmpegDecodeScheduler();
+
+public:
+  bool add_cursor(FfmpegVideoCursor *cursor);
+  void remove_cursor(FfmpegVideoCursor *cursor);
+  void request(FfmpegVideoCursor *cursor, double slack);
+
+  INLINE int get_num_threads() const;
+
+  static FfmpegDecodeScheduler *get_global_ptr();
+
+private:
+  void start_threads();
+  FfmpegVideoCursor *choose_cursor();
+
+  static void st_thread_main(void *self);
+  void thread_main();
+
+  // Protects all of the following members, as well as the _decode_*
+  // members of each FfmpegVideoCursor.
+  Mutex _lock;
+
+  // Condition: a cursor has been queued, or has finished being serviced.
+  ConditionVar _cvar;
+
+  typedef pvector<FfmpegVideoCursor *> Cursors;
+  Cursors _queue;
+
+  typedef pvector<PT(GenericThread) > Threads;
+  Threads _threads;
+  int _num_threads;
+
+  static FfmpegDecodeScheduler *_global_ptr;
+
+  static PStatCollector _latency_pcollector;
+};
+
+#include "ffmpegDecodeScheduler.I"
+
+#endif
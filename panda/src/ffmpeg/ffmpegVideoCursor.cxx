@@ -12,6 +12,7 @@
  */
 
 #include "ffmpegVideoCursor.h"
+#include "ffmpegDecodeScheduler.h"
 #include "config_ffmpeg.h"
 #include "pStatCollector.h"
 #include "pStatTimer.h"
@@ -19,6 +20,7 @@
 #include "reMutexHolder.h"
 #include "ffmpegVideo.h"
 #include "bamReader.h"
+#include "convert_yuv.h"
 extern "C" {
   #include <libavcodec/avcodec.h>
   #include <libavformat/avformat.h>
@@ -35,6 +37,7 @@ TypeHandle FfmpegVideoCursor::FfmpegBuffer::_type_handle;
 PStatCollector FfmpegVideoCursor::_fetch_buffer_pcollector("*:FFMPEG Video Decoding:Fetch");
 PStatCollector FfmpegVideoCursor::_seek_pcollector("*:FFMPEG Video Decoding:Seek");
 PStatCollector FfmpegVideoCursor::_export_frame_pcollector("*:FFMPEG Convert Video to BGR");
+PStatCollector FfmpegVideoCursor::_dropped_frames_pcollector("FFMPEG Dropped frames");
 
 #if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(52, 32, 100)
   #define AV_PIX_FMT_FLAG_ALPHA PIX_FMT_ALPHA
@@ -48,9 +51,13 @@ FfmpegVideoCursor() :
   _max_readahead_frames(0),
   _thread_priority(ffmpeg_thread_priority),
   _lock("FfmpegVideoCursor::_lock"),
-  _action_cvar(_lock),
   _thread_status(TS_stopped),
   _seek_frame(0),
+  _decode_registered(false),
+  _decode_queued(false),
+  _decode_busy(false),
+  _decode_deadline(0.0),
+  _decode_request_time(0.0),
   _packet(nullptr),
   _format_ctx(nullptr),
   _video_ctx(nullptr),
@@ -69,7 +76,7 @@ FfmpegVideoCursor() :
  */
 void FfmpegVideoCursor::
 init_from(FfmpegVideo *source) {
-  nassertv(_thread == nullptr && _thread_status == TS_stopped);
+  nassertv(_thread_status == TS_stopped);
   nassertv(source != nullptr);
   _source = source;
   _filename = _source->get_filename();
@@ -139,7 +146,12 @@ init_from(FfmpegVideo *source) {
                                 _size_x, _size_y, (AVPixelFormat)_pixel_format,
                                 SWS_BILINEAR | SWS_PRINT_INFO, nullptr, nullptr, nullptr);
 #else
-  if (_video_ctx->pix_fmt != _pixel_format) {
+  if (_video_ctx->pix_fmt == AV_PIX_FMT_YUV420P ||
+      _video_ctx->pix_fmt == AV_PIX_FMT_YUVJ420P) {
+    // We can convert this one ourselves; see export_frame().
+    nassertv(_pixel_format == (int)AV_PIX_FMT_BGR24);
+
+  } else if (_video_ctx->pix_fmt != _pixel_format) {
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(_video_ctx->pix_fmt);
     ffmpeg_cat.error()
       << "Video with pixel format " << (desc ? desc->name : "?")
@@ -162,9 +174,13 @@ FfmpegVideoCursor(FfmpegVideo *src) :
   _max_readahead_frames(0),
   _thread_priority(ffmpeg_thread_priority),
   _lock("FfmpegVideoCursor::_lock"),
-  _action_cvar(_lock),
   _thread_status(TS_stopped),
   _seek_frame(0),
+  _decode_registered(false),
+  _decode_queued(false),
+  _decode_busy(false),
+  _decode_deadline(0.0),
+  _decode_request_time(0.0),
   _packet(nullptr),
   _format_ctx(nullptr),
   _video_ctx(nullptr),
@@ -188,8 +204,9 @@ FfmpegVideoCursor::
 /**
  * Specifies the maximum number of frames that a sub-thread will attempt to
  * read ahead of the current frame.  Setting this to a nonzero allows the
- * video decoding to take place in a sub-thread, which smoothes out the video
- * decoding time by spreading it evenly over several frames.  Set this number
+ * video decoding to take place in one of the threads of the shared decoding
+ * pool (see ffmpeg-decode-threads), which smoothes out the video decoding
+ * time by spreading it evenly over several frames.  Set this number
  * larger to increase the buffer between the currently visible frame and the
  * first undecoded frame; set it smaller to reduce memory consumption.
  *
@@ -229,27 +246,20 @@ get_max_readahead_frames() const {
 }
 
 /**
- * Changes the thread priority of the thread that decodes the ffmpeg video
- * stream (if max_readahead_frames is nonzero).  Normally you shouldn't mess
- * with this, but there may be special cases where a precise balance of CPU
- * utilization between the main thread and the various ffmpeg service threads
- * may be needed.
+ * Changes the thread priority associated with this cursor.
+ *
+ * @deprecated Video is now decoded by a pool of threads shared between all
+ * cursors, which always run at ffmpeg-thread-priority; the threads service
+ * whichever cursor is closest to running out of frames.  This value is
+ * retained for compatibility only, and has no effect.
  */
 void FfmpegVideoCursor::
 set_thread_priority(ThreadPriority thread_priority) {
-  if (_thread_priority != thread_priority) {
-    _thread_priority = thread_priority;
-    if (is_thread_started()) {
-      stop_thread();
-      start_thread();
-    }
-  }
+  _thread_priority = thread_priority;
 }
 
 /**
- * Returns the current thread priority of the thread that decodes the ffmpeg
- * video stream (if max_readahead_frames is nonzero).  See
- * set_thread_priority().
+ * Returns the value most recently passed to set_thread_priority().
  */
 ThreadPriority FfmpegVideoCursor::
 get_thread_priority() const {
@@ -257,68 +267,66 @@ get_thread_priority() const {
 }
 
 /**
- * Explicitly starts the ffmpeg decoding thread after it has been stopped by a
- * call to stop_thread().  The thread is normally started automatically, so
- * there is no need to call this method unless you have previously called
- * stop_thread() for some reason.
+ * Explicitly hands this cursor back to the shared ffmpeg decoding threads
+ * after it has been stopped by a call to stop_thread().  This normally
+ * happens automatically, so there is no need to call this method unless you
+ * have previously called stop_thread() for some reason.
  */
 void FfmpegVideoCursor::
 start_thread() {
-  MutexHolder holder(_lock);
+  if (_thread_status != TS_stopped || _max_readahead_frames <= 0) {
+    return;
+  }
 
-  if (_thread_status == TS_stopped && _max_readahead_frames > 0) {
-    // Get a unique name for the thread's sync name.
-    std::ostringstream strm;
-    strm << (void *)this;
-    _sync_name = strm.str();
-
-    // Create and start the thread object.
-    _thread_status = TS_wait;
-    _thread = new GenericThread(_filename.get_basename(), _sync_name, st_thread_main, this);
-    if (!_thread->start(_thread_priority, true)) {
-      // Couldn't start the thread.
-      _thread = nullptr;
-      _thread_status = TS_stopped;
-    }
+  FfmpegDecodeScheduler *scheduler = FfmpegDecodeScheduler::get_global_ptr();
+  if (!scheduler->add_cursor(this)) {
+    // Couldn't start the threads.
+    return;
+  }
+
+  MutexHolder holder(_lock);
+  if (_thread_status == TS_stopped) {
+    // The first thing the decoding thread does is to queue up the frame that
+    // was decoded when the stream was opened.
+    _thread_status = TS_start;
+    do_request_decode();
   }
 }
 
 /**
- * Explicitly stops the ffmpeg decoding thread.  There is normally no reason
- * to do this unless you want to maintain precise control over what threads
- * are consuming CPU resources.  Calling this method will make the video
- * update in the main thread, regardless of the setting of
- * max_readahead_frames, until you call start_thread() again.
+ * Explicitly stops decoding this video in the shared ffmpeg decoding
+ * threads.  There is normally no reason to do this unless you want to
+ * maintain precise control over what threads are consuming CPU resources.
+ * Calling this method will make the video update in the main thread,
+ * regardless of the setting of max_readahead_frames, until you call
+ * start_thread() again.
  */
 void FfmpegVideoCursor::
 stop_thread() {
   if (_thread_status != TS_stopped) {
-    PT(GenericThread) thread = _thread;
     {
       MutexHolder holder(_lock);
       if (_thread_status != TS_stopped) {
         _thread_status = TS_shutdown;
       }
-      _action_cvar.notify();
-      _thread = nullptr;
     }
 
-    // Now that we've released the lock, we can join the thread.
-    thread->join();
+    // Now that we've released the lock, we can wait for the decoding thread
+    // to finish with us, if it is currently doing anything.
+    FfmpegDecodeScheduler::get_global_ptr()->remove_cursor(this);
   }
 
-  // This is a good time to clean up all of the allocated frame objects.  It's
-  // not really necessary to be holding the lock, since the thread is gone,
-  // but we'll grab it anyway just in case someone else starts the thread up
-  // again.
+  // This is a good time to clean up all of the allocated frame objects.
   MutexHolder holder(_lock);
 
+  _thread_status = TS_stopped;
   _readahead_frames.clear();
+  _free_frames.clear();
 }
 
 /**
- * Returns true if the thread has been started, false if not.  This will
- * always return false if max_readahead_frames is 0.
+ * Returns true if the video is being decoded by the shared decoding threads,
+ * false if not.  This will always return false if max_readahead_frames is 0.
  */
 bool FfmpegVideoCursor::
 is_thread_started() const {
@@ -392,7 +400,6 @@ fetch_buffer() {
     if (!_readahead_frames.empty()) {
       frame = _readahead_frames.front();
       _readahead_frames.pop_front();
-      _action_cvar.notify();
       while (frame->_end_frame < _current_frame && !_readahead_frames.empty()) {
         // This frame is too old.  Discard it.
         if (ffmpeg_cat.is_debug()) {
@@ -401,6 +408,8 @@ fetch_buffer() {
             << " at frame " << _current_frame << ", discarding frame at "
             << frame->_begin_frame << "\n";
         }
+        _dropped_frames_pcollector.add_level(1);
+        do_recycle_frame(frame);
         frame = _readahead_frames.front();
         _readahead_frames.pop_front();
       }
@@ -417,7 +426,6 @@ fetch_buffer() {
         if (_thread_status == TS_wait || _thread_status == TS_seek || _thread_status == TS_readahead) {
           _thread_status = TS_seek;
           _seek_frame = _current_frame;
-          _action_cvar.notify();
         }
       }
     }
@@ -426,9 +434,12 @@ fetch_buffer() {
       if (_thread_status == TS_wait || _thread_status == TS_seek || _thread_status == TS_readahead) {
         _thread_status = TS_seek;
         _seek_frame = _current_frame;
-        _action_cvar.notify();
       }
     }
+
+    // Either we've made room in the readahead queue, or we want a seek.  In
+    // both cases, let the decoding threads know we need attention.
+    do_request_decode();
   }
 
   if (frame != nullptr) {
@@ -436,11 +447,15 @@ fetch_buffer() {
     bool too_new = frame->_begin_frame > _current_frame;
     if (too_old || too_new) {
       // The frame is too old or too new.  Just recycle it.
+      do_recycle_frame(frame);
       frame = nullptr;
     }
   }
 
   if (frame != nullptr) {
+    if (_current_frame_buffer != nullptr) {
+      do_recycle_frame(_current_frame_buffer);
+    }
     _current_frame_buffer = frame;
     if (ffmpeg_cat.is_debug()) {
       ffmpeg_cat.debug()
@@ -669,52 +684,59 @@ cleanup() {
 }
 
 /**
- * The thread main function, static version (for passing to GenericThread).
+ * Tells the decoding threads that this cursor has something for them to do,
+ * and how soon it needs to be done.  Assumes the lock is held.
  */
 void FfmpegVideoCursor::
-st_thread_main(void *self) {
-  ((FfmpegVideoCursor *)self)->thread_main();
-}
-
-/**
- * The thread main function.
- */
-void FfmpegVideoCursor::
-thread_main() {
-  if (ffmpeg_cat.is_spam()) {
-    ffmpeg_cat.spam()
-      << "ffmpeg thread for " << _filename.get_basename() << " starting.\n";
+do_request_decode() {
+  if (_thread_status == TS_stopped || _thread_status == TS_wait ||
+      _thread_status == TS_shutdown) {
+    return;
+  }
+  if (_thread_status == TS_readahead &&
+      (int)_readahead_frames.size() >= _max_readahead_frames) {
+    // No room for another frame yet.
+    return;
   }
 
-  // First, push the first frame onto the readahead queue.
-  if (_frame_ready) {
-    PT(FfmpegBuffer) frame = do_alloc_frame();
-    export_frame(frame);
-    MutexHolder holder(_lock);
-    _readahead_frames.push_back(frame);
+  // The deadline is the point at which we run out of decoded frames.  If we
+  // need to seek, or don't have anything buffered, the need is immediate.
+  double slack = 0.0;
+  if (_thread_status == TS_readahead) {
+    int last_frame;
+    if (!_readahead_frames.empty()) {
+      last_frame = _readahead_frames.back()->_end_frame;
+    } else if (_current_frame_buffer != nullptr) {
+      last_frame = _current_frame_buffer->_end_frame;
+    } else {
+      last_frame = _current_frame;
+    }
+    slack = (last_frame - _current_frame) * _video_timebase;
   }
 
-  // Now repeatedly wait for something interesting to do, until we're told to
-  // shut down.
-  MutexHolder holder(_lock);
-  while (_thread_status != TS_shutdown) {
-    nassertv(_thread_status != TS_stopped);
-    _action_cvar.wait();
+  FfmpegDecodeScheduler::get_global_ptr()->request(this, slack);
+}
 
-    while (do_poll()) {
-      // Keep doing stuff as long as there's something to do.
-      _lock.release();
-      PStatClient::thread_tick(_sync_name);
-      Thread::consider_yield();
-      _lock.acquire();
-    }
+/**
+ * Called by one of the FfmpegDecodeScheduler's threads when this cursor is
+ * due to be serviced.  Performs one step of decoding work, and queues up
+ * another request if there may be more to do.  Returns true if any work was
+ * done, false otherwise.
+ */
+bool FfmpegVideoCursor::
+service_decode() {
+  MutexHolder holder(_lock);
+  if (_thread_status == TS_stopped || _thread_status == TS_shutdown) {
+    return false;
   }
 
-  _thread_status = TS_stopped;
-  if (ffmpeg_cat.is_spam()) {
-    ffmpeg_cat.spam()
-      << "ffmpeg thread for " << _filename.get_basename() << " stopped.\n";
+  if (!do_poll()) {
+    // Nothing to do until fetch_buffer() consumes a frame or asks for a seek.
+    return false;
   }
+
+  do_request_decode();
+  return true;
 }
 
 /**
@@ -731,6 +753,21 @@ do_poll() {
     nassertr(false, false);
     return false;
 
+  case TS_start:
+    // Push the first frame onto the readahead queue.
+    if (_frame_ready) {
+      PT(FfmpegBuffer) frame = do_alloc_frame();
+      nassertr(frame != nullptr, false);
+      _lock.release();
+      export_frame(frame);
+      _lock.acquire();
+      _readahead_frames.push_back(frame);
+    }
+    if (_thread_status == TS_start) {
+      _thread_status = TS_wait;
+    }
+    return true;
+
   case TS_wait:
     // The video hasn't started playing yet.
     return false;
@@ -793,19 +830,51 @@ do_poll() {
 }
 
 /**
- * Allocates a new Buffer object.  Assumes the lock is held.
+ * Returns a Buffer object to decode a frame into.  A previously recycled
+ * buffer is reused if nobody else is still holding on to it; otherwise, a new
+ * one is allocated.  Assumes the lock is held.
  */
 PT(FfmpegVideoCursor::FfmpegBuffer) FfmpegVideoCursor::
 do_alloc_frame() {
+  FreeBuffers::iterator fi;
+  for (fi = _free_frames.begin(); fi != _free_frames.end(); ++fi) {
+    if ((*fi)->get_ref_count() == 1 && (*fi)->_image.get_ref_count() == 1) {
+      // Only the free list references this one, and no Texture has adopted
+      // its memory as a RAM image, so nobody can be looking at its contents
+      // any more.
+      PT(FfmpegBuffer) frame = *fi;
+      _free_frames.erase(fi);
+      return frame;
+    }
+  }
+
   PT(Buffer) buffer = make_new_buffer();
   return (FfmpegBuffer *)buffer.p();
 }
 
+/**
+ * Puts a buffer that is no longer needed onto the free list, so that
+ * do_alloc_frame() can reuse its memory once the last outside reference to
+ * it goes away.  Assumes the lock is held.
+ */
+void FfmpegVideoCursor::
+do_recycle_frame(FfmpegBuffer *frame) {
+  // There's no point in keeping more buffers around than can be in flight at
+  // once: a full readahead queue, plus the frame being displayed and the one
+  // being decoded.
+  if ((int)_free_frames.size() < _max_readahead_frames + 2) {
+    _free_frames.push_back(frame);
+  }
+}
+
 /**
  * Empties the entire readahead_frames queue.  Assumes the lock is held.
  */
 void FfmpegVideoCursor::
 do_clear_all_frames() {
+  for (FfmpegBuffer *frame : _readahead_frames) {
+    do_recycle_frame(frame);
+  }
   _readahead_frames.clear();
 }
 
@@ -1183,6 +1252,18 @@ export_frame(FfmpegBuffer *buffer) {
   }
 #else
   nassertv(_frame != nullptr);
+  if (_video_ctx->pix_fmt == AV_PIX_FMT_YUV420P ||
+      _video_ctx->pix_fmt == AV_PIX_FMT_YUVJ420P) {
+    convert_yuv420_to_bgr(_frame_out->data[0], _frame_out->linesize[0], _num_components,
+                          _frame->data[0], _frame->linesize[0],
+                          _frame->data[1], _frame->linesize[1],
+                          _frame->data[2], _frame->linesize[2],
+                          _size_x, _size_y,
+                          _video_ctx->pix_fmt == AV_PIX_FMT_YUVJ420P ||
+                          _video_ctx->color_range == AVCOL_RANGE_JPEG);
+    return;
+  }
+
   uint8_t const *src = _frame->data[0];
   uint8_t *dst = _frame_out->data[0];
   int src_stride = _frame->linesize[0];
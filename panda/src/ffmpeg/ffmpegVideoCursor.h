@@ -19,12 +19,11 @@
 #include "texture.h"
 #include "pointerTo.h"
 #include "ffmpegVirtualFile.h"
-#include "genericThread.h"
 #include "threadPriority.h"
 #include "pmutex.h"
 #include "reMutex.h"
-#include "conditionVar.h"
 #include "pdeque.h"
+#include "pvector.h"
 
 class FfmpegVideo;
 struct AVFormatContext;
@@ -100,10 +99,8 @@ private:
   void cleanup();
 
   Filename _filename;
-  std::string _sync_name;
   int _max_readahead_frames;
   ThreadPriority _thread_priority;
-  PT(GenericThread) _thread;
 
   int _pixel_format;
 
@@ -113,13 +110,17 @@ private:
   // Protects _readahead_frames and all the immediately following members.
   Mutex _lock;
 
-  // Condition: the thread has something to do.
-  ConditionVar _action_cvar;
-
   typedef pdeque<PT(FfmpegBuffer) > Buffers;
   Buffers _readahead_frames;
+
+  // Buffers that are no longer queued, and may be reused for decoding new
+  // frames once nobody else holds a reference to them.
+  typedef pvector<PT(FfmpegBuffer) > FreeBuffers;
+  FreeBuffers _free_frames;
+
   enum ThreadStatus {
     TS_stopped,
+    TS_start,
     TS_wait,
     TS_readahead,
     TS_seek,
@@ -132,13 +133,22 @@ private:
   int _current_frame;
   PT(FfmpegBuffer) _current_frame_buffer;
 
+  // These are protected by the FfmpegDecodeScheduler's lock, not by _lock.
+  bool _decode_registered;
+  bool _decode_queued;
+  bool _decode_busy;
+  double _decode_deadline;
+  double _decode_request_time;
+
 private:
+  void do_request_decode();
+
   // The following functions will be called in the sub-thread.
-  static void st_thread_main(void *self);
-  void thread_main();
+  bool service_decode();
   bool do_poll();
 
   PT(FfmpegBuffer) do_alloc_frame();
+  void do_recycle_frame(FfmpegBuffer *frame);
   void do_clear_all_frames();
 
   bool fetch_packet(int default_frame);
@@ -177,6 +187,7 @@ private:
   static PStatCollector _fetch_buffer_pcollector;
   static PStatCollector _seek_pcollector;
   static PStatCollector _export_frame_pcollector;
+  static PStatCollector _dropped_frames_pcollector;
 
 public:
   static void register_with_read_factory();
@@ -207,6 +218,7 @@ private:
   static TypeHandle _type_handle;
 
   friend class FfmpegVideo;
+  friend class FfmpegDecodeScheduler;
 };
 
 #include "ffmpegVideoCursor.I"
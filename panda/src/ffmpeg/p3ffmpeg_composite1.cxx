@@ -1,5 +1,6 @@
 #include "config_ffmpeg.cxx"
 #include "ffmpegAudio.cxx"
+#include "ffmpegDecodeScheduler.cxx"
 #include "ffmpegVideo.cxx"
 #include "ffmpegVirtualFile.cxx"
 #include "ffmpegAudioCursor.cxx"
@@ -249,6 +249,15 @@ ConfigVariableBool preserve_triangle_strips
           "effective at combining multiple Geoms together, but they will "
           "not implicitly decompose triangle strips."));
 
+ConfigVariableInt vertex_cache_size
+("vertex-cache-size", 32,
+ PRC_DESC("This is the number of entries assumed for the post-transform "
+          "vertex cache of the graphics hardware, when triangles are "
+          "reordered by Geom::optimize_vertex_cache() and when the average "
+          "cache miss ratio is computed by calc_acmr().  Modern hardware "
+          "typically has an effective cache size somewhere between 16 and "
+          "32 vertices; the ordering is not very sensitive to this value."));
+
 ConfigVariableBool dump_generated_shaders
 ("dump-generated-shaders", false,
  PRC_DESC("Set this true to cause all generated shaders to be written "
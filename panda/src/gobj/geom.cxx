@@ -13,6 +13,7 @@
 
 #include "geom.h"
 #include "geomPoints.h"
+#include "geomSimplifier.h"
 #include "geomVertexReader.h"
 #include "geomVertexRewriter.h"
 #include "graphicsStateGuardianBase.h"
@@ -927,6 +928,138 @@ make_adjacency_in_place() {
   nassertv(all_is_valid);
 }
 
+/**
+ * Reorders the primitives within this Geom for better use of the
+ * post-transform vertex cache, and to reduce overdraw, leaving the results in
+ * place.  Triangle strips and fans are decomposed first, unless
+ * preserve-triangle-strips is set.  See GeomPrimitive::optimize_vertex_cache().
+ *
+ * This does not change the order of the vertices in the GeomVertexData, which
+ * may be shared with other Geoms; see
+ * SceneGraphReducer::optimize_vertex_cache() for that.
+ *
+ * Don't call this in a downstream thread unless you don't mind it blowing
+ * away other changes you might have recently made in an upstream thread.
+ */
+void Geom::
+optimize_vertex_cache_in_place(int cache_size) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+
+  CPT(GeomVertexData) vertex_data = cdata->_data.get_read_pointer(current_thread);
+
+#ifndef NDEBUG
+  GeomVertexDataPipelineReader data_reader(vertex_data, current_thread);
+  data_reader.check_array_readers();
+
+  bool all_is_valid = true;
+#endif
+  Primitives::iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) new_prim = (*pi).get_read_pointer(current_thread);
+    if (new_prim->is_composite() && !preserve_triangle_strips) {
+      new_prim = new_prim->decompose();
+    }
+    new_prim = new_prim->optimize_vertex_cache(cache_size, vertex_data);
+    (*pi) = (GeomPrimitive *)new_prim.p();
+
+#ifndef NDEBUG
+    if (!new_prim->check_valid(&data_reader)) {
+      all_is_valid = false;
+    }
+#endif
+  }
+
+  cdata->_modified = Geom::get_next_modified();
+  reset_geom_rendering(cdata);
+  clear_cache_stage(current_thread);
+
+  nassertv(all_is_valid);
+}
+
+/**
+ * Reduces the number of triangles in this Geom to approximately target_ratio
+ * times the original number, by collapsing the edges that least affect the
+ * shape of the surface, and leaves the result in place.  If max_error is
+ * greater than zero, the simplification stops early rather than moving the
+ * surface by more than approximately this distance.
+ *
+ * No new vertices are created; the triangles are merely rearranged to use a
+ * subset of the existing vertices.  Texture, normal and color seams, open
+ * borders, and the boundaries between differently-weighted parts of an
+ * animated mesh are preserved.  Triangle strips and fans are decomposed
+ * first; primitives other than triangles are left alone.
+ *
+ * The vertex data is left with vertices that are no longer used; see
+ * SceneGraphReducer::simplify(), which also removes these.
+ *
+ * Don't call this in a downstream thread unless you don't mind it blowing
+ * away other changes you might have recently made in an upstream thread.
+ */
+void Geom::
+simplify_in_place(PN_stdfloat target_ratio, PN_stdfloat max_error) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+
+  CPT(GeomVertexData) vertex_data = cdata->_data.get_read_pointer(current_thread);
+  GeomSimplifier simplifier(vertex_data, current_thread);
+
+  pvector<int> indices(cdata->_primitives.size(), -1);
+  for (size_t i = 0; i < cdata->_primitives.size(); ++i) {
+    CPT(GeomPrimitive) prim = cdata->_primitives[i].get_read_pointer(current_thread);
+    if (prim->get_primitive_type() == GeomPrimitive::PT_polygons) {
+      if (prim->is_composite()) {
+        prim = prim->decompose();
+      }
+      if (prim->get_num_vertices_per_primitive() == 3) {
+        indices[i] = simplifier.add_primitive(prim);
+      }
+    }
+  }
+
+  int target = (int)(simplifier.get_num_triangles() * target_ratio + 0.5f);
+  simplifier.simplify(target, max_error);
+
+  for (size_t i = 0; i < cdata->_primitives.size(); ++i) {
+    if (indices[i] >= 0) {
+      PT(GeomPrimitive) new_prim = simplifier.get_primitive(indices[i]);
+      cdata->_primitives[i] = new_prim.p();
+    }
+  }
+
+  cdata->_modified = Geom::get_next_modified();
+  reset_geom_rendering(cdata);
+  clear_cache_stage(current_thread);
+  mark_internal_bounds_stale(cdata);
+}
+
+/**
+ * Returns the average cache miss ratio over all of the primitives in this
+ * Geom, weighted by the number of faces in each.  See
+ * GeomPrimitive::calc_acmr().
+ */
+PN_stdfloat Geom::
+calc_acmr(int cache_size) const {
+  Thread *current_thread = Thread::get_current_thread();
+  CDReader cdata(_cycler, current_thread);
+
+  PN_stdfloat num_misses = 0;
+  int num_faces = 0;
+
+  Primitives::const_iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) prim = (*pi).get_read_pointer(current_thread);
+    int prim_faces = prim->get_num_faces();
+    num_misses += prim->calc_acmr(cache_size) * prim_faces;
+    num_faces += prim_faces;
+  }
+
+  if (num_faces == 0) {
+    return 0;
+  }
+  return num_misses / num_faces;
+}
+
 /**
  * Copies the primitives from the indicated Geom into this one.  This does
  * require that both Geoms contain the same fundamental type primitives, both
@@ -109,6 +109,8 @@ PUBLISHED:
   INLINE PT(Geom) make_lines() const;
   INLINE PT(Geom) make_patches() const;
   INLINE PT(Geom) make_adjacency() const;
+  INLINE PT(Geom) optimize_vertex_cache(int cache_size = 0) const;
+  INLINE PT(Geom) simplify(PN_stdfloat target_ratio, PN_stdfloat max_error = 0.0f) const;
 
   void decompose_in_place();
   void doubleside_in_place();
@@ -119,6 +121,9 @@ PUBLISHED:
   void make_lines_in_place();
   void make_patches_in_place();
   void make_adjacency_in_place();
+  void optimize_vertex_cache_in_place(int cache_size = 0);
+  void simplify_in_place(PN_stdfloat target_ratio, PN_stdfloat max_error = 0.0f);
+  PN_stdfloat calc_acmr(int cache_size = 0) const;
 
   virtual bool copy_primitives_from(const Geom *other);
 
@@ -42,6 +42,7 @@ PStatCollector GeomPrimitive::_decompose_pcollector("*:Munge:Decompose");
 PStatCollector GeomPrimitive::_doubleside_pcollector("*:Munge:Doubleside");
 PStatCollector GeomPrimitive::_reverse_pcollector("*:Munge:Reverse");
 PStatCollector GeomPrimitive::_rotate_pcollector("*:Munge:Rotate");
+PStatCollector GeomPrimitive::_optimize_pcollector("*:Munge:Optimize vertex cache");
 
 /**
  * Constructs an invalid object.  Only used when reading from bam.
@@ -1049,6 +1050,89 @@ make_adjacency() const {
   return nullptr;
 }
 
+/**
+ * Returns a new primitive with the same faces as this one, but rendered in a
+ * different order, chosen so that the vertices of consecutive faces are
+ * likely to still be in the post-transform vertex cache of the graphics
+ * hardware.  This reduces the number of times each vertex must be
+ * transformed.  The vertices within each face keep their relative order, so
+ * the facing and the provoking vertex are not changed.
+ *
+ * If vertex_data is supplied, the faces are additionally gathered into
+ * clusters that are sorted so that those facing outward from the center of
+ * the mesh are drawn first, which tends to reduce overdraw from any
+ * viewpoint.
+ *
+ * cache_size specifies the number of vertices assumed to be in the cache; if
+ * it is 0, the value of vertex-cache-size is used.  Only indexed triangles
+ * are currently reordered; other kinds of primitive are returned unchanged.
+ * Also see calc_acmr().
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size, const GeomVertexData *vertex_data) const {
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Optimizing vertex cache for " << get_type() << ": " << (void *)this << "\n";
+  }
+
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+  nassertr(cache_size > 0, this);
+
+  PStatTimer timer(_optimize_pcollector);
+  return optimize_vertex_cache_impl(cache_size, vertex_data);
+}
+
+/**
+ * Returns the average cache miss ratio (ACMR) of the primitive: that is, the
+ * average number of vertices that must be transformed for each face, given a
+ * first-in, first-out post-transform vertex cache of the indicated size.
+ * For triangles, this ranges from 3.0 in the worst case, where no vertex is
+ * ever reused, down to about 0.5 for a very large regular mesh rendered in an
+ * ideal order.
+ *
+ * If cache_size is 0, the value of vertex-cache-size is used.  Composite
+ * primitives are measured as if they had been decomposed.  Returns 0 if the
+ * primitive is empty.
+ */
+PN_stdfloat GeomPrimitive::
+calc_acmr(int cache_size) const {
+  if (cache_size <= 0) {
+    cache_size = vertex_cache_size;
+  }
+  nassertr(cache_size > 0, 0);
+
+  CPT(GeomPrimitive) prim = decompose();
+  int num_faces = prim->get_num_faces();
+  if (num_faces == 0) {
+    return 0;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader reader(prim, current_thread);
+  reader.check_minmax();
+  int num_vertices = reader.get_num_vertices();
+  int max_vertex = reader.get_max_vertex();
+
+  // Rather than maintaining an actual FIFO, we record for each vertex the
+  // number of misses that had occurred when it was last loaded into the
+  // cache.  A vertex is still in the cache if fewer than cache_size misses
+  // have happened since then.
+  pvector<int> loaded_at(max_vertex + 1, -cache_size);
+  int num_misses = 0;
+  for (int i = 0; i < num_vertices; ++i) {
+    int vertex = reader.get_vertex(i);
+    nassertr(vertex >= 0 && vertex <= max_vertex, 0);
+    if (num_misses - loaded_at[vertex] >= cache_size) {
+      loaded_at[vertex] = num_misses;
+      ++num_misses;
+    }
+  }
+
+  return (PN_stdfloat)num_misses / (PN_stdfloat)num_faces;
+}
+
 /**
  * Returns the number of bytes consumed by the primitive and its index
  * table(s).
@@ -1852,6 +1936,14 @@ reverse_impl() const {
   return this;
 }
 
+/**
+ * The virtual implementation of optimize_vertex_cache().
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache_impl(int cache_size, const GeomVertexData *vertex_data) const {
+  return this;
+}
+
 /**
  * Should be redefined to return true in any primitive that implements
  * append_unused_vertices().
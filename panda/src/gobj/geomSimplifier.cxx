@@ -0,0 +1,612 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomSimplifier.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "geomSimplifier.h"
+#include "geomVertexReader.h"
+#include "internalName.h"
+#include "sliderTable.h"
+#include "pStatTimer.h"
+#include "pmap.h"
+#include <algorithm>
+
+PStatCollector GeomSimplifier::_simplify_pcollector("*:Munge:Simplify");
+
+// Planes through the open borders and the attribute seams of the mesh are
+// added to the quadrics with this weight, to discourage collapses that would
+// move them.
+static const double border_weight = 10.0;
+
+/**
+ * Reads the vertex positions, and the joint weights if any, from the vertex
+ * data.  Triangles that reference this vertex data may then be added with
+ * add_primitive().
+ */
+GeomSimplifier::
+GeomSimplifier(const GeomVertexData *vertex_data, Thread *current_thread) :
+  _vertex_data(vertex_data),
+  _current_thread(current_thread),
+  _set_up(false),
+  _num_live_triangles(0),
+  _has_blend_index(false),
+  _has_weights(false)
+{
+  int num_rows = vertex_data->get_num_rows();
+  _vertex_pos.resize(num_rows);
+  _vertex_morphed.resize(num_rows, false);
+
+  GeomVertexReader vertex(vertex_data, InternalName::get_vertex(), current_thread);
+  if (vertex.has_column()) {
+    for (int i = 0; i < num_rows; ++i) {
+      _vertex_pos[i] = vertex.get_data3d();
+    }
+  }
+
+  GeomVertexReader blend(vertex_data, InternalName::get_transform_blend(), current_thread);
+  if (blend.has_column()) {
+    _has_blend_index = true;
+    _blend_index.resize(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+      _blend_index[i] = blend.get_data1i();
+    }
+  }
+
+  GeomVertexReader index(vertex_data, InternalName::get_transform_index(), current_thread);
+  GeomVertexReader weight(vertex_data, InternalName::get_transform_weight(), current_thread);
+  if (weight.has_column()) {
+    _has_weights = true;
+    _transform_index.resize(num_rows, LVecBase4i(0, 1, 2, 3));
+    _transform_weight.resize(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+      if (index.has_column()) {
+        _transform_index[i] = index.get_data4i();
+      }
+      _transform_weight[i] = weight.get_data4();
+    }
+  }
+
+  // Vertices that are moved by a morph slider can't be merged with anything,
+  // since the morph would no longer be applied to the triangles around them.
+  const SliderTable *sliders = vertex_data->get_slider_table();
+  if (sliders != nullptr) {
+    size_t num_sliders = sliders->get_num_sliders();
+    for (size_t si = 0; si < num_sliders; ++si) {
+      const SparseArray &rows = sliders->get_slider_rows(si);
+      size_t num_subranges = rows.get_num_subranges();
+      for (size_t ri = 0; ri < num_subranges; ++ri) {
+        int begin = std::max(rows.get_subrange_begin(ri), 0);
+        int end = std::min(rows.get_subrange_end(ri), num_rows);
+        for (int i = begin; i < end; ++i) {
+          _vertex_morphed[i] = true;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Adds the triangles of the indicated primitive, which must be a GeomTriangles
+ * (or some other primitive with three vertices per face) referencing the
+ * vertex data passed to the constructor.  Returns the index that should later
+ * be passed to get_primitive() to retrieve the simplified result.
+ */
+int GeomSimplifier::
+add_primitive(const GeomPrimitive *triangles) {
+  nassertr(!_set_up, -1);
+  nassertr(triangles->get_primitive_type() == GeomPrimitive::PT_polygons &&
+           triangles->get_num_vertices_per_primitive() == 3, -1);
+
+  int prim_index = (int)_prims.size();
+  _prims.push_back(triangles);
+
+  GeomPrimitivePipelineReader reader(triangles, _current_thread);
+  int num_vertices = reader.get_num_vertices();
+  int num_rows = (int)_vertex_pos.size();
+  for (int i = 0; i + 2 < num_vertices; i += 3) {
+    Triangle tri;
+    tri._v[0] = reader.get_vertex(i);
+    tri._v[1] = reader.get_vertex(i + 1);
+    tri._v[2] = reader.get_vertex(i + 2);
+    tri._prim = prim_index;
+    tri._alive = true;
+    nassertr(tri._v[0] >= 0 && tri._v[0] < num_rows &&
+             tri._v[1] >= 0 && tri._v[1] < num_rows &&
+             tri._v[2] >= 0 && tri._v[2] < num_rows, -1);
+    _triangles.push_back(tri);
+    ++_num_live_triangles;
+  }
+
+  return prim_index;
+}
+
+/**
+ * Collapses edges, cheapest first, until no more than target_triangles
+ * triangles remain.  If max_error is greater than zero, this stops early
+ * rather than performing a collapse that would move the surface by more than
+ * approximately this distance.  It may also stop early if there are no more
+ * edges that can be collapsed without damaging the mesh.
+ */
+void GeomSimplifier::
+simplify(int target_triangles, PN_stdfloat max_error) {
+  PStatTimer timer(_simplify_pcollector, _current_thread);
+
+  if (!_set_up) {
+    setup();
+  }
+
+  double max_cost = -1.0;
+  if (max_error > 0.0f) {
+    max_cost = (double)max_error * (double)max_error;
+  }
+
+  pvector<Collapse> queue;
+  for (const Triangle &tri : _triangles) {
+    if (tri._alive) {
+      for (int k = 0; k < 3; ++k) {
+        int a = get_group(tri._v[k]);
+        int b = get_group(tri._v[(k + 1) % 3]);
+        push_collapse(queue, a, b);
+        push_collapse(queue, b, a);
+      }
+    }
+  }
+
+  IntList from_tris, shared_tris, remap, to_tris;
+  while (_num_live_triangles > target_triangles && !queue.empty()) {
+    std::pop_heap(queue.begin(), queue.end());
+    Collapse collapse = queue.back();
+    queue.pop_back();
+
+    Group &from = _groups[collapse._from];
+    Group &to = _groups[collapse._to];
+    if (!from._alive || !to._alive ||
+        from._seq != collapse._from_seq || to._seq != collapse._to_seq) {
+      // This entry is stale; the cost has been recomputed since.
+      continue;
+    }
+    if (max_cost >= 0.0 && collapse._cost > max_cost) {
+      break;
+    }
+    if (!check_collapse(collapse._from, collapse._to, from_tris, shared_tris, remap)) {
+      continue;
+    }
+
+    // The triangles along the edge disappear.
+    for (int ti : shared_tris) {
+      _triangles[ti]._alive = false;
+      --_num_live_triangles;
+    }
+
+    // The remaining triangles around the "from" vertices now use the
+    // corresponding "to" vertices instead.
+    for (int ti : from_tris) {
+      Triangle &tri = _triangles[ti];
+      if (!tri._alive) {
+        continue;
+      }
+      for (int k = 0; k < 3; ++k) {
+        if (get_group(tri._v[k]) == collapse._from) {
+          for (size_t ri = 0; ri < remap.size(); ri += 2) {
+            if (remap[ri] == tri._v[k]) {
+              tri._v[k] = remap[ri + 1];
+              break;
+            }
+          }
+        }
+      }
+      to._triangles.push_back(ti);
+    }
+
+    to._quadric += from._quadric;
+    from._alive = false;
+    from._triangles.clear();
+    ++to._seq;
+
+    // Recompute the cost of collapsing all of the edges around the merged
+    // vertex.
+    get_live_triangles(collapse._to, to_tris);
+    for (int ti : to_tris) {
+      const Triangle &tri = _triangles[ti];
+      for (int k = 0; k < 3; ++k) {
+        int g = get_group(tri._v[k]);
+        if (g != collapse._to) {
+          push_collapse(queue, collapse._to, g);
+          push_collapse(queue, g, collapse._to);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Returns a copy of the nth primitive passed to add_primitive(), containing
+ * only the triangles that remain after simplification.
+ */
+PT(GeomPrimitive) GeomSimplifier::
+get_primitive(int n) const {
+  nassertr(n >= 0 && n < (int)_prims.size(), nullptr);
+
+  PT(GeomPrimitive) prim = _prims[n]->make_copy();
+  prim->clear_vertices();
+  for (const Triangle &tri : _triangles) {
+    if (tri._alive && tri._prim == n) {
+      prim->add_vertices(tri._v[0], tri._v[1], tri._v[2]);
+      prim->close_primitive();
+    }
+  }
+  return prim;
+}
+
+/**
+ * Groups the vertices by position, and computes the initial quadric for each
+ * group from the planes of the triangles around it, and from the borders and
+ * seams that it lies on.
+ */
+void GeomSimplifier::
+setup() {
+  _set_up = true;
+
+  // Sort the vertices by position, so that vertices with an identical
+  // position end up next to each other.
+  int num_rows = (int)_vertex_pos.size();
+  IntList order(num_rows);
+  for (int i = 0; i < num_rows; ++i) {
+    order[i] = i;
+  }
+  const pvector<LPoint3d> &pos = _vertex_pos;
+  std::sort(order.begin(), order.end(), [&pos](int a, int b) {
+    const LPoint3d &pa = pos[a];
+    const LPoint3d &pb = pos[b];
+    if (pa[0] != pb[0]) {
+      return pa[0] < pb[0];
+    }
+    if (pa[1] != pb[1]) {
+      return pa[1] < pb[1];
+    }
+    return pa[2] < pb[2];
+  });
+
+  _vertex_group.resize(num_rows);
+  _groups.clear();
+  for (int i = 0; i < num_rows; ++i) {
+    int v = order[i];
+    if (i == 0 || pos[v] != pos[order[i - 1]]) {
+      Group group;
+      group._pos = pos[v];
+      group._seq = 0;
+      group._alive = true;
+      group._border = false;
+      group._locked = false;
+      _groups.push_back(group);
+    }
+    int g = (int)_groups.size() - 1;
+    _vertex_group[v] = g;
+    if (_vertex_morphed[v]) {
+      _groups[g]._locked = true;
+    }
+  }
+
+  // Now compute the face quadrics, and collect the edges.  Triangles that
+  // have two vertices in the same place are invisible, and are simply
+  // removed.
+  class EdgeInfo {
+  public:
+    int _count;
+    int _v0, _v1;
+    bool _seam;
+    LVector3d _normal;
+  };
+  typedef pmap<std::pair<int, int>, EdgeInfo> Edges;
+  Edges edges;
+
+  int num_triangles = (int)_triangles.size();
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    Triangle &tri = _triangles[ti];
+    int g[3];
+    for (int k = 0; k < 3; ++k) {
+      g[k] = get_group(tri._v[k]);
+    }
+    if (g[0] == g[1] || g[1] == g[2] || g[0] == g[2]) {
+      tri._alive = false;
+      --_num_live_triangles;
+      continue;
+    }
+
+    const LPoint3d &p0 = _groups[g[0]]._pos;
+    const LPoint3d &p1 = _groups[g[1]]._pos;
+    const LPoint3d &p2 = _groups[g[2]]._pos;
+    LVector3d normal = (p1 - p0).cross(p2 - p0);
+    if (normal.normalize()) {
+      double d = -normal.dot(p0);
+      for (int k = 0; k < 3; ++k) {
+        _groups[g[k]]._quadric.add_plane(normal, d, 1.0);
+      }
+    }
+
+    for (int k = 0; k < 3; ++k) {
+      _groups[g[k]]._triangles.push_back(ti);
+
+      int va = tri._v[k];
+      int vb = tri._v[(k + 1) % 3];
+      if (g[k] > g[(k + 1) % 3]) {
+        std::swap(va, vb);
+      }
+      std::pair<int, int> key(get_group(va), get_group(vb));
+      Edges::iterator ei = edges.find(key);
+      if (ei == edges.end()) {
+        EdgeInfo info;
+        info._count = 1;
+        info._v0 = va;
+        info._v1 = vb;
+        info._seam = false;
+        info._normal = normal;
+        edges.insert(Edges::value_type(key, info));
+      } else {
+        EdgeInfo &info = (*ei).second;
+        ++info._count;
+        if (info._v0 != va || info._v1 != vb) {
+          info._seam = true;
+        }
+      }
+    }
+  }
+
+  Edges::const_iterator ei;
+  for (ei = edges.begin(); ei != edges.end(); ++ei) {
+    const EdgeInfo &info = (*ei).second;
+    Group &ga = _groups[(*ei).first.first];
+    Group &gb = _groups[(*ei).first.second];
+
+    if (info._count > 2) {
+      // A non-manifold edge.  We can't safely do anything here.
+      ga._locked = true;
+      gb._locked = true;
+      continue;
+    }
+
+    bool border = (info._count == 1);
+    if (border) {
+      ga._border = true;
+      gb._border = true;
+    }
+    if (border || info._seam) {
+      // Add a plane perpendicular to the face, through the edge, so that
+      // vertices along it prefer to stay along it.
+      LVector3d dir = gb._pos - ga._pos;
+      LVector3d normal = dir.cross(info._normal);
+      if (normal.normalize()) {
+        double d = -normal.dot(ga._pos);
+        ga._quadric.add_plane(normal, d, border_weight);
+        gb._quadric.add_plane(normal, d, border_weight);
+      }
+    }
+  }
+}
+
+/**
+ * Fills result with the triangles around the indicated group that have not
+ * been removed, and drops the removed ones from the group's list.
+ */
+void GeomSimplifier::
+get_live_triangles(int group, IntList &result) {
+  IntList &triangles = _groups[group]._triangles;
+  IntList::iterator dest = triangles.begin();
+  for (int ti : triangles) {
+    if (_triangles[ti]._alive) {
+      *dest++ = ti;
+    }
+  }
+  triangles.erase(dest, triangles.end());
+  result = triangles;
+}
+
+/**
+ * Returns true if the vertices of group "from" may be merged into those of
+ * group "to".  If so, fills from_tris with the triangles around "from",
+ * shared_tris with those of them that will disappear, and remap with pairs of
+ * vertex indices, each mapping a vertex of "from" to its counterpart in "to".
+ */
+bool GeomSimplifier::
+check_collapse(int from, int to, IntList &from_tris, IntList &shared_tris,
+               IntList &remap) {
+  const Group &gf = _groups[from];
+  const Group &gt = _groups[to];
+  if (!gf._alive || !gt._alive || gf._locked) {
+    return false;
+  }
+
+  get_live_triangles(from, from_tris);
+  shared_tris.clear();
+  remap.clear();
+
+  for (int ti : from_tris) {
+    const Triangle &tri = _triangles[ti];
+    int va = -1, vb = -1;
+    for (int k = 0; k < 3; ++k) {
+      int g = get_group(tri._v[k]);
+      if (g == from) {
+        va = tri._v[k];
+      } else if (g == to) {
+        vb = tri._v[k];
+      }
+    }
+    if (vb < 0) {
+      continue;
+    }
+    shared_tris.push_back(ti);
+
+    // Each vertex of "from" must correspond to exactly one vertex of "to".
+    // This is what keeps a seam intact: a vertex on a seam can only be
+    // collapsed along the seam.
+    bool found = false;
+    for (size_t ri = 0; ri < remap.size(); ri += 2) {
+      if (remap[ri] == va) {
+        if (remap[ri + 1] != vb) {
+          return false;
+        }
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      remap.push_back(va);
+      remap.push_back(vb);
+    }
+  }
+
+  if (gf._border) {
+    // A border vertex may only slide along the border.
+    if (!gt._border || shared_tris.size() != 1) {
+      return false;
+    }
+  } else if (shared_tris.size() != 2) {
+    return false;
+  }
+
+  for (int ti : from_tris) {
+    const Triangle &tri = _triangles[ti];
+    for (int k = 0; k < 3; ++k) {
+      if (get_group(tri._v[k]) == from) {
+        bool found = false;
+        for (size_t ri = 0; ri < remap.size(); ri += 2) {
+          if (remap[ri] == tri._v[k]) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) {
+          // This vertex is on the other side of a seam from the edge.
+          return false;
+        }
+      }
+    }
+  }
+
+  for (size_t ri = 0; ri < remap.size(); ri += 2) {
+    if (!same_animation(remap[ri], remap[ri + 1])) {
+      return false;
+    }
+  }
+
+  // The only vertices adjacent to both ends of the edge may be the ones
+  // opposite it; otherwise, the collapse would fold the surface onto itself.
+  IntList from_neighbors, to_neighbors, to_tris;
+  for (int ti : from_tris) {
+    for (int k = 0; k < 3; ++k) {
+      int g = get_group(_triangles[ti]._v[k]);
+      if (g != from && g != to) {
+        from_neighbors.push_back(g);
+      }
+    }
+  }
+  get_live_triangles(to, to_tris);
+  for (int ti : to_tris) {
+    for (int k = 0; k < 3; ++k) {
+      int g = get_group(_triangles[ti]._v[k]);
+      if (g != from && g != to) {
+        to_neighbors.push_back(g);
+      }
+    }
+  }
+  std::sort(from_neighbors.begin(), from_neighbors.end());
+  from_neighbors.erase(std::unique(from_neighbors.begin(), from_neighbors.end()), from_neighbors.end());
+  std::sort(to_neighbors.begin(), to_neighbors.end());
+  to_neighbors.erase(std::unique(to_neighbors.begin(), to_neighbors.end()), to_neighbors.end());
+
+  size_t num_common = 0;
+  IntList::const_iterator fi = from_neighbors.begin();
+  IntList::const_iterator ti = to_neighbors.begin();
+  while (fi != from_neighbors.end() && ti != to_neighbors.end()) {
+    if (*fi < *ti) {
+      ++fi;
+    } else if (*ti < *fi) {
+      ++ti;
+    } else {
+      ++num_common;
+      ++fi;
+      ++ti;
+    }
+  }
+  if (num_common != shared_tris.size()) {
+    return false;
+  }
+
+  // Finally, make sure that none of the remaining triangles would be flipped
+  // over or squashed flat.
+  for (int ti : from_tris) {
+    if (std::find(shared_tris.begin(), shared_tris.end(), ti) != shared_tris.end()) {
+      continue;
+    }
+    const Triangle &tri = _triangles[ti];
+    LPoint3d old_pos[3], new_pos[3];
+    for (int k = 0; k < 3; ++k) {
+      int g = get_group(tri._v[k]);
+      old_pos[k] = _groups[g]._pos;
+      new_pos[k] = (g == from) ? gt._pos : old_pos[k];
+    }
+    LVector3d old_normal = (old_pos[1] - old_pos[0]).cross(old_pos[2] - old_pos[0]);
+    LVector3d new_normal = (new_pos[1] - new_pos[0]).cross(new_pos[2] - new_pos[0]);
+    double new_length2 = new_normal.length_squared();
+    if (new_length2 <= 0.0) {
+      return false;
+    }
+    double dot = old_normal.dot(new_normal);
+    if (dot <= 0.0 || dot * dot < 0.04 * old_normal.length_squared() * new_length2) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns true if the two vertices are animated by the same joints, with the
+ * same weights.
+ */
+bool GeomSimplifier::
+same_animation(int a, int b) const {
+  if (_has_blend_index && _blend_index[a] != _blend_index[b]) {
+    return false;
+  }
+  if (_has_weights) {
+    if (_transform_index[a] != _transform_index[b] ||
+        !_transform_weight[a].almost_equal(_transform_weight[b], 0.001f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Computes the cost of merging group "from" into group "to", and adds it to
+ * the queue.
+ */
+void GeomSimplifier::
+push_collapse(pvector<Collapse> &queue, int from, int to) {
+  const Group &gf = _groups[from];
+  const Group &gt = _groups[to];
+  if (gf._locked || !gf._alive || !gt._alive) {
+    return;
+  }
+
+  Quadric quadric = gf._quadric;
+  quadric += gt._quadric;
+
+  Collapse collapse;
+  collapse._cost = std::max(quadric.evaluate(gt._pos), 0.0);
+  collapse._from = from;
+  collapse._to = to;
+  collapse._from_seq = gf._seq;
+  collapse._to_seq = gt._seq;
+  queue.push_back(collapse);
+  std::push_heap(queue.begin(), queue.end());
+}
@@ -0,0 +1,133 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomSimplifier.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef GEOMSIMPLIFIER_H
+#define GEOMSIMPLIFIER_H
+
+#include "pandabase.h"
+#include "geomPrimitive.h"
+#include "geomVertexData.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+
+/**
+ * Reduces the number of triangles in a set of GeomTriangles that share a
+ * common GeomVertexData, by repeatedly collapsing the edge that introduces
+ * the least error, as measured by the quadric error metric of Garland and
+ * Heckbert.
+ *
+ * Each collapse merges one vertex into a neighboring one without creating any
+ * new vertices, so the vertex data itself is not modified; only the triangles
+ * are.  Vertices that share a position but differ in some other attribute,
+ * such as a texture coordinate, normal or color, are collapsed together, and
+ * only along the seam that they define, so that seams are preserved.  Open
+ * borders are kept in place, and vertices are never merged with vertices
+ * that have a different set of joint weights or that are affected by a
+ * morph slider.
+ *
+ * This is used to implement Geom::simplify_in_place().
+ */
+class EXPCL_PANDA_GOBJ GeomSimplifier {
+public:
+  GeomSimplifier(const GeomVertexData *vertex_data,
+                 Thread *current_thread = Thread::get_current_thread());
+
+  int add_primitive(const GeomPrimitive *triangles);
+  INLINE int get_num_triangles() const;
+
+  void simplify(int target_triangles, PN_stdfloat max_error = 0.0f);
+
+  PT(GeomPrimitive) get_primitive(int n) const;
+
+private:
+  // A symmetric 4x4 matrix, stored as its upper triangle, which measures the
+  // sum of squared distances of a point to a set of planes.
+  class Quadric {
+  public:
+    INLINE Quadric();
+    INLINE void add_plane(const LVector3d &normal, double d, double weight);
+    INLINE void operator += (const Quadric &other);
+    INLINE double evaluate(const LPoint3d &point) const;
+
+    double _a[10];
+  };
+
+  class Triangle {
+  public:
+    int _v[3];
+    int _prim;
+    bool _alive;
+  };
+
+  class Collapse {
+  public:
+    INLINE bool operator < (const Collapse &other) const;
+
+    double _cost;
+    int _from;
+    int _to;
+    unsigned int _from_seq;
+    unsigned int _to_seq;
+  };
+
+  typedef pvector<int> IntList;
+
+  void setup();
+  INLINE int get_group(int vertex) const;
+  void get_live_triangles(int group, IntList &result);
+  bool check_collapse(int from, int to, IntList &from_tris, IntList &shared_tris,
+                      IntList &remap);
+  bool same_animation(int a, int b) const;
+  void push_collapse(pvector<Collapse> &queue, int from, int to);
+
+private:
+  CPT(GeomVertexData) _vertex_data;
+  Thread *_current_thread;
+  bool _set_up;
+
+  pvector<CPT(GeomPrimitive)> _prims;
+  pvector<Triangle> _triangles;
+  int _num_live_triangles;
+
+  // All vertices with an identical position are grouped together.  These
+  // tables are indexed by vertex row.
+  IntList _vertex_group;
+  pvector<LPoint3d> _vertex_pos;
+  pvector<bool> _vertex_morphed;
+
+  // For animated vertex data, the joint weights of each vertex.
+  bool _has_blend_index;
+  bool _has_weights;
+  IntList _blend_index;
+  pvector<LVecBase4i> _transform_index;
+  pvector<LVecBase4> _transform_weight;
+
+  // These tables are indexed by group.
+  class Group {
+  public:
+    LPoint3d _pos;
+    Quadric _quadric;
+    IntList _triangles;
+    unsigned int _seq;
+    bool _alive;
+    bool _border;
+    bool _locked;
+  };
+  pvector<Group> _groups;
+
+  static PStatCollector _simplify_pcollector;
+};
+
+#include "geomSimplifier.I"
+
+#endif
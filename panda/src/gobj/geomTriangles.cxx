@@ -18,11 +18,52 @@
 #include "bamWriter.h"
 #include "graphicsStateGuardianBase.h"
 #include "geomTrianglesAdjacency.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "internalName.h"
+#include "cmath.h"
+#include <algorithm>
 
 using std::map;
 
 TypeHandle GeomTriangles::_type_handle;
 
+/**
+ * Returns the number of vertices that would have to be transformed to render
+ * the indicated triangle list, given a FIFO post-transform cache.
+ */
+static int
+count_cache_misses(const pvector<int> &indices, int max_vertex, int cache_size) {
+  pvector<int> loaded_at(max_vertex + 1, -cache_size);
+  int num_misses = 0;
+  for (int vertex : indices) {
+    if (num_misses - loaded_at[vertex] >= cache_size) {
+      loaded_at[vertex] = num_misses;
+      ++num_misses;
+    }
+  }
+  return num_misses;
+}
+
+/**
+ * Returns the score of a vertex for the purposes of choosing the next
+ * triangle in optimize_vertex_cache_impl().  Vertices that are in the cache
+ * score higher, as do vertices that have few triangles left to render, so
+ * that they may be finished off and dropped from the cache.
+ */
+static float
+calc_vertex_score(int cache_pos, int valence, const pvector<float> &cache_scores) {
+  if (valence == 0) {
+    // No triangles need this vertex anymore.
+    return -1.0f;
+  }
+  float score = 0.0f;
+  if (cache_pos >= 0) {
+    score = cache_scores[cache_pos];
+  }
+  return score + 2.0f * cpow((float)valence, -0.5f);
+}
+
 /**
  *
  */
@@ -326,6 +367,273 @@ rotate_impl() const {
   return new_vertices;
 }
 
+/**
+ * The virtual implementation of optimize_vertex_cache().  The triangles are
+ * ordered with the greedy algorithm described by Tom Forsyth in "Linear-Speed
+ * Vertex Cache Optimisation": each vertex is scored according to its position
+ * in a simulated LRU cache and to the number of triangles still waiting to
+ * use it, and the next triangle is always the best-scoring one that uses a
+ * vertex in the cache.
+ *
+ * The resulting order is then split into clusters wherever the cache would be
+ * cold anyway, and if vertex_data is given, these are sorted so that clusters
+ * facing away from the center of the mesh come first, as described by Sander
+ * et al. in "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw".
+ */
+CPT(GeomPrimitive) GeomTriangles::
+optimize_vertex_cache_impl(int cache_size, const GeomVertexData *vertex_data) const {
+  if (!is_indexed()) {
+    // There is no vertex reuse to take advantage of.
+    return this;
+  }
+
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader from(this, current_thread);
+  from.check_minmax();
+  int num_vertices = from.get_num_vertices();
+  int num_triangles = num_vertices / 3;
+  nassertr(num_triangles * 3 == num_vertices, this);
+  if (num_triangles < 2) {
+    return this;
+  }
+
+  int max_vertex = from.get_max_vertex();
+  pvector<int> indices(num_vertices);
+  for (int i = 0; i < num_vertices; ++i) {
+    indices[i] = from.get_vertex(i);
+  }
+
+  // Build a table of the triangles that use each vertex.  The first
+  // _valence[v] entries for each vertex are the triangles that have not yet
+  // been added.
+  pvector<int> valence(max_vertex + 1, 0);
+  for (int vertex : indices) {
+    ++valence[vertex];
+  }
+  pvector<int> offsets(max_vertex + 2);
+  offsets[0] = 0;
+  for (int v = 0; v <= max_vertex; ++v) {
+    offsets[v + 1] = offsets[v] + valence[v];
+  }
+  pvector<int> vertex_triangles(num_vertices);
+  {
+    pvector<int> fill(offsets);
+    for (int i = 0; i < num_vertices; ++i) {
+      vertex_triangles[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  // The three most recently used vertices get a fixed score, so that the
+  // algorithm does not prefer whichever one of the just-added triangle's
+  // vertices happened to be first.
+  pvector<float> cache_scores(cache_size);
+  for (int i = 0; i < cache_size; ++i) {
+    if (i < 3) {
+      cache_scores[i] = 0.75f;
+    } else {
+      float scaler = 1.0f / (float)std::max(cache_size - 3, 1);
+      cache_scores[i] = cpow(1.0f - (float)(i - 3) * scaler, 1.5f);
+    }
+  }
+
+  pvector<int> cache_pos(max_vertex + 1, -1);
+  pvector<float> scores(max_vertex + 1);
+  for (int v = 0; v <= max_vertex; ++v) {
+    scores[v] = calc_vertex_score(-1, valence[v], cache_scores);
+  }
+
+  pvector<bool> added(num_triangles, false);
+  pvector<int> cache, new_cache;
+  cache.reserve(cache_size + 3);
+  new_cache.reserve(cache_size + 3);
+
+  pvector<int> order;
+  order.reserve(num_triangles);
+
+  int best_triangle = -1;
+  int next_unadded = 0;
+
+  while ((int)order.size() < num_triangles) {
+    if (best_triangle < 0) {
+      // We have run into a dead end: none of the vertices in the cache are
+      // used by any remaining triangle.  Just pick the next one in the
+      // original order.
+      while (added[next_unadded]) {
+        ++next_unadded;
+      }
+      best_triangle = next_unadded;
+    }
+
+    int tri = best_triangle;
+    added[tri] = true;
+    order.push_back(tri);
+
+    // Remove the triangle from the list of remaining triangles of each of
+    // its vertices, and move those vertices to the front of the cache.
+    new_cache.clear();
+    for (int k = 0; k < 3; ++k) {
+      int vertex = indices[tri * 3 + k];
+      int *begin = &vertex_triangles[offsets[vertex]];
+      int *end = begin + valence[vertex];
+      int *found = std::find(begin, end, tri);
+      nassertr(found != end, this);
+      std::swap(*found, *(end - 1));
+      --valence[vertex];
+
+      if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end()) {
+        new_cache.push_back(vertex);
+      }
+    }
+    for (int vertex : cache) {
+      if (std::find(new_cache.begin(), new_cache.end(), vertex) == new_cache.end()) {
+        new_cache.push_back(vertex);
+      }
+    }
+
+    // Rescore the vertices whose position in the cache has changed,
+    // including any that have just fallen out of it.
+    for (size_t i = 0; i < new_cache.size(); ++i) {
+      int vertex = new_cache[i];
+      int pos = ((int)i < cache_size) ? (int)i : -1;
+      cache_pos[vertex] = pos;
+      scores[vertex] = calc_vertex_score(pos, valence[vertex], cache_scores);
+    }
+    if ((int)new_cache.size() > cache_size) {
+      new_cache.resize(cache_size);
+    }
+    cache.swap(new_cache);
+
+    // Now the next triangle is the best one that uses any vertex in the
+    // cache.
+    best_triangle = -1;
+    float best_score = 0.0f;
+    for (int vertex : cache) {
+      const int *begin = &vertex_triangles[offsets[vertex]];
+      const int *end = begin + valence[vertex];
+      for (const int *ti = begin; ti != end; ++ti) {
+        int t = *ti;
+        float score = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+        if (score > best_score) {
+          best_score = score;
+          best_triangle = t;
+        }
+      }
+    }
+  }
+
+  pvector<int> new_indices;
+  new_indices.reserve(num_vertices);
+  for (int tri : order) {
+    new_indices.push_back(indices[tri * 3]);
+    new_indices.push_back(indices[tri * 3 + 1]);
+    new_indices.push_back(indices[tri * 3 + 2]);
+  }
+
+  // Split the order into clusters, beginning at each triangle that finds
+  // none of its vertices in the cache.  The clusters may be rearranged
+  // without costing much in terms of cache efficiency.
+  if (vertex_data != nullptr &&
+      vertex_data->has_column(InternalName::get_vertex()) &&
+      max_vertex < vertex_data->get_num_rows()) {
+    pvector<int> cluster_starts;
+    {
+      pvector<int> loaded_at(max_vertex + 1, -cache_size);
+      int num_misses = 0;
+      for (int t = 0; t < num_triangles; ++t) {
+        int tri_misses = 0;
+        for (int k = 0; k < 3; ++k) {
+          int vertex = new_indices[t * 3 + k];
+          if (num_misses - loaded_at[vertex] >= cache_size) {
+            loaded_at[vertex] = num_misses;
+            ++num_misses;
+            ++tri_misses;
+          }
+        }
+        if (tri_misses == 3) {
+          cluster_starts.push_back(t);
+        }
+      }
+    }
+    cluster_starts.push_back(num_triangles);
+
+    int num_clusters = (int)cluster_starts.size() - 1;
+    if (num_clusters > 1) {
+      GeomVertexReader reader(vertex_data, InternalName::get_vertex(), current_thread);
+
+      // Compute the area-weighted centroid and normal of each cluster, and of
+      // the whole mesh.
+      pvector<LPoint3> centroids(num_clusters);
+      pvector<LVector3> normals(num_clusters);
+      LPoint3 mesh_centroid(0);
+      PN_stdfloat mesh_area = 0;
+      for (int c = 0; c < num_clusters; ++c) {
+        LPoint3 centroid(0);
+        LVector3 normal(0);
+        PN_stdfloat area = 0;
+        for (int t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t) {
+          reader.set_row_unsafe(new_indices[t * 3]);
+          LPoint3 p0 = reader.get_data3();
+          reader.set_row_unsafe(new_indices[t * 3 + 1]);
+          LPoint3 p1 = reader.get_data3();
+          reader.set_row_unsafe(new_indices[t * 3 + 2]);
+          LPoint3 p2 = reader.get_data3();
+
+          LVector3 n = (p1 - p0).cross(p2 - p0);
+          PN_stdfloat a = n.length();
+          normal += n;
+          centroid += (p0 + p1 + p2) * (a / 3);
+          area += a;
+        }
+        mesh_centroid += centroid;
+        mesh_area += area;
+        centroids[c] = (area > 0) ? centroid / area : centroid;
+        normals[c] = normal;
+        normals[c].normalize();
+      }
+      if (mesh_area > 0) {
+        mesh_centroid /= mesh_area;
+      }
+
+      pvector<std::pair<PN_stdfloat, int> > sorted_clusters(num_clusters);
+      for (int c = 0; c < num_clusters; ++c) {
+        sorted_clusters[c].first = -normals[c].dot(centroids[c] - mesh_centroid);
+        sorted_clusters[c].second = c;
+      }
+      std::stable_sort(sorted_clusters.begin(), sorted_clusters.end());
+
+      pvector<int> sorted_indices;
+      sorted_indices.reserve(num_vertices);
+      for (const auto &sc : sorted_clusters) {
+        int c = sc.second;
+        sorted_indices.insert(sorted_indices.end(),
+                              new_indices.begin() + cluster_starts[c] * 3,
+                              new_indices.begin() + cluster_starts[c + 1] * 3);
+      }
+
+      // Make sure that this didn't cost us too much in cache efficiency.
+      int misses = count_cache_misses(new_indices, max_vertex, cache_size);
+      int sorted_misses = count_cache_misses(sorted_indices, max_vertex, cache_size);
+      if (sorted_misses * 20 <= misses * 21) {
+        new_indices.swap(sorted_indices);
+      }
+    }
+  }
+
+  PT(GeomVertexArrayData) new_vertices = make_index_data();
+  new_vertices->unclean_set_num_rows(num_vertices);
+  {
+    GeomVertexWriter to(new_vertices, 0, current_thread);
+    for (int vertex : new_indices) {
+      to.set_data1i(vertex);
+    }
+  }
+
+  PT(GeomPrimitive) new_prim = make_copy();
+  new_prim->set_vertices(new_vertices);
+  return new_prim;
+}
+
 /**
  * Tells the BamReader how to create objects of type Geom.
  */
@@ -17,6 +17,7 @@
 #include "geomPatches.cxx"
 #include "geomPoints.cxx"
 #include "geomPrimitive.cxx"
+#include "geomSimplifier.cxx"
 #include "geomTriangles.cxx"
 #include "geomTrianglesAdjacency.cxx"
 #include "geomTrifans.cxx"
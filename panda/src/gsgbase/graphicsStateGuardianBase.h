@@ -232,6 +232,10 @@ public:
                           int light_id) { }
 
   virtual void ensure_generated_shader(const RenderState *state)=0;
+  virtual void enqueue_generated_shader(const RenderState *state) {
+    ensure_generated_shader(state);
+  }
+  virtual void flush_generated_shaders() { }
 
   static void mark_rehash_generated_shaders() {
 #ifdef HAVE_CG
@@ -0,0 +1,186 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file convert_yuv.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "convert_yuv.h"
+#include "pnotify.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define CONVERT_YUV_SSE2
+#endif
+
+namespace {
+  // The BT.601 matrix in 3.13 fixed point.  The arithmetic below is arranged
+  // so that every intermediate value fits in a signed 16-bit integer, which
+  // allows the SSE2 version to process eight pixels per instruction and still
+  // produce exactly the same result as the scalar version.
+  struct YUVCoefficients {
+    short _y_offset;
+    short _y;
+    short _v_r;
+    short _u_g;
+    short _v_g;
+    short _u_b;
+  };
+
+  const YUVCoefficients limited_range = { 16, 9539, 13075, 3209, 6660, 16525 };
+  const YUVCoefficients full_range = { 0, 8192, 11485, 2819, 5850, 14516 };
+}
+
+/**
+ * Equivalent to _mm_mulhi_epi16 for a single value.
+ */
+static INLINE int
+mulhi(int a, int b) {
+  return (a * b) >> 16;
+}
+
+/**
+ * Clamps the value to the range of an unsigned char.
+ */
+static INLINE unsigned char
+clamp_uchar(int value) {
+  return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+/**
+ * Converts the indicated range of pixels of a single row, one pixel at a
+ * time.
+ */
+static void
+convert_row_scalar(unsigned char *dest, int num_components,
+                   const unsigned char *y_row, const unsigned char *u_row,
+                   const unsigned char *v_row, int begin, int end,
+                   const YUVCoefficients &k) {
+  for (int x = begin; x < end; ++x) {
+    int c = (y_row[x] - k._y_offset) << 6;
+    int d = (u_row[x >> 1] - 128) << 6;
+    int e = (v_row[x >> 1] - 128) << 6;
+    int yc = mulhi(c, k._y);
+
+    unsigned char *p = dest + x * num_components;
+    p[0] = clamp_uchar((yc + mulhi(d, k._u_b) + 4) >> 3);
+    p[1] = clamp_uchar((yc - mulhi(d, k._u_g) - mulhi(e, k._v_g) + 4) >> 3);
+    p[2] = clamp_uchar((yc + mulhi(e, k._v_r) + 4) >> 3);
+    if (num_components == 4) {
+      p[3] = 0xff;
+    }
+  }
+}
+
+#ifdef CONVERT_YUV_SSE2
+/**
+ * Converts as much of a single row as possible eight pixels at a time.
+ * Returns the number of pixels that were converted.
+ */
+static int
+convert_row_sse2(unsigned char *dest, int num_components,
+                 const unsigned char *y_row, const unsigned char *u_row,
+                 const unsigned char *v_row, int width,
+                 const YUVCoefficients &k) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i y_offset = _mm_set1_epi16(k._y_offset);
+  const __m128i uv_offset = _mm_set1_epi16(128);
+  const __m128i round = _mm_set1_epi16(4);
+  const __m128i alpha = _mm_set1_epi8((char)0xff);
+  const __m128i k_y = _mm_set1_epi16(k._y);
+  const __m128i k_v_r = _mm_set1_epi16(k._v_r);
+  const __m128i k_u_g = _mm_set1_epi16(k._u_g);
+  const __m128i k_v_g = _mm_set1_epi16(k._v_g);
+  const __m128i k_u_b = _mm_set1_epi16(k._u_b);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i y = _mm_loadl_epi64((const __m128i *)(y_row + x));
+    y = _mm_unpacklo_epi8(y, zero);
+
+    // Each chroma sample covers two horizontally adjacent pixels.
+    int u4, v4;
+    memcpy(&u4, u_row + (x >> 1), 4);
+    memcpy(&v4, v_row + (x >> 1), 4);
+    __m128i u = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+    __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+    u = _mm_unpacklo_epi16(u, u);
+    v = _mm_unpacklo_epi16(v, v);
+
+    __m128i c = _mm_slli_epi16(_mm_sub_epi16(y, y_offset), 6);
+    __m128i d = _mm_slli_epi16(_mm_sub_epi16(u, uv_offset), 6);
+    __m128i e = _mm_slli_epi16(_mm_sub_epi16(v, uv_offset), 6);
+    __m128i yc = _mm_add_epi16(_mm_mulhi_epi16(c, k_y), round);
+
+    __m128i b = _mm_add_epi16(yc, _mm_mulhi_epi16(d, k_u_b));
+    __m128i g = _mm_sub_epi16(_mm_sub_epi16(yc, _mm_mulhi_epi16(d, k_u_g)),
+                              _mm_mulhi_epi16(e, k_v_g));
+    __m128i r = _mm_add_epi16(yc, _mm_mulhi_epi16(e, k_v_r));
+
+    b = _mm_packus_epi16(_mm_srai_epi16(b, 3), zero);
+    g = _mm_packus_epi16(_mm_srai_epi16(g, 3), zero);
+    r = _mm_packus_epi16(_mm_srai_epi16(r, 3), zero);
+
+    // Interleave into BGRA order.
+    __m128i bg = _mm_unpacklo_epi8(b, g);
+    __m128i ra = _mm_unpacklo_epi8(r, alpha);
+    __m128i lo = _mm_unpacklo_epi16(bg, ra);
+    __m128i hi = _mm_unpackhi_epi16(bg, ra);
+
+    if (num_components == 4) {
+      _mm_storeu_si128((__m128i *)(dest + x * 4), lo);
+      _mm_storeu_si128((__m128i *)(dest + x * 4 + 16), hi);
+    } else {
+      // SSE2 has no convenient way to drop every fourth byte, so go through
+      // a temporary buffer.
+      unsigned char bgra[32];
+      _mm_storeu_si128((__m128i *)bgra, lo);
+      _mm_storeu_si128((__m128i *)(bgra + 16), hi);
+      unsigned char *p = dest + x * 3;
+      for (int i = 0; i < 8; ++i) {
+        p[0] = bgra[i * 4];
+        p[1] = bgra[i * 4 + 1];
+        p[2] = bgra[i * 4 + 2];
+        p += 3;
+      }
+    }
+  }
+  return x;
+}
+#endif  // CONVERT_YUV_SSE2
+
+/**
+ * Converts a YUV 4:2:0 planar image to BGR (num_components == 3) or BGRA
+ * (num_components == 4), with an opaque alpha channel.
+ */
+void
+convert_yuv420_to_bgr(unsigned char *dest, int dest_stride, int num_components,
+                      const unsigned char *y_plane, int y_stride,
+                      const unsigned char *u_plane, int u_stride,
+                      const unsigned char *v_plane, int v_stride,
+                      int width, int height, bool full) {
+  nassertv(num_components == 3 || num_components == 4);
+  const YUVCoefficients &k = full ? full_range : limited_range;
+
+  for (int y = 0; y < height; ++y) {
+    const unsigned char *y_row = y_plane + y * y_stride;
+    const unsigned char *u_row = u_plane + (y >> 1) * u_stride;
+    const unsigned char *v_row = v_plane + (y >> 1) * v_stride;
+
+    int x = 0;
+#ifdef CONVERT_YUV_SSE2
+    x = convert_row_sse2(dest, num_components, y_row, u_row, v_row, width, k);
+#endif
+    convert_row_scalar(dest, num_components, y_row, u_row, v_row, x, width, k);
+
+    dest += dest_stride;
+  }
+}
@@ -0,0 +1,32 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file convert_yuv.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef CONVERT_YUV_H
+#define CONVERT_YUV_H
+
+#include "pandabase.h"
+
+// Converts planar YUV 4:2:0 video (as produced by most video decoders) to
+// Panda's BGR or BGRA texture layout, using the BT.601 matrix.  If full_range
+// is true, the luma is taken to span 0-255 (as in JPEG); otherwise, it is
+// taken to span 16-235.  The destination stride may be negative, to flip the
+// image vertically.  When SSE2 is available at compile time, eight pixels are
+// converted at once; the result is identical either way.
+EXPCL_PANDA_MOVIES void
+convert_yuv420_to_bgr(unsigned char *dest, int dest_stride, int num_components,
+                      const unsigned char *y_plane, int y_stride,
+                      const unsigned char *u_plane, int u_stride,
+                      const unsigned char *v_plane, int v_stride,
+                      int width, int height, bool full_range);
+
+#endif
@@ -21,6 +21,7 @@
 PStatCollector MovieVideoCursor::_copy_pcollector("*:Copy Video into Texture");
 PStatCollector MovieVideoCursor::_copy_pcollector_ram("*:Copy Video into Texture:modify_ram_image");
 PStatCollector MovieVideoCursor::_copy_pcollector_copy("*:Copy Video into Texture:copy");
+PStatCollector MovieVideoCursor::_copy_pcollector_adopt("*:Copy Video into Texture:adopt");
 
 TypeHandle MovieVideoCursor::_type_handle;
 TypeHandle MovieVideoCursor::Buffer::_type_handle;
@@ -116,6 +117,11 @@ fetch_buffer() {
 
 /**
  * Stores this buffer's contents in the indicated texture.
+ *
+ * If the buffer has exactly the layout of the texture's RAM image, and it is
+ * not the cursor's standard buffer (which would be overwritten in place by
+ * the next frame), the buffer's memory is simply adopted as the new RAM
+ * image, without being copied.
  */
 void MovieVideoCursor::
 apply_to_texture(const Buffer *buffer, Texture *t, int page) {
@@ -125,6 +131,17 @@ apply_to_texture(const Buffer *buffer, Texture *t, int page) {
 
   PStatTimer timer(_copy_pcollector);
 
+  if (buffer != _standard_buffer && page == 0 && t->get_num_pages() == 1 &&
+      t->get_x_size() == size_x() && t->get_y_size() == size_y() &&
+      t->get_num_components() == get_num_components() &&
+      t->get_component_width() == 1 &&
+      buffer->_image.size() == t->get_expected_ram_image_size()) {
+    PStatTimer timer2(_copy_pcollector_adopt);
+    t->set_keep_ram_image(true);
+    t->set_ram_image(buffer->_image);
+    return;
+  }
+
   nassertv(t->get_x_size() >= size_x());
   nassertv(t->get_y_size() >= size_y());
   nassertv((t->get_num_components() == 3) || (t->get_num_components() == 4) ||
@@ -361,10 +378,10 @@ fillin(DatagramIterator &scan, BamReader *manager) {
  */
 MovieVideoCursor::Buffer::
 Buffer(size_t block_size) :
+  _image(PTA_uchar::empty_array(block_size, get_class_type())),
   _block_size(block_size)
 {
-  _deleted_chain = memory_hook->get_deleted_chain(_block_size);
-  _block = (unsigned char *)_deleted_chain->allocate(_block_size, get_class_type());
+  _block = _image.p();
 }
 
 /**
@@ -372,7 +389,6 @@ Buffer(size_t block_size) :
  */
 MovieVideoCursor::Buffer::
 ~Buffer() {
-  _deleted_chain->deallocate(_block, get_class_type());
 }
 
 /**
@@ -21,6 +21,7 @@
 #include "pStatCollector.h"
 #include "deletedChain.h"
 #include "typedReferenceCount.h"
+#include "pta_uchar.h"
 
 class MovieVideo;
 class FactoryParams;
@@ -71,12 +72,13 @@ PUBLISHED:
     virtual double get_timestamp() const;
 
   public:
+    // _block points into _image.  The array is reference-counted so that
+    // apply_to_texture() can hand it to the Texture directly as its RAM
+    // image, rather than copying it.
+    PTA_uchar _image;
     unsigned char *_block;
     size_t _block_size;
 
-  private:
-    DeletedBufferChain *_deleted_chain;
-
   public:
     static TypeHandle get_class_type() {
       return _type_handle;
@@ -121,6 +123,7 @@ protected:
   static PStatCollector _copy_pcollector;
   static PStatCollector _copy_pcollector_ram;
   static PStatCollector _copy_pcollector_copy;
+  static PStatCollector _copy_pcollector_adopt;
 
 public:
   virtual void write_datagram(BamWriter *manager, Datagram &dg);
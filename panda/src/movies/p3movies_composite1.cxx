@@ -1,4 +1,5 @@
 #include "config_movies.cxx"
+#include "convert_yuv.cxx"
 #include "flacAudio.cxx"
 #include "flacAudioCursor.cxx"
 #include "inkblotVideo.cxx"
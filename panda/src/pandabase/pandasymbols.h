@@ -61,6 +61,14 @@
   #define EXPTP_OPENAL_AUDIO IMPORT_TEMPL
 #endif
 
+#ifdef BUILDING_SOFTWARE_AUDIO
+  #define EXPCL_SOFTWARE_AUDIO EXPORT_CLASS
+  #define EXPTP_SOFTWARE_AUDIO EXPORT_TEMPL
+#else
+  #define EXPCL_SOFTWARE_AUDIO IMPORT_CLASS
+  #define EXPTP_SOFTWARE_AUDIO IMPORT_TEMPL
+#endif
+
 /* BUILDING_PANDA is just a buildsystem shortcut for all of these: */
 #ifdef BUILDING_PANDA
   #define BUILDING_LIBPANDA
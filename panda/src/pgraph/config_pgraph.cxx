@@ -306,6 +306,16 @@ ConfigVariableBool flatten_geoms
           "only the NodePath interfaces; you may still make the lower-level "
           "SceneGraphReducer calls directly."));
 
+ConfigVariableBool flatten_optimize_vertex_cache
+("flatten-optimize-vertex-cache", false,
+ PRC_DESC("When this is true, NodePath::flatten_strong() will additionally "
+          "reorder the triangles and vertices of the resulting Geoms for "
+          "better use of the post-transform vertex cache, which can reduce "
+          "the vertex processing cost of large meshes.  This makes flattening "
+          "slower, and it does not preserve the rendering order of triangles "
+          "within a Geom, which may matter for unsorted transparent "
+          "geometry.  See SceneGraphReducer::optimize_vertex_cache()."));
+
 ConfigVariableInt max_lenses
 ("max-lenses", 100,
  PRC_DESC("Specifies an upper limit on the maximum number of lenses "
@@ -375,6 +385,14 @@ ConfigVariableBool allow_live_flatten
           "only has an effect when Panda is not compiled for a release "
           "build."));
 
+ConfigVariableInt find_query_cache_size
+("find-query-cache-size", 64,
+ PRC_DESC("Specifies the number of distinct path strings passed to "
+          "NodePath::find() and find_all_matches() whose parsed form is "
+          "kept for reuse.  When the cache fills up, it is emptied and "
+          "begins to fill again.  Set this to 0 to parse the string on "
+          "every call."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -57,6 +57,7 @@ extern ConfigVariableInt max_collect_indices;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool premunge_data;
 extern ConfigVariableBool preserve_geom_nodes;
 extern ConfigVariableBool flatten_geoms;
+extern ConfigVariableBool flatten_optimize_vertex_cache;
 extern EXPCL_PANDA_PGRAPH ConfigVariableInt max_lenses;
 
 extern ConfigVariableBool polylight_info;
@@ -73,6 +74,7 @@ extern ConfigVariableList load_file_type;
 extern ConfigVariableString default_model_extension;
 
 extern ConfigVariableBool allow_live_flatten;
+extern ConfigVariableInt find_query_cache_size;
 
 extern EXPCL_PANDA_PGRAPH void init_libpgraph();
 
@@ -0,0 +1,178 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file findApproxIndex.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "findApproxIndex.h"
+#include "nodePath.h"
+#include "nodePathCollection.h"
+#include "pandaNode.h"
+#include "lightMutexHolder.h"
+#include "pStatTimer.h"
+
+#include <algorithm>
+
+PStatCollector FindApproxIndex::_rebuild_pcollector("*:NodePath:find_index");
+
+/**
+ *
+ */
+FindApproxIndex::
+FindApproxIndex(PandaNode *root) :
+  _root(root),
+  _max_depth(0),
+  _stale(1)
+{
+}
+
+/**
+ * Returns true if the indicated path is one that can be answered by the
+ * index: a match-many component followed by an exact name, a tag key, or a
+ * tag key and value, with no flags that would change which nodes are
+ * considered.
+ */
+bool FindApproxIndex::
+is_indexable(const FindApproxPath &approx_path) {
+  if (approx_path._path.size() != 2 ||
+      !approx_path._return_hidden ||
+      approx_path._return_stashed) {
+    return false;
+  }
+
+  const FindApproxPath::Component &many = approx_path._path[0];
+  const FindApproxPath::Component &match = approx_path._path[1];
+  if (many._type != FindApproxPath::CT_match_many ||
+      many._flags != 0 || match._flags != 0) {
+    return false;
+  }
+
+  switch (match._type) {
+  case FindApproxPath::CT_match_name:
+  case FindApproxPath::CT_match_tag:
+  case FindApproxPath::CT_match_tag_value:
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+/**
+ * Adds to result up to max_matches NodePaths, extending start, that match the
+ * indicated path, which must have passed is_indexable().  start must refer to
+ * the root node of the index.  The results are the same, and in the same
+ * order, as NodePath::find_matches() would have produced by searching the
+ * graph.
+ */
+void FindApproxIndex::
+find_matches(NodePathCollection &result, const NodePath &start,
+             const FindApproxPath &approx_path, int max_matches,
+             Thread *current_thread) {
+  nassertv(start.node() == _root);
+
+  LightMutexHolder holder(_lock);
+  if (AtomicAdjust::get(_stale) != 0 ||
+      _max_depth != NodePath::get_max_search_depth()) {
+    rebuild(current_thread);
+  }
+
+  const FindApproxPath::Component &match = approx_path._path[1];
+  const Index &index =
+    (match._type == FindApproxPath::CT_match_name) ? _names : _tags;
+
+  Index::const_iterator ii = index.find(match._name);
+  if (ii == index.end()) {
+    return;
+  }
+
+  for (int n : (*ii).second) {
+    if (match._type == FindApproxPath::CT_match_tag_value &&
+        !match.matches(_entries[n]._node)) {
+      continue;
+    }
+    result.add_path(get_node_path(start, n, current_thread));
+    if (max_matches > 0 && result.get_num_paths() >= max_matches) {
+      return;
+    }
+  }
+}
+
+/**
+ * Walks the graph below the root node and records every node by name and by
+ * tag key.  Assumes the lock is held.
+ */
+void FindApproxIndex::
+rebuild(Thread *current_thread) {
+  PStatTimer timer(_rebuild_pcollector, current_thread);
+
+  // Clear the flag before we start, so that a change made while we are
+  // walking the graph will cause another rebuild next time.
+  AtomicAdjust::set(_stale, 0);
+  _max_depth = NodePath::get_max_search_depth();
+
+  _entries.clear();
+  _names.clear();
+  _tags.clear();
+  _entries.push_back(Entry(-1, _root));
+
+  // FindApproxLevelEntry builds each level of its breadth-first search by
+  // prepending to a linked list, so it visits the nodes of each level in the
+  // reverse of the order in which they were encountered.  We do the same.
+  // The root node itself is never a match, and a solution at depth n is only
+  // found if the search is allowed n + 1 levels.
+  size_t level_begin = 0;
+  size_t level_end = _entries.size();
+
+  for (int depth = 1; depth < _max_depth && level_begin < level_end; ++depth) {
+    for (size_t i = level_begin; i < level_end; ++i) {
+      PandaNode::Children children = _entries[i]._node->get_children(current_thread);
+      size_t num_children = children.get_num_children();
+      for (size_t ci = 0; ci < num_children; ++ci) {
+        _entries.push_back(Entry((int)i, children.get_child(ci)));
+      }
+    }
+    std::reverse(_entries.begin() + level_end, _entries.end());
+
+    for (size_t n = level_end; n < _entries.size(); ++n) {
+      PandaNode *node = _entries[n]._node;
+      _names[node->get_name()].push_back((int)n);
+
+      size_t num_tags = node->get_num_tags();
+      for (size_t ti = 0; ti < num_tags; ++ti) {
+        _tags[node->get_tag_key(ti)].push_back((int)n);
+      }
+    }
+
+    level_begin = level_end;
+    level_end = _entries.size();
+  }
+}
+
+/**
+ * Returns the NodePath to the nth entry, extending start, which refers to the
+ * root node.
+ */
+NodePath FindApproxIndex::
+get_node_path(const NodePath &start, int n, Thread *current_thread) const {
+  vector_int chain;
+  while (n > 0) {
+    chain.push_back(n);
+    n = _entries[n]._parent;
+  }
+
+  NodePath path = start;
+  for (vector_int::const_reverse_iterator ci = chain.rbegin();
+       ci != chain.rend();
+       ++ci) {
+    path = NodePath(path, _entries[*ci]._node, current_thread);
+  }
+  return path;
+}
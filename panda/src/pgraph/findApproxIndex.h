@@ -0,0 +1,89 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file findApproxIndex.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef FINDAPPROXINDEX_H
+#define FINDAPPROXINDEX_H
+
+#include "pandabase.h"
+
+#include "findApproxPath.h"
+#include "referenceCount.h"
+#include "lightMutex.h"
+#include "atomicAdjust.h"
+#include "pStatCollector.h"
+#include "pmap.h"
+#include "pvector.h"
+#include "vector_int.h"
+
+class NodePath;
+class NodePathCollection;
+class PandaNode;
+class Thread;
+
+/**
+ * This class is local to this package only; it doesn't get exported.  It
+ * records the names and tags of all of the nodes below a particular
+ * PandaNode, so that a search for any node below with a particular name or
+ * tag need not visit every node of the subgraph.  See
+ * PandaNode::set_find_indexed().
+ *
+ * The nodes are stored in the same order in which FindApproxLevelEntry would
+ * visit them, so that the index returns the matches in the same order as the
+ * full search.
+ */
+class FindApproxIndex : public ReferenceCount {
+public:
+  explicit FindApproxIndex(PandaNode *root);
+
+  INLINE void mark_stale();
+
+  static bool is_indexable(const FindApproxPath &approx_path);
+  void find_matches(NodePathCollection &result, const NodePath &start,
+                    const FindApproxPath &approx_path, int max_matches,
+                    Thread *current_thread);
+
+private:
+  void rebuild(Thread *current_thread);
+  NodePath get_node_path(const NodePath &start, int n,
+                         Thread *current_thread) const;
+
+  class Entry {
+  public:
+    INLINE Entry(int parent, PandaNode *node);
+
+    int _parent;
+    PandaNode *_node;
+  };
+  typedef pvector<Entry> Entries;
+  typedef pmap<std::string, vector_int> Index;
+
+  // The root node owns the index, so we don't hold a reference to it.
+  PandaNode *_root;
+
+  // The first entry is always the root node itself.  The remaining nodes are
+  // not reference counted either; if any of them is removed from the graph,
+  // the index is marked stale and rebuilt before it is used again.
+  Entries _entries;
+  Index _names;
+  Index _tags;
+  int _max_depth;
+
+  AtomicAdjust::Integer _stale;
+  LightMutex _lock;
+
+  static PStatCollector _rebuild_pcollector;
+};
+
+#include "findApproxIndex.I"
+
+#endif
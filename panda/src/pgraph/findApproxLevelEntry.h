@@ -29,7 +29,7 @@ class NodePathCollection;
 class FindApproxLevelEntry {
 public:
   INLINE FindApproxLevelEntry(const WorkingNodePath &node_path,
-                              FindApproxPath &approx_path);
+                              const FindApproxPath &approx_path);
   INLINE FindApproxLevelEntry(const FindApproxLevelEntry &parent,
                               PandaNode *child_node, int i,
                               FindApproxLevelEntry *next);
@@ -58,7 +58,7 @@ public:
   // against all of the children of _node_path, above.  If _i refers to the
   // end of the approx_path, then _node_path is a solution.
   int _i;
-  FindApproxPath &_approx_path;
+  const FindApproxPath &_approx_path;
   FindApproxLevelEntry *_next;
 
 public:
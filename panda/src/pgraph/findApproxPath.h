@@ -100,6 +100,7 @@ private:
   bool _return_stashed;
   bool _case_insensitive;
 
+friend class FindApproxIndex;
 friend std::ostream &operator << (std::ostream &, FindApproxPath::ComponentType);
 friend INLINE std::ostream &operator << (std::ostream &, const FindApproxPath::Component &);
 };
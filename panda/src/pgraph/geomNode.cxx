@@ -416,6 +416,9 @@ r_prepare_scene(GraphicsStateGuardianBase *gsg, const RenderState *node_state,
       Shader *shader = (Shader *)sa->get_shader();
       if (shader != nullptr) {
         prepared_objects->enqueue_shader(shader);
+      } else if (sa->auto_shader()) {
+        // The GSG generates these in one batch at the end of prepare_scene().
+        gsg->enqueue_generated_shader(geom_state);
       }
       // TODO: prepare the shader inputs.
     }
@@ -902,6 +902,30 @@ reverse(GeomNode *node) {
   return (num_geoms != 0);
 }
 
+/**
+ * Reorders the primitives of the Geoms in this GeomNode for better use of the
+ * post-transform vertex cache; see Geom::optimize_vertex_cache().  The
+ * vertices themselves will also be rearranged into the order in which they
+ * are first used, for better locality of vertex fetches, the next time
+ * finish_apply() is called.
+ *
+ * Returns true if any Geoms are modified, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(GeomNode *node, int cache_size) {
+  int num_geoms = node->get_num_geoms();
+  for (int i = 0; i < num_geoms; ++i) {
+    PT(Geom) geom = node->modify_geom(i);
+    geom->optimize_vertex_cache_in_place(cache_size);
+
+    VertexDataAssoc &assoc = _vdata_assoc[geom->get_vertex_data()];
+    assoc._geoms.push_back(geom);
+    assoc._reorder_vertices = true;
+  }
+
+  return (num_geoms != 0);
+}
+
 /**
  * Should be called after performing any operations--particularly
  * PandaNode::apply_attribs_to_vertices()--that might result in new
@@ -915,7 +939,10 @@ finish_apply() {
   for (vi = _vdata_assoc.begin(); vi != _vdata_assoc.end(); ++vi) {
     const GeomVertexData *vdata = (*vi).first;
     VertexDataAssoc &assoc = (*vi).second;
-    if (assoc._might_have_unused) {
+    if (assoc._reorder_vertices) {
+      // This also removes any unused vertices.
+      assoc.reorder_vertices(vdata);
+    } else if (assoc._might_have_unused) {
       assoc.remove_unused_vertices(vdata);
     }
   }
@@ -1549,3 +1576,150 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+/**
+ * Rearranges the vertices of the indicated GeomVertexData into the order in
+ * which they are first referenced by the associated Geoms, so that vertices
+ * that are rendered together are also stored together.  Vertices that are
+ * not referenced at all are removed.
+ */
+void GeomTransformer::VertexDataAssoc::
+reorder_vertices(const GeomVertexData *vdata) {
+  if (_geoms.empty()) {
+    // Trivial case.
+    return;
+  }
+
+  PT(Thread) current_thread = Thread::get_current_thread();
+
+  int num_vertices = vdata->get_num_rows();
+  pvector<int> remap_array(num_vertices, -1);
+  int new_num_vertices = 0;
+  bool any_moved = false;
+
+  GeomList::iterator gi;
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      GeomPrimitivePipelineReader reader(geom->get_primitive(i), current_thread);
+      int strip_cut_index = reader.is_indexed() ? reader.get_strip_cut_index() : -1;
+      int num_prim_vertices = reader.get_num_vertices();
+      for (int vi = 0; vi < num_prim_vertices; ++vi) {
+        int index = reader.get_vertex(vi);
+        if (index == strip_cut_index) {
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        if (remap_array[index] < 0) {
+          if (index != new_num_vertices) {
+            any_moved = true;
+          }
+          remap_array[index] = new_num_vertices++;
+        }
+      }
+    }
+  }
+
+  if (!any_moved && new_num_vertices == num_vertices) {
+    // The vertices are already in order.
+    return;
+  }
+
+  // Now recopy the actual vertex data, one array at a time.
+  PT(GeomVertexData) new_vdata = new GeomVertexData(*vdata);
+  new_vdata->unclean_set_num_rows(new_num_vertices);
+
+  size_t num_arrays = vdata->get_num_arrays();
+  nassertv(num_arrays == new_vdata->get_num_arrays());
+
+  {
+    GeomVertexDataPipelineReader reader(vdata, current_thread);
+    reader.check_array_readers();
+    GeomVertexDataPipelineWriter writer(new_vdata, true, current_thread);
+    writer.check_array_writers();
+
+    for (size_t a = 0; a < num_arrays; ++a) {
+      const GeomVertexArrayDataHandle *array_reader = reader.get_array_reader(a);
+      GeomVertexArrayDataHandle *array_writer = writer.get_array_writer(a);
+
+      int stride = array_reader->get_array_format()->get_stride();
+      nassertv(stride == array_writer->get_array_format()->get_stride());
+
+      for (int index = 0; index < num_vertices; ++index) {
+        int new_index = remap_array[index];
+        if (new_index >= 0) {
+          array_writer->copy_subdata_from(new_index * stride, stride,
+                                          array_reader,
+                                          index * stride, stride);
+        }
+      }
+    }
+  }
+
+  // The rows affected by the TransformBlendTable and the SliderTable, if
+  // any, are no longer contiguous in the same way, so we recompute them.
+  PT(TransformBlendTable) tbtable = new_vdata->modify_transform_blend_table();
+  if (!tbtable.is_null()) {
+    const SparseArray &rows = tbtable->get_rows();
+    SparseArray new_rows;
+    for (int index = 0; index < num_vertices; ++index) {
+      if (remap_array[index] >= 0 && rows.get_bit(index)) {
+        new_rows.set_bit(remap_array[index]);
+      }
+    }
+    tbtable->set_rows(new_rows);
+  }
+
+  const SliderTable *sliders = new_vdata->get_slider_table();
+  if (sliders != nullptr) {
+    PT(SliderTable) new_sliders = new SliderTable(*sliders);
+    size_t num_sliders = sliders->get_num_sliders();
+    for (size_t si = 0; si < num_sliders; ++si) {
+      const SparseArray &rows = sliders->get_slider_rows(si);
+      SparseArray new_rows;
+      for (int index = 0; index < num_vertices; ++index) {
+        if (remap_array[index] >= 0 && rows.get_bit(index)) {
+          new_rows.set_bit(remap_array[index]);
+        }
+      }
+      new_sliders->set_slider_rows(si, new_rows);
+    }
+    new_vdata->set_slider_table(SliderTable::register_table(new_sliders));
+  }
+
+  // Finally, reindex the Geoms.
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(i);
+      prim->make_indexed();
+      int strip_cut_index = prim->get_strip_cut_index();
+      PT(GeomVertexArrayData) vertices = prim->modify_vertices();
+      GeomVertexRewriter rewriter(vertices, 0, current_thread);
+
+      while (!rewriter.is_at_end()) {
+        int index = rewriter.get_data1i();
+        if (index == strip_cut_index) {
+          rewriter.set_data1i(index);
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        int new_index = remap_array[index];
+        nassertv(new_index >= 0 && new_index < new_num_vertices);
+        rewriter.set_data1i(new_index);
+      }
+    }
+
+    geom->set_vertex_data(new_vdata);
+  }
+}
@@ -82,6 +82,8 @@ public:
   bool doubleside(GeomNode *node);
   bool reverse(GeomNode *node);
 
+  bool optimize_vertex_cache(GeomNode *node, int cache_size);
+
   void finish_apply();
 
   int collect_vertex_data(Geom *geom, int collect_bits, bool format_only);
@@ -102,8 +104,10 @@ private:
   public:
     INLINE VertexDataAssoc();
     bool _might_have_unused;
+    bool _reorder_vertices;
     GeomList _geoms;
     void remove_unused_vertices(const GeomVertexData *vdata);
+    void reorder_vertices(const GeomVertexData *vdata);
   };
   typedef pmap<CPT(GeomVertexData), VertexDataAssoc> VertexDataAssocMap;
   VertexDataAssocMap _vdata_assoc;
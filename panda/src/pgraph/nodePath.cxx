@@ -16,6 +16,8 @@
 #include "nodePathCollection.h"
 #include "findApproxPath.h"
 #include "findApproxLevelEntry.h"
+#include "findApproxIndex.h"
+#include "nodePathQuery.h"
 #include "internalNameCollection.h"
 #include "config_pgraph.h"
 #include "colorAttrib.h"
@@ -324,6 +326,27 @@ find(const string &path) const {
   return col.get_path(0);
 }
 
+/**
+ * Searches for a node below the referenced node that matches the indicated
+ * query.  This is the same as find(), but it accepts a path string that has
+ * already been parsed.
+ */
+NodePath NodePath::
+find(const NodePathQuery &query) const {
+  nassertr_always(!is_empty(), fail());
+
+  NodePathCollection col;
+  if (query.is_valid()) {
+    find_matches(col, query.get_approx_path(), 1);
+  }
+
+  if (col.is_empty()) {
+    return NodePath::not_found();
+  }
+
+  return col.get_path(0);
+}
+
 /**
  * Searches for the indicated node below this node and returns the shortest
  * NodePath that connects them.
@@ -359,6 +382,23 @@ find_all_matches(const string &path) const {
   return col;
 }
 
+/**
+ * Returns the complete set of all NodePaths that begin with this NodePath and
+ * can be extended by the indicated query.  This is the same as
+ * find_all_matches(), but it accepts a path string that has already been
+ * parsed.
+ */
+NodePathCollection NodePath::
+find_all_matches(const NodePathQuery &query) const {
+  NodePathCollection col;
+  nassertr_always(!is_empty(), col);
+  nassertr(verify_complete(), col);
+  if (query.is_valid()) {
+    find_matches(col, query.get_approx_path(), -1);
+  }
+  return col;
+}
+
 /**
  * Returns the set of all NodePaths that extend from this NodePath down to the
  * indicated node.  The shortest paths will be listed first.
@@ -5586,6 +5626,10 @@ flatten_medium() {
  * that will be culled largely as a single unit, like a car.  Applying this to
  * an entire scene may result in overall poorer performance because of less-
  * effective culling.
+ *
+ * If flatten-optimize-vertex-cache is set, the resulting Geoms are also
+ * reordered for better vertex cache efficiency; see
+ * SceneGraphReducer::optimize_vertex_cache().
  */
 int NodePath::
 flatten_strong() {
@@ -5598,6 +5642,10 @@ flatten_strong() {
     gr.make_compatible_state(node());
     gr.collect_vertex_data(node(), ~(SceneGraphReducer::CVD_format | SceneGraphReducer::CVD_name | SceneGraphReducer::CVD_animation_type));
     gr.unify(node(), false);
+
+    if (flatten_optimize_vertex_cache) {
+      gr.optimize_vertex_cache(node());
+    }
   }
 
   return num_removed;
@@ -6060,9 +6108,9 @@ find_matches(NodePathCollection &result, const string &path,
       << "'.\n";
     return;
   }
-  FindApproxPath approx_path;
-  if (approx_path.add_string(path)) {
-    find_matches(result, approx_path, max_matches);
+  CPT(NodePathQuery) query = NodePathQuery::get_cached(path);
+  if (query->is_valid()) {
+    find_matches(result, query->get_approx_path(), max_matches);
   }
 }
 
@@ -6072,7 +6120,7 @@ find_matches(NodePathCollection &result, const string &path,
  * matches to return, or -1 not to limit the number returned.
  */
 void NodePath::
-find_matches(NodePathCollection &result, FindApproxPath &approx_path,
+find_matches(NodePathCollection &result, const FindApproxPath &approx_path,
              int max_matches) const {
   if (is_empty()) {
     pgraph_cat.warning()
@@ -6080,6 +6128,17 @@ find_matches(NodePathCollection &result, FindApproxPath &approx_path,
     return;
   }
 
+  // If the node keeps an index of the names and tags below it, and this is
+  // the sort of query it can answer, we needn't walk the graph.
+  PandaNode *this_node = node();
+  if (this_node->_find_index != nullptr &&
+      FindApproxIndex::is_indexable(approx_path)) {
+    this_node->_find_index->find_matches(result, *this, approx_path,
+                                         max_matches,
+                                         Thread::get_current_thread());
+    return;
+  }
+
   // We start with just one entry on the level.
   FindApproxLevelEntry *level =
     new FindApproxLevelEntry(WorkingNodePath(*this), approx_path);
@@ -47,6 +47,7 @@
 #include "textureStageCollection.h"
 
 class NodePathCollection;
+class NodePathQuery;
 class FindApproxPath;
 class FindApproxLevelEntry;
 class Light;
@@ -243,8 +244,10 @@ PUBLISHED:
   MAKE_PROPERTY(sort, get_sort);
 
   NodePath find(const std::string &path) const;
+  NodePath find(const NodePathQuery &query) const;
   NodePath find_path_to(PandaNode *node) const;
   NodePathCollection find_all_matches(const std::string &path) const;
+  NodePathCollection find_all_matches(const NodePathQuery &query) const;
   NodePathCollection find_all_paths_to(PandaNode *node) const;
 
   // Methods that actually move nodes around in the scene graph.  The optional
@@ -978,7 +981,7 @@ private:
                     const std::string &approx_path_str,
                     int max_matches) const;
   void find_matches(NodePathCollection &result,
-                    FindApproxPath &approx_path,
+                    const FindApproxPath &approx_path,
                     int max_matches) const;
   void find_matches(NodePathCollection &result,
                     FindApproxLevelEntry *level,
@@ -14,6 +14,7 @@
 #include "nodePathCollection.h"
 #include "findApproxPath.h"
 #include "findApproxLevelEntry.h"
+#include "nodePathQuery.h"
 #include "textureAttrib.h"
 #include "colorScaleAttrib.h"
 #include "colorAttrib.h"
@@ -227,20 +228,29 @@ ls(std::ostream &out, int indent_level) const {
  */
 NodePathCollection NodePathCollection::
 find_all_matches(const std::string &path) const {
+  CPT(NodePathQuery) query = NodePathQuery::get_cached(path);
+  return find_all_matches(*query);
+}
+
+/**
+ * Returns the complete set of all NodePaths that begin with any NodePath in
+ * this collection and can be extended by the indicated query.  This is the
+ * same as find_all_matches(), but it accepts a path string that has already
+ * been parsed.
+ */
+NodePathCollection NodePathCollection::
+find_all_matches(const NodePathQuery &query) const {
   NodePathCollection result;
 
-  FindApproxPath approx_path;
-  if (approx_path.add_string(path)) {
-    if (!is_empty()) {
-      FindApproxLevelEntry *level = nullptr;
-      for (int i = 0; i < get_num_paths(); i++) {
-        FindApproxLevelEntry *start =
-          new FindApproxLevelEntry(get_path(i), approx_path);
-        start->_next = level;
-        level = start;
-      }
-      get_path(0).find_matches(result, level, -1);
+  if (query.is_valid() && !is_empty()) {
+    FindApproxLevelEntry *level = nullptr;
+    for (int i = 0; i < get_num_paths(); i++) {
+      FindApproxLevelEntry *start =
+        new FindApproxLevelEntry(get_path(i), query.get_approx_path());
+      start->_next = level;
+      level = start;
     }
+    get_path(0).find_matches(result, level, -1);
   }
 
   return result;
@@ -59,6 +59,7 @@ PUBLISHED:
   void ls(std::ostream &out, int indent_level = 0) const;
 
   NodePathCollection find_all_matches(const std::string &path) const;
+  NodePathCollection find_all_matches(const NodePathQuery &query) const;
   void reparent_to(const NodePath &other);
   void wrt_reparent_to(const NodePath &other);
 
@@ -0,0 +1,72 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nodePathQuery.cxx
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#include "nodePathQuery.h"
+#include "config_pgraph.h"
+#include "lightMutexHolder.h"
+
+NodePathQuery::Cache NodePathQuery::_cache;
+LightMutex NodePathQuery::_cache_lock("NodePathQuery::_cache_lock");
+
+/**
+ * Parses the indicated path string.  If the string contains an error, it is
+ * reported, and is_valid() will return false.
+ */
+NodePathQuery::
+NodePathQuery(const std::string &path) :
+  _path(path)
+{
+  _valid = _approx_path.add_string(path);
+}
+
+/**
+ *
+ */
+void NodePathQuery::
+output(std::ostream &out) const {
+  out << "NodePathQuery(\"" << _path << "\")";
+}
+
+/**
+ * Returns a query for the indicated path string, reusing a previously parsed
+ * query for the same string if there is one.  This is used to implement the
+ * forms of NodePath::find() and find_all_matches() that accept a string.
+ *
+ * Invalid strings are not cached, so that the error is reported again each
+ * time.
+ */
+CPT(NodePathQuery) NodePathQuery::
+get_cached(const std::string &path) {
+  int cache_size = find_query_cache_size;
+  if (cache_size <= 0) {
+    return new NodePathQuery(path);
+  }
+
+  {
+    LightMutexHolder holder(_cache_lock);
+    Cache::const_iterator ci = _cache.find(path);
+    if (ci != _cache.end()) {
+      return (*ci).second;
+    }
+  }
+
+  CPT(NodePathQuery) query = new NodePathQuery(path);
+  if (query->is_valid()) {
+    LightMutexHolder holder(_cache_lock);
+    if ((int)_cache.size() >= cache_size) {
+      _cache.clear();
+    }
+    _cache[path] = query;
+  }
+  return query;
+}
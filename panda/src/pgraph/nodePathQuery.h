@@ -0,0 +1,65 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nodePathQuery.h
+ * @author agent
+ * @date 2026-10-17
+ */
+
+#ifndef NODEPATHQUERY_H
+#define NODEPATHQUERY_H
+
+#include "pandabase.h"
+
+#include "findApproxPath.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "lightMutex.h"
+#include "pmap.h"
+
+/**
+ * A path string, as accepted by NodePath::find() and find_all_matches(),
+ * that has been parsed in advance.  Code that issues the same search many
+ * times, for instance once each frame, may construct a NodePathQuery once
+ * and pass it in place of the string, to avoid parsing the string again on
+ * each call.
+ */
+class EXPCL_PANDA_PGRAPH NodePathQuery : public ReferenceCount {
+PUBLISHED:
+  explicit NodePathQuery(const std::string &path);
+
+  INLINE bool is_valid() const;
+  INLINE const std::string &get_path() const;
+  MAKE_PROPERTY(valid, is_valid);
+  MAKE_PROPERTY(path, get_path);
+
+  void output(std::ostream &out) const;
+
+public:
+  INLINE const FindApproxPath &get_approx_path() const;
+
+  static CPT(NodePathQuery) get_cached(const std::string &path);
+
+private:
+  std::string _path;
+  FindApproxPath _approx_path;
+  bool _valid;
+
+  typedef pmap<std::string, CPT(NodePathQuery) > Cache;
+  static Cache _cache;
+  static LightMutex _cache_lock;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const NodePathQuery &query) {
+  query.output(out);
+  return out;
+}
+
+#include "nodePathQuery.I"
+
+#endif
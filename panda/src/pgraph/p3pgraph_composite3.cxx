@@ -18,6 +18,7 @@
 #include "modelRoot.cxx"
 #include "nodePathCollection.cxx"
 #include "nodePathComponent.cxx"
+#include "nodePathQuery.cxx"
 #include "occluderEffect.cxx"
 #include "occluderNode.cxx"
 #include "pandaNode.cxx"
@@ -41,6 +41,7 @@ TypeHandle PandaNode::BamReaderAuxDataDown::_type_handle;
 PandaNode::SceneRootFunc *PandaNode::_scene_root_func;
 
 PandaNodeChain PandaNode::_dirty_prev_transforms("_dirty_prev_transforms");
+AtomicAdjust::Integer PandaNode::_num_find_indexes = 0;
 DrawMask PandaNode::_overall_bit = DrawMask::bit(31);
 
 PStatCollector PandaNode::_reset_prev_pcollector("App:Collisions:Reset");
@@ -119,6 +120,11 @@ PandaNode::
 #endif  // NDEBUG
   */
 
+  if (_find_index != nullptr) {
+    _find_index = nullptr;
+    AtomicAdjust::dec(_num_find_indexes);
+  }
+
   remove_all_children();
 }
 
@@ -553,6 +559,7 @@ add_child(PandaNode *child_node, int sort, Thread *current_thread) {
 
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -583,6 +590,7 @@ remove_child(int child_index, Thread *current_thread) {
 
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -617,6 +625,7 @@ remove_child(PandaNode *child_node, Thread *current_thread) {
     // Call callback hooks.
     children_changed();
     child_node->parents_changed();
+    mark_find_index_stale(current_thread);
   }
 
   return any_removed;
@@ -663,6 +672,7 @@ replace_child(PandaNode *orig_child, PandaNode *new_child,
     children_changed();
     orig_child->parents_changed();
     new_child->parents_changed();
+    mark_find_index_stale(current_thread);
   }
 
   return any_replaced;
@@ -705,6 +715,7 @@ stash_child(int child_index, Thread *current_thread) {
 
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -747,6 +758,7 @@ unstash_child(int stashed_index, Thread *current_thread) {
   force_bounds_stale();
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -789,6 +801,7 @@ add_stashed(PandaNode *child_node, int sort, Thread *current_thread) {
   // Call callback hooks.
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -817,6 +830,7 @@ remove_stashed(int child_index, Thread *current_thread) {
 
   children_changed();
   child_node->parents_changed();
+  mark_find_index_stale(current_thread);
   mark_bam_modified();
   child_node->mark_bam_modified();
 }
@@ -863,6 +877,7 @@ remove_all_children(Thread *current_thread) {
   force_bounds_stale();
   children_changed();
   mark_bam_modified();
+  mark_find_index_stale(current_thread);
 }
 
 /**
@@ -1214,6 +1229,7 @@ set_tag(const string &key, const string &value, Thread *current_thread) {
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
   mark_bam_modified();
+  mark_find_index_stale(current_thread);
 }
 
 /**
@@ -1229,6 +1245,7 @@ clear_tag(const string &key, Thread *current_thread) {
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
   mark_bam_modified();
+  mark_find_index_stale(current_thread);
 }
 
 /**
@@ -1262,6 +1279,7 @@ copy_tags(PandaNode *other) {
   _python_tag_data = other->_python_tag_data;
 
   mark_bam_modified();
+  mark_find_index_stale(current_thread);
 }
 
 /**
@@ -1351,6 +1369,33 @@ compare_tags(const PandaNode *other) const {
   return 0;
 }
 
+/**
+ * Enables or disables an index of the names and tags of all of the nodes
+ * below this node.  While it is enabled, a NodePath::find() or
+ * find_all_matches() that begins at this node and searches for any node below
+ * with a particular name, tag, or tag value (that is, a path consisting of
+ * "**", a slash, and then a name, "=key" or "=key=value") looks up the
+ * answer in the index rather than visiting every node of the subgraph.  The
+ * results are the same either way.
+ *
+ * The index is rebuilt on the first such search after any node below this
+ * one has been renamed or retagged, or after any node has been added to or
+ * removed from the subgraph.  It therefore only pays off for a subgraph that
+ * is searched much more often than it changes.
+ */
+void PandaNode::
+set_find_indexed(bool find_indexed) {
+  if (find_indexed) {
+    if (_find_index == nullptr) {
+      _find_index = new FindApproxIndex(this);
+      AtomicAdjust::inc(_num_find_indexes);
+    }
+  } else if (_find_index != nullptr) {
+    _find_index = nullptr;
+    AtomicAdjust::dec(_num_find_indexes);
+  }
+}
+
 /**
  * Copies the TransformState, RenderState, RenderEffects, tags, Python tags,
  * and the show/hide state from the other node onto this one.  Typically this
@@ -1418,6 +1463,7 @@ copy_all_properties(PandaNode *other) {
   // It's okay to copy the tags by pointer, because get_python_tags does a
   // copy-on-write.
   _python_tag_data = other->_python_tag_data;
+  mark_find_index_stale(current_thread);
 
   if (any_transform_changed || any_state_changed || any_draw_mask_changed) {
     mark_bounds_stale(current_thread);
@@ -1751,13 +1797,15 @@ get_off_clip_planes(Thread *current_thread) const {
  * overhead away from that process.
  *
  * In particular, this will ensure that textures and vertex buffers within the
- * scene are loaded into graphics memory.
+ * scene are loaded into graphics memory, and that shaders are generated for
+ * any states that use the shader generator.
  */
 void PandaNode::
 prepare_scene(GraphicsStateGuardianBase *gsg, const RenderState *node_state) {
   GeomTransformer transformer;
   Thread *current_thread = Thread::get_current_thread();
   r_prepare_scene(gsg, node_state, transformer, current_thread);
+  gsg->flush_generated_shaders();
 }
 
 /**
@@ -2280,6 +2328,23 @@ force_bounds_stale(int pipeline_stage, Thread *current_thread) {
   }
 }
 
+/**
+ * Marks the index kept by set_find_indexed() stale on this node and on every
+ * node above it.
+ */
+void PandaNode::
+r_mark_find_index_stale(Thread *current_thread) {
+  if (_find_index != nullptr) {
+    _find_index->mark_stale();
+  }
+
+  Parents parents = get_parents(current_thread);
+  size_t num_parents = parents.get_num_parents();
+  for (size_t i = 0; i < num_parents; ++i) {
+    parents.get_parent(i)->r_mark_find_index_stale(current_thread);
+  }
+}
+
 /**
  * Recursively calls Geom::mark_bounds_stale() on every Geom at this node and
  * below.
@@ -2758,6 +2823,11 @@ void PandaNode::
 detach(NodePathComponent *child, int pipeline_stage, Thread *current_thread) {
   nassertv(child != nullptr);
 
+  PT(PandaNode) parent_node;
+  if (!child->is_top_node(pipeline_stage, current_thread)) {
+    parent_node = child->get_next(pipeline_stage, current_thread)->get_node();
+  }
+
   for (int pipeline_stage_i = pipeline_stage;
        pipeline_stage_i >= 0;
        --pipeline_stage_i) {
@@ -2765,6 +2835,9 @@ detach(NodePathComponent *child, int pipeline_stage, Thread *current_thread) {
   }
 
   child->get_node()->parents_changed();
+  if (parent_node != nullptr) {
+    parent_node->mark_find_index_stale(current_thread);
+  }
 }
 
 /**
@@ -2861,6 +2934,7 @@ reparent(NodePathComponent *new_parent, NodePathComponent *child, int sort,
   if (new_parent != nullptr) {
     new_parent->get_node()->children_changed();
     new_parent->get_node()->mark_bam_modified();
+    new_parent->get_node()->mark_find_index_stale(current_thread);
   }
   child->get_node()->parents_changed();
   child->get_node()->mark_bam_modified();
@@ -46,6 +46,7 @@
 #include "lightReMutex.h"
 #include "extension.h"
 #include "simpleHashMap.h"
+#include "findApproxIndex.h"
 
 class NodePathComponent;
 class CullTraverser;
@@ -225,6 +226,14 @@ PUBLISHED:
 
   int compare_tags(const PandaNode *other) const;
 
+  INLINE void set_name(const std::string &name);
+  INLINE void clear_name();
+  MAKE_PROPERTY(name, get_name, set_name);
+
+  void set_find_indexed(bool find_indexed);
+  INLINE bool is_find_indexed() const;
+  MAKE_PROPERTY(find_indexed, is_find_indexed, set_find_indexed);
+
   void copy_all_properties(PandaNode *other);
   void replace_node(PandaNode *other);
 
@@ -448,6 +457,9 @@ private:
   INLINE void do_set_dirty_prev_transform();
   INLINE void do_clear_dirty_prev_transform();
 
+  INLINE void mark_find_index_stale(Thread *current_thread);
+  void r_mark_find_index_stale(Thread *current_thread);
+
 public:
   // This must be declared public so that VC6 will allow the nested CData
   // class to access it.
@@ -524,6 +536,12 @@ private:
   bool _dirty_prev_transform;
   static PandaNodeChain _dirty_prev_transforms;
 
+  // The index used by NodePath::find() for the subgraph below this node, if
+  // set_find_indexed() has been called.  We keep a count of these, so that
+  // we need not walk up the graph on every change when there are none.
+  PT(FindApproxIndex) _find_index;
+  static AtomicAdjust::Integer _num_find_indexes;
+
   // This is used to maintain a table of keyed data on each node, for the
   // user's purposes.
   typedef SimpleHashMap<std::string, std::string, string_hash> TagData;
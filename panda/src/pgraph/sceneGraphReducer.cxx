@@ -31,6 +31,8 @@ PStatCollector SceneGraphReducer::_collect_collector("*:Flatten:collect");
 PStatCollector SceneGraphReducer::_make_nonindexed_collector("*:Flatten:make nonindexed");
 PStatCollector SceneGraphReducer::_unify_collector("*:Flatten:unify");
 PStatCollector SceneGraphReducer::_remove_unused_collector("*:Flatten:remove unused vertices");
+PStatCollector SceneGraphReducer::_optimize_vertex_cache_collector("*:Flatten:optimize vertex cache");
+PStatCollector SceneGraphReducer::_simplify_collector("*:Flatten:simplify");
 PStatCollector SceneGraphReducer::_premunge_collector("*:Premunge");
 
 /**
@@ -202,6 +204,74 @@ remove_unused_vertices(PandaNode *root) {
   Thread::consider_yield();
 }
 
+/**
+ * Reorders the primitives of every Geom at this level and below for better
+ * use of the post-transform vertex cache, and to reduce overdraw.  The
+ * vertices in each GeomVertexData are then rearranged into the order in which
+ * they are first used, for better locality of vertex fetches.  This is most
+ * effective after the Geoms have been combined by flatten_strong(), and it
+ * benefits the tinydisplay software renderer as well as hardware renderers.
+ *
+ * If cache_size is 0, the value of vertex-cache-size is used.  Returns the
+ * number of Geoms that were examined.  Also see calc_acmr().
+ */
+int SceneGraphReducer::
+optimize_vertex_cache(PandaNode *root, int cache_size) {
+  nassertr(check_live_flatten(root), 0);
+  PStatTimer timer(_optimize_vertex_cache_collector);
+
+  int num_geoms = r_optimize_vertex_cache(root, cache_size, _transformer);
+  _transformer.finish_apply();
+
+  if (pgraph_cat.is_debug()) {
+    pgraph_cat.debug()
+      << "Optimized vertex cache for " << num_geoms << " Geoms under "
+      << *root << ", ACMR is now " << calc_acmr(root, cache_size) << "\n";
+  }
+  Thread::consider_yield();
+  return num_geoms;
+}
+
+/**
+ * Returns the average cache miss ratio over all of the Geoms at this level and
+ * below, weighted by the number of faces in each.  This is the average number
+ * of vertices that have to be transformed for each triangle; see
+ * GeomPrimitive::calc_acmr().  This is useful to measure the effect of
+ * optimize_vertex_cache().
+ */
+PN_stdfloat SceneGraphReducer::
+calc_acmr(PandaNode *root, int cache_size) {
+  PN_stdfloat num_misses = 0;
+  int num_faces = 0;
+  r_calc_acmr(root, cache_size, num_misses, num_faces);
+
+  if (num_faces == 0) {
+    return 0;
+  }
+  return num_misses / num_faces;
+}
+
+/**
+ * Reduces the number of triangles in every Geom at this level and below to
+ * approximately target_ratio times the original number, and then removes the
+ * vertices that are no longer used.  If max_error is greater than zero, each
+ * Geom is simplified only as far as possible without moving its surface by
+ * more than approximately this distance.  See Geom::simplify_in_place().
+ *
+ * This is intended for generating the lower levels of an LODNode; see
+ * LODNode::add_simplified_switch().  Returns the number of triangles removed.
+ */
+int SceneGraphReducer::
+simplify(PandaNode *root, PN_stdfloat target_ratio, PN_stdfloat max_error) {
+  nassertr(check_live_flatten(root), 0);
+  PStatTimer timer(_simplify_collector);
+
+  int num_removed = r_simplify(root, target_ratio, max_error, _transformer);
+  _transformer.finish_apply();
+  Thread::consider_yield();
+  return num_removed;
+}
+
 /**
  * In a non-release build, returns false if the node is correctly not in a
  * live scene graph.  (Calling flatten on a node that is part of a live scene
@@ -948,6 +1018,90 @@ r_decompose(PandaNode *node) {
   }
 }
 
+/**
+ * The recursive implementation of optimize_vertex_cache().
+ */
+int SceneGraphReducer::
+r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                        GeomTransformer &transformer) {
+  int num_geoms = 0;
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    num_geoms += geom_node->get_num_geoms();
+    transformer.optimize_vertex_cache(geom_node, cache_size);
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_geoms += r_optimize_vertex_cache(children.get_child(i), cache_size, transformer);
+  }
+  Thread::consider_yield();
+  return num_geoms;
+}
+
+/**
+ * The recursive implementation of calc_acmr().
+ */
+void SceneGraphReducer::
+r_calc_acmr(PandaNode *node, int cache_size,
+            PN_stdfloat &num_misses, int &num_faces) {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geom_node->get_geom(i);
+      int num_primitives = geom->get_num_primitives();
+      for (int j = 0; j < num_primitives; ++j) {
+        CPT(GeomPrimitive) prim = geom->get_primitive(j);
+        int prim_faces = prim->get_num_faces();
+        num_misses += prim->calc_acmr(cache_size) * prim_faces;
+        num_faces += prim_faces;
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_calc_acmr(children.get_child(i), cache_size, num_misses, num_faces);
+  }
+}
+
+/**
+ * The recursive implementation of simplify().
+ */
+int SceneGraphReducer::
+r_simplify(PandaNode *node, PN_stdfloat target_ratio, PN_stdfloat max_error,
+           GeomTransformer &transformer) {
+  int num_removed = 0;
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      PT(Geom) geom = geom_node->modify_geom(i);
+      int orig_faces = 0, new_faces = 0;
+      for (size_t j = 0; j < geom->get_num_primitives(); ++j) {
+        orig_faces += geom->get_primitive(j)->get_num_faces();
+      }
+      geom->simplify_in_place(target_ratio, max_error);
+      for (size_t j = 0; j < geom->get_num_primitives(); ++j) {
+        new_faces += geom->get_primitive(j)->get_num_faces();
+      }
+      num_removed += orig_faces - new_faces;
+      transformer.register_vertices(geom, true);
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    num_removed += r_simplify(children.get_child(i), target_ratio, max_error, transformer);
+  }
+  Thread::consider_yield();
+  return num_removed;
+}
+
 /**
  * The recursive implementation of premunge().
  */
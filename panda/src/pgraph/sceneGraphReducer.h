@@ -138,6 +138,11 @@ PUBLISHED:
   void unify(PandaNode *root, bool preserve_order);
   void remove_unused_vertices(PandaNode *root);
 
+  int optimize_vertex_cache(PandaNode *root, int cache_size = 0);
+  PN_stdfloat calc_acmr(PandaNode *root, int cache_size = 0);
+
+  int simplify(PandaNode *root, PN_stdfloat target_ratio, PN_stdfloat max_error = 0.0f);
+
   INLINE void premunge(PandaNode *root, const RenderState *initial_state);
   bool check_live_flatten(PandaNode *node);
 
@@ -177,6 +182,12 @@ protected:
   void r_unify(PandaNode *node, int max_indices, bool preserve_order);
   void r_register_vertices(PandaNode *node, GeomTransformer &transformer);
   void r_decompose(PandaNode *node);
+  int r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                              GeomTransformer &transformer);
+  void r_calc_acmr(PandaNode *node, int cache_size,
+                   PN_stdfloat &num_misses, int &num_faces);
+  int r_simplify(PandaNode *node, PN_stdfloat target_ratio, PN_stdfloat max_error,
+                 GeomTransformer &transformer);
 
   void r_premunge(PandaNode *node, const RenderState *state);
 
@@ -193,6 +204,8 @@ private:
   static PStatCollector _make_nonindexed_collector;
   static PStatCollector _unify_collector;
   static PStatCollector _remove_unused_collector;
+  static PStatCollector _optimize_vertex_cache_collector;
+  static PStatCollector _simplify_collector;
   static PStatCollector _premunge_collector;
 };
 
@@ -99,6 +99,21 @@ ConfigVariableDouble parallax_mapping_scale
           "how much influence the height values have on the texture "
           "coordinates."));
 
+ConfigVariableBool shader_generator_disk_cache
+("shader-generator-disk-cache", true,
+ PRC_DESC("When this is true, and the model cache is enabled (see "
+          "model-cache-dir), shaders synthesized by the shader generator "
+          "are also written to the model cache, so that later sessions may "
+          "reuse them instead of generating them again."));
+
+ConfigVariableInt shader_generator_threads
+("shader-generator-threads", 4,
+ PRC_DESC("The maximum number of threads the shader generator may use to "
+          "generate shaders for many states at once, as it does during "
+          "prepare_scene().  Set this to 1 to generate them all on the "
+          "calling thread.  This has no effect unless Panda was compiled "
+          "with true threads."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
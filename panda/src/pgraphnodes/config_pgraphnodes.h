@@ -40,6 +40,9 @@ extern ConfigVariableBool verify_lods;
 extern ConfigVariableInt parallax_mapping_samples;
 extern ConfigVariableDouble parallax_mapping_scale;
 
+extern ConfigVariableBool shader_generator_disk_cache;
+extern ConfigVariableInt shader_generator_threads;
+
 extern EXPCL_PANDA_PGRAPHNODES void init_libpgraphnodes();
 
 #endif
@@ -37,6 +37,7 @@
 #include "shaderAttrib.h"
 #include "colorAttrib.h"
 #include "clipPlaneAttrib.h"
+#include "sceneGraphReducer.h"
 
 TypeHandle LODNode::_type_handle;
 
@@ -70,6 +71,41 @@ make_copy() const {
   return new LODNode(*this);
 }
 
+/**
+ * Adds a new level of detail that is automatically generated from the
+ * indicated source geometry.  A copy is made of the source subgraph, the
+ * triangles of which are reduced to approximately target_ratio times the
+ * original number with SceneGraphReducer::simplify(), and the copy is added
+ * as a new child to be shown between the indicated switch distances.  The new
+ * child is returned.
+ *
+ * This assumes that the LODNode has as many children as switches, so that
+ * the new child corresponds to the new switch.  A target_ratio of 1 adds an
+ * unsimplified copy, suitable for the highest level of detail.  For instance,
+ * to make three levels from a single model:
+ *
+ * lod.add_simplified_switch(model, 50, 0, 1.0);
+ * lod.add_simplified_switch(model, 200, 50, 0.25);
+ * lod.add_simplified_switch(model, 1000, 200, 0.05);
+ */
+PT(PandaNode) LODNode::
+add_simplified_switch(PandaNode *source, PN_stdfloat in, PN_stdfloat out,
+                      PN_stdfloat target_ratio, PN_stdfloat max_error) {
+  nassertr(source != nullptr, nullptr);
+  nassertr(in >= out, nullptr);
+
+  Thread *current_thread = Thread::get_current_thread();
+  PT(PandaNode) level = source->copy_subgraph(current_thread);
+  if (target_ratio < 1.0f) {
+    SceneGraphReducer gr;
+    gr.simplify(level, target_ratio, max_error);
+  }
+
+  add_child(level);
+  add_switch(in, out);
+  return level;
+}
+
 /**
  * Returns true if it is generally safe to combine this particular kind of
  * PandaNode with other kinds of PandaNodes of compatible type, adding
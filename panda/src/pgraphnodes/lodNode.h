@@ -51,6 +51,9 @@ PUBLISHED:
   // "out".
 
   INLINE void add_switch(PN_stdfloat in, PN_stdfloat out);
+  PT(PandaNode) add_simplified_switch(PandaNode *source, PN_stdfloat in,
+                                      PN_stdfloat out, PN_stdfloat target_ratio,
+                                      PN_stdfloat max_error = 0.0f);
   INLINE bool set_switch(int index, PN_stdfloat in, PN_stdfloat out);
   INLINE void clear_switches();
 
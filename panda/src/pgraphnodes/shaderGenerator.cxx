@@ -46,6 +46,12 @@
 #include "lvector4.h"
 #include "config_pgraphnodes.h"
 #include "pStatTimer.h"
+#include "geomNode.h"
+#include "bamCache.h"
+#include "hashVal.h"
+#include "datagram.h"
+#include "genericThread.h"
+#include "pset.h"
 
 using std::string;
 
@@ -76,6 +82,10 @@ static PStatCollector synthesize_collector("*:Munge:ShaderGen:Synthesize");
  * Create a ShaderGenerator.  This has no state, except possibly to cache
  * certain results.  The parameter that must be passed is the GSG to which the
  * shader generator belongs.
+ *
+ * The GSG may also be NULL, in which case the shaders are generated for an
+ * OpenGL GSG that supports shadow filtering.  This is useful to fill the
+ * model cache ahead of time; see prepare_scene().
  */
 ShaderGenerator::
 ShaderGenerator(const GraphicsStateGuardianBase *gsg) {
@@ -83,14 +93,14 @@ ShaderGenerator(const GraphicsStateGuardianBase *gsg) {
   // both arbvp1 and glslv, which behave more consistently.  However, they
   // don't exist in Direct3D 9.  Use this silly little check for now.
 #ifdef _WIN32
-  _use_generic_attr = !gsg->get_supports_hlsl();
+  _use_generic_attr = (gsg == nullptr) || !gsg->get_supports_hlsl();
 #else
   _use_generic_attr = true;
 #endif
 
   // Do we want to use the ARB_shadow extension?  This also allows us to use
   // hardware shadows PCF.
-  _use_shadow_filter = gsg->get_supports_shadow_filter();
+  _use_shadow_filter = (gsg == nullptr) || gsg->get_supports_shadow_filter();
 }
 
 /**
@@ -641,6 +651,41 @@ clear_generated_shaders() {
   }
 }
 
+/**
+ * Walks through the scene graph beginning at the indicated node, and
+ * generates the shaders for all of the states within it that use the shader
+ * generator.  Returns the number of distinct states that were found.
+ *
+ * It is not necessary to call this, since the shaders are generated as they
+ * are needed, and NodePath::prepare_scene() already does this for the GSG's
+ * own shader generator.  However, when the model cache is enabled, this may
+ * be used by an offline tool to store the shaders for a scene in the cache,
+ * so that they need not be generated when the scene is first rendered.
+ */
+int ShaderGenerator::
+prepare_scene(const NodePath &scene) {
+  nassertr(!scene.is_empty(), 0);
+  Thread *current_thread = Thread::get_current_thread();
+
+  pvector<CPT(RenderState)> states;
+  pset<const RenderState *> visited;
+  r_collect_states(scene.node(), scene.get_net_state(current_thread),
+                   states, visited);
+
+  pvector<GeomVertexAnimationSpec> anims(states.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    const ShaderAttrib *sattr;
+    states[i]->get_attrib_def(sattr);
+    if (sattr->get_flag(ShaderAttrib::F_hardware_skinning)) {
+      anims[i].set_hardware(4, true);
+    }
+  }
+
+  pvector<CPT(ShaderAttrib)> results;
+  synthesize_shaders(states, anims, results);
+  return (int)states.size();
+}
+
 /**
  * This is the routine that implements the next-gen fixed function pipeline by
  * synthesizing a shader.  It also takes care of setting up any buffers needed
@@ -687,8 +732,29 @@ synthesize_shader(const RenderState *rs, const GeomVertexAnimationSpec &anim) {
     }
   }
 
-  PStatTimer timer(synthesize_collector);
+  // Next, see if a previous run left this shader in the model cache.
+  PT(BamCacheRecord) record = lookup_disk_cache(key);
+  PT(Shader) shader = load_disk_cache(record);
 
+  if (shader == nullptr) {
+    PStatTimer timer(synthesize_collector);
+    shader = Shader::make(generate_shader_text(key, rs), Shader::SL_Cg);
+    nassertr(shader != nullptr, nullptr);
+    store_disk_cache(record, shader);
+  }
+
+  CPT(ShaderAttrib) attr = make_shader_attrib(key, shader);
+  _generated_shaders[key] = attr;
+  return attr;
+}
+
+/**
+ * Generates the text of the shader for the given key.  The RenderState is
+ * only used to produce a descriptive comment at the top of the shader; all
+ * other decisions are made based on the key.
+ */
+string ShaderGenerator::
+generate_shader_text(const ShaderKey &key, const RenderState *rs) {
   reset_register_allocator();
 
   if (pgraphnodes_cat.is_debug()) {
@@ -1206,7 +1272,7 @@ synthesize_shader(const RenderState *rs, const GeomVertexAnimationSpec &anim) {
     }
   }
   for (size_t i = 0; i < key._textures.size(); ++i) {
-    ShaderKey::TextureInfo &tex = key._textures[i];
+    const ShaderKey::TextureInfo &tex = key._textures[i];
     if (tex._mode == TextureStage::M_modulate && tex._flags == 0) {
       // Skip this stage.
       continue;
@@ -1711,10 +1777,16 @@ synthesize_shader(const RenderState *rs, const GeomVertexAnimationSpec &anim) {
       << text.str() << "\n";
   }
 
-  // Insert the shader into the shader attrib.
-  PT(Shader) shader = Shader::make(text.str(), Shader::SL_Cg);
-  nassertr(shader != nullptr, nullptr);
+  reset_register_allocator();
+  return text.str();
+}
 
+/**
+ * Wraps the generated shader in a ShaderAttrib, with the flags that are
+ * implied by the key.
+ */
+CPT(ShaderAttrib) ShaderGenerator::
+make_shader_attrib(const ShaderKey &key, Shader *shader) {
   CPT(RenderAttrib) shattr = ShaderAttrib::make(shader);
   int flags = 0;
   if (key._alpha_test_mode != RenderAttrib::M_none) {
@@ -1726,12 +1798,262 @@ synthesize_shader(const RenderState *rs, const GeomVertexAnimationSpec &anim) {
   if (flags != 0) {
     shattr = DCAST(ShaderAttrib, shattr)->set_flag(flags, true);
   }
+  return DCAST(ShaderAttrib, shattr);
+}
 
-  reset_register_allocator();
+/**
+ * Generates the shaders for a whole list of states at once, filling in
+ * results with the ShaderAttrib for each state.  This has the same effect as
+ * calling synthesize_shader() on each state, except that the shaders that
+ * need to be generated are divided among several threads, up to the number
+ * given by shader-generator-threads.
+ */
+void ShaderGenerator::
+synthesize_shaders(const pvector<CPT(RenderState)> &states,
+                   const pvector<GeomVertexAnimationSpec> &anims,
+                   pvector<CPT(ShaderAttrib)> &results) {
+  nassertv(states.size() == anims.size());
+  results.resize(states.size());
+
+  size_t num_threads = (size_t)std::max((int)shader_generator_threads, 1);
+  if (num_threads == 1 || !Thread::is_true_threads() ||
+      get_type() != get_class_type()) {
+    // A derived class may generate its shaders differently, so we can only
+    // go through synthesize_shader() for each state.
+    for (size_t i = 0; i < states.size(); ++i) {
+      results[i] = synthesize_shader(states[i], anims[i]);
+    }
+    return;
+  }
+
+  // Look up each state first, so that only the shaders we don't already have
+  // are handed to the threads, and each one only once.
+  pvector<GenerateJob> jobs;
+  pvector<size_t> job_indices(states.size(), (size_t)-1);
+  pmap<ShaderKey, size_t> keys;
+  {
+    PStatTimer timer(lookup_collector);
+    for (size_t i = 0; i < states.size(); ++i) {
+      ShaderKey key;
+      key._anim_spec = anims[i];
+      analyze_renderstate(key, states[i]);
 
-  CPT(ShaderAttrib) attr = DCAST(ShaderAttrib, shattr);
-  _generated_shaders[key] = attr;
-  return attr;
+      GeneratedShaders::const_iterator si = _generated_shaders.find(key);
+      if (si != _generated_shaders.end()) {
+        results[i] = si->second;
+        continue;
+      }
+
+      pmap<ShaderKey, size_t>::const_iterator ki = keys.find(key);
+      if (ki != keys.end()) {
+        job_indices[i] = ki->second;
+        continue;
+      }
+
+      PT(BamCacheRecord) record = lookup_disk_cache(key);
+      PT(Shader) shader = load_disk_cache(record);
+      if (shader != nullptr) {
+        results[i] = make_shader_attrib(key, shader);
+        _generated_shaders[key] = results[i];
+        continue;
+      }
+
+      job_indices[i] = jobs.size();
+      keys[key] = jobs.size();
+      jobs.push_back(GenerateJob());
+      jobs.back()._key = key;
+      jobs.back()._state = states[i];
+      jobs.back()._record = std::move(record);
+    }
+  }
+
+  if (jobs.empty()) {
+    return;
+  }
+
+  {
+    PStatTimer timer(synthesize_collector);
+
+    // Read these once before starting the threads.
+    parallax_mapping_samples.get_value();
+    parallax_mapping_scale.get_value();
+
+    // The register allocator keeps its state on the generator, so each
+    // thread gets a generator of its own.  This thread takes the first share.
+    num_threads = std::min(num_threads, jobs.size());
+    pvector<PT(ShaderGenerator)> helpers;
+    pvector<GenerateThreadData> data(num_threads);
+    pvector<PT(GenericThread)> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+      data[t]._generator = this;
+      data[t]._jobs = &jobs;
+      data[t]._begin = t;
+      data[t]._step = num_threads;
+
+      if (t != 0) {
+        PT(ShaderGenerator) helper = new ShaderGenerator(nullptr);
+        helper->_use_generic_attr = _use_generic_attr;
+        helper->_use_shadow_filter = _use_shadow_filter;
+        helpers.push_back(helper);
+        data[t]._generator = helper;
+
+        PT(GenericThread) thread =
+          new GenericThread("ShaderGenerator", "ShaderGenerator",
+                            &generate_thread_main, &data[t]);
+        if (thread->start(TP_normal, true)) {
+          threads.push_back(thread);
+        } else {
+          // Couldn't start the thread; do its share ourselves afterwards.
+          data[t]._generator = this;
+          threads.push_back(nullptr);
+        }
+      }
+    }
+
+    generate_thread_main(&data[0]);
+    for (size_t t = 1; t < num_threads; ++t) {
+      if (threads[t - 1] != nullptr) {
+        threads[t - 1]->join();
+      } else {
+        generate_thread_main(&data[t]);
+      }
+    }
+
+    // Shader::make() is not thread-safe, so the shaders are created here.
+    for (GenerateJob &job : jobs) {
+      PT(Shader) shader = Shader::make(std::move(job._text), Shader::SL_Cg);
+      nassertd(shader != nullptr) continue;
+      store_disk_cache(job._record, shader);
+
+      job._attrib = make_shader_attrib(job._key, shader);
+      _generated_shaders[job._key] = job._attrib;
+    }
+  }
+
+  for (size_t i = 0; i < states.size(); ++i) {
+    if (job_indices[i] != (size_t)-1) {
+      results[i] = jobs[job_indices[i]]._attrib;
+    }
+  }
+}
+
+/**
+ * Returns the model cache record in which the shader for the given key is
+ * stored, or NULL if shaders are not to be cached on disk.
+ */
+PT(BamCacheRecord) ShaderGenerator::
+lookup_disk_cache(const ShaderKey &key) const {
+#ifdef HAVE_OPENSSL
+  if (!shader_generator_disk_cache) {
+    return nullptr;
+  }
+  BamCache *cache = BamCache::get_global_ptr();
+  if (!cache->get_active()) {
+    return nullptr;
+  }
+
+  // The generated text also depends on these, so they are part of the hash.
+  Datagram dg;
+  dg.add_uint8(1);  // Bump this when the generated shaders change.
+  dg.add_bool(_use_generic_attr);
+  dg.add_bool(_use_shadow_filter);
+  dg.add_int32(parallax_mapping_samples);
+  dg.add_float64(parallax_mapping_scale);
+  key.write_datagram(dg);
+
+  HashVal hv;
+  hv.hash_buffer((const char *)dg.get_data(), dg.get_length());
+
+  // There is no source file, so we make up a name for the record.
+  Filename source("/$shader-generator/" + hv.as_hex());
+  return cache->lookup(source, "sgs");
+#else
+  return nullptr;
+#endif  // HAVE_OPENSSL
+}
+
+/**
+ * Returns the shader stored in the indicated model cache record, or NULL if
+ * the record is NULL or contains no shader.
+ */
+PT(Shader) ShaderGenerator::
+load_disk_cache(BamCacheRecord *record) {
+  if (record == nullptr || !record->has_data() ||
+      !record->get_data()->is_of_type(Shader::get_class_type())) {
+    return nullptr;
+  }
+
+  if (pgraphnodes_cat.is_debug()) {
+    pgraphnodes_cat.debug()
+      << "Loading generated shader from " << record->get_cache_filename()
+      << "\n";
+  }
+
+  // Pass the text through Shader::make(), as for a freshly generated shader,
+  // so that it is shared with other identical shaders and its parameters are
+  // analyzed the same way.
+  const Shader *cached = DCAST(Shader, record->get_data());
+  return Shader::make(cached->get_text(), Shader::SL_Cg);
+}
+
+/**
+ * Writes the indicated shader to the model cache record returned by
+ * lookup_disk_cache(), if any.
+ */
+void ShaderGenerator::
+store_disk_cache(BamCacheRecord *record, Shader *shader) {
+  if (record != nullptr) {
+    record->set_data(shader);
+    BamCache::get_global_ptr()->store(record);
+  }
+}
+
+/**
+ * The recursive implementation of prepare_scene().  Adds each state found
+ * under the node that uses the shader generator to the list, if it is not
+ * already there.
+ */
+void ShaderGenerator::
+r_collect_states(PandaNode *node, const RenderState *net_state,
+                 pvector<CPT(RenderState)> &states,
+                 pset<const RenderState *> &visited) const {
+  if (node->is_geom_node()) {
+    const GeomNode *gnode = (const GeomNode *)node;
+    int num_geoms = gnode->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(RenderState) state = net_state->compose(gnode->get_geom_state(i));
+      const ShaderAttrib *sattr;
+      state->get_attrib_def(sattr);
+      if (sattr->auto_shader() && visited.insert(state.p()).second) {
+        states.push_back(std::move(state));
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  for (size_t i = 0; i < children.get_num_children(); ++i) {
+    PandaNode *child = children.get_child(i);
+    r_collect_states(child, net_state->compose(child->get_state()), states, visited);
+  }
+
+  PandaNode::Stashed stashed = node->get_stashed();
+  for (size_t i = 0; i < stashed.get_num_stashed(); ++i) {
+    PandaNode *child = stashed.get_stashed(i);
+    r_collect_states(child, net_state->compose(child->get_state()), states, visited);
+  }
+}
+
+/**
+ * The function run by each of the threads started by synthesize_shaders().
+ * Generates the text for every step'th job, starting at begin.
+ */
+void ShaderGenerator::
+generate_thread_main(void *data) {
+  GenerateThreadData *tdata = (GenerateThreadData *)data;
+  pvector<GenerateJob> &jobs = *tdata->_jobs;
+  for (size_t j = tdata->_begin; j < jobs.size(); j += tdata->_step) {
+    jobs[j]._text = tdata->_generator->generate_shader_text(jobs[j]._key, jobs[j]._state);
+  }
 }
 
 /**
@@ -2039,6 +2361,59 @@ operator == (const ShaderKey &other) const {
       && _light_ramp == other._light_ramp;
 }
 
+/**
+ * Writes the contents of the key to the datagram, in a form that does not
+ * depend on the current session, so that it may be hashed to identify the
+ * shader in the model cache.
+ */
+void ShaderGenerator::ShaderKey::
+write_datagram(Datagram &dg) const {
+  dg.add_uint8(_anim_spec.get_animation_type());
+  dg.add_int32(_anim_spec.get_num_transforms());
+  dg.add_bool(_anim_spec.get_indexed_transforms());
+
+  dg.add_int32(_color_type);
+  dg.add_int32(_material_flags);
+  dg.add_int32(_texture_flags);
+
+  dg.add_uint32(_textures.size());
+  for (const TextureInfo &tex : _textures) {
+    dg.add_string(tex._texcoord_name != nullptr ? tex._texcoord_name->get_name() : std::string());
+    dg.add_int32(tex._type);
+    dg.add_int32(tex._mode);
+    dg.add_int32(tex._gen_mode);
+    dg.add_int32(tex._flags);
+    dg.add_uint16(tex._combine_rgb);
+    dg.add_uint16(tex._combine_alpha);
+  }
+
+  // The TypeHandle indices may differ between sessions, but the names don't.
+  dg.add_uint32(_lights.size());
+  for (const LightInfo &light : _lights) {
+    dg.add_string(light._type.get_name());
+    dg.add_int32(light._flags);
+  }
+
+  dg.add_bool(_lighting);
+  dg.add_bool(_have_separate_ambient);
+  dg.add_int32(_fog_mode);
+  dg.add_int32(_outputs);
+  dg.add_bool(_calc_primary_alpha);
+  dg.add_bool(_disable_alpha_write);
+  dg.add_int32(_alpha_test_mode);
+  dg.add_stdfloat(_alpha_test_ref);
+  dg.add_int32(_num_clip_planes);
+
+  dg.add_bool(_light_ramp != nullptr);
+  if (_light_ramp != nullptr) {
+    dg.add_int32(_light_ramp->get_mode());
+    for (int i = 0; i < 2; ++i) {
+      dg.add_stdfloat(_light_ramp->get_threshold(i));
+      dg.add_stdfloat(_light_ramp->get_level(i));
+    }
+  }
+}
+
 #else
 
 // Stubs for when building without Cg support.
@@ -2058,6 +2433,19 @@ void ShaderGenerator::
 clear_generated_shaders() {
 }
 
+int ShaderGenerator::
+prepare_scene(const NodePath &scene) {
+  return 0;
+}
+
+void ShaderGenerator::
+synthesize_shaders(const pvector<CPT(RenderState)> &states,
+                   const pvector<GeomVertexAnimationSpec> &anims,
+                   pvector<CPT(ShaderAttrib)> &results) {
+  results.clear();
+  results.resize(states.size());
+}
+
 CPT(ShaderAttrib) ShaderGenerator::
 synthesize_shader(const RenderState *rs, const GeomVertexAnimationSpec &anim) {
   return nullptr;
@@ -21,12 +21,13 @@
 #include "graphicsStateGuardianBase.h"
 #include "shaderAttrib.h"
 #include "renderState.h"
+#include "nodePath.h"
 
 #ifdef HAVE_CG
 
 #include "graphicsOutputBase.h"
-#include "nodePath.h"
 #include "renderAttrib.h"
+#include "bamCacheRecord.h"
 
 #include "colorAttrib.h"
 #include "lightRampAttrib.h"
@@ -65,7 +66,7 @@ class GeomVertexAnimationSpec;
  */
 class EXPCL_PANDA_PGRAPHNODES ShaderGenerator : public TypedReferenceCount {
 PUBLISHED:
-  ShaderGenerator(const GraphicsStateGuardianBase *gsg);
+  ShaderGenerator(const GraphicsStateGuardianBase *gsg = nullptr);
   virtual ~ShaderGenerator();
   virtual CPT(ShaderAttrib) synthesize_shader(const RenderState *rs,
                                               const GeomVertexAnimationSpec &anim);
@@ -73,6 +74,13 @@ PUBLISHED:
   void rehash_generated_shaders();
   void clear_generated_shaders();
 
+  int prepare_scene(const NodePath &scene);
+
+public:
+  void synthesize_shaders(const pvector<CPT(RenderState)> &states,
+                          const pvector<GeomVertexAnimationSpec> &anims,
+                          pvector<CPT(ShaderAttrib)> &results);
+
 protected:
   // Shader register allocation:
 
@@ -161,12 +169,20 @@ protected:
     int _num_clip_planes;
 
     CPT(LightRampAttrib) _light_ramp;
+
+    void write_datagram(Datagram &dg) const;
   };
 
   typedef phash_map<ShaderKey, CPT(ShaderAttrib)> GeneratedShaders;
   GeneratedShaders _generated_shaders;
 
   void analyze_renderstate(ShaderKey &key, const RenderState *rs);
+  std::string generate_shader_text(const ShaderKey &key, const RenderState *rs);
+  CPT(ShaderAttrib) make_shader_attrib(const ShaderKey &key, Shader *shader);
+
+  PT(BamCacheRecord) lookup_disk_cache(const ShaderKey &key) const;
+  static PT(Shader) load_disk_cache(BamCacheRecord *record);
+  static void store_disk_cache(BamCacheRecord *record, Shader *shader);
 
   static std::string combine_mode_as_string(const ShaderKey::TextureInfo &info,
                       TextureStage::CombineMode c_mode, bool alpha, short texindex);
@@ -174,6 +190,28 @@ protected:
                                          short num, bool alpha, short texindex);
   static const char *texture_type_as_string(Texture::TextureType ttype);
 
+private:
+  void r_collect_states(PandaNode *node, const RenderState *net_state,
+                        pvector<CPT(RenderState)> &states,
+                        pset<const RenderState *> &visited) const;
+
+  class GenerateJob {
+  public:
+    ShaderKey _key;
+    CPT(RenderState) _state;
+    PT(BamCacheRecord) _record;
+    std::string _text;
+    CPT(ShaderAttrib) _attrib;
+  };
+  class GenerateThreadData {
+  public:
+    ShaderGenerator *_generator;
+    pvector<GenerateJob> *_jobs;
+    size_t _begin;
+    size_t _step;
+  };
+  static void generate_thread_main(void *data);
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -197,7 +235,7 @@ private:
 // If we don't have Cg, let's replace this with a stub.
 class EXPCL_PANDA_PGRAPHNODES ShaderGenerator : public TypedReferenceCount {
 PUBLISHED:
-  ShaderGenerator(const GraphicsStateGuardianBase *gsg);
+  ShaderGenerator(const GraphicsStateGuardianBase *gsg = nullptr);
   virtual ~ShaderGenerator();
 
   virtual CPT(ShaderAttrib) synthesize_shader(const RenderState *rs,
@@ -206,7 +244,13 @@ PUBLISHED:
   void rehash_generated_shaders();
   void clear_generated_shaders();
 
+  int prepare_scene(const NodePath &scene);
+
 public:
+  void synthesize_shaders(const pvector<CPT(RenderState)> &states,
+                          const pvector<GeomVertexAnimationSpec> &anims,
+                          pvector<CPT(ShaderAttrib)> &results);
+
   static TypeHandle get_class_type() {
     return _type_handle;
   }
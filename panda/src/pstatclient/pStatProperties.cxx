@@ -220,6 +220,8 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Collision Volumes",                { 1.0, 0.8, 0.5 },  "", 500 },
   { 1, "Collision Tests",                  { 0.5, 0.8, 1.0 },  "", 100 },
   { 1, "Command latency",                  { 0.8, 0.2, 0.0 },  "ms", 10, 1.0 / 1000.0 },
+  { 1, "FFMPEG Decode latency",            { 0.3, 0.6, 0.9 },  "ms", 50, 1.0 / 1000.0 },
+  { 1, "FFMPEG Dropped frames",            { 0.9, 0.3, 0.3 },  "", 100 },
   { 0, nullptr }
 };
 
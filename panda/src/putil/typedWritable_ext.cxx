@@ -133,7 +133,11 @@ __reduce_persist__(PyObject *self, PyObject *pickler) const {
  */
 PyObject *Extension<TypedWritable>::
 find_global_decode(PyObject *this_class, const char *func_name) {
-  // Get the module in which BamWriter is defined.
+  // Get the module in which BamWriter is defined.  The class may not have
+  // been created yet if it has not been used.
+  if (!Dtool_ReadyClass(Dtool_BamWriter)) {
+    return nullptr;
+  }
   PyObject *module_name = PyObject_GetAttrString((PyObject *)&Dtool_BamWriter, "__module__");
   if (module_name != nullptr) {
     // borrowed reference
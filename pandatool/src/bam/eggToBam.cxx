@@ -21,6 +21,10 @@
 #include "config_chan.h"
 #include "pandaNode.h"
 #include "geomNode.h"
+#include "sceneGraphReducer.h"
+#include "sceneGraphAnalyzer.h"
+#include "lodNode.h"
+#include "boundingSphere.h"
 #include "renderState.h"
 #include "textureAttrib.h"
 #include "dcast.h"
@@ -74,6 +78,38 @@ EggToBam() :
      "variable.",
      &EggToBam::dispatch_int, &_has_egg_combine_geoms, &_egg_combine_geoms);
 
+  add_option
+    ("optimize-vertex-cache", "", 0,
+     "Reorders the triangles and vertices of the loaded geometry for better "
+     "use of the post-transform vertex cache of the graphics hardware, and "
+     "reports the average number of vertices transformed per triangle "
+     "(ACMR) before and after.  The assumed size of the cache is taken from "
+     "the vertex-cache-size Config.prc variable.",
+     &EggToBam::dispatch_none, &_optimize_vertex_cache);
+
+  add_option
+    ("lod", "levels", 0,
+     "Generates the indicated number of levels of detail from the loaded "
+     "geometry, by automatic simplification, and places them under an "
+     "LODNode.  The first level is the original geometry; each following "
+     "level has fewer triangles, according to -lod-ratio.",
+     &EggToBam::dispatch_int, nullptr, &_lod_levels);
+
+  add_option
+    ("lod-ratio", "ratio", 0,
+     "Specifies the fraction of the triangles of each level of detail that "
+     "is kept in the next level, when -lod is in effect.  The default is "
+     "0.25.",
+     &EggToBam::dispatch_double, nullptr, &_lod_ratio);
+
+  add_option
+    ("lod-distance", "distance", 0,
+     "Specifies the distance at which the first level of detail switches to "
+     "the second, when -lod is in effect.  Each following switch distance is "
+     "double the previous one.  The default is ten times the radius of the "
+     "model.",
+     &EggToBam::dispatch_double, &_has_lod_distance, &_lod_distance);
+
   add_option
     ("suppress-hidden", "flag", 0,
      "Specifies whether to suppress hidden geometry.  If this is nonzero, "
@@ -210,6 +246,10 @@ EggToBam() :
   _egg_flatten = 0;
   _egg_combine_geoms = 0;
   _egg_suppress_hidden = 1;
+  _optimize_vertex_cache = false;
+  _lod_levels = 0;
+  _lod_ratio = 0.25;
+  _lod_distance = 0.0;
   _tex_txopz = false;
   _ctex_quality = "best";
 }
@@ -262,6 +302,18 @@ run() {
     exit(1);
   }
 
+  if (_lod_levels > 1) {
+    make_lod(root);
+  }
+
+  if (_optimize_vertex_cache) {
+    SceneGraphReducer gr;
+    PN_stdfloat orig_acmr = gr.calc_acmr(root);
+    gr.optimize_vertex_cache(root);
+    nout << "Vertex cache ACMR: " << orig_acmr << " before, "
+         << gr.calc_acmr(root) << " after.\n";
+  }
+
   if (_tex_ctex) {
 #ifndef HAVE_SQUISH
     if (!make_buffer()) {
@@ -333,6 +385,45 @@ run() {
   }
 }
 
+/**
+ * Replaces the children of the indicated root with an LODNode, which
+ * contains _lod_levels automatically simplified versions of them.
+ */
+void EggToBam::
+make_lod(PandaNode *root) {
+  PT(PandaNode) source = new PandaNode(root->get_name());
+  source->steal_children(root);
+
+  PN_stdfloat distance = _lod_distance;
+  if (!_has_lod_distance) {
+    CPT(BoundingVolume) bounds = source->get_bounds();
+    const BoundingSphere *sphere = bounds->as_bounding_sphere();
+    if (sphere != nullptr && !sphere->is_empty() && !sphere->is_infinite()) {
+      distance = sphere->get_radius() * 10.0f;
+    } else {
+      distance = 100.0f;
+    }
+  }
+
+  PT(LODNode) lod = LODNode::make_default_lod(root->get_name());
+  PN_stdfloat out = 0.0f;
+  PN_stdfloat ratio = 1.0f;
+  for (int i = 0; i < _lod_levels; ++i) {
+    PT(PandaNode) level = lod->add_simplified_switch(source, distance, out, ratio);
+
+    SceneGraphAnalyzer sga;
+    sga.add_node(level);
+    nout << "Level " << i << ": " << sga.get_num_tris() << " triangles, visible from "
+         << out << " to " << distance << "\n";
+
+    out = distance;
+    distance *= 2.0f;
+    ratio *= (PN_stdfloat)_lod_ratio;
+  }
+
+  root->add_child(lod);
+}
+
 /**
  * Does something with the additional arguments on the command line (after all
  * the -options have been parsed).  Returns true if the arguments are good,
@@ -45,6 +45,7 @@ private:
   void convert_txo(Texture *tex);
 
   bool make_buffer();
+  void make_lod(PandaNode *root);
 
 private:
   typedef pset<Texture *> Textures;
@@ -55,6 +56,11 @@ private:
   bool _has_egg_combine_geoms;
   int _egg_combine_geoms;
   bool _egg_suppress_hidden;
+  bool _optimize_vertex_cache;
+  int _lod_levels;
+  double _lod_ratio;
+  bool _has_lod_distance;
+  double _lod_distance;
   bool _ls;
   bool _has_compression_quality;
   int _compression_quality;
@@ -195,6 +195,12 @@ EggPalettize() : EggMultiFilter(true) {
      "of keeping every texture as a separate image (which is convenient for "
      "development).",
      &EggPalettize::dispatch_none, &_omitall);
+  add_option
+    ("j", "threads", 0,
+     "Specifies the number of threads to use for reading source images and "
+     "egg files and for generating the palette images.  The default is to "
+     "use one thread for each CPU.",
+     &EggPalettize::dispatch_int, nullptr, &_num_threads);
 
   // This isn't even implemented yet.  Presently, we never lock anyway.
   // Dangerous, but hard to implement reliable file locking across NFSSamba
@@ -215,6 +221,7 @@ EggPalettize() : EggMultiFilter(true) {
      &EggPalettize::dispatch_none, &_describe_input_file);
 
   _txa_filename = "textures.txa";
+  _num_threads = 0;
 }
 
 
@@ -682,6 +689,7 @@ run() {
   }
 
   pal->set_noabs(_noabs);
+  pal->set_num_threads(_num_threads);
 
   if (_report_pi) {
     pal->report_pi();
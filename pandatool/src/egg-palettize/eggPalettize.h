@@ -62,6 +62,7 @@ private:
   bool _omitall;
   bool _redo_all;
   bool _redo_eggs;
+  int _num_threads;
 
   bool _describe_input_file;
   bool _remove_eggs;
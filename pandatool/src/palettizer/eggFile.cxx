@@ -479,26 +479,47 @@ remove_egg() {
 bool EggFile::
 read_egg(bool noabs) {
   nassertr(_data == nullptr, false);
-  nassertr(!_source_filename.empty(), false);
+
+  PT(EggData) data = load_egg(noabs);
+  if (data == nullptr) {
+    return false;
+  }
+
+  set_egg_data(data);
+  return true;
+}
+
+/**
+ * Performs the first part of read_egg(): reads the egg file from its
+ * _source_filename and resolves its filenames, and returns the new EggData,
+ * or NULL if there is an error.  The result should be passed to
+ * set_egg_data().
+ *
+ * This does not modify the EggFile or any other part of the palettizer, so
+ * several egg files may be loaded at once in different threads.
+ */
+PT(EggData) EggFile::
+load_egg(bool noabs) const {
+  nassertr(!_source_filename.empty(), nullptr);
 
   Filename user_source_filename =
     FilenameUnifier::make_user_filename(_source_filename);
 
   if (!_source_filename.exists()) {
     nout << user_source_filename << " does not exist.\n";
-    return false;
+    return nullptr;
   }
 
   PT(EggData) data = new EggData;
   if (!data->read(_source_filename, user_source_filename)) {
     // Failure reading.
-    return false;
+    return nullptr;
   }
 
   if (noabs && data->original_had_absolute_pathnames()) {
     nout << _source_filename.get_basename()
          << " references textures using absolute pathnames!\n";
-    return false;
+    return nullptr;
   }
 
   // Extract the set of textures referenced by this egg file.
@@ -527,9 +548,20 @@ read_egg(bool noabs) {
 
   if (!data->load_externals()) {
     // Failure reading an external.
-    return false;
+    return nullptr;
   }
 
+  return data;
+}
+
+/**
+ * Performs the remainder of read_egg(), accepting the EggData that was
+ * returned by a previous successful call to load_egg().
+ */
+void EggFile::
+set_egg_data(EggData *data) {
+  nassertv(_data == nullptr);
+
   _data = data;
   _had_data = true;
   remove_backstage(_data);
@@ -542,8 +574,6 @@ read_egg(bool noabs) {
     // If we already have textures, assume we're re-reading the file.
     rescan_textures();
   }
-
-  return true;
 }
 
 /**
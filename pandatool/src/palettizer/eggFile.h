@@ -70,6 +70,8 @@ public:
   void update_egg();
   void remove_egg();
   bool read_egg(bool noabs);
+  PT(EggData) load_egg(bool noabs) const;
+  void set_egg_data(EggData *data);
   void release_egg_data();
   bool write_egg();
 
@@ -14,12 +14,14 @@
 #include "filenameUnifier.h"
 
 #include "executionEnvironment.h"
+#include "lightMutexHolder.h"
 
 Filename FilenameUnifier::_txa_filename;
 Filename FilenameUnifier::_txa_dir;
 Filename FilenameUnifier::_rel_dirname;
 
 FilenameUnifier::CanonicalFilenames FilenameUnifier::_canonical_filenames;
+LightMutex FilenameUnifier::_canonical_lock;
 
 /**
  * Notes the filename the .txa file was found in.  This may have come from the
@@ -115,11 +117,14 @@ make_canonical(Filename &filename) {
 
   Filename orig_dirname = filename.get_dirname();
 
-  CanonicalFilenames::iterator fi;
-  fi = _canonical_filenames.find(orig_dirname);
-  if (fi != _canonical_filenames.end()) {
-    filename.set_dirname((*fi).second);
-    return;
+  {
+    LightMutexHolder holder(_canonical_lock);
+    CanonicalFilenames::iterator fi;
+    fi = _canonical_filenames.find(orig_dirname);
+    if (fi != _canonical_filenames.end()) {
+      filename.set_dirname((*fi).second);
+      return;
+    }
   }
 
   Filename new_dirname = orig_dirname;
@@ -129,5 +134,6 @@ make_canonical(Filename &filename) {
   new_dirname.make_canonical();
   filename.set_dirname(new_dirname);
 
+  LightMutexHolder holder(_canonical_lock);
   _canonical_filenames.insert(CanonicalFilenames::value_type(orig_dirname, new_dirname));
 }
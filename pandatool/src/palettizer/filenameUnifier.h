@@ -19,6 +19,7 @@
 #include "filename.h"
 
 #include "pmap.h"
+#include "lightMutex.h"
 
 /**
  * This static class does the job of converting filenames from relative to
@@ -44,8 +45,10 @@ private:
   static Filename _txa_dir;
   static Filename _rel_dirname;
 
+  // The cache may be consulted by several threads at once.
   typedef pmap<std::string, std::string> CanonicalFilenames;
   static CanonicalFilenames _canonical_filenames;
+  static LightMutex _canonical_lock;
 };
 
 #endif
@@ -192,6 +192,11 @@ set_filename(const string &dirname, const string &basename) {
   _filename = Filename(dirname, basename);
   _filename.standardize();
 
+  // The filename we read from the textures.boo file is canonical, so this one
+  // must be as well, or a relative map directory would make it appear to have
+  // changed every session.
+  FilenameUnifier::make_canonical(_filename);
+
   // Since we use set_extension() here, if the file already contains a
   // filename extension it will be lost.
 
@@ -554,6 +554,20 @@ update_images(bool redo_all) {
   }
 }
 
+/**
+ * Checks each PaletteImage on this group, as in update_images(), but instead
+ * of regenerating the ones that need it, adds them to the indicated list.  See
+ * PalettePage::prepare_images().
+ */
+void PaletteGroup::
+prepare_images(bool redo_all, pvector<PaletteImage *> &stale_images) {
+  Pages::iterator pai;
+  for (pai = _pages.begin(); pai != _pages.end(); ++pai) {
+    PalettePage *page = (*pai).second;
+    page->prepare_images(redo_all, stale_images);
+  }
+}
+
 /**
  * Registers the current object as something that can be read from a Bam file.
  */
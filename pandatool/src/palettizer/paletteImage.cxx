@@ -134,6 +134,7 @@ PaletteImage() {
   _index = 0;
   _new_image = false;
   _got_image = false;
+  _image_hash = 0;
 
   _swapped_image = 0;
 }
@@ -152,6 +153,7 @@ PaletteImage(PalettePage *page, int index) :
   _y_size = pal->_pal_y_size;
   _new_image = true;
   _got_image = false;
+  _image_hash = 0;
   _swapped_image = 0;
 
   setup_filename();
@@ -172,6 +174,7 @@ PaletteImage(PalettePage *page, int index, unsigned swapIndex) :
   _y_size = pal->_pal_y_size;
   _new_image = true;
   _got_image = false;
+  _image_hash = 0;
 
   setup_filename();
 }
@@ -526,11 +529,25 @@ setup_shadow_image() {
  */
 void PaletteImage::
 update_image(bool redo_all) {
+  if (prepare_update(redo_all)) {
+    generate_image();
+  }
+}
+
+/**
+ * Performs the first half of update_image(): determines whether the palette
+ * has changed since it was last written out, and updates its filename.
+ * Returns true if the image must now be regenerated with generate_image().
+ *
+ * This must be called from the main thread; generate_image() need not be.
+ */
+bool PaletteImage::
+prepare_update(bool redo_all) {
   if (is_empty() && pal->_aggressively_clean_mapdir) {
     // If the palette image is 'empty', ensure that it doesn't exist.  No need
     // to clutter up the map directory.
     remove_image();
-    return;
+    return false;
   }
 
   if (redo_all) {
@@ -596,9 +613,31 @@ update_image(bool redo_all) {
 
   if (!needs_update) {
     // No sweat; nothing has changed.
-    return;
+    return false;
+  }
+
+  // [gjeon] make sure the swapped images are named properly, too
+  SwappedImages::iterator si;
+  for (si = _swappedImages.begin(); si != _swappedImages.end(); ++si) {
+    PaletteImage *swappedImage = (*si);
+    swappedImage->update_filename();
   }
 
+  return true;
+}
+
+/**
+ * Performs the second half of update_image(), after prepare_update() has
+ * returned true: regenerates the image, and writes it out if its contents
+ * have changed since the last time it was written.
+ *
+ * This touches only this image and its swapped images, so several different
+ * PaletteImages may be generated at the same time in different threads.
+ */
+void PaletteImage::
+generate_image() {
+  Placements::iterator pi;
+
   get_image();
   // [gjeon] get swapped images, too
   get_swapped_images();
@@ -628,16 +667,24 @@ update_image(bool redo_all) {
       SwappedImages::iterator si;
       for (si = _swappedImages.begin(); si != _swappedImages.end(); ++si) {
         PaletteImage *swappedImage = (*si);
-        swappedImage->update_filename();
         placement->fill_swapped_image(swappedImage->_image, si - _swappedImages.begin());
       }
     }
   }
 
-  write(_image);
+  // If the regenerated image is identical to the one we wrote last time, we
+  // leave the file alone, so that it doesn't appear to have changed.
+  uint64_t image_hash = hash_image(_image);
+  if (image_hash == _image_hash && exists()) {
+    nout << "Unchanged "
+         << FilenameUnifier::make_user_filename(get_filename()) << "\n";
+  } else {
+    write(_image);
 
-  if (pal->_shadow_color_type != nullptr) {
-    _shadow_image.write(_image);
+    if (pal->_shadow_color_type != nullptr) {
+      _shadow_image.write(_image);
+    }
+    _image_hash = image_hash;
   }
 
   release_image();
@@ -780,58 +827,162 @@ setup_filename() {
  * Searches for a hole of at least x_size by y_size pixels somewhere within
  * the PaletteImage.  If a suitable hole is found, sets x and y to the top
  * left corner and returns true; otherwise, returns false.
+ *
+ * This uses the MaxRects algorithm: the free space on the image is described
+ * as the set of all maximal empty rectangles, and the texture goes into the
+ * one that it fits most snugly (by the shorter of the two leftover sides).
  */
 bool PaletteImage::
 find_hole(int &x, int &y, int x_size, int y_size) const {
-  y = 0;
-  while (y + y_size <= _y_size) {
-    int next_y = _y_size;
-    // Scan along the row at 'y'.
-    x = 0;
-    while (x + x_size <= _x_size) {
-      int next_x = x;
-
-      // Consider the spot at x, y.
-      TexturePlacement *overlap = find_overlap(x, y, x_size, y_size);
-
-      if (overlap == nullptr) {
-        // Hooray!
-        return true;
-      }
+  FreeRects free_rects;
+  free_rects.push_back(FreeRect(0, 0, _x_size, _y_size));
+
+  Placements::const_iterator pi;
+  for (pi = _placements.begin(); pi != _placements.end(); ++pi) {
+    TexturePlacement *placement = (*pi);
+    if (placement->is_placed()) {
+      split_free_rects(free_rects,
+                       FreeRect(placement->get_placed_x(),
+                                placement->get_placed_y(),
+                                placement->get_placed_x_size(),
+                                placement->get_placed_y_size()));
+    }
+  }
 
-      next_x = overlap->get_placed_x() + overlap->get_placed_x_size();
-      next_y = std::min(next_y, overlap->get_placed_y() + overlap->get_placed_y_size());
-      nassertr(next_x > x, false);
-      x = next_x;
+  bool found = false;
+  int best_short = 0;
+  int best_long = 0;
+  FreeRects::const_iterator fi;
+  for (fi = free_rects.begin(); fi != free_rects.end(); ++fi) {
+    const FreeRect &rect = (*fi);
+    if (rect._x_size < x_size || rect._y_size < y_size) {
+      continue;
     }
 
-    nassertr(next_y > y, false);
-    y = next_y;
+    int leftover_x = rect._x_size - x_size;
+    int leftover_y = rect._y_size - y_size;
+    int short_side = std::min(leftover_x, leftover_y);
+    int long_side = std::max(leftover_x, leftover_y);
+
+    // Ties are broken in favor of the topmost, then leftmost, position, so
+    // that the packing does not depend on the order of the free list.
+    if (!found || short_side < best_short ||
+        (short_side == best_short &&
+         (long_side < best_long ||
+          (long_side == best_long &&
+           (rect._y < y || (rect._y == y && rect._x < x)))))) {
+      found = true;
+      best_short = short_side;
+      best_long = long_side;
+      x = rect._x;
+      y = rect._y;
+    }
   }
 
-  // Nope, wouldn't fit anywhere.
-  return false;
+  return found;
 }
 
 /**
- * If the rectangle whose top left corner is x, y and whose size is x_size,
- * y_size describes an empty hole that does not overlap any placed images,
- * returns NULL; otherwise, returns the first placed texture that the image
- * does overlap.  It is assumed the rectangle lies completely within the
- * boundaries of the image itself.
+ * Removes the indicated used rectangle from the list of maximal free
+ * rectangles, replacing each free rectangle that it overlaps with the up to
+ * four maximal rectangles that remain around it.
  */
-TexturePlacement *PaletteImage::
-find_overlap(int x, int y, int x_size, int y_size) const {
-  Placements::const_iterator pi;
-  for (pi = _placements.begin(); pi != _placements.end(); ++pi) {
-    TexturePlacement *placement = (*pi);
-    if (placement->is_placed() &&
-        placement->intersects(x, y, x_size, y_size)) {
-      return placement;
+void PaletteImage::
+split_free_rects(FreeRects &free_rects, const FreeRect &used) {
+  FreeRects result;
+  result.reserve(free_rects.size() + 4);
+
+  int used_right = used._x + used._x_size;
+  int used_bottom = used._y + used._y_size;
+
+  FreeRects::const_iterator fi;
+  for (fi = free_rects.begin(); fi != free_rects.end(); ++fi) {
+    const FreeRect &rect = (*fi);
+    int right = rect._x + rect._x_size;
+    int bottom = rect._y + rect._y_size;
+
+    if (used._x >= right || used_right <= rect._x ||
+        used._y >= bottom || used_bottom <= rect._y) {
+      // No overlap; keep it as it is.
+      result.push_back(rect);
+      continue;
+    }
+
+    if (used._x > rect._x) {
+      result.push_back(FreeRect(rect._x, rect._y,
+                                used._x - rect._x, rect._y_size));
+    }
+    if (used_right < right) {
+      result.push_back(FreeRect(used_right, rect._y,
+                                right - used_right, rect._y_size));
+    }
+    if (used._y > rect._y) {
+      result.push_back(FreeRect(rect._x, rect._y,
+                                rect._x_size, used._y - rect._y));
+    }
+    if (used_bottom < bottom) {
+      result.push_back(FreeRect(rect._x, used_bottom,
+                                rect._x_size, bottom - used_bottom));
+    }
+  }
+
+  // Now remove any rectangle that is entirely contained within another one,
+  // since it is no longer maximal.
+  free_rects.clear();
+  size_t num_rects = result.size();
+  for (size_t i = 0; i < num_rects; ++i) {
+    const FreeRect &a = result[i];
+    bool contained = false;
+    for (size_t j = 0; j < num_rects && !contained; ++j) {
+      if (i == j) {
+        continue;
+      }
+      const FreeRect &b = result[j];
+      if (a._x >= b._x && a._y >= b._y &&
+          a._x + a._x_size <= b._x + b._x_size &&
+          a._y + a._y_size <= b._y + b._y_size) {
+        // If two rectangles are identical, only the later one is dropped.
+        contained = (a._x != b._x || a._y != b._y ||
+                     a._x_size != b._x_size || a._y_size != b._y_size || i > j);
+      }
+    }
+    if (!contained) {
+      free_rects.push_back(a);
+    }
+  }
+}
+
+/**
+ * Returns a hash of the size and pixel contents of the indicated image, used
+ * to determine whether a regenerated palette has actually changed.
+ */
+uint64_t PaletteImage::
+hash_image(const PNMImage &image) {
+  // This is the 64-bit FNV-1a hash.
+  uint64_t hash = 14695981039346656037ULL;
+  const uint64_t prime = 1099511628211ULL;
+
+  int x_size = image.get_x_size();
+  int y_size = image.get_y_size();
+  int header[4] = { x_size, y_size, image.get_num_channels(), (int)image.get_maxval() };
+  for (int i = 0; i < 4; ++i) {
+    hash = (hash ^ (uint64_t)(unsigned int)header[i]) * prime;
+  }
+
+  bool has_alpha = image.has_alpha();
+  for (int y = 0; y < y_size; ++y) {
+    for (int x = 0; x < x_size; ++x) {
+      const xel &pixel = image.get_xel_val(x, y);
+      hash = (hash ^ (uint64_t)PPM_GETR(pixel)) * prime;
+      hash = (hash ^ (uint64_t)PPM_GETG(pixel)) * prime;
+      hash = (hash ^ (uint64_t)PPM_GETB(pixel)) * prime;
+      if (has_alpha) {
+        hash = (hash ^ (uint64_t)image.get_alpha_val(x, y)) * prime;
+      }
     }
   }
 
-  return nullptr;
+  return hash;
 }
 
 /**
@@ -998,6 +1149,7 @@ write_datagram(BamWriter *writer, Datagram &datagram) {
   datagram.add_uint32(_index);
   datagram.add_string(_basename);
   datagram.add_bool(_new_image);
+  datagram.add_uint64(_image_hash);
 
   // We don't write _got_image or _image.  These are loaded per-session.
 
@@ -1072,4 +1224,8 @@ fillin(DatagramIterator &scan, BamReader *manager) {
   _index = scan.get_uint32();
   _basename = scan.get_string();
   _new_image = scan.get_bool();
+
+  if (Palettizer::_read_pi_version >= 21) {
+    _image_hash = scan.get_uint64();
+  }
 }
@@ -55,13 +55,26 @@ public:
   void reset_image();
   void setup_shadow_image();
   void update_image(bool redo_all);
+  bool prepare_update(bool redo_all);
+  void generate_image();
 
   bool update_filename();
 
 private:
   bool setup_filename();
+  // A rectangle of empty pixels, used while searching for a hole.
+  class FreeRect {
+  public:
+    FreeRect(int x, int y, int x_size, int y_size) :
+      _x(x), _y(y), _x_size(x_size), _y_size(y_size) {}
+    int _x, _y;
+    int _x_size, _y_size;
+  };
+  typedef pvector<FreeRect> FreeRects;
+
   bool find_hole(int &x, int &y, int x_size, int y_size) const;
-  TexturePlacement *find_overlap(int x, int y, int x_size, int y_size) const;
+  static void split_free_rects(FreeRects &free_rects, const FreeRect &used);
+  static uint64_t hash_image(const PNMImage &image);
   void get_image();
   void release_image();
   void remove_image();
@@ -102,6 +115,9 @@ private:
   bool _got_image;
   PNMImage _image;
 
+  // The hash of the image contents as it was last written to disk.
+  uint64_t _image_hash;
+
   unsigned _swapped_image; // 0 for non swapped image
 
   ImageFile _shadow_image;
@@ -208,6 +208,22 @@ update_images(bool redo_all) {
   }
 }
 
+/**
+ * Checks each PaletteImage on this page, as in update_images(), but instead
+ * of regenerating the ones that need it, adds them to the indicated list, to
+ * be regenerated later with PaletteImage::generate_image().
+ */
+void PalettePage::
+prepare_images(bool redo_all, pvector<PaletteImage *> &stale_images) {
+  Images::iterator ii;
+  for (ii = _images.begin(); ii != _images.end(); ++ii) {
+    PaletteImage *image = (*ii);
+    if (image->prepare_update(redo_all)) {
+      stale_images.push_back(image);
+    }
+  }
+}
+
 /**
  * Registers the current object as something that can be read from a Bam file.
  */
@@ -16,6 +16,7 @@
 #include "textureImage.h"
 #include "pal_string_utils.h"
 #include "paletteGroup.h"
+#include "paletteImage.h"
 #include "filenameUnifier.h"
 #include "textureMemoryCounter.h"
 
@@ -28,6 +29,10 @@
 #include "bamReader.h"
 #include "bamWriter.h"
 #include "indent.h"
+#include "genericThread.h"
+#include "lightMutexHolder.h"
+
+#include <thread>
 
 using std::cout;
 using std::string;
@@ -39,7 +44,7 @@ Palettizer *pal = nullptr;
 // update egg-palettize to write out additional information to its pi file,
 // without having it increment the bam version number for all bam and boo
 // files anywhere in the world.
-int Palettizer::_pi_version = 20;
+int Palettizer::_pi_version = 21;
 /*
  * Updated to version 8 on 32003 to remove extensions from texture key names.
  * Updated to version 9 on 41303 to add a few properties in various places.
@@ -53,7 +58,8 @@ int Palettizer::_pi_version = 20;
  * TextureImage::_txa_wrap_u etc.  Updated to version 18 on 51308 to add
  * TextureProperties::_quality_level.  Updated to version 19 on 71609 to add
  * PaletteGroup::_override_margin Updated to version 20 on 72709 to add
- * TexturePlacement::_swapTextures
+ * TexturePlacement::_swapTextures.  Updated to version 21 to add
+ * PaletteImage::_image_hash.
  */
 
 int Palettizer::_min_pi_version = 8;
@@ -101,6 +107,32 @@ public:
   }
 };
 
+// These are the jobs handed to run_parallel().
+static void
+read_source_image_job(void *user_data, size_t n) {
+  const pvector<TextureImage *> &textures = *(const pvector<TextureImage *> *)user_data;
+  textures[n]->read_source_image();
+}
+
+class LoadEggsJob {
+public:
+  const pvector<EggFile *> *_egg_files;
+  pvector<PT(EggData)> *_data;
+  bool _noabs;
+};
+
+static void
+load_egg_job(void *user_data, size_t n) {
+  LoadEggsJob *job = (LoadEggsJob *)user_data;
+  (*job->_data)[n] = (*job->_egg_files)[n]->load_egg(job->_noabs);
+}
+
+static void
+generate_image_job(void *user_data, size_t n) {
+  const pvector<PaletteImage *> &images = *(const pvector<PaletteImage *> *)user_data;
+  images[n]->generate_image();
+}
+
 /**
  *
  */
@@ -108,6 +140,7 @@ Palettizer::
 Palettizer() {
   _is_valid = true;
   _noabs = false;
+  _num_threads = 0;
 
   _generated_image_pattern = "%g_palette_%p_%i";
   _map_dirname = "%g";
@@ -159,6 +192,28 @@ set_noabs(bool noabs) {
   _noabs = noabs;
 }
 
+/**
+ * Returns the number of threads that will be used to read source images and
+ * egg files, and to generate palette images.  See set_num_threads().
+ */
+int Palettizer::
+get_num_threads() const {
+  if (_num_threads <= 0) {
+    return std::max((int)std::thread::hardware_concurrency(), 1);
+  }
+  return _num_threads;
+}
+
+/**
+ * Specifies the number of threads that will be used to read source images
+ * and egg files, and to generate palette images.  If this is 0, the default,
+ * one thread is used for each CPU.
+ */
+void Palettizer::
+set_num_threads(int num_threads) {
+  _num_threads = num_threads;
+}
+
 /**
  * Returns true if the palette information file was read correctly, or false
  * if there was some error and the palettization can't continue.
@@ -447,20 +502,27 @@ process_command_line_eggs(bool force_texture_read, const Filename &state_filenam
 
   // Now match each of the textures mentioned in those egg files against a
   // line in the .txa file.
+  // If we're forcing a redo, or the texture image has changed, re-read the
+  // complete image; otherwise, just the header is sufficient.  The images
+  // are read in parallel.
+  pvector<TextureImage *> changed_textures;
   CommandLineTextures::iterator ti;
   for (ti = _command_line_textures.begin();
        ti != _command_line_textures.end();
        ++ti) {
     TextureImage *texture = *ti;
-
     if (force_texture_read || texture->is_newer_than(state_filename)) {
-      // If we're forcing a redo, or the texture image has changed, re-read
-      // the complete image.
-      texture->read_source_image();
+      changed_textures.push_back(texture);
     } else {
-      // Otherwise, just the header is sufficient.
       texture->read_header();
     }
+  }
+  read_source_images(changed_textures);
+
+  for (ti = _command_line_textures.begin();
+       ti != _command_line_textures.end();
+       ++ti) {
+    TextureImage *texture = *ti;
 
     texture->mark_texture_named();
     texture->pre_txa_file();
@@ -552,20 +614,37 @@ process_all(bool force_texture_read, const Filename &state_filename) {
   }
 
   // Now match each of the textures in the world against a line in the .txa
-  // file.
+  // file.  We read the source images of the changed textures a few at a
+  // time, in parallel, and release them again as soon as they have been
+  // examined, to avoid bloating memory.
+  pvector<TextureImage *> textures;
+  textures.reserve(_textures.size());
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    TextureImage *texture = (*ti).second;
-    if (force_texture_read || texture->is_newer_than(state_filename)) {
-      texture->read_source_image();
+    textures.push_back((*ti).second);
+  }
+
+  size_t batch_size = (size_t)get_num_threads() * 2;
+  for (size_t bi = 0; bi < textures.size(); bi += batch_size) {
+    size_t bend = std::min(bi + batch_size, textures.size());
+
+    pvector<TextureImage *> changed_textures;
+    for (size_t i = bi; i < bend; ++i) {
+      TextureImage *texture = textures[i];
+      if (force_texture_read || texture->is_newer_than(state_filename)) {
+        changed_textures.push_back(texture);
+      }
     }
+    read_source_images(changed_textures);
 
-    texture->mark_texture_named();
-    texture->pre_txa_file();
-    _txa_file.match_texture(texture);
-    texture->post_txa_file();
+    for (size_t i = bi; i < bend; ++i) {
+      TextureImage *texture = textures[i];
+      texture->mark_texture_named();
+      texture->pre_txa_file();
+      _txa_file.match_texture(texture);
+      texture->post_txa_file();
 
-    // We need to do this to avoid bloating memory.
-    texture->release_source_image();
+      texture->release_source_image();
+    }
   }
 
   // And now, assign each texture to an appropriate group or groups.
@@ -631,12 +710,18 @@ reset_images() {
  */
 void Palettizer::
 generate_images(bool redo_all) {
+  // First, determine which images need to be regenerated.  This may rename
+  // files and mark egg files stale, so it is done in this thread.
+  pvector<PaletteImage *> stale_images;
   Groups::iterator gi;
   for (gi = _groups.begin(); gi != _groups.end(); ++gi) {
     PaletteGroup *group = (*gi).second;
-    group->update_images(redo_all);
+    group->prepare_images(redo_all, stale_images);
   }
 
+  // Then regenerate them all in parallel.
+  run_parallel(stale_images.size(), &generate_image_job, &stale_images);
+
   Textures::iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
     TextureImage *texture = (*ti).second;
@@ -658,15 +743,35 @@ read_stale_eggs(bool redo_all) {
 
   pvector<EggFiles::iterator> invalid_eggs;
 
+  pvector<EggFiles::iterator> stale_eggs;
   EggFiles::iterator ei;
   for (ei = _egg_files.begin(); ei != _egg_files.end(); ++ei) {
     EggFile *egg_file = (*ei).second;
     if (!egg_file->had_data() &&
         (egg_file->is_stale() || redo_all)) {
-      if (!egg_file->read_egg(_noabs)) {
-        invalid_eggs.push_back(ei);
+      stale_eggs.push_back(ei);
+    }
+  }
+
+  // The egg files are loaded a few at a time, in parallel.
+  size_t batch_size = (size_t)get_num_threads() * 2;
+  for (size_t bi = 0; bi < stale_eggs.size(); bi += batch_size) {
+    size_t bend = std::min(bi + batch_size, stale_eggs.size());
+
+    pvector<EggFile *> egg_files;
+    for (size_t i = bi; i < bend; ++i) {
+      egg_files.push_back((*stale_eggs[i]).second);
+    }
+    pvector<PT(EggData)> data;
+    load_eggs(egg_files, data);
+
+    for (size_t i = 0; i < egg_files.size(); ++i) {
+      EggFile *egg_file = egg_files[i];
+      if (data[i] == nullptr) {
+        invalid_eggs.push_back(stale_eggs[bi + i]);
 
       } else {
+        egg_file->set_egg_data(data[i]);
         egg_file->scan_textures();
         egg_file->choose_placements();
         egg_file->release_egg_data();
@@ -714,19 +819,41 @@ bool Palettizer::
 write_eggs() {
   bool okflag = true;
 
+  pvector<EggFile *> egg_files;
   EggFiles::iterator ei;
   for (ei = _egg_files.begin(); ei != _egg_files.end(); ++ei) {
     EggFile *egg_file = (*ei).second;
     if (egg_file->had_data()) {
-      if (!egg_file->has_data()) {
-        // Re-read the egg file.
-        bool read_ok = egg_file->read_egg(_noabs);
-        if (!read_ok) {
-          nout << "Error!  Unable to re-read egg file.\n";
-          okflag = false;
-        }
+      egg_files.push_back(egg_file);
+    }
+  }
+
+  // Any egg files that need to be re-read are loaded a few at a time, in
+  // parallel.
+  size_t batch_size = (size_t)get_num_threads() * 2;
+  for (size_t bi = 0; bi < egg_files.size(); bi += batch_size) {
+    size_t bend = std::min(bi + batch_size, egg_files.size());
+
+    pvector<EggFile *> reread_eggs;
+    for (size_t i = bi; i < bend; ++i) {
+      if (!egg_files[i]->has_data()) {
+        reread_eggs.push_back(egg_files[i]);
+      }
+    }
+    pvector<PT(EggData)> data;
+    load_eggs(reread_eggs, data);
+
+    for (size_t i = 0; i < reread_eggs.size(); ++i) {
+      if (data[i] == nullptr) {
+        nout << "Error!  Unable to re-read egg file.\n";
+        okflag = false;
+      } else {
+        reread_eggs[i]->set_egg_data(data[i]);
       }
+    }
 
+    for (size_t i = bi; i < bend; ++i) {
+      EggFile *egg_file = egg_files[i];
       if (egg_file->has_data()) {
         egg_file->update_egg();
         if (!egg_file->write_egg()) {
@@ -740,6 +867,86 @@ write_eggs() {
   return okflag;
 }
 
+/**
+ * Calls func(user_data, n) for each n in the range [0, num_jobs), dividing
+ * the jobs among get_num_threads() threads, and returns when all of them have
+ * completed.  The calling thread takes part in the work.
+ */
+void Palettizer::
+run_parallel(size_t num_jobs, ParallelFunc *func, void *user_data) const {
+  ParallelJobs jobs;
+  jobs._func = func;
+  jobs._user_data = user_data;
+  jobs._num_jobs = num_jobs;
+  jobs._next_job = 0;
+
+  pvector<PT(Thread)> threads;
+  size_t num_threads = std::min((size_t)get_num_threads(), num_jobs);
+  if (num_threads > 1 && Thread::is_threading_supported()) {
+    for (size_t i = 1; i < num_threads; ++i) {
+      PT(GenericThread) thread =
+        new GenericThread("palettize", "palettize", &parallel_thread_main, &jobs);
+      if (thread->start(TP_normal, true)) {
+        threads.push_back(thread);
+      }
+    }
+  }
+
+  parallel_thread_main(&jobs);
+
+  pvector<PT(Thread)>::iterator thi;
+  for (thi = threads.begin(); thi != threads.end(); ++thi) {
+    (*thi)->join();
+  }
+}
+
+/**
+ * The main function of each of the threads started by run_parallel().
+ */
+void Palettizer::
+parallel_thread_main(void *data) {
+  ParallelJobs *jobs = (ParallelJobs *)data;
+  while (true) {
+    size_t n;
+    {
+      LightMutexHolder holder(jobs->_lock);
+      if (jobs->_next_job >= jobs->_num_jobs) {
+        return;
+      }
+      n = jobs->_next_job++;
+    }
+    (*jobs->_func)(jobs->_user_data, n);
+  }
+}
+
+/**
+ * Reads the complete source image of each of the indicated textures, in
+ * parallel.
+ */
+void Palettizer::
+read_source_images(const pvector<TextureImage *> &textures) const {
+  run_parallel(textures.size(), &read_source_image_job,
+               (void *)&textures);
+}
+
+/**
+ * Loads each of the indicated egg files from disk, in parallel, and fills
+ * the data vector with the results, in the same order.  An egg file that
+ * could not be loaded gets a NULL entry.  See EggFile::load_egg().
+ */
+void Palettizer::
+load_eggs(const pvector<EggFile *> &egg_files,
+          pvector<PT(EggData)> &data) const {
+  LoadEggsJob job;
+  job._egg_files = &egg_files;
+  job._data = &data;
+  job._noabs = _noabs;
+
+  data.clear();
+  data.resize(egg_files.size());
+  run_parallel(egg_files.size(), &load_egg_job, &job);
+}
+
 /**
  * Returns the EggFile with the given name.  If there is no EggFile with the
  * indicated name, creates one.  This is the key name used to sort the egg
@@ -23,8 +23,11 @@
 #include "pvector.h"
 #include "pset.h"
 #include "pmap.h"
+#include "lightMutex.h"
+#include "pointerTo.h"
 
 class PNMFileType;
+class EggData;
 class EggFile;
 class PaletteGroup;
 class TextureImage;
@@ -43,6 +46,9 @@ public:
   bool get_noabs() const;
   void set_noabs(bool noabs);
 
+  int get_num_threads() const;
+  void set_num_threads(int num_threads);
+
   bool is_valid() const;
   void report_pi() const;
   void report_statistics() const;
@@ -67,9 +73,27 @@ public:
   PaletteGroup *get_default_group();
   TextureImage *get_texture(const std::string &name);
 
+  typedef void ParallelFunc(void *user_data, size_t n);
+  void run_parallel(size_t num_jobs, ParallelFunc *func, void *user_data) const;
+
 private:
   static const char *yesno(bool flag);
 
+  void read_source_images(const pvector<TextureImage *> &textures) const;
+  void load_eggs(const pvector<EggFile *> &egg_files,
+                 pvector<PT(EggData)> &data) const;
+
+  // The state shared by the threads of a run_parallel() call.
+  class ParallelJobs {
+  public:
+    ParallelFunc *_func;
+    void *_user_data;
+    size_t _num_jobs;
+    size_t _next_job;
+    LightMutex _lock;
+  };
+  static void parallel_thread_main(void *data);
+
 public:
   static int _pi_version;
   static int _min_pi_version;
@@ -92,6 +116,7 @@ public:
   std::string _default_groupname;
   std::string _default_groupdir;
   bool _noabs;
+  int _num_threads;
 
   // The following parameter values specifically relate to textures and
   // palettes.  These values are stored in the textures.boo file for future
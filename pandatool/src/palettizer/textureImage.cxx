@@ -28,6 +28,7 @@
 #include "pnmFileType.h"
 #include "indirectCompareNames.h"
 #include "pvector.h"
+#include "lightMutexHolder.h"
 
 #include <iterator>
 
@@ -746,6 +747,36 @@ set_source_image(const PNMImage &image) {
   _ever_read_image = true;
 }
 
+/**
+ * Fills the indicated PNMImage with the source image.  If the source image has
+ * already been read (or was given with set_source_image()), this copies it;
+ * otherwise, it is read from disk directly into the indicated image, and is
+ * not retained.
+ *
+ * Unlike read_source_image(), this may be called by several threads at once,
+ * so that the palette images may be generated in parallel.  Returns true on
+ * success, false on failure.
+ */
+bool TextureImage::
+get_source_image(PNMImage &image) {
+  SourceTextureImage *source;
+  {
+    LightMutexHolder holder(_lock);
+    if (_read_source_image) {
+      image = _source_image;
+      return image.is_valid();
+    }
+    source = get_preferred_source();
+    _ever_read_image = true;
+  }
+
+  if (source == nullptr) {
+    image.clear();
+    return false;
+  }
+  return source->read(image);
+}
+
 /**
  * Causes the header part of the image to be reread, usually to confirm that
  * its image properties (size, number of channels, etc.) haven't changed.
@@ -24,6 +24,7 @@
 #include "filename.h"
 #include "pnmImage.h"
 #include "eggRenderMode.h"
+#include "lightMutex.h"
 
 #include "pmap.h"
 #include "pset.h"
@@ -85,6 +86,7 @@ public:
   const PNMImage &read_source_image();
   void release_source_image();
   void set_source_image(const PNMImage &image);
+  bool get_source_image(PNMImage &image);
   void read_header();
   bool is_newer_than(const Filename &reference_filename);
 
@@ -149,6 +151,7 @@ private:
   bool _read_source_image;
   bool _allow_release_source_image;
   PNMImage _source_image;
+  LightMutex _lock;
   bool _texture_named;
   bool _got_txa_file;
 
@@ -722,8 +722,8 @@ fill_image(PNMImage &image) {
   nassertv(x_size >= 0 && y_size >= 0);
 
   // Now we get a PNMImage that represents the source texture at that size.
-  const PNMImage &source_full = _texture->read_source_image();
-  if (!source_full.is_valid()) {
+  PNMImage source_full;
+  if (!_texture->get_source_image(source_full)) {
     flag_error_image(image);
     return;
   }
@@ -810,8 +810,6 @@ fill_image(PNMImage &image) {
       }
     }
   }
-
-  _texture->release_source_image();
 }
 
 
@@ -854,8 +852,8 @@ fill_swapped_image(PNMImage &image, int index) {
   TextureSwaps::iterator tsi;
   tsi = _textureSwaps.begin() + index;
   TextureImage *swapTexture = (*tsi);
-  const PNMImage &source_full = swapTexture->read_source_image();
-  if (!source_full.is_valid()) {
+  PNMImage source_full;
+  if (!swapTexture->get_source_image(source_full)) {
     flag_error_image(image);
     return;
   }
@@ -906,8 +904,6 @@ fill_swapped_image(PNMImage &image, int index) {
       }
     }
   }
-
-  swapTexture->release_source_image();
 }
 
 /**
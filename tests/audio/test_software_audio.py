@@ -0,0 +1,105 @@
+import math
+import struct
+import subprocess
+import sys
+import wave
+
+import pytest
+
+
+# The choice of audio library is made once per process, so the software mixer
+# is exercised in a separate interpreter.
+SCRIPT = r'''
+import sys
+from panda3d.core import *
+
+load_prc_file_data("", """
+audio-library-name p3software_audio
+software-audio-output {output}
+software-audio-threaded false
+software-audio-rate 44100
+software-audio-channels 2
+""")
+
+clock = ClockObject.get_global_clock()
+clock.mode = ClockObject.M_slave
+clock.frame_time = 0.0
+
+mgr = AudioManager.create_AudioManager()
+if mgr.get_type().name != "SoftwareAudioManager":
+    sys.exit(77)
+
+sound = mgr.get_sound(Filename.from_os_specific({input!r}))
+assert sound.get_type().name == "SoftwareAudioSound"
+assert abs(sound.length() - 0.5) < 0.001
+
+sound.balance = -1.0
+sound.set_finished_event("sound-done")
+sound.play()
+assert sound.status() == AudioSound.PLAYING
+
+# Advancing the clock by a quarter second mixes a quarter second of audio.
+clock.frame_time = 0.25
+mgr.update()
+assert sound.status() == AudioSound.PLAYING
+assert abs(sound.get_time() - 0.25) < 0.001
+
+clock.frame_time = 1.0
+mgr.update()
+assert sound.status() == AudioSound.READY
+
+queue = EventQueue.get_global_event_queue()
+names = []
+while not queue.is_queue_empty():
+    names.append(queue.dequeue_event().get_name())
+assert "sound-done" in names
+
+mgr.shutdown()
+'''
+
+
+def write_sine(path, rate, seconds, freq, amplitude):
+    with wave.open(str(path), 'wb') as out:
+        out.setnchannels(1)
+        out.setsampwidth(2)
+        out.setframerate(rate)
+        frames = int(rate * seconds)
+        out.writeframes(b''.join(
+            struct.pack('<h', int(amplitude * math.sin(2 * math.pi * freq * i / rate)))
+            for i in range(frames)))
+
+
+def test_software_audio_mix(tmp_path):
+    input = tmp_path / 'sine.wav'
+    output = tmp_path / 'mixed.wav'
+
+    # A half-second sine wave at half the output rate, so that it has to be
+    # resampled.
+    write_sine(input, 22050, 0.5, 441, 16000)
+
+    script = SCRIPT.format(input=str(input), output=output.as_posix())
+    result = subprocess.run([sys.executable, '-c', script])
+    if result.returncode == 77:
+        pytest.skip("p3software_audio not available")
+    assert result.returncode == 0
+
+    with wave.open(str(output), 'rb') as mixed:
+        assert mixed.getnchannels() == 2
+        assert mixed.getsampwidth() == 2
+        assert mixed.getframerate() == 44100
+        assert mixed.getnframes() == 44100
+        data = mixed.readframes(mixed.getnframes())
+
+    samples = struct.unpack('<%dh' % (len(data) // 2), data)
+    left = samples[0::2]
+    right = samples[1::2]
+
+    # The sound was panned hard left, and lasted half a second.
+    assert not any(right)
+    assert any(left[:22050])
+    assert not any(left[22050:])
+
+    # Linear interpolation should track the original waveform closely.
+    for i in range(0, 22000, 7):
+        expected = 16000 * math.sin(2 * math.pi * 441 * i / 44100)
+        assert abs(left[i] - expected) < 64
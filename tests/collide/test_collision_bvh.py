@@ -0,0 +1,136 @@
+from panda3d import core
+import pytest
+
+
+def make_grid_geom(size):
+    # Makes a flat grid of size x size quads in the XY plane, spanning 0..size.
+    vdata = core.GeomVertexData("grid", core.GeomVertexFormat.get_v3(),
+                                core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            tris.add_vertices(i, i + 1, i + size + 2)
+            tris.add_vertices(i, i + size + 2, i + size + 1)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+    return geom
+
+
+def make_polygon_node(size):
+    # Makes a CollisionNode with a grid of size x size polygons at z=0, plus an
+    # unbounded plane at z=-10.
+    cnode = core.CollisionNode("polys")
+    for y in range(size):
+        for x in range(size):
+            cnode.add_solid(core.CollisionPolygon(
+                (x, y, 0), (x + 1, y, 0), (x + 1, y + 1, 0), (x, y + 1, 0)))
+    cnode.add_solid(core.CollisionPlane(core.Plane((0, 0, 1), (0, 0, -10))))
+    return cnode
+
+
+COLLIDERS = [
+    core.CollisionSphere((3.3, 4.6, 0.2), 0.5),
+    core.CollisionSphere((10.5, 10.5, 5), 0.5),
+    core.CollisionRay((7.25, 2.75, 5), (0, 0, -1)),
+    core.CollisionRay((1, 1, 1), (1, 2, -0.1)),
+    core.CollisionSegment((2.5, 2.5, 1), (5.5, 3.5, -1)),
+    core.CollisionCapsule((1.2, 1.2, 0.3), (4.2, 1.7, 0.3), 0.4),
+    core.CollisionBox((8.5, 8.5, 0), 1.2, 0.7, 0.5),
+]
+
+
+def collide(into_node, solid):
+    root = core.NodePath("root")
+    root.attach_new_node(into_node)
+
+    from_node = core.CollisionNode("from")
+    from_node.add_solid(solid)
+    from_node.set_into_collide_mask(0)
+    from_node.set_from_collide_mask(core.GeomNode.get_default_collide_mask() |
+                                    core.CollisionNode.get_default_collide_mask())
+    from_np = root.attach_new_node(from_node)
+
+    trav = core.CollisionTraverser()
+    queue = core.CollisionHandlerQueue()
+    trav.add_collider(from_np, queue)
+    trav.traverse(root)
+
+    hits = set()
+    for entry in queue.entries:
+        point = entry.get_surface_point(root)
+        hits.add((round(point.x, 3), round(point.y, 3), round(point.z, 3)))
+    return hits
+
+
+@pytest.fixture
+def bvh_threshold():
+    var = core.ConfigVariableInt("collision-bvh-threshold")
+    yield var
+    var.clear_local_value()
+
+
+@pytest.mark.parametrize("solid", COLLIDERS)
+def test_collision_bvh_geom(bvh_threshold, solid):
+    gnode = core.GeomNode("grid")
+    gnode.add_geom(make_grid_geom(16))
+
+    bvh_threshold.value = 16
+    hits = collide(gnode, solid)
+
+    bvh_threshold.value = 0
+    assert collide(gnode, solid) == hits
+
+
+@pytest.mark.parametrize("solid", COLLIDERS)
+def test_collision_bvh_node(bvh_threshold, solid):
+    cnode = make_polygon_node(12)
+
+    bvh_threshold.value = 16
+    hits = collide(cnode, solid)
+
+    bvh_threshold.value = 0
+    assert collide(cnode, solid) == hits
+
+
+def test_collision_bvh_geom_modified(bvh_threshold):
+    bvh_threshold.value = 16
+
+    geom = make_grid_geom(16)
+    gnode = core.GeomNode("grid")
+    gnode.add_geom(geom)
+    ray = core.CollisionRay((3.5, 3.5, 5), (0, 0, -1))
+    assert collide(gnode, ray) == {(3.5, 3.5, 0.0)}
+
+    # Raising the vertices must be noticed by the cached hierarchy.
+    vdata = geom.modify_vertex_data()
+    rewriter = core.GeomVertexRewriter(vdata, "vertex")
+    while not rewriter.is_at_end():
+        x, y, z = rewriter.get_data3()
+        rewriter.set_data3(x, y, z + 2)
+    del rewriter
+    gnode.mark_internal_bounds_stale()
+
+    assert collide(gnode, ray) == {(3.5, 3.5, 2.0)}
+
+
+def test_collision_bvh_node_modified(bvh_threshold):
+    bvh_threshold.value = 16
+
+    cnode = make_polygon_node(8)
+    ray = core.CollisionRay((3.5, 3.5, 5), (0, 0, -1))
+    assert collide(cnode, ray) == {(3.5, 3.5, 0.0), (3.5, 3.5, -10.0)}
+
+    # Replacing a solid must be noticed by the cached hierarchy.
+    cnode.set_solid(3 * 8 + 3, core.CollisionPolygon(
+        (3, 3, 1), (4, 3, 1), (4, 4, 1), (3, 4, 1)))
+    assert collide(cnode, ray) == {(3.5, 3.5, 1.0), (3.5, 3.5, -10.0)}
+
+    cnode.remove_solid(3 * 8 + 3)
+    assert collide(cnode, ray) == {(3.5, 3.5, -10.0)}
@@ -0,0 +1,123 @@
+from panda3d import core
+import pytest
+
+
+def make_floor_mesh(size):
+    # Makes a floor of size x size quads spanning 0..size, sloping so that the
+    # height at (x, y) is 0.5 * x + 0.25 * y.
+    mesh = core.CollisionFloorMesh()
+    for y in range(size + 1):
+        for x in range(size + 1):
+            mesh.add_vertex((x, y, 0.5 * x + 0.25 * y))
+
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            mesh.add_triangle(i, i + 1, i + size + 2)
+            mesh.add_triangle(i, i + size + 2, i + size + 1)
+    return mesh
+
+
+def get_floor(mesh, x, y):
+    # Returns the surface point under the indicated point, or None.
+    root = core.NodePath("root")
+    cnode = core.CollisionNode("floor")
+    cnode.add_solid(mesh)
+    root.attach_new_node(cnode)
+
+    from_node = core.CollisionNode("from")
+    from_node.add_solid(core.CollisionRay((x, y, 1000), (0, 0, -1)))
+    from_np = root.attach_new_node(from_node)
+
+    trav = core.CollisionTraverser()
+    queue = core.CollisionHandlerQueue()
+    trav.add_collider(from_np, queue)
+    trav.traverse(root)
+
+    if queue.get_num_entries() == 0:
+        return None
+    return queue.get_entry(0).get_surface_point(root)
+
+
+def reconstruct(object, minor_ver):
+    buffer = core.DatagramBuffer()
+    writer = core.BamWriter(buffer)
+    writer.set_file_minor_ver(minor_ver)
+    writer.init()
+    writer.write_object(object)
+
+    reader = core.BamReader(buffer)
+    reader.init()
+    object = reader.read_object()
+    reader.resolve()
+    return object
+
+
+POINTS = [(0.5, 0.5), (3.25, 7.75), (9.9, 0.1), (6.0, 2.5), (5.5, 5.0)]
+
+
+def test_floor_mesh_ray():
+    mesh = make_floor_mesh(10)
+
+    for x, y in POINTS:
+        point = get_floor(mesh, x, y)
+        assert point is not None
+        assert point.almost_equal((x, y, 0.5 * x + 0.25 * y), 0.001)
+
+    assert get_floor(mesh, -0.5, 5) is None
+    assert get_floor(mesh, 5, 10.5) is None
+    assert get_floor(mesh, 20, 20) is None
+
+
+def test_floor_mesh_add_triangle():
+    # Adding a triangle after the mesh has been queried must be noticed.
+    mesh = make_floor_mesh(4)
+    assert get_floor(mesh, 6, 1) is None
+
+    first = mesh.get_num_vertices()
+    mesh.add_vertex((5, 0, 1))
+    mesh.add_vertex((7, 0, 1))
+    mesh.add_vertex((7, 2, 1))
+    mesh.add_triangle(first, first + 1, first + 2)
+    assert get_floor(mesh, 6.5, 0.5).almost_equal((6.5, 0.5, 1), 0.001)
+
+
+def test_floor_mesh_flatten():
+    mesh = make_floor_mesh(4)
+    cnode = core.CollisionNode("floor")
+    cnode.add_solid(mesh)
+    np = core.NodePath(cnode)
+    np.set_pos(10, 0, 2)
+    np.flatten_light()
+
+    mesh = cnode.get_solid(0)
+    assert mesh.get_num_triangles() == 32
+    assert get_floor(mesh, 1.5, 1.25) is None
+    assert get_floor(mesh, 11.5, 1.25).almost_equal((11.5, 1.25, 3.0625), 0.001)
+
+
+@pytest.mark.parametrize("minor_ver", [44, 46])
+def test_floor_mesh_bam(minor_ver):
+    mesh = make_floor_mesh(10)
+    # Make sure the grid has been built before writing.
+    get_floor(mesh, 1.5, 1.5)
+
+    mesh2 = reconstruct(mesh, minor_ver)
+    assert type(mesh2) is core.CollisionFloorMesh
+    assert mesh2.get_num_vertices() == mesh.get_num_vertices()
+    assert mesh2.get_num_triangles() == mesh.get_num_triangles()
+
+    for x, y in POINTS:
+        assert get_floor(mesh2, x, y) == get_floor(mesh, x, y)
+    assert get_floor(mesh2, 20, 20) is None
+
+
+def test_floor_mesh_bam_large():
+    # More than 65535 triangles can only be stored in the newer format.
+    mesh = make_floor_mesh(200)
+    assert mesh.get_num_triangles() == 80000
+
+    mesh2 = reconstruct(mesh, 46)
+    assert mesh2.get_num_triangles() == 80000
+    assert get_floor(mesh2, 150.25, 199.5).almost_equal(
+        (150.25, 199.5, 0.5 * 150.25 + 0.25 * 199.5), 0.01)
@@ -0,0 +1,63 @@
+from panda3d import core
+
+
+def make_scene():
+    # A ray pointing down through three spheres at different heights.
+    root = core.NodePath("root")
+
+    into_nodes = []
+    for z in (2, -5, -2):
+        cnode = core.CollisionNode("sphere%d" % (z))
+        cnode.add_solid(core.CollisionSphere(0, 0, z, 0.5))
+        root.attach_new_node(cnode)
+        into_nodes.append(cnode)
+
+    from_node = core.CollisionNode("ray")
+    from_node.add_solid(core.CollisionRay((0, 0, 0), (0, 0, -1)))
+    from_np = root.attach_new_node(from_node)
+    from_np.set_pos(0, 0, 5)
+    return root, from_np
+
+
+def traverse(root, from_np, queue):
+    trav = core.CollisionTraverser()
+    trav.add_collider(from_np, queue)
+    trav.traverse(root)
+
+
+def test_collision_handler_queue_sort():
+    root, from_np = make_scene()
+    queue = core.CollisionHandlerQueue()
+    traverse(root, from_np, queue)
+
+    queue.sort_entries()
+    names = [entry.into_node.name for entry in queue.entries]
+    assert names == ["sphere2", "sphere-2", "sphere-5"]
+
+
+def test_collision_handler_queue_hits_only():
+    root, from_np = make_scene()
+
+    queue = core.CollisionHandlerQueue()
+    traverse(root, from_np, queue)
+    queue.sort_entries()
+
+    hits = core.CollisionHandlerQueue()
+    assert not hits.hits_only
+    hits.hits_only = True
+    traverse(root, from_np, hits)
+    hits.sort_entries()
+
+    assert hits.get_num_entries() == 0
+    assert hits.get_num_hits() == queue.get_num_entries()
+    for i, entry in enumerate(queue.entries):
+        assert hits.get_hit_point(i).almost_equal(entry.get_surface_point(from_np))
+        assert hits.get_hit_normal(i).almost_equal(entry.get_surface_normal(from_np))
+        assert hits.get_hit_from_node(i) == from_np.node()
+        assert hits.get_hit_into_node(i) == entry.into_node
+
+    # The points are in the space of the from node.
+    assert hits.get_hit_point(0).almost_equal((0, 0, -2.5))
+
+    hits.clear_entries()
+    assert hits.get_num_hits() == 0
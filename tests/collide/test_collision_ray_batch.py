@@ -0,0 +1,161 @@
+from panda3d import core
+import pytest
+
+
+def make_scene():
+    # A few different kinds of solids and visible geometry, some of them
+    # transformed, to collide the rays with.
+    root = core.NodePath("root")
+
+    cnode = core.CollisionNode("solids")
+    cnode.add_solid(core.CollisionSphere((0, 10, 0), 1))
+    cnode.add_solid(core.CollisionBox((5, 10, 0), 1, 1, 1))
+    cnode.add_solid(core.CollisionPolygon(
+        (-6, 9, -1), (-4, 9, -1), (-4, 9, 1), (-6, 9, 1)))
+    cnode.add_solid(core.CollisionPlane(core.Plane((0, 0, 1), (0, 0, -5))))
+    solids = root.attach_new_node(cnode)
+    solids.set_pos(0, 2, 0)
+
+    vdata = core.GeomVertexData("quad", core.GeomVertexFormat.get_v3(),
+                                core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    vertex.add_data3(-1, 0, -1)
+    vertex.add_data3(1, 0, -1)
+    vertex.add_data3(1, 0, 1)
+    vertex.add_data3(-1, 0, 1)
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    tris.add_vertices(0, 1, 2)
+    tris.add_vertices(0, 2, 3)
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+
+    gnode = core.GeomNode("quad")
+    gnode.add_geom(geom)
+    quad = root.attach_new_node(gnode)
+    quad.set_pos(0, 20, 0)
+    quad.set_scale(10)
+    quad.set_h(30)
+
+    return root
+
+
+RAYS = [
+    ((0.3, 0, 0.2), (0, 1, 0)),
+    ((5, 0, 0), (0, 1, 0)),
+    ((-5, 0, 0), (0, 1, 0)),
+    ((0.5, 0, 0.5), (0, 1, 0)),
+    ((3, 0, 2), (0.1, 1, -0.1)),
+    ((0, 0, 0), (0, 0, -1)),
+    ((0, 0, 0), (0, -1, 0)),
+    ((100, 0, 0), (0, 1, 0)),
+]
+
+
+def traverser_hits(root, origin, direction, find_all):
+    from_node = core.CollisionNode("from")
+    from_node.add_solid(core.CollisionRay(origin, direction))
+    from_node.set_into_collide_mask(0)
+    from_node.set_from_collide_mask(core.GeomNode.get_default_collide_mask() |
+                                    core.CollisionNode.get_default_collide_mask())
+    from_np = root.attach_new_node(from_node)
+
+    trav = core.CollisionTraverser()
+    queue = core.CollisionHandlerQueue()
+    trav.add_collider(from_np, queue)
+    trav.traverse(root)
+    from_np.remove_node()
+
+    queue.sort_entries()
+    points = [entry.get_surface_point(root) for entry in queue.entries]
+    if not find_all:
+        points = points[:1]
+    return points
+
+
+@pytest.mark.parametrize("find_all", [False, True])
+def test_ray_batch_matches_traverser(find_all):
+    root = make_scene()
+
+    batch = core.CollisionRayBatch()
+    batch.collide_mask = (core.GeomNode.get_default_collide_mask() |
+                          core.CollisionNode.get_default_collide_mask())
+    batch.find_all = find_all
+    for origin, direction in RAYS:
+        batch.add_ray(origin, direction)
+    batch.traverse(root)
+
+    for i, (origin, direction) in enumerate(RAYS):
+        expected = traverser_hits(root, origin, direction, find_all)
+        assert batch.get_num_hits(i) == len(expected)
+        for n, point in enumerate(expected):
+            assert batch.get_hit_point(i, n).almost_equal(point, 0.001)
+
+
+def test_ray_batch_segment():
+    root = make_scene()
+
+    batch = core.CollisionRayBatch()
+    batch.add_segment((0, 0, 0), (0, 20, 0))
+    batch.add_segment((0, 0, 0), (0, 5, 0))
+    batch.add_segment((0, 14, 0), (0, 0, 0))
+    assert batch.traverse(root) == 2
+
+    assert batch.has_hit(0)
+    assert batch.get_hit_t(0) == pytest.approx(11 / 20.0)
+    assert batch.get_hit_point(0).almost_equal((0, 11, 0), 0.001)
+    assert batch.get_hit_normal(0).almost_equal((0, -1, 0), 0.001)
+    assert batch.get_hit_node(0).name == "solids"
+
+    assert not batch.has_hit(1)
+
+    assert batch.get_hit_point(2).almost_equal((0, 13, 0), 0.001)
+    assert batch.get_hit_normal(2).almost_equal((0, 1, 0), 0.001)
+
+
+def test_ray_batch_collide_mask():
+    root = make_scene()
+
+    # By default, visible geometry is not considered.
+    batch = core.CollisionRayBatch()
+    batch.add_ray((0.5, 0, 0.5), (0, 1, 0))
+    batch.add_ray((20, 0, 0), (-1, 1, 0))
+    batch.traverse(root)
+    assert batch.get_hit_node(0).name == "solids"
+    assert not batch.has_hit(1)
+
+    batch.collide_mask = core.GeomNode.get_default_collide_mask()
+    batch.traverse(root)
+    assert batch.get_hit_node(0).name == "quad"
+    assert batch.get_hit_node(1).name == "quad"
+
+
+def test_ray_batch_bvh():
+    # A CollisionNode large enough to have a bounding volume hierarchy must
+    # give the same results as one that does not.
+    var = core.ConfigVariableInt("collision-bvh-threshold")
+    root = core.NodePath("root")
+    cnode = core.CollisionNode("polys")
+    for y in range(12):
+        for x in range(12):
+            cnode.add_solid(core.CollisionPolygon(
+                (x, y, 0), (x + 1, y, 0), (x + 1, y + 1, 0), (x, y + 1, 0)))
+    root.attach_new_node(cnode)
+
+    batch = core.CollisionRayBatch()
+    for y in range(13):
+        for x in range(13):
+            batch.add_ray((x + 0.3, y + 0.6, 5), (0.1, -0.1, -1))
+
+    results = []
+    try:
+        for threshold in (16, 0):
+            var.value = threshold
+            batch.traverse(root)
+            results.append([batch.get_hit_point(i) if batch.has_hit(i) else None
+                            for i in range(batch.get_num_rays())])
+    finally:
+        var.clear_local_value()
+
+    assert results[0] == results[1]
+    assert results[0].count(None) > 0
+    assert results[0].count(None) < len(results[0])
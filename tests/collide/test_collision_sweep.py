@@ -0,0 +1,140 @@
+from panda3d import core
+import pytest
+
+
+def make_quad():
+    # A 2x2 quad in the XZ plane, facing -Y.
+    return core.CollisionPolygon(
+        (-1, 0, -1), (1, 0, -1), (1, 0, 1), (-1, 0, 1))
+
+
+def make_quad_geom():
+    vdata = core.GeomVertexData("quad", core.GeomVertexFormat.get_v3(),
+                                core.Geom.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    vertex.add_data3(-1, 0, -1)
+    vertex.add_data3(1, 0, -1)
+    vertex.add_data3(1, 0, 1)
+    vertex.add_data3(-1, 0, 1)
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    tris.add_vertices(0, 1, 2)
+    tris.add_vertices(0, 2, 3)
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+
+    gnode = core.GeomNode("quad")
+    gnode.add_geom(geom)
+    return gnode
+
+
+def make_scene(solid_from, into, prev_pos, pos):
+    root = core.NodePath("root")
+    if isinstance(into, core.CollisionSolid):
+        cnode = core.CollisionNode("into")
+        cnode.add_solid(into)
+        into = cnode
+    root.attach_new_node(into)
+
+    from_node = core.CollisionNode("from")
+    from_node.add_solid(solid_from)
+    from_node.set_from_collide_mask(core.GeomNode.get_default_collide_mask() |
+                                    core.CollisionNode.get_default_collide_mask())
+    from_np = root.attach_new_node(from_node)
+    from_np.set_pos(prev_pos)
+    from_np.set_fluid_pos(pos)
+    return root, from_np
+
+
+def sweep(solid_from, into, prev_pos, pos, respect_prev_transform=True):
+    root, from_np = make_scene(solid_from, into, prev_pos, pos)
+
+    trav = core.CollisionTraverser()
+    trav.respect_prev_transform = respect_prev_transform
+    queue = core.CollisionHandlerQueue()
+    trav.add_collider(from_np, queue)
+    trav.traverse(root)
+
+    if queue.get_num_entries() == 0:
+        return None
+    queue.sort_entries()
+    entry = queue.get_entry(0)
+    return entry.get_t(), entry.get_contact_pos(root)
+
+
+BOX = core.CollisionBox((0, 0, 0), 0.25, 0.25, 0.25)
+CAPSULE = core.CollisionCapsule((0, 0, -0.5), (0, 0, 0.5), 0.25)
+
+
+@pytest.mark.parametrize("into", [make_quad, make_quad_geom])
+def test_box_sweep_into_poly(into):
+    # Without the sweep, the box passes right through.
+    assert sweep(BOX, into(), (0, -5, 0), (0, 5, 0), False) is None
+
+    t, pos = sweep(BOX, into(), (0, -5, 0), (0, 5, 0))
+    assert t == pytest.approx(0.475)
+    assert pos.almost_equal((0, -0.25, 0), 0.001)
+
+    # Passing by the side of the polygon is not a hit.
+    assert sweep(BOX, into(), (1.5, -5, 0), (1.5, 5, 0)) is None
+
+    # Nor is moving through it from behind.
+    assert sweep(BOX, into(), (0, 5, 0), (0, -5, 0)) is None
+
+
+@pytest.mark.parametrize("into", [make_quad, make_quad_geom])
+def test_capsule_sweep_into_poly(into):
+    assert sweep(CAPSULE, into(), (0, -5, 0), (0, 5, 0), False) is None
+
+    t, pos = sweep(CAPSULE, into(), (0, -5, 0), (0, 5, 0))
+    assert t == pytest.approx(0.475, abs=0.02)
+    assert pos.almost_equal((0, 10 * t - 5, -0.5), 0.001)
+
+    # It only clips the edge of the polygon with its end.
+    t, pos = sweep(CAPSULE, into(), (0, -5, 1.6), (0, 5, 1.6))
+    assert 0.475 <= t <= 0.525
+
+    assert sweep(CAPSULE, into(), (0, -5, 1.9), (0, 5, 1.9)) is None
+
+
+def test_box_sweep_into_box():
+    into = core.CollisionBox((0, 0, 0), 1, 1, 1)
+    assert sweep(BOX, into, (-10, 0, 0), (10, 0, 0), False) is None
+
+    t, pos = sweep(BOX, into, (-10, 0, 0), (10, 0, 0))
+    assert t == pytest.approx(8.75 / 20)
+    assert pos.almost_equal((-1.25, 0, 0), 0.001)
+
+    assert sweep(BOX, into, (-10, 1.5, 0), (10, 1.5, 0)) is None
+
+    # A box that is not moving gives the same result as before.
+    t, pos = sweep(BOX, into, (0.5, 0, 0), (0.5, 0, 0))
+    assert t == 1
+
+
+def test_capsule_sweep_into_box():
+    into = core.CollisionBox((0, 0, 0), 1, 1, 1)
+    assert sweep(CAPSULE, into, (-10, 0, 0), (10, 0, 0), False) is None
+
+    t, pos = sweep(CAPSULE, into, (-10, 0, 0), (10, 0, 0))
+    assert t == pytest.approx(8.75 / 20, abs=0.02)
+    assert pos.almost_equal((20 * t - 10, 0, -0.5), 0.001)
+
+    assert sweep(CAPSULE, into, (-10, 1.5, 0), (10, 1.5, 0)) is None
+
+
+@pytest.mark.parametrize("solid", [BOX, CAPSULE])
+@pytest.mark.parametrize("pusher_type", [core.CollisionHandlerPusher,
+                                         core.CollisionHandlerFluidPusher])
+def test_pusher_sweep(solid, pusher_type):
+    # A fast-moving collider must be stopped in front of the wall, rather than
+    # passing through it.
+    root, from_np = make_scene(solid, make_quad(), (0, -5, 0), (0, 5, 0))
+
+    trav = core.CollisionTraverser()
+    trav.respect_prev_transform = True
+    pusher = pusher_type()
+    pusher.add_collider(from_np, from_np)
+    trav.add_collider(from_np, pusher)
+    trav.traverse(root)
+
+    assert from_np.get_y() == pytest.approx(-0.25, abs=0.25)
@@ -0,0 +1,170 @@
+from panda3d import core
+import http.server
+import threading
+import random
+import time
+import re
+import pytest
+
+HTTPDownloadManager = getattr(core, 'HTTPDownloadManager', None)
+pytestmark = pytest.mark.skipif(HTTPDownloadManager is None, reason="requires OpenSSL")
+
+
+class RangeRequestHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    documents = {}
+    ranges = []
+
+    def log_message(self, *args):
+        pass
+
+    def send_document(self, send_body):
+        data = self.documents.get(self.path.lstrip('/'))
+        if data is None:
+            self.send_response(404)
+            self.send_header('Content-Length', '0')
+            self.end_headers()
+            return
+
+        range_header = self.headers.get('Range')
+        if range_header:
+            match = re.match(r'bytes=(\d+)-(\d*)$', range_header)
+            first = int(match.group(1))
+            last = int(match.group(2)) if match.group(2) else len(data) - 1
+            body = data[first:last + 1]
+            self.ranges.append((self.path, first, last))
+            self.send_response(206)
+            self.send_header('Content-Range', 'bytes %d-%d/%d' % (first, last, len(data)))
+        else:
+            body = data
+            self.send_response(200)
+
+        self.send_header('Accept-Ranges', 'bytes')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        if send_body:
+            self.wfile.write(body)
+
+    def do_GET(self):
+        self.send_document(True)
+
+    def do_HEAD(self):
+        self.send_document(False)
+
+
+@pytest.fixture(scope='module')
+def server():
+    httpd = http.server.ThreadingHTTPServer(('127.0.0.1', 0), RangeRequestHandler)
+    thread = threading.Thread(target=httpd.serve_forever, daemon=True)
+    thread.start()
+    yield httpd
+    httpd.shutdown()
+    httpd.server_close()
+
+
+def make_document(name, size):
+    data = random.Random(size).getrandbits(size * 8).to_bytes(size, 'little')
+    RangeRequestHandler.documents[name] = data
+    return data
+
+
+def url(server, name):
+    return core.DocumentSpec('http://127.0.0.1:%d/%s' % (server.server_address[1], name))
+
+
+def filename(tmp_path, name):
+    return core.Filename.from_os_specific(str(tmp_path / name))
+
+
+def expected_hash(data):
+    hv = core.HashVal()
+    hv.hash_bytes(data)
+    return hv
+
+
+def test_download_manager_small(server, tmp_path):
+    data = make_document('small.bin', 1000)
+
+    mgr = HTTPDownloadManager()
+    n = mgr.add_download(url(server, 'small.bin'), filename(tmp_path, 'small.bin'))
+    assert mgr.download_all()
+
+    assert mgr.get_download_status(n) == HTTPDownloadManager.DS_complete
+    assert mgr.get_download_file_size(n) == len(data)
+    assert mgr.get_download_hash(n) == expected_hash(data)
+    assert (tmp_path / 'small.bin').read_bytes() == data
+
+
+def test_download_manager_ranges(server, tmp_path):
+    data = make_document('ranges.bin', 1000000)
+    del RangeRequestHandler.ranges[:]
+
+    mgr = HTTPDownloadManager()
+    mgr.max_connections_per_host = 4
+    mgr.range_size = 65536
+    n = mgr.add_download(url(server, 'ranges.bin'), filename(tmp_path, 'ranges.bin'),
+                         0, expected_hash(data))
+    assert mgr.download_all()
+
+    assert mgr.get_download_status(n) == HTTPDownloadManager.DS_complete
+    assert (tmp_path / 'ranges.bin').read_bytes() == data
+    assert 1 < mgr.num_connections <= 4
+
+    # The document should have been fetched in pieces.
+    ranges = sorted(r[1:] for r in RangeRequestHandler.ranges if r[0] == '/ranges.bin')
+    assert len(ranges) == (len(data) + 65535) // 65536
+    assert ranges[0][0] == 0
+    assert ranges[-1][1] == len(data) - 1
+
+
+def test_download_manager_known_size(server, tmp_path):
+    data = make_document('known.bin', 300000)
+
+    mgr = HTTPDownloadManager()
+    mgr.range_size = 100000
+    n = mgr.add_download(url(server, 'known.bin'), filename(tmp_path, 'known.bin'), len(data))
+    assert mgr.download_all()
+
+    assert mgr.get_download_status(n) == HTTPDownloadManager.DS_complete
+    assert mgr.get_download_hash(n) == expected_hash(data)
+    assert (tmp_path / 'known.bin').read_bytes() == data
+
+
+def test_download_manager_hash_mismatch(server, tmp_path):
+    make_document('mismatch.bin', 5000)
+
+    mgr = HTTPDownloadManager()
+    n = mgr.add_download(url(server, 'mismatch.bin'), filename(tmp_path, 'mismatch.bin'),
+                         0, core.HashVal())
+    assert not mgr.download_all()
+    assert mgr.get_download_status(n) == HTTPDownloadManager.DS_hash_mismatch
+
+
+def test_download_manager_missing(server, tmp_path):
+    mgr = HTTPDownloadManager()
+    mgr.max_retries = 0
+    n = mgr.add_download(url(server, 'missing.bin'), filename(tmp_path, 'missing.bin'))
+    assert not mgr.download_all()
+    assert mgr.get_download_status(n) == HTTPDownloadManager.DS_failed
+    assert not (tmp_path / 'missing.bin').exists()
+
+
+def test_download_manager_throughput(server, tmp_path):
+    # Not a pass/fail benchmark; reports the loopback throughput.
+    size = 16 * 1024 * 1024
+    documents = [make_document('bench%d.bin' % (i), size + i) for i in range(4)]
+
+    mgr = HTTPDownloadManager()
+    mgr.max_connections_per_host = 8
+    mgr.range_size = 1024 * 1024
+    for i, data in enumerate(documents):
+        mgr.add_download(url(server, 'bench%d.bin' % (i)),
+                         filename(tmp_path, 'bench%d.bin' % (i)),
+                         len(data), expected_hash(data))
+
+    start = time.time()
+    assert mgr.download_all()
+    elapsed = time.time() - start
+
+    total = sum(len(data) for data in documents)
+    print("Downloaded %d bytes in %.3f s (%.1f MB/s)" % (total, elapsed, total / elapsed / 1e6))
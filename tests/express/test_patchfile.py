@@ -0,0 +1,84 @@
+from panda3d import core
+import random
+import pytest
+
+Patchfile = getattr(core, 'Patchfile', None)
+pytestmark = pytest.mark.skipif(Patchfile is None, reason="requires OpenSSL")
+
+
+def make_files(tmp_path, size):
+    rng = random.Random(size)
+    orig = rng.getrandbits(size * 8).to_bytes(size, 'little')
+
+    # Make a new version with some bytes changed, some removed, some inserted,
+    # and a block moved from the end to the front.
+    new = bytearray(orig)
+    for i in range(20):
+        new[rng.randrange(len(new))] ^= 0xff
+    pos = rng.randrange(len(new) - 1000)
+    del new[pos:pos + 1000]
+    pos = rng.randrange(len(new))
+    new[pos:pos] = rng.getrandbits(500 * 8).to_bytes(500, 'little')
+    new = new[-5000:] + new[:-5000]
+
+    orig_fn = tmp_path / 'orig.bin'
+    new_fn = tmp_path / 'new.bin'
+    orig_fn.write_bytes(bytes(orig))
+    new_fn.write_bytes(bytes(new))
+    return core.Filename.from_os_specific(str(orig_fn)), \
+           core.Filename.from_os_specific(str(new_fn))
+
+
+def build_and_apply(tmp_path, orig_fn, new_fn, name):
+    patch_fn = core.Filename.from_os_specific(str(tmp_path / (name + '.pch')))
+    result_fn = core.Filename.from_os_specific(str(tmp_path / (name + '.out')))
+
+    assert Patchfile().build(orig_fn, new_fn, patch_fn)
+    assert Patchfile().apply(patch_fn, orig_fn, result_fn)
+
+    with open(result_fn.to_os_specific(), 'rb') as result, \
+         open(new_fn.to_os_specific(), 'rb') as new:
+        assert result.read() == new.read()
+
+    with open(patch_fn.to_os_specific(), 'rb') as patch:
+        return patch.read()
+
+
+def test_patchfile_build_small(tmp_path):
+    orig_fn, new_fn = make_files(tmp_path, 20000)
+    patch = build_and_apply(tmp_path, orig_fn, new_fn, 'small')
+    assert len(patch) < 2000
+
+
+def test_patchfile_build_threads(tmp_path):
+    # Large enough to be divided into several chunks.
+    orig_fn, new_fn = make_files(tmp_path, 3 * 1024 * 1024)
+
+    page = core.load_prc_file_data('', 'patchfile-build-threads 1')
+    try:
+        patch1 = build_and_apply(tmp_path, orig_fn, new_fn, 'threads1')
+    finally:
+        core.unload_prc_file(page)
+
+    page = core.load_prc_file_data('', 'patchfile-build-threads 4')
+    try:
+        patch4 = build_and_apply(tmp_path, orig_fn, new_fn, 'threads4')
+    finally:
+        core.unload_prc_file(page)
+
+    # The result should not depend on the number of threads.
+    assert patch1 == patch4
+    assert len(patch1) < 10000
+
+
+def test_patchfile_build_sparse_index(tmp_path):
+    orig_fn, new_fn = make_files(tmp_path, 1024 * 1024)
+
+    # Allow only enough index memory for one in every 16 positions.
+    page = core.load_prc_file_data('', 'patchfile-max-index-size %d' % (1024 * 1024 // 4))
+    try:
+        patch = build_and_apply(tmp_path, orig_fn, new_fn, 'sparse')
+    finally:
+        core.unload_prc_file(page)
+
+    assert len(patch) < 10000
@@ -101,3 +101,62 @@ def test_geom_linestrips_adjacency():
         3, 4, 5, 6,
         4, 5, 6, 6,
     )
+
+
+def make_grid_triangles(size):
+    # Returns the triangles of a size x size grid of quads, in a scrambled
+    # order that is hostile to a vertex cache.
+    tris = []
+    for y in range(size):
+        for x in range(size):
+            v0 = y * (size + 1) + x
+            v1 = v0 + 1
+            v2 = v0 + size + 1
+            v3 = v2 + 1
+            tris.append((v0, v1, v3))
+            tris.append((v0, v3, v2))
+
+    # A fixed stride permutation, so that the test is deterministic.
+    count = len(tris)
+    return [tris[(i * 97) % count] for i in range(count)]
+
+
+def test_geom_triangles_optimize_vertex_cache():
+    tris = make_grid_triangles(16)
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    for tri in tris:
+        prim.add_vertices(*tri)
+        prim.close_primitive()
+
+    orig_acmr = prim.calc_acmr(16)
+    assert orig_acmr > 2.0
+
+    opt = prim.optimize_vertex_cache(16)
+    assert opt.get_num_primitives() == prim.get_num_primitives()
+    assert opt.calc_acmr(16) < 1.0
+    assert opt.calc_acmr(16) < orig_acmr
+
+    # The same triangles must be present, each with its winding intact.
+    def canonical(tri):
+        i = tri.index(min(tri))
+        return tri[i:] + tri[:i]
+
+    verts = tuple(opt.get_vertex_list())
+    new_tris = [verts[i:i + 3] for i in range(0, len(verts), 3)]
+    assert sorted(map(canonical, new_tris)) == sorted(map(canonical, tris))
+
+
+def test_geom_primitive_calc_acmr():
+    # Nothing is reused between disconnected triangles.
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    prim.add_vertices(0, 1, 2)
+    prim.add_vertices(3, 4, 5)
+    assert prim.calc_acmr() == 3.0
+
+    # A strip shares two vertices with the previous triangle.
+    prim = core.GeomTristrips(core.GeomEnums.UH_static)
+    prim.add_consecutive_vertices(0, 6)
+    prim.close_primitive()
+    assert prim.calc_acmr() == 1.5
+
+    assert core.GeomPoints(core.GeomEnums.UH_static).calc_acmr() == 0
@@ -0,0 +1,83 @@
+import os
+import subprocess
+import sys
+import time
+
+import pytest
+
+
+lazy = pytest.mark.skipif(sys.version_info < (3, 7),
+                          reason="requires module-level __getattr__")
+
+# Each of these runs in a fresh interpreter, since other tests will already
+# have created most of the classes.
+LAZY_SCRIPT = r'''
+import panda3d.core as core
+assert 'PfmFile' not in core.__dict__
+assert 'PfmFile' in dir(core)
+assert hasattr(core, 'PfmFile')
+assert 'PfmFile' in core.__dict__
+assert core.PfmFile.__name__ == 'PfmFile'
+'''
+
+RETURN_SCRIPT = r'''
+import panda3d.core as core
+assert 'ModelRoot' not in core.__dict__
+assert 'PandaNode' not in core.__dict__
+
+# Wrapping a returned object creates its class, even if it was never accessed
+# through the module.
+root = core.NodePath(core.ModelRoot("root"))
+node = root.node()
+assert type(node).__name__ == 'ModelRoot'
+assert isinstance(node, core.PandaNode)
+'''
+
+STAR_SCRIPT = r'''
+from panda3d.core import *
+assert PfmFile.__name__ == 'PfmFile'
+assert LPoint3 is LPoint3f or LPoint3 is LPoint3d
+'''
+
+
+def run_script(script):
+    result = subprocess.run([sys.executable, '-c', script],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    assert result.returncode == 0, result.stdout.decode()
+
+
+@lazy
+def test_lazy_class_access():
+    run_script(LAZY_SCRIPT)
+
+
+@lazy
+def test_lazy_class_return():
+    run_script(RETURN_SCRIPT)
+
+
+@lazy
+def test_lazy_class_import_star():
+    run_script(STAR_SCRIPT)
+
+
+def test_lazy_class_missing():
+    import panda3d.core as core
+    with pytest.raises(AttributeError):
+        core.ThisClassDoesNotExist
+
+
+@pytest.mark.skipif(not os.environ.get('PANDA_BENCHMARK'),
+                    reason="set PANDA_BENCHMARK to run benchmarks")
+def test_import_time():
+    # Measures the time taken by a fresh "import panda3d.core".
+    script = ("import time; t = time.perf_counter(); import panda3d.core; "
+              "print(time.perf_counter() - t)")
+    times = []
+    for i in range(5):
+        result = subprocess.run([sys.executable, '-c', script],
+                                stdout=subprocess.PIPE, check=True)
+        times.append(float(result.stdout))
+
+    print("import panda3d.core: %.1f ms" % (min(times) * 1000))
+    assert min(times) < 1.0
@@ -0,0 +1,137 @@
+from panda3d import core
+import pytest
+
+
+def make_tree():
+    # Builds a tree with several nodes sharing each name, at varying depths,
+    # and an instanced subgraph.
+    root = core.NodePath("root")
+    for i in range(3):
+        branch = root.attach_new_node("branch")
+        branch.set_tag("branch", str(i))
+        for j in range(3):
+            leaf = branch.attach_new_node("leaf")
+            leaf.set_tag("kind", "leaf%d" % (j))
+            twig = leaf.attach_new_node("twig%d" % (j))
+            twig.attach_new_node("leaf")
+
+    shared = core.NodePath("shared")
+    shared.attach_new_node("leaf").set_tag("kind", "shared")
+    shared.instance_to(root.find("branch"))
+    shared.instance_to(root.find("**/twig2"))
+
+    hidden = root.attach_new_node("leaf")
+    hidden.hide()
+    root.attach_new_node("leaf").stash()
+    return root
+
+
+QUERIES = ["**/leaf", "**/twig1", "**/=kind", "**/=kind=leaf1",
+           "**/=kind=leaf*", "**/=branch=1", "**/missing", "**/+PandaNode",
+           "**/leaf;+s", "**/tw*", "branch/leaf", "**/=kind;-h"]
+
+
+def paths(collection):
+    return [str(np) for np in collection]
+
+
+@pytest.mark.parametrize("query", QUERIES)
+def test_find_indexed(query):
+    root = make_tree()
+    expected = paths(root.find_all_matches(query))
+    expected_first = str(root.find(query))
+
+    root.node().find_indexed = True
+    assert root.node().is_find_indexed()
+    assert paths(root.find_all_matches(query)) == expected
+    assert str(root.find(query)) == expected_first
+
+    compiled = core.NodePathQuery(query)
+    assert compiled.valid
+    assert compiled.path == query
+    assert paths(root.find_all_matches(compiled)) == expected
+    assert str(root.find(compiled)) == expected_first
+
+    root.node().find_indexed = False
+    assert paths(root.find_all_matches(compiled)) == expected
+
+
+def test_find_indexed_changes():
+    root = make_tree()
+    root.node().set_find_indexed(True)
+    assert root.find_all_matches("**/renamed").is_empty()
+
+    # Renaming a node, even one deep below the indexed node, is noticed.
+    twig = root.find("**/twig1")
+    twig.set_name("renamed")
+    assert root.find("**/renamed") == twig
+    assert len(root.find_all_matches("**/twig1")) == 2
+    twig.node().name = "renamed2"
+    assert root.find("**/renamed").is_empty()
+    assert not root.find("**/renamed2").is_empty()
+
+    # So are tags.
+    twig.set_tag("new", "value")
+    assert root.find("**/=new=value") == twig
+    twig.clear_tag("new")
+    assert root.find("**/=new").is_empty()
+
+    # So are changes to the graph.
+    extra = core.NodePath("extra")
+    extra.attach_new_node("deep")
+    assert root.find("**/deep").is_empty()
+    extra.reparent_to(root.find("**/twig0"))
+    assert not root.find("**/deep").is_empty()
+    extra.stash()
+    assert root.find("**/deep").is_empty()
+    extra.unstash()
+    assert not root.find("**/deep").is_empty()
+    extra.detach_node()
+    assert root.find("**/deep").is_empty()
+
+    root.node().add_child(extra.node())
+    assert root.find("**/deep").get_parent().get_parent() == root
+    root.node().remove_child(extra.node())
+    assert root.find("**/deep").is_empty()
+
+    # The results still match an unindexed search.
+    for query in QUERIES:
+        expected = paths(root.find_all_matches(core.NodePathQuery(query)))
+        root.node().find_indexed = False
+        assert paths(root.find_all_matches(query)) == expected
+        root.node().find_indexed = True
+
+
+def test_find_indexed_max_search_depth():
+    root = core.NodePath("root")
+    np = root
+    for i in range(10):
+        np = np.attach_new_node("node")
+    root.node().find_indexed = True
+
+    depth = core.NodePath.get_max_search_depth()
+    try:
+        core.NodePath.set_max_search_depth(5)
+        assert len(root.find_all_matches("**/node")) == 4
+        root.node().find_indexed = False
+        assert len(root.find_all_matches("**/node")) == 4
+        root.node().find_indexed = True
+    finally:
+        core.NodePath.set_max_search_depth(depth)
+    assert len(root.find_all_matches("**/node")) == 10
+
+
+def test_nodepath_query_invalid():
+    query = core.NodePathQuery("**/+NoSuchType")
+    assert not query.valid
+
+    root = make_tree()
+    assert root.find(query).is_empty()
+    assert root.find_all_matches(query).is_empty()
+
+
+def test_nodepath_collection_find_all_matches():
+    root = make_tree()
+    branches = root.find_all_matches("branch")
+    assert paths(branches.find_all_matches(core.NodePathQuery("**/twig0"))) == \
+        paths(branches.find_all_matches("**/twig0"))
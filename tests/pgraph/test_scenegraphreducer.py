@@ -0,0 +1,110 @@
+from panda3d import core
+
+
+def make_grid(size):
+    vdata = core.GeomVertexData("grid", core.GeomVertexFormat.get_v3(), core.GeomEnums.UH_static)
+    vdata.unclean_set_num_rows((size + 1) * (size + 1))
+    writer = core.GeomVertexWriter(vdata, "vertex")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            writer.add_data3(x, y, 0)
+
+    tris = []
+    for y in range(size):
+        for x in range(size):
+            v0 = y * (size + 1) + x
+            v1 = v0 + 1
+            v2 = v0 + size + 1
+            v3 = v2 + 1
+            tris.append((v0, v1, v3))
+            tris.append((v0, v3, v2))
+
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    count = len(tris)
+    for i in range(count):
+        prim.add_vertices(*tris[(i * 97) % count])
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(prim)
+    node = core.GeomNode("grid")
+    node.add_geom(geom)
+    return node
+
+
+def get_triangle_positions(node):
+    geom = node.get_geom(0)
+    reader = core.GeomVertexReader(geom.get_vertex_data(), "vertex")
+    result = []
+    for prim in geom.get_primitives():
+        verts = prim.get_vertex_list()
+        for i in range(0, len(verts), 3):
+            tri = []
+            for v in verts[i:i + 3]:
+                reader.set_row(v)
+                tri.append(tuple(reader.get_data3()))
+            # Rotate to a canonical starting vertex without changing winding.
+            j = tri.index(min(tri))
+            result.append(tuple(tri[j:] + tri[:j]))
+    return sorted(result)
+
+
+def test_scenegraphreducer_optimize_vertex_cache():
+    node = make_grid(16)
+    orig_tris = get_triangle_positions(node)
+
+    gr = core.SceneGraphReducer()
+    orig_acmr = gr.calc_acmr(node, 16)
+    assert gr.optimize_vertex_cache(node, 16) == 1
+    assert gr.calc_acmr(node, 16) < orig_acmr
+
+    # The triangles are unchanged, but the vertices are now stored in the
+    # order in which they are first used.
+    assert get_triangle_positions(node) == orig_tris
+
+    geom = node.get_geom(0)
+    verts = geom.get_primitive(0).get_vertex_list()
+    seen = []
+    for v in verts:
+        if v not in seen:
+            seen.append(v)
+    assert seen == list(range(geom.get_vertex_data().get_num_rows()))
+
+
+def test_scenegraphreducer_simplify():
+    node = make_grid(16)
+    assert node.get_geom(0).get_primitive(0).get_num_faces() == 512
+
+    gr = core.SceneGraphReducer()
+    removed = gr.simplify(node, 0.25)
+    assert removed >= 384
+
+    tris = get_triangle_positions(node)
+    assert len(tris) == 512 - removed
+
+    # The grid is flat, so the open border is preserved exactly, and no
+    # triangle is flipped over.
+    corners = set(v for tri in tris for v in tri)
+    for corner in (0, 0, 0), (16, 0, 0), (0, 16, 0), (16, 16, 0):
+        assert corner in corners
+
+    for a, b, c in tris:
+        cross = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])
+        assert cross > 0
+
+
+def test_lodnode_add_simplified_switch():
+    source = make_grid(16)
+
+    lod = core.LODNode("lod")
+    lod.add_simplified_switch(source, 10, 0, 1.0)
+    lod.add_simplified_switch(source, 20, 10, 0.25)
+    assert lod.get_num_switches() == 2
+    assert lod.get_num_children() == 2
+
+    # The source itself is not modified.
+    assert source.get_geom(0).get_primitive(0).get_num_faces() == 512
+
+    faces = [lod.get_child(i).get_geom(0).get_primitive(0).get_num_faces()
+             for i in range(2)]
+    assert faces[0] == 512
+    assert faces[1] <= 128
@@ -0,0 +1,48 @@
+from panda3d import core
+
+
+def test_config_variable_set_value():
+    var = core.ConfigVariableBool("test-cache-bool", False)
+    assert var.value is False
+
+    var.value = True
+    assert var.value is True
+
+    assert var.clear_local_value()
+    assert var.value is False
+
+
+def test_config_variable_shared_core():
+    # Two ConfigVariable objects with the same name share a value, even
+    # though each has its own cache.
+    var1 = core.ConfigVariableInt("test-cache-shared", 1)
+    var2 = core.ConfigVariableInt("test-cache-shared", 1)
+    assert var1.value == 1
+    assert var2.value == 1
+
+    var1.value = 2
+    assert var2.value == 2
+
+    var2.clear_local_value()
+    assert var1.value == 1
+
+
+def test_config_variable_declaration_change():
+    var = core.ConfigVariableDouble("test-cache-decl", 1.0)
+    other = core.ConfigVariableDouble("test-cache-decl-other", 1.0)
+    assert var.value == 1.0
+    assert other.value == 1.0
+
+    page = core.load_prc_file_data("test_config_variable_declaration_change",
+                                   "test-cache-decl 2.0")
+    assert var.value == 2.0
+    assert other.value == 1.0
+
+    # Modifying the declaration in place is also noticed.
+    page.modify_declaration(0).set_double_word(0, 3.0)
+    assert var.value == 3.0
+    assert other.value == 1.0
+
+    assert core.unload_prc_file(page)
+    assert var.value == 1.0
+